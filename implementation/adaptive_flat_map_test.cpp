@@ -0,0 +1,174 @@
+#include "adaptive_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+
+// Test instantiations.
+template class std::adaptive_flat_map<int, std::string>;
+
+namespace {
+    template<typename Adaptive, typename Map>
+    bool same_elements(Adaptive const & adaptive, Map const & map)
+    {
+        return adaptive.size() == map.size() &&
+               std::equal(
+                   adaptive.begin(),
+                   adaptive.end(),
+                   map.begin(),
+                   map.end(),
+                   [](auto lhs, auto const & rhs) {
+                       return lhs.first == rhs.first &&
+                              lhs.second == rhs.second;
+                   });
+    }
+
+    using representation = std::adaptive_representation;
+}
+
+TEST(std_adaptive_flat_map, against_std_map)
+{
+    std::adaptive_flat_map_thresholds thresholds;
+    thresholds.segmented_size = 200;
+    thresholds.window = 64;
+    using map_t =
+        std::adaptive_flat_map<int, std::string, std::less<int>, 8, 16>;
+
+    map_t adaptive(std::less<int>(), thresholds);
+    std::map<int, std::string> map;
+    std::mt19937 gen(5);
+    bool seen[3] = {};
+    for (int i = 0; i < 20000; ++i) {
+        // Phases of growth, lookups and shrinkage take the map through
+        // every representation, several times.
+        int const phase = i / 2500 % 4;
+        int const k = int(gen() % 1000);
+        unsigned const op = gen() % 10;
+        if (phase == 0 || (phase == 1 && op < 2)) {
+            auto const result = adaptive.try_emplace(k, std::to_string(i));
+            auto const map_result = map.try_emplace(k, std::to_string(i));
+            ASSERT_EQ(result.second, map_result.second);
+            ASSERT_EQ(result.first->first, k);
+            ASSERT_EQ(result.first->second, map_result.first->second);
+        } else if (phase == 2 && op < 8) {
+            ASSERT_EQ(adaptive.erase(k), map.erase(k));
+        } else if (phase == 3 && op < 3 && !map.empty()) {
+            auto const it = adaptive.erase(adaptive.begin());
+            map.erase(map.begin());
+            ASSERT_EQ(it, adaptive.begin());
+        } else {
+            auto const it = adaptive.lower_bound(k);
+            auto const map_it = map.lower_bound(k);
+            ASSERT_EQ(it == adaptive.end(), map_it == map.end());
+            if (map_it != map.end()) {
+                ASSERT_EQ(it->first, map_it->first);
+            }
+            ASSERT_EQ(adaptive.contains(k), map.count(k) == 1u);
+        }
+        seen[int(adaptive.representation())] = true;
+        if (adaptive.representation() == representation::small) {
+            ASSERT_LE(adaptive.size(), 8u);
+        }
+        if (i % 500 == 0) {
+            ASSERT_TRUE(same_elements(adaptive, map));
+        }
+    }
+    EXPECT_TRUE(seen[0] && seen[1] && seen[2]);
+    EXPECT_TRUE(same_elements(adaptive, map));
+
+    // Iterating backward visits the same elements in reverse.
+    std::vector<int> backward;
+    for (auto it = adaptive.rbegin(); it != adaptive.rend(); ++it) {
+        backward.push_back(it->first);
+    }
+    std::vector<int> forward;
+    for (auto const & x : map) {
+        forward.push_back(x.first);
+    }
+    EXPECT_TRUE(std::equal(
+        backward.rbegin(), backward.rend(), forward.begin(), forward.end()));
+}
+
+TEST(std_adaptive_flat_map, transitions)
+{
+    std::adaptive_flat_map_thresholds thresholds;
+    thresholds.segmented_size = 100;
+    thresholds.window = 10;
+    thresholds.mutation_percent = 50;
+    using map_t = std::adaptive_flat_map<int, int, std::less<int>, 4, 8>;
+
+    map_t map(std::less<int>(), thresholds);
+    EXPECT_EQ(map.representation(), representation::small);
+    for (int i = 0; i < 4; ++i) {
+        map.emplace(i, i);
+    }
+    EXPECT_EQ(map.representation(), representation::small);
+    map[4] = 4;
+    EXPECT_EQ(map.representation(), representation::sorted);
+
+    // Insertions alone make every window insert-heavy.
+    for (int i = 5; i < 99; ++i) {
+        map.insert({i, i});
+    }
+    EXPECT_EQ(map.representation(), representation::sorted);
+    map.insert({99, 99});
+    EXPECT_EQ(map.representation(), representation::segmented);
+    EXPECT_EQ(map.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(map.at(i), i);
+    }
+
+    // The lookups above made the last window lookup-heavy, so the next
+    // mutation goes back to one flat_map.
+    map.insert_or_assign(0, -1);
+    EXPECT_EQ(map.representation(), representation::sorted);
+    EXPECT_EQ(map.at(0), -1);
+
+    // Erasing by key goes back to the small representation at half of
+    // _SmallSize; erasing by iterator never changes representation.
+    while (3 < map.size()) {
+        map.erase(map.begin()->first);
+    }
+    EXPECT_EQ(map.representation(), representation::sorted);
+    map.erase(map.begin());
+    EXPECT_EQ(map.representation(), representation::sorted);
+    map.erase(98);
+    EXPECT_EQ(map.representation(), representation::small);
+    EXPECT_EQ(map.begin()->first, 99);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.representation(), representation::small);
+    EXPECT_THROW(map.at(0), std::out_of_range);
+}
+
+TEST(std_adaptive_flat_map, construction)
+{
+    using map_t = std::adaptive_flat_map<int, std::string, std::less<int>, 4>;
+
+    map_t const small = {{3, "three"}, {1, "one"}, {2, "two"}};
+    EXPECT_EQ(small.representation(), representation::small);
+    EXPECT_EQ(small.begin()->second, "one");
+
+    std::map<int, std::string> source;
+    for (int i = 0; i < 50; ++i) {
+        source.emplace(i, std::to_string(i));
+    }
+    map_t const sorted(source.begin(), source.end());
+    EXPECT_EQ(sorted.representation(), representation::sorted);
+    EXPECT_TRUE(same_elements(sorted, source));
+    EXPECT_EQ(sorted.find(7)->second, "7");
+    EXPECT_EQ(sorted.find(70), sorted.end());
+    EXPECT_EQ(sorted.upper_bound(48)->first, 49);
+    auto const range = sorted.equal_range(10);
+    EXPECT_EQ(std::distance(range.first, range.second), 1);
+
+    map_t copy = sorted;
+    EXPECT_EQ(copy, sorted);
+    copy[7] = "seven";
+    EXPECT_NE(copy, sorted);
+    map_t::const_iterator const it = copy.find(7);
+    EXPECT_EQ(it->second, "seven");
+}
@@ -0,0 +1,102 @@
+#include "aos_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+
+// Test instantiations.
+template class std::aos_flat_map<std::string, int>;
+template class std::aos_flat_map<int, double, std::greater<int>>;
+
+TEST(std_aos_flat_map, matches_std_map)
+{
+    std::aos_flat_map<int, std::string> map;
+    std::map<int, std::string> reference;
+    std::mt19937 gen(42);
+    for (int i = 0; i < 4000; ++i) {
+        int const key = int(gen() % 500);
+        std::string const value = std::to_string(i);
+        switch (gen() % 4) {
+        case 0:
+            EXPECT_EQ(
+                map.try_emplace(key, value).second,
+                reference.try_emplace(key, value).second);
+            break;
+        case 1:
+            map.insert_or_assign(key, value);
+            reference.insert_or_assign(key, value);
+            break;
+        case 2:
+            EXPECT_EQ(map.erase(key), reference.erase(key));
+            break;
+        default:
+            EXPECT_EQ(map.count(key), reference.count(key));
+            break;
+        }
+    }
+    ASSERT_EQ(map.size(), reference.size());
+    auto it = reference.begin();
+    for (auto const & [key, value] : map) {
+        EXPECT_EQ(key, it->first);
+        EXPECT_EQ(value, it->second);
+        ++it;
+    }
+    EXPECT_EQ(
+        map.lower_bound(250) - map.begin(),
+        std::distance(reference.begin(), reference.lower_bound(250)));
+    EXPECT_THROW(map.at(-1), std::out_of_range);
+}
+
+TEST(std_aos_flat_map, flat_map_interface)
+{
+    using map_t = std::aos_flat_map<std::string, int, std::less<>>;
+    using flat_map_t = std::flat_map<std::string, int, std::less<>>;
+    using traits = std::iterator_traits<map_t::iterator>;
+    using flat_map_traits = std::iterator_traits<flat_map_t::iterator>;
+    static_assert(std::is_same<
+                  traits::reference,
+                  flat_map_traits::reference>::value);
+    static_assert(std::is_same<
+                  traits::iterator_category,
+                  std::random_access_iterator_tag>::value);
+
+    map_t map = {{"b", 2}, {"a", 1}, {"c", 3}, {"a", 4}};
+    EXPECT_EQ(map.size(), 3u);
+    EXPECT_EQ(map["a"], 1);
+    map.begin()->second = 10;
+    EXPECT_EQ(map.at("a"), 10);
+    map["d"] = 4;
+    EXPECT_EQ((map.end() - 1)->first, "d");
+    map_t::const_iterator const cit = map.find(std::string_view("c"));
+    EXPECT_EQ(cit->second, 3);
+    EXPECT_TRUE(map.contains(std::string_view("b")));
+    EXPECT_EQ(map.rbegin()->first, "d");
+
+    std::pair<std::string, int> const more[] = {
+        {"a", 0}, {"e", 5}, {"f", 6}};
+    map.insert(std::sorted_unique, std::begin(more), std::end(more));
+    EXPECT_EQ(map.size(), 6u);
+    EXPECT_EQ(map.at("a"), 10);
+    EXPECT_EQ(map.at("f"), 6);
+
+    auto const even = [](auto x) { return x.second % 2 == 0; };
+    EXPECT_EQ(erase_if(map, even), 4u);
+    EXPECT_EQ(map, (map_t{{"c", 3}, {"e", 5}}));
+
+    auto elements = std::move(map).extract();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(elements.size(), 2u);
+    elements.emplace_back("z", 26);
+    map.replace(std::move(elements));
+    EXPECT_EQ(map.at("z"), 26);
+    EXPECT_EQ(map.erase(map.begin(), map.begin() + 2), map.begin());
+    EXPECT_EQ(map.size(), 1u);
+
+    map_t other(std::sorted_unique, {{"x", 1}, {"y", 2}});
+    swap(map, other);
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_LT(map, other);
+}
@@ -0,0 +1,156 @@
+#include "async_flat_map_loader"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <random>
+
+namespace {
+    using map_t = std::flat_map<int, double>;
+    using long_map_t = std::flat_map<long, int, std::greater<long>>;
+
+    std::string file_name(int i)
+    {
+        return "async_flat_map_loader_test." + std::to_string(i) + ".bin";
+    }
+
+    // Writes maps of assorted sizes, including an empty one and ones
+    // spanning many blocks, and returns them.
+    std::vector<map_t> write_maps()
+    {
+        std::vector<map_t> maps;
+        std::mt19937 gen(11);
+        for (int size : {0, 1, 1000, 50000, 123457}) {
+            std::vector<int> keys;
+            std::vector<double> values;
+            int k = -1000;
+            for (int i = 0; i < size; ++i) {
+                k += 1 + int(gen() % 100);
+                keys.push_back(k);
+                values.push_back(double(gen()));
+            }
+            map_t m(std::sorted_unique, std::move(keys), std::move(values));
+            std::write_flat_map_file(file_name(int(maps.size())).c_str(), m);
+            maps.push_back(std::move(m));
+        }
+        return maps;
+    }
+
+    void load_and_compare(std::async_load_options const & opts)
+    {
+        std::vector<map_t> const expected = write_maps();
+        std::vector<map_t> loaded(expected.size());
+        for (auto & m : loaded) {
+            m.emplace(-1, -1.0);
+        }
+        long_map_t other;
+        other.emplace(3, 3);
+        other.emplace(1, 1);
+        std::write_flat_map_file("async_flat_map_loader_test.long.bin", other);
+
+        std::async_flat_map_loader loader(opts);
+        for (std::size_t i = 0; i < loaded.size(); ++i) {
+            loader.add(file_name(int(i)).c_str(), loaded[i]);
+        }
+        long_map_t other_loaded;
+        loader.add(
+            "async_flat_map_loader_test.long.bin",
+            other_loaded,
+            std::sorted_unique);
+        loader.run();
+
+        for (std::size_t i = 0; i < loaded.size(); ++i) {
+            EXPECT_EQ(loaded[i], expected[i]) << "map " << i;
+        }
+        EXPECT_EQ(other_loaded, other);
+        EXPECT_EQ(other_loaded.begin()->first, 3);
+    }
+}
+
+TEST(async_flat_map_loader, buffered)
+{
+    std::async_load_options opts;
+    opts.block_size = 4096;
+    opts.queue_depth = 8;
+    load_and_compare(opts);
+}
+
+TEST(async_flat_map_loader, direct_io)
+{
+    std::async_load_options opts;
+    opts.direct_io = true;
+    opts.block_size = 64 * 1024;
+    load_and_compare(opts);
+}
+
+TEST(async_flat_map_loader, default_options)
+{
+    load_and_compare(std::async_load_options());
+}
+
+TEST(async_flat_map_loader, errors)
+{
+    std::vector<map_t> const expected = write_maps();
+
+    // Flip a byte of the values of map 3, and truncate map 4.
+    {
+        std::fstream f(file_name(3), std::ios::in | std::ios::out |
+                                         std::ios::binary);
+        f.seekp(-8, std::ios::end);
+        f.put('\x5a');
+    }
+    {
+        std::ifstream in(file_name(4), std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)),
+                          std::istreambuf_iterator<char>());
+        std::ofstream out(file_name(4), std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size() / 2);
+    }
+
+    for (bool direct : {false, true}) {
+        std::async_load_options opts;
+        opts.direct_io = direct;
+        opts.block_size = 8192;
+        std::async_flat_map_loader loader(opts);
+
+        std::vector<map_t> loaded(expected.size());
+        map_t missing;
+        missing.emplace(7, 7.0);
+        for (std::size_t i = 0; i < loaded.size(); ++i) {
+            loader.add(file_name(int(i)).c_str(), loaded[i]);
+        }
+        loader.add("async_flat_map_loader_test.missing.bin", missing);
+
+        // The first error, in the order the files were added, is thrown.
+        try {
+            loader.run();
+            ADD_FAILURE() << "run() did not throw";
+        } catch (std::runtime_error const & e) {
+            EXPECT_STREQ(e.what(), "flat_map file fails its checksum");
+        }
+
+        for (std::size_t i = 0; i < 3; ++i) {
+            EXPECT_EQ(loaded[i], expected[i]) << "map " << i;
+        }
+        EXPECT_TRUE(loaded[3].empty());
+        EXPECT_TRUE(loaded[4].empty());
+        EXPECT_EQ(missing.size(), 1u);
+
+        // The loader is reusable, and a missing file throws system_error.
+        loader.add("async_flat_map_loader_test.missing.bin", missing);
+        EXPECT_THROW(loader.run(), std::system_error);
+    }
+
+    // Unsorted keys are rejected, unless added with sorted_unique.
+    {
+        map_t m;
+        m.emplace(1, 1.0);
+        m.emplace(2, 2.0);
+        std::write_flat_map_file(file_name(0).c_str(), m);
+        std::flat_map<int, double, std::greater<int>> reversed;
+        std::async_flat_map_loader loader;
+        loader.add(file_name(0).c_str(), reversed);
+        EXPECT_THROW(loader.run(), std::runtime_error);
+        EXPECT_TRUE(reversed.empty());
+    }
+}
@@ -0,0 +1,116 @@
+#include "buffered_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+// Test instantiations.
+template class std::buffered_flat_map<std::flat_map<std::string, int>>;
+
+TEST(std_buffered_flat_map, insert_lookup)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    std::buffered_flat_map<fmap_t> map;
+    std::map<int, int> std_map;
+    for (int i = 0; i < 5000; ++i) {
+        int const key = (i * 7919) % 3001;
+        auto const result = map.try_emplace(key, i);
+        auto const std_result = std_map.try_emplace(key, i);
+        EXPECT_EQ(result.second, std_result.second);
+        EXPECT_EQ(*result.first, std_result.first->second);
+        EXPECT_TRUE(map.contains(key));
+        EXPECT_EQ(map.at(key), std_map.at(key));
+    }
+    EXPECT_EQ(map.size(), std_map.size());
+    EXPECT_FALSE(map.contains(-1));
+    EXPECT_THROW(map.at(-1), std::out_of_range);
+
+    EXPECT_TRUE(std::equal(
+        map.begin(),
+        map.end(),
+        std_map.begin(),
+        std_map.end(),
+        [](auto lhs, auto rhs) {
+            return lhs.first == rhs.first && lhs.second == rhs.second;
+        }));
+}
+
+TEST(std_buffered_flat_map, erase_assign)
+{
+    using fmap_t = std::flat_map<std::string, int>;
+
+    std::buffered_flat_map<fmap_t> map(fmap_t{{"key1", 1}, {"key2", 2}}, 4);
+    EXPECT_EQ(map.max_tail_size(), 4u);
+
+    map["key0"] = 0;
+    map.insert_or_assign("key1", 10);
+    map.insert_or_assign("key3", 3);
+    EXPECT_EQ(map.size(), 4u);
+
+    EXPECT_EQ(map.erase("key3"), 1u);
+    EXPECT_EQ(map.erase("key2"), 1u);
+    EXPECT_EQ(map.erase("key2"), 0u);
+
+    fmap_t const expected = {{"key0", 0}, {"key1", 10}};
+    EXPECT_EQ(map.map(), expected);
+    EXPECT_EQ(map.find("key1")->second, 10);
+    EXPECT_EQ(std::move(map).release(), expected);
+}
+
+TEST(std_buffered_flat_map, deferred_erase)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t initial;
+    for (int i = 0; i < 100; ++i) {
+        initial.emplace(i, i);
+    }
+    std::buffered_flat_map<fmap_t> map(initial, 8);
+    std::map<int, int> std_map;
+    for (int i = 0; i < 100; ++i) {
+        std_map.emplace(i, i);
+    }
+
+    // Erases from the sorted map stay marked until the eighth.
+    for (int i = 0; i < 7; ++i) {
+        EXPECT_EQ(map.erase(i * 3), 1u);
+        std_map.erase(i * 3);
+    }
+    EXPECT_EQ(map.erase(3), 0u);
+    EXPECT_EQ(map.size(), 93u);
+    EXPECT_FALSE(map.contains(3));
+    EXPECT_EQ(map.count(4), 1u);
+    EXPECT_THROW(map.at(6), std::out_of_range);
+
+    // A marked key can be inserted again, into the tail.
+    EXPECT_TRUE(map.try_emplace(6, 60).second);
+    std_map.emplace(6, 60);
+    EXPECT_EQ(map.at(6), 60);
+    EXPECT_EQ(map.size(), 94u);
+
+    for (int i = 7; i < 30; ++i) {
+        EXPECT_EQ(map.erase(i * 3), 1u);
+        std_map.erase(i * 3);
+    }
+    EXPECT_EQ(map.size(), std_map.size());
+
+    // find() removes the marked elements before handing out an iterator.
+    EXPECT_EQ(map.erase(31), 1u);
+    std_map.erase(31);
+    map.erase(map.find(32));
+    std_map.erase(32);
+    EXPECT_EQ(map.erase(91), 1u);
+    std_map.erase(91);
+
+    EXPECT_EQ(map.size(), std_map.size());
+    EXPECT_TRUE(std::equal(
+        map.begin(),
+        map.end(),
+        std_map.begin(),
+        std_map.end(),
+        [](auto lhs, auto rhs) {
+            return lhs.first == rhs.first && lhs.second == rhs.second;
+        }));
+}
@@ -0,0 +1,173 @@
+#include "checkpointed_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+#include <sys/stat.h>
+
+// Test instantiations.
+template class std::checkpointed_flat_map<std::flat_map<int, double>>;
+template class std::checkpointed_flat_map<
+    std::flat_map<long, int, std::greater<long>>>;
+
+namespace {
+    std::size_t file_size(char const * path)
+    {
+        struct stat st;
+        EXPECT_EQ(::stat(path, &st), 0);
+        return std::size_t(st.st_size);
+    }
+}
+
+TEST(std_checkpointed_flat_map, against_flat_map)
+{
+    using fmap_t = std::flat_map<int, int>;
+    char const * const path = "checkpointed_flat_map_test.random.bin";
+    std::remove(path);
+
+    std::checkpointed_flat_map<fmap_t> map(
+        fmap_t(), std::flat_map_checkpoint_policy{8, 200});
+    fmap_t expected;
+    std::mt19937 gen(13);
+    int full = 0;
+    for (int i = 0; i < 6000; ++i) {
+        int const k = int(gen() % 1000);
+        switch (gen() % 4) {
+        case 0:
+            EXPECT_EQ(
+                map.try_emplace(k, i).second,
+                expected.try_emplace(k, i).second);
+            break;
+        case 1:
+            EXPECT_EQ(
+                map.insert_or_assign(k, i).second,
+                expected.insert_or_assign(k, i).second);
+            break;
+        case 2: EXPECT_EQ(map.erase(k), expected.erase(k)); break;
+        case 3:
+            if (gen() % 50 == 0) {
+                map.clear();
+                expected.clear();
+            }
+            break;
+        }
+        ASSERT_EQ(map.map(), expected);
+        if (i % 97 == 96) {
+            full += map.checkpoint(path);
+            EXPECT_EQ(map.changed_elements(), 0u);
+            fmap_t loaded = {{-1, -1}};
+            std::load_checkpoint(path, loaded);
+            ASSERT_EQ(loaded, expected);
+        }
+    }
+    // The first checkpoint, and at least every eighth after it, is full.
+    EXPECT_LE(61 / 9, full);
+    EXPECT_LT(full, 61);
+
+    map.checkpoint(path);
+    std::checkpointed_flat_map<fmap_t> recovered(path);
+    EXPECT_EQ(recovered.map(), expected);
+    std::remove(path);
+}
+
+TEST(std_checkpointed_flat_map, delta_blocks)
+{
+    using fmap_t = std::flat_map<long, int, std::greater<long>>;
+    char const * const path = "checkpointed_flat_map_test.delta.bin";
+    std::remove(path);
+
+    fmap_t initial;
+    for (long i = 100000 - 1; 0 <= i; --i) {
+        initial.emplace_hint(initial.end(), i, int(i));
+    }
+    std::checkpointed_flat_map<fmap_t> map(initial);
+    EXPECT_EQ(map.changed_elements(), 0u);
+    EXPECT_TRUE(map.checkpoint(path));
+    std::size_t const base = file_size(path);
+    EXPECT_LE(100000u * (sizeof(long) + sizeof(int)), base);
+
+    // Assignments write only their elements.
+    EXPECT_FALSE(map.checkpoint(path));
+    EXPECT_EQ(file_size(path), base);
+    map.insert_or_assign(500, -1);
+    map.insert_or_assign(501, -1);
+    map.insert_or_assign(90000, -1);
+    EXPECT_EQ(map.changed_elements(), 3u);
+    EXPECT_FALSE(map.checkpoint(path));
+    std::size_t const one = file_size(path) - base;
+    EXPECT_EQ(
+        one,
+        sizeof(std::flat_map_delta_header) + 4 * sizeof(std::uint64_t) +
+            3 * (sizeof(long) + sizeof(int)));
+
+    // An insertion or erasure writes the elements it shifts: in
+    // descending order, those of the keys below it.
+    map.try_emplace(-1, -1);
+    EXPECT_EQ(map.changed_elements(), 1u);
+    map.erase(25000);
+    EXPECT_EQ(map.changed_elements(), 25001u);
+    map.try_emplace(25000, 0);
+    EXPECT_EQ(map.changed_elements(), 25002u);
+    map.erase(-1);
+    EXPECT_EQ(map.changed_elements(), 25001u);
+    EXPECT_FALSE(map.checkpoint(path));
+
+    // A delta that would take the blocks past half the full map's size
+    // rewrites the file instead.
+    map.erase(99999);
+    EXPECT_EQ(map.changed_elements(), 99999u);
+    EXPECT_TRUE(map.checkpoint(path));
+    EXPECT_LT(file_size(path), base);
+    fmap_t loaded;
+    std::load_checkpoint(path, loaded);
+    EXPECT_EQ(loaded, map.map());
+    std::remove(path);
+}
+
+TEST(std_checkpointed_flat_map, torn_block)
+{
+    using fmap_t = std::flat_map<int, int>;
+    char const * const path = "checkpointed_flat_map_test.torn.bin";
+    std::remove(path);
+
+    std::flat_map_checkpoint_policy const policy{64, 1000};
+    std::checkpointed_flat_map<fmap_t> map(
+        fmap_t{{1, 1}, {2, 2}, {3, 3}}, policy);
+    EXPECT_TRUE(map.checkpoint(path));
+    map.insert_or_assign(2, 20);
+    EXPECT_FALSE(map.checkpoint(path));
+    fmap_t const good = map.map();
+    std::size_t const good_size = file_size(path);
+    map.try_emplace(0, 0);
+    EXPECT_FALSE(map.checkpoint(path));
+
+    // A crash in the middle of the last block loses only that block.
+    ASSERT_EQ(::truncate(path, off_t(file_size(path) - 1)), 0);
+    fmap_t loaded;
+    std::load_checkpoint(path, loaded);
+    EXPECT_EQ(loaded, good);
+
+    // Recovery from a torn file rewrites it at the next checkpoint.
+    std::checkpointed_flat_map<fmap_t> recovered(path, {}, policy);
+    EXPECT_EQ(recovered.map(), good);
+    recovered.try_emplace(4, 4);
+    EXPECT_TRUE(recovered.checkpoint(path));
+    recovered.try_emplace(5, 5);
+    EXPECT_FALSE(recovered.checkpoint(path));
+    std::load_checkpoint(path, loaded);
+    EXPECT_EQ(loaded, recovered.map());
+    EXPECT_LT(good_size, file_size(path));
+
+    // A malformed full map throws, and leaves the map unchanged.
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "not a flat_map";
+    }
+    fmap_t unchanged = {{7, 7}};
+    EXPECT_THROW(std::load_checkpoint(path, unchanged), std::runtime_error);
+    EXPECT_EQ(unchanged, (fmap_t{{7, 7}}));
+    std::remove(path);
+}
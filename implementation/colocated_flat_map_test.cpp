@@ -0,0 +1,203 @@
+#include "colocated_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <string>
+
+// Test instantiations.
+template class std::colocated_flat_map<std::string, int>;
+template class std::colocated_flat_map<char, double>;
+
+namespace {
+    int allocations = 0;
+    bool copies_throw = false;
+
+    template<typename T>
+    struct counting_allocator
+    {
+        using value_type = T;
+
+        counting_allocator() = default;
+        template<typename U>
+        counting_allocator(counting_allocator<U> const &)
+        {}
+
+        T * allocate(std::size_t n)
+        {
+            ++allocations;
+            return std::allocator<T>().allocate(n);
+        }
+        void deallocate(T * p, std::size_t n)
+        {
+            std::allocator<T>().deallocate(p, n);
+        }
+
+        friend bool
+        operator==(counting_allocator const &, counting_allocator const &)
+        {
+            return true;
+        }
+        friend bool
+        operator!=(counting_allocator const &, counting_allocator const &)
+        {
+            return false;
+        }
+    };
+
+    struct throws_on_copy
+    {
+        throws_on_copy(int x) : x(x) {}
+        throws_on_copy(throws_on_copy const & other) : x(other.x)
+        {
+            if (copies_throw)
+                throw std::runtime_error("copy");
+        }
+        throws_on_copy & operator=(throws_on_copy const &) = default;
+        bool operator<(throws_on_copy const & other) const
+        {
+            return x < other.x;
+        }
+        int x;
+    };
+}
+
+TEST(std_colocated_flat_map, one_allocation_per_growth)
+{
+    using map_t = std::colocated_flat_map<
+        std::uint16_t,
+        double,
+        std::less<std::uint16_t>,
+        counting_allocator<std::pair<std::uint16_t const, double>>>;
+
+    allocations = 0;
+    map_t map;
+    EXPECT_EQ(allocations, 0);
+    std::size_t growths = 0;
+    for (int i = 0; i < 1000; ++i) {
+        std::size_t const capacity = map.capacity();
+        map[std::uint16_t(i * 7919 % 1000)] = i / 2.0;
+        growths += capacity != map.capacity();
+    }
+    EXPECT_EQ(map.size(), 1000u);
+    EXPECT_EQ(std::size_t(allocations), growths);
+
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(map.at(std::uint16_t(i * 7919 % 1000)), i / 2.0);
+    }
+    // The values are suitably aligned after any number of keys.
+    EXPECT_EQ(
+        reinterpret_cast<std::uintptr_t>(map.mapped_data()) % alignof(double),
+        0u);
+
+    allocations = 0;
+    map.reserve(5000);
+    EXPECT_EQ(allocations, 1);
+    EXPECT_EQ(map.capacity(), 5000u);
+    map.shrink_to_fit();
+    EXPECT_EQ(allocations, 2);
+    EXPECT_EQ(map.capacity(), 1000u);
+    EXPECT_TRUE(std::is_sorted(map.key_data(), map.key_data() + map.size()));
+}
+
+TEST(std_colocated_flat_map, matches_std_map)
+{
+    std::colocated_flat_map<std::string, int> map;
+    std::map<std::string, int> reference;
+    std::mt19937 gen(42);
+    for (int i = 0; i < 4000; ++i) {
+        std::string const key = std::to_string(gen() % 500);
+        switch (gen() % 4) {
+        case 0:
+            EXPECT_EQ(
+                map.try_emplace(key, i).second,
+                reference.try_emplace(key, i).second);
+            break;
+        case 1:
+            map.insert_or_assign(key, i);
+            reference.insert_or_assign(key, i);
+            break;
+        case 2:
+            EXPECT_EQ(map.erase(key), reference.erase(key));
+            break;
+        default:
+            EXPECT_EQ(map.count(key), reference.count(key));
+            break;
+        }
+    }
+    ASSERT_EQ(map.size(), reference.size());
+    auto it = reference.begin();
+    for (auto const & x : map) {
+        EXPECT_EQ(x.first, it->first);
+        EXPECT_EQ(x.second, it->second);
+        ++it;
+    }
+    EXPECT_EQ(map.lower_bound("2"), map.find((*map.lower_bound("2")).first));
+    EXPECT_THROW(map.at("x"), std::out_of_range);
+
+    std::colocated_flat_map<std::string, int> copy = map;
+    EXPECT_EQ(copy, map);
+    copy.erase(copy.begin());
+    EXPECT_NE(copy, map);
+    copy = map;
+    EXPECT_EQ(copy, map);
+    std::colocated_flat_map<std::string, int> moved = std::move(copy);
+    EXPECT_EQ(moved, map);
+    EXPECT_TRUE(copy.empty());
+
+    std::colocated_flat_map<std::string, int> const il = {
+        {"b", 2}, {"a", 1}, {"b", 3}};
+    EXPECT_EQ(il.size(), 2u);
+    EXPECT_EQ(il.at("b"), 2);
+    EXPECT_EQ((*il.begin()).first, "a");
+}
+
+TEST(std_colocated_flat_map, pmr)
+{
+    using value_t = std::pair<int const, std::pmr::string>;
+    using map_t = std::colocated_flat_map<
+        int,
+        std::pmr::string,
+        std::less<int>,
+        std::pmr::polymorphic_allocator<value_t>>;
+
+    std::pmr::monotonic_buffer_resource first;
+    std::pmr::monotonic_buffer_resource second;
+    map_t a(&first);
+    map_t b(&second);
+    for (int i = 0; i < 10; ++i) {
+        a.try_emplace(i, std::to_string(i));
+    }
+    b = std::move(a);
+    EXPECT_EQ(b.size(), 10u);
+    EXPECT_EQ(b.at(3), "3");
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(b.get_allocator().resource(), &second);
+    map_t c(b, &first);
+    EXPECT_EQ(c, b);
+    EXPECT_EQ(c.get_allocator().resource(), &first);
+}
+
+TEST(std_colocated_flat_map, growth_is_all_or_nothing)
+{
+    std::colocated_flat_map<throws_on_copy, int> map;
+    map.try_emplace(13, 0);
+    map.try_emplace(20, 1);
+    map.try_emplace(30, 2);
+    map.shrink_to_fit();
+    EXPECT_EQ(map.size(), map.capacity());
+
+    copies_throw = true;
+    EXPECT_THROW(map.try_emplace(10, 3), std::runtime_error);
+    copies_throw = false;
+    EXPECT_EQ(map.size(), 3u);
+    EXPECT_EQ(map.capacity(), 3u);
+    EXPECT_EQ((*map.begin()).first.x, 13);
+    EXPECT_EQ(map.at(30), 2);
+
+    map.try_emplace(10, 3);
+    EXPECT_EQ(map.size(), 4u);
+    EXPECT_EQ((*map.begin()).first.x, 10);
+}
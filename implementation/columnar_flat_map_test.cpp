@@ -0,0 +1,99 @@
+#include "columnar_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+
+// Test instantiations.
+template class std::columnar_flat_map<int, std::tuple<float, double, int>>;
+template class std::
+    columnar_flat_map<std::string, std::tuple<std::string>, std::less<>>;
+
+TEST(std_columnar_flat_map, columns)
+{
+    using map_t = std::columnar_flat_map<int, std::tuple<float, int, double>>;
+    using fields_t = std::tuple<float &, int &, double &>;
+    static_assert(std::is_same<
+                  map_t::reference,
+                  std::pair<int const &, fields_t>>::value);
+    static_assert(std::is_same<map_t::column_type<1>, std::vector<int>>::value);
+
+    map_t map;
+    std::map<int, std::tuple<float, int, double>> reference;
+    std::mt19937 gen(42);
+    for (int i = 0; i < 4000; ++i) {
+        int const key = int(gen() % 300);
+        auto const fields = std::make_tuple(float(i), i % 7, i / 2.0);
+        switch (gen() % 3) {
+        case 0:
+            EXPECT_EQ(
+                map.try_emplace(key, float(i), i % 7, i / 2.0).second,
+                reference.try_emplace(key, fields).second);
+            break;
+        case 1:
+            map.insert_or_assign(key, fields);
+            reference.insert_or_assign(key, fields);
+            break;
+        default:
+            EXPECT_EQ(map.erase(key), reference.erase(key));
+            break;
+        }
+    }
+    ASSERT_EQ(map.size(), reference.size());
+    auto ref_it = reference.begin();
+    for (auto const & [key, fields] : map) {
+        EXPECT_EQ(key, ref_it->first);
+        EXPECT_EQ(fields, ref_it->second);
+        ++ref_it;
+    }
+
+    // A scan over one column reads only that column.
+    std::vector<int> const & counts = map.column<1>();
+    ASSERT_EQ(counts.size(), map.size());
+    int expected = 0;
+    for (auto const & x : reference) {
+        expected += std::get<1>(x.second);
+    }
+    EXPECT_EQ(std::accumulate(counts.begin(), counts.end(), 0), expected);
+    EXPECT_EQ(map.keys().size(), map.column<2>().size());
+
+    int const key = reference.begin()->first;
+    std::get<2>(map.at(key)) = -1.0;
+    EXPECT_EQ(std::get<2>(map.find(key)->second), -1.0);
+    EXPECT_EQ(map.column<2>().front(), -1.0);
+    EXPECT_THROW(map.at(-1), std::out_of_range);
+    EXPECT_EQ(map.lower_bound(key), map.begin());
+    EXPECT_EQ(map.upper_bound(key), map.begin() + 1);
+    EXPECT_EQ(map.rbegin()->first, reference.rbegin()->first);
+
+    map_t copy = map;
+    EXPECT_EQ(copy, map);
+    copy.erase(copy.begin());
+    EXPECT_NE(copy, map);
+    copy.clear();
+    EXPECT_TRUE(copy.empty());
+    EXPECT_TRUE(copy.column<0>().empty());
+}
+
+TEST(std_columnar_flat_map, transparent_lookup_and_insert)
+{
+    using map_t = std::columnar_flat_map<
+        std::string,
+        std::tuple<std::string, int>,
+        std::less<>>;
+    map_t map = {
+        {"b", {"bee", 2}}, {"a", {"ay", 1}}, {"b", {"other", 3}}};
+    EXPECT_EQ(map.size(), 2u);
+    std::string_view const b = "b";
+    EXPECT_TRUE(map.contains(b));
+    EXPECT_EQ(std::get<0>(map.find(b)->second), "bee");
+    EXPECT_EQ(map.column<1>(), (std::vector<int>{1, 2}));
+
+    map_t::const_iterator const it = map.begin();
+    EXPECT_EQ(it->first, "a");
+    EXPECT_EQ(map.end() - it, 2);
+}
@@ -0,0 +1,111 @@
+#include "compressed_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+// Test instantiations.
+template class std::compressed_flat_map<std::uint64_t, int>;
+template class std::compressed_flat_map<short, double>;
+
+namespace {
+    template<typename Map, typename Key>
+    void check_against(Map const & map, std::vector<Key> const & keys, Key q)
+    {
+        std::size_t const lb =
+            std::lower_bound(keys.begin(), keys.end(), q) - keys.begin();
+        std::size_t const ub =
+            std::upper_bound(keys.begin(), keys.end(), q) - keys.begin();
+        EXPECT_EQ(std::size_t(map.lower_bound(q) - map.begin()), lb);
+        EXPECT_EQ(std::size_t(map.upper_bound(q) - map.begin()), ub);
+        EXPECT_EQ(map.contains(q), lb != ub);
+        if (lb != ub)
+            EXPECT_EQ(map.at(q), int(lb));
+        else
+            EXPECT_EQ(map.find(q), map.end());
+    }
+}
+
+TEST(std_compressed_flat_map, dense_ids)
+{
+    std::mt19937_64 gen(42);
+    std::vector<std::uint64_t> keys;
+    std::uint64_t id = 1000000000000ull;
+    for (int i = 0; i < 100000; ++i) {
+        keys.push_back(id);
+        id += 1 + gen() % 4;
+        if (i % 20000 == 0)
+            id += 1ull << 40;
+    }
+    std::vector<int> values(keys.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = int(i);
+    }
+
+    std::compressed_flat_map<std::uint64_t, int> const map(
+        std::sorted_unique, keys, values);
+    ASSERT_EQ(map.size(), keys.size());
+    EXPECT_LT(map.key_bytes() * 4, keys.size() * sizeof(std::uint64_t));
+
+    std::size_t i = 0;
+    for (auto const & x : map) {
+        ASSERT_EQ(x.first, keys[i]);
+        ASSERT_EQ(x.second, int(i));
+        ++i;
+    }
+    for (int n = 0; n < 20000; ++n) {
+        std::uint64_t const k = keys[gen() % keys.size()];
+        check_against(map, keys, k);
+        check_against(map, keys, k + 1);
+        check_against(map, keys, k - 1);
+    }
+    check_against(map, keys, std::uint64_t(0));
+    check_against(map, keys, ~std::uint64_t(0));
+    EXPECT_EQ(map.rbegin()->first, keys.back());
+    EXPECT_THROW(map.at(0), std::out_of_range);
+}
+
+TEST(std_compressed_flat_map, extremes)
+{
+    std::compressed_flat_map<std::uint64_t, int> const empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.find(1), empty.end());
+    EXPECT_EQ(empty.lower_bound(1), empty.end());
+
+    // A block spanning the whole range needs every bit of each offset.
+    std::vector<std::uint64_t> const wide = {0, 1, 1ull << 63, ~0ull};
+    std::compressed_flat_map<std::uint64_t, int> const wide_map(
+        std::sorted_unique, wide, std::vector<int>{0, 1, 2, 3});
+    for (std::uint64_t k : wide) {
+        check_against(wide_map, wide, k);
+    }
+    check_against(wide_map, wide, std::uint64_t(2));
+
+    std::vector<short> signed_keys;
+    for (int k = -30000; k < 30000; k += 7) {
+        signed_keys.push_back(short(k));
+    }
+    std::vector<double> values(signed_keys.size(), 1.0);
+    std::compressed_flat_map<short, double> const signed_map(
+        std::sorted_unique, signed_keys, values);
+    EXPECT_EQ(signed_map.key_at(0), -30000);
+    EXPECT_TRUE(signed_map.contains(short(-30000 + 7 * 100)));
+    EXPECT_FALSE(signed_map.contains(short(-30000 + 7 * 100 + 1)));
+    EXPECT_EQ(signed_map.lower_bound(-1)->first, short(2));
+
+    std::flat_map<int, int> source;
+    for (int k = 0; k < 1000; ++k) {
+        source.emplace(k * 3 - 1500, k);
+    }
+    std::compressed_flat_map<int, int> const from_map(source);
+    EXPECT_EQ(from_map.size(), source.size());
+    EXPECT_EQ(from_map.at(-1500), 0);
+    EXPECT_EQ(from_map.at(1497), 999);
+
+    EXPECT_THROW(
+        (std::compressed_flat_map<int, int>(
+            std::sorted_unique, std::vector<int>{1, 2}, std::vector<int>{1})),
+        std::invalid_argument);
+}
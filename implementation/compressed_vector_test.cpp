@@ -0,0 +1,187 @@
+#include "compressed_vector"
+#include "compressed_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+
+// Test instantiations.
+template class std::__block_compressed_vector<double, std::__xor_codec<double>>;
+template class std::__block_compressed_vector<float, std::__xor_codec<float>>;
+template class std::
+    __block_compressed_vector<std::int8_t, std::__delta_codec<std::int8_t>>;
+template class std::compressed_flat_map<
+    std::int64_t,
+    double,
+    std::xor_compressed_vector<double>>;
+
+namespace {
+    template<typename T>
+    bool same_bits(T x, T y)
+    {
+        return std::memcmp(&x, &y, sizeof(T)) == 0;
+    }
+
+    template<typename Vector, typename T>
+    void check_round_trip(std::vector<T> const & values)
+    {
+        Vector const v(values.begin(), values.end());
+        ASSERT_EQ(v.size(), values.size());
+        std::size_t i = 0;
+        for (T x : v) {
+            ASSERT_TRUE(same_bits(x, values[i])) << i;
+            ++i;
+        }
+        std::mt19937 gen(3);
+        for (int n = 0; n < 1000 && !values.empty(); ++n) {
+            std::size_t const j = gen() % values.size();
+            ASSERT_TRUE(same_bits(v[j], values[j])) << j;
+            std::size_t const k = gen() % values.size();
+            auto const it = v.begin() + j;
+            ASSERT_TRUE(same_bits(
+                it[std::ptrdiff_t(k) - std::ptrdiff_t(j)], values[k]))
+                << k;
+        }
+        // == compares values, and NaNs compare unequal.
+        if (std::equal(values.begin(), values.end(), values.begin())) {
+            EXPECT_EQ(v, Vector(values.begin(), values.end()));
+        }
+    }
+}
+
+TEST(compressed_vector, xor_round_trip)
+{
+    using vec_t = std::xor_compressed_vector<double>;
+    check_round_trip<vec_t>(std::vector<double>{});
+    check_round_trip<vec_t>(std::vector<double>{1.5});
+
+    double const inf = std::numeric_limits<double>::infinity();
+    check_round_trip<vec_t>(std::vector<double>{
+        0.0,
+        -0.0,
+        inf,
+        -inf,
+        std::numeric_limits<double>::quiet_NaN(),
+        std::numeric_limits<double>::denorm_min(),
+        std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::lowest(),
+        1.0,
+        1.0,
+        3.0});
+
+    std::mt19937_64 gen(7);
+    std::vector<double> random(1000);
+    for (double & x : random) {
+        std::uint64_t const bits = gen();
+        std::memcpy(&x, &bits, sizeof(x));
+    }
+    check_round_trip<vec_t>(random);
+
+    std::vector<float> floats;
+    float f = 20.0f;
+    for (int i = 0; i < 1000; ++i) {
+        floats.push_back(f);
+        f += float(int(gen() % 3) - 1) * 0.125f;
+    }
+    check_round_trip<std::xor_compressed_vector<float>>(floats);
+}
+
+TEST(compressed_vector, delta_round_trip)
+{
+    std::mt19937_64 gen(11);
+    std::vector<std::int64_t> extremes;
+    for (int i = 0; i < 300; ++i) {
+        extremes.push_back(
+            i % 3 == 0 ? std::numeric_limits<std::int64_t>::min()
+                       : i % 3 == 1 ? std::numeric_limits<std::int64_t>::max()
+                                    : std::int64_t(gen()));
+    }
+    check_round_trip<std::delta_compressed_vector<std::int64_t>>(extremes);
+
+    std::vector<std::int8_t> small;
+    for (int i = 0; i < 300; ++i) {
+        small.push_back(std::int8_t(i * 7));
+    }
+    check_round_trip<std::delta_compressed_vector<std::int8_t>>(small);
+
+    std::vector<std::uint32_t> counters;
+    std::uint32_t c = 0xfffff000u;
+    for (int i = 0; i < 1000; ++i) {
+        counters.push_back(c);
+        c += 100 + std::uint32_t(gen() % 3);
+    }
+    check_round_trip<std::delta_compressed_vector<std::uint32_t>>(counters);
+}
+
+TEST(compressed_vector, compression)
+{
+    // A gauge that holds each reading for a while, and a counter at a
+    // steady rate.
+    std::mt19937_64 gen(5);
+    std::vector<double> gauge;
+    std::vector<std::uint64_t> counter;
+    double reading = 20.5;
+    for (int i = 0; i < 100000; ++i) {
+        if (i % 8 == 0)
+            reading += double(int(gen() % 5) - 2) * 0.25;
+        gauge.push_back(reading);
+        counter.push_back(std::uint64_t(i) * 60);
+    }
+    std::xor_compressed_vector<double> const g(gauge.begin(), gauge.end());
+    std::delta_compressed_vector<std::uint64_t> const n(
+        counter.begin(), counter.end());
+    EXPECT_LT(g.bytes() * 5, gauge.size() * sizeof(double));
+    EXPECT_LT(n.bytes() * 20, counter.size() * sizeof(std::uint64_t));
+    EXPECT_EQ(g[99999], gauge[99999]);
+    EXPECT_EQ(n.back(), counter.back());
+    EXPECT_THROW(n.at(100000), std::out_of_range);
+}
+
+TEST(compressed_vector, compressed_flat_map_values)
+{
+    // A time series sampled every second, with some jitter.
+    std::mt19937_64 gen(13);
+    std::vector<std::int64_t> times;
+    std::vector<double> readings;
+    std::int64_t t = 1600000000000;
+    double reading = 100.0;
+    for (int i = 0; i < 50000; ++i) {
+        times.push_back(t);
+        readings.push_back(reading);
+        t += 1000 + std::int64_t(gen() % 3);
+        if (i % 10 == 0)
+            reading += 0.5;
+    }
+
+    using map_t = std::compressed_flat_map<
+        std::int64_t,
+        double,
+        std::xor_compressed_vector<double>>;
+    map_t const map(
+        std::sorted_unique,
+        times,
+        std::xor_compressed_vector<double>(readings.begin(), readings.end()));
+    ASSERT_EQ(map.size(), times.size());
+    EXPECT_LT(
+        (map.key_bytes() + map.values().bytes()) * 5,
+        times.size() * (sizeof(std::int64_t) + sizeof(double)));
+
+    std::size_t i = 0;
+    for (auto const & x : map) {
+        ASSERT_EQ(x.first, times[i]);
+        ASSERT_EQ(x.second, readings[i]);
+        ++i;
+    }
+    for (int n = 0; n < 1000; ++n) {
+        std::size_t const j = 1 + gen() % (times.size() - 1);
+        ASSERT_EQ(map.at(times[j]), readings[j]);
+        auto const it = map.find(times[j]);
+        ASSERT_EQ(it->second, readings[j]);
+        ASSERT_EQ(std::prev(it)->second, readings[j - 1]);
+    }
+    EXPECT_EQ(map.find(times[0] + 1), map.end());
+}
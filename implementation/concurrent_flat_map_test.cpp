@@ -0,0 +1,188 @@
+#include "concurrent_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Test instantiations.
+template class std::concurrent_flat_map<std::flat_map<std::string, int>>;
+
+TEST(std_concurrent_flat_map, batched_writes)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    std::concurrent_flat_map<fmap_t> map(fmap_t{{1, 10}, {3, 30}, {5, 50}});
+    auto const before = map.read();
+
+    map.insert_or_assign(2, 20);
+    map.insert_or_assign(3, 31);
+    map.erase(5);
+    map.insert_or_assign(5, 51);
+    map.erase(1);
+    map.insert_or_assign(7, 70);
+    map.erase(7);
+    map.erase(8);
+    EXPECT_EQ(map.size(), 3u);
+    map.publish();
+
+    fmap_t const expected = {{2, 20}, {3, 31}, {5, 51}};
+    EXPECT_EQ(*map.read(), expected);
+    EXPECT_EQ(map.find(3), std::optional<int>(31));
+    EXPECT_EQ(map.find(1), std::nullopt);
+    EXPECT_TRUE(map.contains(2));
+
+    // Pinned versions are unchanged and outlive the publish.
+    fmap_t const original = {{1, 10}, {3, 30}, {5, 50}};
+    EXPECT_EQ(*before, original);
+
+    map.update([](fmap_t & m) { m.erase(2); });
+    fmap_t const updated = {{3, 31}, {5, 51}};
+    EXPECT_EQ(*map.read(), updated);
+    auto const size_of = [](fmap_t const & m) { return m.size(); };
+    EXPECT_EQ(map.visit(size_of), 2u);
+}
+
+TEST(std_concurrent_flat_map, many_snapshots)
+{
+    using fmap_t = std::flat_map<int, int>;
+    using cmap_t = std::concurrent_flat_map<fmap_t>;
+
+    // More live snapshots than the map has hazard slots of its own.
+    cmap_t map(fmap_t{{1, 10}});
+    std::vector<cmap_t::snapshot> snapshots;
+    for (int i = 0; i < 300; ++i) {
+        snapshots.push_back(map.read());
+    }
+    map.insert_or_assign(2, 20);
+    map.publish();
+    fmap_t const original = {{1, 10}};
+    for (auto const & s : snapshots) {
+        EXPECT_EQ(*s, original);
+    }
+    EXPECT_EQ(map.size(), 2u);
+
+    // Released overflow slots are reused.
+    snapshots.clear();
+    for (int i = 0; i < 300; ++i) {
+        snapshots.push_back(map.read());
+    }
+    EXPECT_EQ(snapshots.back()->size(), 2u);
+}
+
+TEST(std_concurrent_flat_map, readers_and_writer)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    // Every version maps each of its keys k to k * version, and holds the
+    // keys [0, version).
+    std::concurrent_flat_map<fmap_t> map;
+    std::atomic<bool> done(false);
+    std::atomic<int> bad(0);
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                auto const s = map.read();
+                int const version = int(s->size());
+                for (auto const & x : *s) {
+                    if (x.second != x.first * version)
+                        ++bad;
+                }
+            }
+        });
+    }
+
+    for (int version = 1; version <= 200; ++version) {
+        map.update([&](fmap_t & m) {
+            for (auto x : m) {
+                x.second = x.first * version;
+            }
+            m.emplace(version - 1, (version - 1) * version);
+        });
+    }
+    done = true;
+    for (auto & reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(bad.load(), 0);
+    EXPECT_EQ(map.size(), 200u);
+    map.reclaim();
+}
+
+TEST(std_concurrent_flat_map, insert_or_assign_async)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    // Runs the merge inline.
+    {
+        std::concurrent_flat_map<fmap_t> map(fmap_t{{1, 10}, {3, 30}});
+        std::vector<std::pair<int, int>> const delta = {
+            {4, 40}, {3, 31}, {0, 0}, {4, 41}};
+        auto done = map.insert_or_assign_async(
+            [](auto task) { task(); }, delta.begin(), delta.end());
+        done.get();
+        fmap_t const expected = {{0, 0}, {1, 10}, {3, 31}, {4, 41}};
+        EXPECT_EQ(*map.read(), expected);
+    }
+
+    // Holds the merge until a version has been published in between, so
+    // that the merge is redone against it.
+    {
+        std::concurrent_flat_map<fmap_t> map(fmap_t{{1, 10}});
+        std::function<void()> held;
+        std::vector<std::pair<int, int>> const delta = {{2, 20}, {5, 50}};
+        auto done = map.insert_or_assign_async(
+            [&](std::function<void()> task) { held = std::move(task); },
+            delta.begin(),
+            delta.end());
+        map.insert_or_assign(5, 0);
+        map.insert_or_assign(7, 70);
+        map.publish();
+        held();
+        done.get();
+        fmap_t const expected = {{1, 10}, {2, 20}, {5, 50}, {7, 70}};
+        EXPECT_EQ(*map.read(), expected);
+    }
+
+    // Merges a large batch on another thread while readers keep reading.
+    {
+        fmap_t initial;
+        for (int i = 0; i < 100000; i += 2) {
+            initial.emplace(i, i);
+        }
+        std::concurrent_flat_map<fmap_t> map(std::move(initial));
+        std::vector<std::pair<int, int>> delta;
+        for (int i = 1; i < 100000; i += 2) {
+            delta.emplace_back(i, i);
+        }
+
+        std::atomic<bool> done_reading(false);
+        std::atomic<int> bad(0);
+        std::thread reader([&] {
+            while (!done_reading.load()) {
+                auto const s = map.read();
+                if (s->size() != 50000u && s->size() != 100000u)
+                    ++bad;
+                if (s->find(4) == s->end() || s->find(4)->second != 4)
+                    ++bad;
+            }
+        });
+        auto done = map.insert_or_assign_async(
+            [](auto task) { std::thread(std::move(task)).detach(); },
+            delta.begin(),
+            delta.end());
+        done.get();
+        done_reading = true;
+        reader.join();
+
+        EXPECT_EQ(bad.load(), 0);
+        EXPECT_EQ(map.size(), 100000u);
+        EXPECT_EQ(map.find(99999), std::optional<int>(99999));
+        map.reclaim();
+    }
+}
@@ -0,0 +1,265 @@
+#include "concurrent_segmented_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <random>
+#include <thread>
+
+// Test instantiations.
+template class std::concurrent_segmented_flat_map<int, double>;
+template class std::
+    concurrent_segmented_flat_map<long, int, std::greater<long>, 16>;
+
+TEST(std_concurrent_segmented_flat_map, against_std_map)
+{
+    std::concurrent_segmented_flat_map<int, int, std::less<int>, 8> map;
+    std::map<int, int> expected;
+    std::mt19937 gen(5);
+    for (int i = 0; i < 5000; ++i) {
+        int const k = int(gen() % 300);
+        switch (gen() % 4) {
+        case 0:
+            EXPECT_EQ(map.try_emplace(k, i), expected.emplace(k, i).second);
+            break;
+        case 1: {
+            bool const inserted = !expected.count(k);
+            expected[k] = i;
+            EXPECT_EQ(map.insert_or_assign(k, i), inserted);
+            break;
+        }
+        case 2: EXPECT_EQ(map.erase(k), expected.erase(k)); break;
+        case 3: {
+            auto const it = expected.find(k);
+            if (it == expected.end()) {
+                EXPECT_EQ(map.find(k), std::nullopt);
+                EXPECT_FALSE(map.contains(k));
+            } else {
+                EXPECT_EQ(map.find(k), it->second);
+                EXPECT_TRUE(map.contains(k));
+            }
+            break;
+        }
+        }
+        ASSERT_EQ(map.size(), expected.size());
+    }
+    EXPECT_LT(1u, map.block_count());
+
+    auto const snapshot = map.snapshot();
+    EXPECT_TRUE(std::equal(
+        snapshot.begin(),
+        snapshot.end(),
+        expected.begin(),
+        expected.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second == y.second;
+        }));
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(0), std::nullopt);
+    EXPECT_TRUE(map.try_emplace(0, 1));
+    EXPECT_EQ(map.find(0), 1);
+}
+
+TEST(std_concurrent_segmented_flat_map, from_flat_map)
+{
+    std::flat_map<long, int, std::greater<long>> m;
+    for (long i = 0; i < 100; ++i) {
+        m.emplace(i, int(i));
+    }
+    std::concurrent_segmented_flat_map<long, int, std::greater<long>, 16> map(
+        m);
+    // Blocks start three quarters full.
+    EXPECT_EQ(map.block_count(), 9u);
+    EXPECT_EQ(map.size(), 100u);
+    EXPECT_EQ(map.snapshot(), m);
+    for (long i = 0; i < 100; ++i) {
+        EXPECT_EQ(map.find(i), int(i));
+    }
+    EXPECT_FALSE(map.contains(100));
+    EXPECT_FALSE(map.contains(-1));
+
+    std::concurrent_segmented_flat_map<long, int, std::greater<long>, 16>
+        empty_map((std::flat_map<long, int, std::greater<long>>()));
+    EXPECT_TRUE(empty_map.empty());
+    EXPECT_EQ(empty_map.block_count(), 1u);
+}
+
+TEST(std_concurrent_segmented_flat_map, concurrent_writers)
+{
+    // Each writer owns the keys congruent to its number, so all of them
+    // write to every block, and split blocks under each other.
+    std::concurrent_segmented_flat_map<int, int, std::less<int>, 32> map;
+    constexpr int writers = 8;
+    constexpr int per_writer = 4000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < writers; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937 gen(t);
+            std::vector<int> keys;
+            for (int i = 0; i < per_writer; ++i) {
+                keys.push_back(i * writers + t);
+            }
+            std::shuffle(keys.begin(), keys.end(), gen);
+            for (int k : keys) {
+                map.try_emplace(k, -k);
+            }
+            for (int k : keys) {
+                if (k % 3 == 0)
+                    map.erase(k);
+                else
+                    map.insert_or_assign(k, k);
+            }
+        });
+    }
+    for (auto & t : threads) {
+        t.join();
+    }
+
+    std::flat_map<int, int> expected;
+    for (int k = 0; k < writers * per_writer; ++k) {
+        if (k % 3)
+            expected.emplace(k, k);
+    }
+    EXPECT_EQ(map.size(), expected.size());
+    EXPECT_EQ(map.snapshot(), expected);
+}
+
+namespace {
+    // Stalls stall_thread at its first comparison involving stall_key once
+    // split() is true, until released or for at most 200 ms.
+    struct stalling_less
+    {
+        bool operator()(int x, int y) const
+        {
+            if ((x == stall_key || y == stall_key) &&
+                std::this_thread::get_id() == stall_thread && !stalled &&
+                split()) {
+                stalled = true;
+                for (int i = 0; i < 200 && !released; ++i) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+            return x < y;
+        }
+
+        static int stall_key;
+        static std::thread::id stall_thread;
+        static std::function<bool()> split;
+        static std::atomic<bool> stalled;
+        static std::atomic<bool> released;
+    };
+    int stalling_less::stall_key = 0;
+    std::thread::id stalling_less::stall_thread;
+    std::function<bool()> stalling_less::split;
+    std::atomic<bool> stalling_less::stalled{false};
+    std::atomic<bool> stalling_less::released{false};
+}
+
+TEST(std_concurrent_segmented_flat_map, split_under_other_writers)
+{
+    // One writer splits the full block and stalls before it inserts into
+    // the new upper block; another writer, routed there by the index,
+    // must wait for that insertion rather than write alongside it.
+    std::concurrent_segmented_flat_map<int, int, stalling_less, 4> map;
+    for (int k : {10, 20, 30, 40}) {
+        map.try_emplace(k, k);
+    }
+    stalling_less::stall_key = 100;
+    stalling_less::split = [&] { return map.block_count() == 2; };
+
+    std::thread splitter([&] {
+        stalling_less::stall_thread = std::this_thread::get_id();
+        map.try_emplace(100, 100);
+    });
+    std::thread other([&] {
+        while (!stalling_less::stalled) {
+            std::this_thread::yield();
+        }
+        for (int k : {41, 42, 43, 44}) {
+            map.insert_or_assign(k, k);
+        }
+        stalling_less::released = true;
+    });
+    splitter.join();
+    other.join();
+    stalling_less::split = nullptr;
+
+    EXPECT_TRUE(stalling_less::stalled);
+    std::flat_map<int, int, stalling_less> expected;
+    for (int k : {10, 20, 30, 40, 41, 42, 43, 44, 100}) {
+        expected.emplace(k, k);
+    }
+    EXPECT_EQ(map.snapshot(), expected);
+    for (auto const & x : expected) {
+        EXPECT_EQ(map.find(x.first), x.second);
+    }
+}
+
+TEST(std_concurrent_segmented_flat_map, concurrent_readers)
+{
+    // Each value holds its key, so a read that mixes two writes shows up
+    // as a value for the wrong key.  The even keys are never erased, so a
+    // reader must always find them, even while their blocks split.
+    struct value
+    {
+        int key;
+        int generation;
+    };
+    std::concurrent_segmented_flat_map<int, value, std::less<int>, 16> map;
+    constexpr int keys = 4000;
+    for (int k = 0; k < keys; k += 2) {
+        map.try_emplace(k, value{k, 0});
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<bool> mismatch{false};
+    std::atomic<bool> missing{false};
+    std::atomic<long> hits{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&, t] {
+            std::mt19937 gen(t);
+            long n = 0;
+            while (!done) {
+                int const k = int(gen() % keys);
+                if (auto const v = map.find(k)) {
+                    ++n;
+                    if (v->key != k)
+                        mismatch = true;
+                } else if (k % 2 == 0) {
+                    missing = true;
+                }
+            }
+            hits += n;
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; ++t) {
+        writers.emplace_back([&, t] {
+            std::mt19937 gen(100 + t);
+            for (int i = 0; i < 50000; ++i) {
+                int const k = int(gen() % keys);
+                if (k % 2 == 0 || gen() % 3)
+                    map.insert_or_assign(k, value{k, i});
+                else
+                    map.erase(k);
+            }
+        });
+    }
+    for (auto & w : writers) {
+        w.join();
+    }
+    done = true;
+    for (auto & r : readers) {
+        r.join();
+    }
+    EXPECT_FALSE(mismatch);
+    EXPECT_FALSE(missing);
+    EXPECT_GT(hits, 0);
+}
@@ -0,0 +1,97 @@
+#include "cow_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+// Test instantiations.
+template class std::cow_flat_map<std::flat_map<std::string, int>>;
+
+TEST(std_cow_flat_map, copies_share_until_changed)
+{
+    using fmap_t = std::flat_map<int, std::string>;
+    using cow_t = std::cow_flat_map<fmap_t>;
+
+    cow_t map = {{1, "a"}, {2, "b"}, {3, "c"}};
+    EXPECT_TRUE(map.unique());
+    cow_t const snap = map.snapshot();
+    EXPECT_FALSE(map.unique());
+    EXPECT_EQ(&snap.map(), &map.map());
+
+    // Reading through const overloads does not clone.
+    cow_t const & cmap = map;
+    EXPECT_EQ(cmap.at(2), "b");
+    EXPECT_NE(cmap.find(3), cmap.end());
+    EXPECT_EQ(map.count(4), 0u);
+    EXPECT_EQ(map.erase(4), 0u);
+    EXPECT_EQ(&snap.map(), &map.map());
+
+    map[4] = "d";
+    EXPECT_TRUE(map.unique());
+    EXPECT_TRUE(snap.unique());
+    EXPECT_NE(&snap.map(), &map.map());
+    EXPECT_EQ(map.size(), 4u);
+    EXPECT_EQ(snap.size(), 3u);
+    EXPECT_FALSE(snap.contains(4));
+
+    // An iterator taken before unsharing still erases the right element.
+    cow_t copy = map;
+    auto const it = cmap.find(2);
+    copy = map;
+    map.erase(it);
+    EXPECT_FALSE(map.contains(2));
+    EXPECT_TRUE(copy.contains(2));
+    auto const hint = cmap.find(3);
+    copy = map;
+    map.emplace_hint(hint, 5, "e");
+    EXPECT_TRUE(map.contains(5));
+    EXPECT_FALSE(copy.contains(5));
+
+    cow_t other = map;
+    other.clear();
+    EXPECT_TRUE(other.empty());
+    EXPECT_EQ(map.size(), 4u);
+    other.replace({7}, {"g"});
+    EXPECT_EQ(other.at(7), "g");
+
+    fmap_t const expected = {{1, "a"}, {3, "c"}, {4, "d"}, {5, "e"}};
+    EXPECT_EQ(map.map(), expected);
+    cow_t const moved = std::move(map);
+    EXPECT_EQ(map, moved);
+    EXPECT_EQ(std::move(map).release(), expected);
+    EXPECT_EQ(moved.map(), expected);
+}
+
+TEST(std_cow_flat_map, snapshots_across_threads)
+{
+    using cow_t = std::cow_flat_map<std::flat_map<int, int>>;
+
+    cow_t map;
+    std::vector<cow_t> snapshots;
+    for (int i = 0; i < 100; ++i) {
+        map[i] = i;
+        snapshots.push_back(map.snapshot());
+    }
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&snapshots, t] {
+            for (std::size_t i = t; i < snapshots.size(); i += 4) {
+                cow_t snap = std::move(snapshots[i]);
+                EXPECT_EQ(snap.size(), i + 1);
+                snap[-1] = 0;
+                EXPECT_EQ(snap.size(), i + 2);
+            }
+        });
+    }
+    for (int i = 0; i < 1000; ++i) {
+        map[i % 200] += 1;
+    }
+    for (auto & t : readers) {
+        t.join();
+    }
+    EXPECT_EQ(map.size(), 200u);
+    EXPECT_EQ(map.at(0), 5);
+    EXPECT_EQ(map.at(150), 5);
+}
@@ -0,0 +1,239 @@
+#include "deamortized_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Test instantiations.
+template class std::deamortized_flat_map<std::string, int>;
+template class std::__deamortized_vector<std::string>;
+
+namespace {
+    template<class Map, class StdMap>
+    bool same_elements(Map const & map, StdMap const & std_map)
+    {
+        return map.size() == std_map.size() &&
+               std::equal(
+                   map.begin(),
+                   map.end(),
+                   std_map.begin(),
+                   std_map.end(),
+                   [](auto const & x, auto const & y) {
+                       return x.first == y.first && x.second == y.second;
+                   });
+    }
+
+    template<class Map>
+    bool blocks_valid(Map const & map)
+    {
+        for (std::size_t i = 0; i < map.block_count(); ++i) {
+            auto const & block = map.block(i);
+            if (block.empty() || Map::block_size < block.size())
+                return false;
+            if (i &&
+                !(map.block(i - 1).rbegin()->first < block.begin()->first)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Counts the moves and copies of all its objects.
+    long moves = 0;
+    struct counted
+    {
+        counted(int v = 0) : value(v) {}
+        counted(counted const & other) : value(other.value) { ++moves; }
+        counted(counted && other) noexcept : value(other.value) { ++moves; }
+        counted & operator=(counted const & other)
+        {
+            value = other.value;
+            ++moves;
+            return *this;
+        }
+        counted & operator=(counted && other) noexcept
+        {
+            value = other.value;
+            ++moves;
+            return *this;
+        }
+        int value;
+    };
+}
+
+TEST(std_deamortized_flat_map, deamortized_vector)
+{
+    std::__deamortized_vector<std::string> vec;
+    std::vector<std::string> expected;
+    std::mt19937 gen(7);
+    bool transitioned = false;
+    for (int i = 0; i < 5000; ++i) {
+        if (gen() % 3 || expected.empty()) {
+            std::size_t const p = gen() % (expected.size() + 1);
+            std::string s = "element number " + std::to_string(i);
+            expected.insert(expected.begin() + p, s);
+            vec.insert(p, std::move(s));
+        } else {
+            std::size_t const p = gen() % expected.size();
+            expected.erase(expected.begin() + p);
+            vec.erase(p);
+        }
+        transitioned = transitioned || vec.in_transition();
+        ASSERT_EQ(vec.size(), expected.size());
+        if (i % 97 == 0) {
+            for (std::size_t j = 0; j < expected.size(); ++j) {
+                ASSERT_EQ(vec[j], expected[j]);
+            }
+        }
+    }
+    EXPECT_TRUE(transitioned);
+    for (std::size_t j = 0; j < expected.size(); ++j) {
+        ASSERT_EQ(vec[j], expected[j]);
+    }
+
+    std::__deamortized_vector<std::string> moved(std::move(vec));
+    EXPECT_TRUE(vec.empty());
+    EXPECT_EQ(moved.size(), expected.size());
+    moved.migrate(moved.size());
+    EXPECT_FALSE(moved.in_transition());
+    moved.clear();
+    EXPECT_TRUE(moved.empty());
+}
+
+TEST(std_deamortized_flat_map, random_operations)
+{
+    using dmap_t = std::deamortized_flat_map<int, int, std::less<int>, 8>;
+
+    dmap_t map;
+    std::map<int, int> std_map;
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<int> key(0, 999);
+    for (int i = 0; i < 10000; ++i) {
+        int const k = key(gen);
+        switch (gen() % 4) {
+        case 0:
+        case 1: {
+            auto const result = map.try_emplace(k, i);
+            EXPECT_EQ(result.second, std_map.try_emplace(k, i).second);
+            EXPECT_EQ(result.first->first, k);
+            break;
+        }
+        case 2:
+            EXPECT_EQ(map.erase(k), std_map.erase(k));
+            break;
+        case 3: {
+            auto const it = map.lower_bound(k);
+            auto const std_it = std_map.lower_bound(k);
+            if (std_it == std_map.end()) {
+                EXPECT_EQ(it, map.end());
+            } else {
+                EXPECT_EQ(it->first, std_it->first);
+                it->second = -i;
+                std_it->second = -i;
+            }
+            break;
+        }
+        }
+    }
+    EXPECT_TRUE(same_elements(map, std_map));
+    EXPECT_TRUE(blocks_valid(map));
+    EXPECT_LT(1u, map.block_count());
+
+    for (int k = -1; k < 1001; ++k) {
+        EXPECT_EQ(map.contains(k), std_map.count(k) == 1);
+        auto const upper = map.upper_bound(k);
+        auto const std_upper = std_map.upper_bound(k);
+        EXPECT_EQ(upper == map.end(), std_upper == std_map.end());
+        if (std_upper != std_map.end()) {
+            EXPECT_EQ(upper->first, std_upper->first);
+        }
+    }
+    EXPECT_TRUE(std::equal(
+        map.rbegin(),
+        map.rend(),
+        std_map.rbegin(),
+        std_map.rend(),
+        [](auto const & x, auto const & y) { return x.first == y.first; }));
+
+    // Erasing by iterator walks the whole map.
+    for (auto it = map.begin(); it != map.end();) {
+        it = map.erase(it);
+    }
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.block_count(), 0u);
+}
+
+TEST(std_deamortized_flat_map, bounded_work)
+{
+    // No insertion moves more than a block's worth of values, however large
+    // the map grows, while a flat_map reallocates and moves them all.
+    constexpr std::size_t block = 64;
+    std::deamortized_flat_map<int, counted, std::less<int>, block> map;
+    std::flat_map<int, counted> flat;
+    std::mt19937 gen(3);
+    long max_moves = 0;
+    long max_flat_moves = 0;
+    bool transitioned = false;
+    for (int i = 0; i < 20000; ++i) {
+        int const k = int(gen() % 1000000);
+        moves = 0;
+        map.try_emplace(k, i);
+        max_moves = (std::max)(max_moves, moves);
+        moves = 0;
+        flat.try_emplace(k, i);
+        max_flat_moves = (std::max)(max_flat_moves, moves);
+        transitioned = transitioned || map.directory_in_transition();
+        if (map.directory_in_transition()) {
+            ASSERT_TRUE(map.contains(k));
+        }
+    }
+    EXPECT_TRUE(transitioned);
+    EXPECT_LE(max_moves, long(2 * block + 2));
+    EXPECT_LT(long(10000), max_flat_moves);
+    EXPECT_TRUE(blocks_valid(map));
+    EXPECT_EQ(map.size(), flat.size());
+    EXPECT_TRUE(std::equal(
+        map.begin(),
+        map.end(),
+        flat.begin(),
+        flat.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second.value == y.second.value;
+        }));
+
+    std::vector<int> keys(flat.keys().begin(), flat.keys().end());
+    std::shuffle(keys.begin(), keys.end(), gen);
+    max_moves = 0;
+    for (std::size_t i = 0; i < keys.size() / 2; ++i) {
+        moves = 0;
+        EXPECT_EQ(map.erase(keys[i]), 1u);
+        max_moves = (std::max)(max_moves, moves);
+    }
+    EXPECT_LE(max_moves, long(2 * block + 2));
+    EXPECT_TRUE(blocks_valid(map));
+}
+
+TEST(std_deamortized_flat_map, construction)
+{
+    using dmap_t = std::deamortized_flat_map<std::string, int>;
+    dmap_t const map = {{"b", 2}, {"a", 1}, {"c", 3}, {"a", 4}};
+    EXPECT_EQ(map.size(), 3u);
+    EXPECT_EQ(map.at("a"), 1);
+    EXPECT_EQ(map.begin()->first, "a");
+    EXPECT_THROW(map.at("d"), std::out_of_range);
+
+    dmap_t copy(std::flat_map<std::string, int>{{"a", 1}, {"b", 2}, {"c", 3}});
+    EXPECT_EQ(copy, map);
+    copy.insert_or_assign("a", 10);
+    copy["d"] = 4;
+    EXPECT_NE(copy, map);
+    EXPECT_EQ(copy.at("a"), 10);
+    EXPECT_EQ(copy.size(), 4u);
+    copy.clear();
+    EXPECT_TRUE(copy.empty());
+    EXPECT_EQ(copy.find("a"), copy.end());
+}
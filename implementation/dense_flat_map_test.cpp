@@ -0,0 +1,173 @@
+#include "dense_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+
+// Test instantiations.
+template class std::dense_flat_map<int, std::string>;
+template class std::dense_flat_map<std::uint8_t, int>;
+
+namespace {
+    template<typename Dense, typename Map>
+    bool same_elements(Dense const & dense, Map const & map)
+    {
+        return dense.size() == map.size() &&
+               std::equal(
+                   dense.begin(),
+                   dense.end(),
+                   map.begin(),
+                   map.end(),
+                   [](auto lhs, auto const & rhs) {
+                       return lhs.first == rhs.first &&
+                              lhs.second == rhs.second;
+                   });
+    }
+}
+
+TEST(std_dense_flat_map, against_std_map)
+{
+    using dense_t = std::dense_flat_map<int, std::string>;
+
+    dense_t dense;
+    std::map<int, std::string> map;
+    std::mt19937 gen(11);
+    for (int i = 0; i < 20000; ++i) {
+        // The keys come from a range that widens to [-500, 500], so the
+        // map's range grows both ways.
+        int const k = int(gen() % (2 * (i / 40 + 1) + 1)) - (i / 40 + 1);
+        switch (gen() % 5) {
+        case 0:
+        case 1: {
+            auto const dense_result = dense.try_emplace(k, std::to_string(i));
+            auto const map_result = map.try_emplace(k, std::to_string(i));
+            ASSERT_EQ(dense_result.second, map_result.second);
+            ASSERT_EQ(dense_result.first->first, k);
+            ASSERT_EQ(dense_result.first->second, map_result.first->second);
+            break;
+        }
+        case 2:
+            ASSERT_EQ(dense.erase(k), map.erase(k));
+            break;
+        case 3: {
+            auto const it = dense.lower_bound(k);
+            auto const map_it = map.lower_bound(k);
+            ASSERT_EQ(it == dense.end(), map_it == map.end());
+            if (map_it != map.end()) {
+                ASSERT_EQ(it->first, map_it->first);
+            }
+            auto const up = dense.upper_bound(k);
+            auto const map_up = map.upper_bound(k);
+            ASSERT_EQ(up == dense.end(), map_up == map.end());
+            if (map_up != map.end()) {
+                ASSERT_EQ(up->first, map_up->first);
+            }
+            break;
+        }
+        default:
+            ASSERT_EQ(dense.contains(k), map.count(k) == 1u);
+            if (map.count(k)) {
+                ASSERT_EQ(dense.at(k), map.at(k));
+                ASSERT_EQ(dense.find(k)->second, map.at(k));
+            } else {
+                ASSERT_EQ(dense.find(k), dense.end());
+                ASSERT_THROW(dense.at(k), std::out_of_range);
+            }
+            break;
+        }
+    }
+    EXPECT_TRUE(same_elements(dense, map));
+    EXPECT_LE(dense.key_span(), 2u * 1001u);
+
+    // Iterating backward visits the same elements in reverse.
+    std::vector<int> backward;
+    for (auto it = dense.end(); it != dense.begin();) {
+        --it;
+        backward.push_back(it->first);
+    }
+    std::vector<int> forward;
+    for (auto const & x : map) {
+        forward.push_back(x.first);
+    }
+    EXPECT_TRUE(std::equal(
+        backward.rbegin(), backward.rend(), forward.begin(), forward.end()));
+
+    auto it = dense.begin();
+    auto const second = std::next(map.begin());
+    it = dense.erase(it);
+    EXPECT_EQ(it->first, second->first);
+    map.erase(map.begin());
+
+    dense_t const copy = dense;
+    EXPECT_EQ(copy, dense);
+    dense[10000] = "far";
+    EXPECT_NE(copy, dense);
+    EXPECT_EQ(std::prev(dense.end())->first, 10000);
+
+    dense.clear();
+    EXPECT_TRUE(dense.empty());
+    EXPECT_EQ(dense.begin(), dense.end());
+}
+
+TEST(std_dense_flat_map, build_and_bounds)
+{
+    std::flat_map<int, int> fm;
+    for (int i = 0; i < 100; ++i) {
+        fm.emplace(1000 + i * 3, i);
+    }
+    using dense_t = std::dense_flat_map<int, int>;
+    EXPECT_TRUE(dense_t::dense_enough(fm.keys().begin(), fm.keys().end()));
+    EXPECT_FALSE(
+        dense_t::dense_enough(fm.keys().begin(), fm.keys().end(), 2));
+
+    dense_t const dense(fm);
+    EXPECT_EQ(dense.min_key(), 1000);
+    EXPECT_EQ(dense.key_span(), 298u);
+    EXPECT_TRUE(same_elements(dense, fm));
+    EXPECT_EQ(dense.lower_bound(0), dense.begin());
+    EXPECT_EQ(dense.lower_bound(1001)->first, 1003);
+    EXPECT_EQ(dense.upper_bound(1003)->first, 1006);
+    EXPECT_EQ(dense.lower_bound(5000), dense.end());
+    auto const range = dense.equal_range(1003);
+    EXPECT_EQ(std::distance(range.first, range.second), 1);
+
+    dense_t const from_pairs(fm.begin(), fm.end());
+    EXPECT_EQ(from_pairs, dense);
+
+    dense_t reserved(-5, 5);
+    EXPECT_EQ(reserved.key_span(), 11u);
+    EXPECT_TRUE(reserved.empty());
+    reserved.insert({{-5, 1}, {5, 2}, {0, 3}});
+    EXPECT_EQ(reserved.key_span(), 11u);
+    EXPECT_EQ(reserved.begin()->first, -5);
+    EXPECT_THROW(dense_t(5, -5), std::invalid_argument);
+}
+
+TEST(std_dense_flat_map, extreme_keys)
+{
+    std::dense_flat_map<std::uint8_t, int> map;
+    for (int k = 255; 0 <= k; k -= 5) {
+        map.emplace(std::uint8_t(k), k);
+    }
+    EXPECT_EQ(map.key_span(), 256u);
+    EXPECT_EQ(map.size(), 52u);
+    int expected = 0;
+    for (auto const & x : map) {
+        EXPECT_EQ(x.first, expected);
+        EXPECT_EQ(x.second, expected);
+        expected += 5;
+    }
+
+    enum class opcode : std::int8_t { nop = -2, load = 0, store = 1, jump = 7 };
+    std::dense_flat_map<opcode, std::string> ops = {
+        {opcode::store, "store"}, {opcode::nop, "nop"}, {opcode::jump, "jump"}};
+    EXPECT_EQ(ops.begin()->first, opcode::nop);
+    EXPECT_EQ(ops.at(opcode::jump), "jump");
+    EXPECT_FALSE(ops.contains(opcode::load));
+    EXPECT_EQ(ops.lower_bound(opcode::load)->second, "store");
+    EXPECT_EQ(ops.erase(opcode::nop), 1u);
+    EXPECT_EQ(ops.begin()->first, opcode::store);
+}
@@ -0,0 +1,109 @@
+#include "distributed_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <thread>
+
+namespace {
+    template<typename FlatMap>
+    using inputs_t = std::vector<std::vector<std::pair<
+        typename FlatMap::key_type,
+        typename FlatMap::mapped_type>>>;
+
+    // Runs distributed_build() on __n threads, where thread __r
+    // contributes the elements inputs[__r], and returns each thread's part.
+    template<typename FlatMap>
+    std::vector<std::distributed_flat_map_part<FlatMap>> build_on_threads(
+        inputs_t<FlatMap> const & inputs, std::size_t oversampling)
+    {
+        std::size_t const n = inputs.size();
+        std::thread_transport::group group(n);
+        std::vector<std::distributed_flat_map_part<FlatMap>> parts(n);
+        std::vector<std::thread> threads;
+        for (std::size_t r = 0; r < n; ++r) {
+            threads.emplace_back([&, r] {
+                std::thread_transport transport(group, r);
+                typename FlatMap::key_container_type keys;
+                typename FlatMap::mapped_container_type values;
+                for (auto const & e : inputs[r]) {
+                    keys.push_back(e.first);
+                    values.push_back(e.second);
+                }
+                parts[r] = std::distributed_build<FlatMap>(
+                    transport,
+                    std::move(keys),
+                    std::move(values),
+                    oversampling);
+            });
+        }
+        for (auto & t : threads) {
+            t.join();
+        }
+        return parts;
+    }
+
+    template<typename FlatMap>
+    void check_parts(
+        inputs_t<FlatMap> const & inputs,
+        std::vector<std::distributed_flat_map_part<FlatMap>> const & parts)
+    {
+        // The first of several equivalent keys, in rank order, is kept.
+        FlatMap expected;
+        for (auto const & input : inputs) {
+            for (auto const & e : input) {
+                expected.insert(e);
+            }
+        }
+        FlatMap all;
+        for (std::size_t r = 0; r < parts.size(); ++r) {
+            EXPECT_EQ(parts[r].router.shard_count(), parts.size());
+            for (auto const & e : parts[r].local) {
+                EXPECT_EQ(parts[r].router(e.first), r);
+                EXPECT_TRUE(all.insert(e).second);
+            }
+        }
+        EXPECT_EQ(all, expected);
+    }
+}
+
+TEST(distributed_flat_map, threads)
+{
+    using map_t = std::flat_map<int, int>;
+    std::mt19937 gen(5);
+    inputs_t<map_t> inputs(4);
+    for (std::size_t r = 0; r < inputs.size(); ++r) {
+        for (int i = 0; i < 5000; ++i) {
+            inputs[r].emplace_back(int(gen() % 12000), int(r * 100000 + i));
+        }
+    }
+    auto const parts = build_on_threads<map_t>(inputs, 32);
+    check_parts(inputs, parts);
+    // Sampling balances the parts.
+    for (auto const & part : parts) {
+        EXPECT_GT(part.local.size(), 1000u);
+        EXPECT_LT(part.local.size(), 4000u);
+    }
+}
+
+TEST(distributed_flat_map, uneven_inputs)
+{
+    using map_t = std::flat_map<std::string, std::string>;
+    inputs_t<map_t> inputs(3);
+    inputs[0] = {{"b", "0b"}, {"a", "0a"}, {"b", "0b2"}};
+    inputs[2] = {{"c", "2c"}, {"a", "2a"}, {"d", "2d"}};
+    auto const parts = build_on_threads<map_t>(inputs, 1);
+    check_parts(inputs, parts);
+
+    inputs_t<map_t> const single = {
+        {{"x", "1"}, {"w", "2"}}};
+    auto const one = build_on_threads<map_t>(single, 4);
+    ASSERT_EQ(one.size(), 1u);
+    EXPECT_EQ(one[0].local, map_t({{"w", "2"}, {"x", "1"}}));
+
+    inputs_t<map_t> const empty(2);
+    auto const none = build_on_threads<map_t>(empty, 4);
+    EXPECT_TRUE(none[0].local.empty());
+    EXPECT_TRUE(none[1].local.empty());
+}
@@ -0,0 +1,141 @@
+#include "enum_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+
+namespace {
+    enum class opcode : signed char { nop, load, store, add, sub, jump };
+    enum color { red, green, blue };
+}
+
+template<>
+struct std::enum_flat_map_max_key<opcode>
+    : std::integral_constant<std::size_t, std::size_t(opcode::jump)>
+{};
+template<>
+struct std::enum_flat_map_max_key<color>
+    : std::integral_constant<std::size_t, blue>
+{};
+template<>
+struct std::enum_flat_map_max_key<unsigned char>
+    : std::integral_constant<std::size_t, 255>
+{};
+
+// Test instantiations.
+template class std::enum_flat_map<opcode, std::string>;
+template class std::enum_flat_map<bool, int>;
+
+TEST(std_enum_flat_map, against_std_map)
+{
+    using enum_t = std::enum_flat_map<unsigned char, int>;
+
+    enum_t m;
+    std::map<unsigned char, int> map;
+    std::mt19937 gen(5);
+    for (int i = 0; i < 20000; ++i) {
+        auto const k = (unsigned char)(gen() % 256);
+        switch (gen() % 4) {
+        case 0: {
+            auto const result = m.try_emplace(k, i);
+            auto const map_result = map.try_emplace(k, i);
+            ASSERT_EQ(result.second, map_result.second);
+            ASSERT_EQ(result.first->first, k);
+            ASSERT_EQ(result.first->second, map_result.first->second);
+            break;
+        }
+        case 1:
+            ASSERT_EQ(m.erase(k), map.erase(k));
+            break;
+        case 2: {
+            auto const it = m.lower_bound(k);
+            auto const map_it = map.lower_bound(k);
+            ASSERT_EQ(it == m.end(), map_it == map.end());
+            if (map_it != map.end()) {
+                ASSERT_EQ(it->first, map_it->first);
+            }
+            auto const upper = m.upper_bound(k);
+            auto const map_upper = map.upper_bound(k);
+            ASSERT_EQ(upper == m.end(), map_upper == map.end());
+            if (map_upper != map.end()) {
+                ASSERT_EQ(upper->first, map_upper->first);
+            }
+            break;
+        }
+        default:
+            ASSERT_EQ(m.contains(k), map.count(k) == 1);
+            break;
+        }
+    }
+    ASSERT_EQ(m.size(), map.size());
+    EXPECT_TRUE(std::equal(
+        m.begin(),
+        m.end(),
+        map.begin(),
+        map.end(),
+        [](auto lhs, auto const & rhs) {
+            return lhs.first == rhs.first && lhs.second == rhs.second;
+        }));
+    EXPECT_TRUE(std::equal(
+        m.rbegin(),
+        m.rend(),
+        map.rbegin(),
+        map.rend(),
+        [](auto lhs, auto const & rhs) {
+            return lhs.first == rhs.first && lhs.second == rhs.second;
+        }));
+}
+
+TEST(std_enum_flat_map, small_enum)
+{
+    using enum_t = std::enum_flat_map<color, int>;
+    static_assert(sizeof(enum_t) <= 64, "");
+    static_assert(enum_t::max_size() == 3, "");
+
+    enum_t m = {{blue, 3}, {red, 1}, {blue, 4}};
+    EXPECT_EQ(m.size(), 2u);
+    EXPECT_EQ(m.begin()->first, red);
+    EXPECT_EQ(m.at(blue), 3);
+    EXPECT_FALSE(m.contains(green));
+    EXPECT_THROW(m.at(green), std::out_of_range);
+    m[green] = 2;
+    EXPECT_EQ(m, (enum_t{{red, 1}, {green, 2}, {blue, 3}}));
+    EXPECT_NE(m, (enum_t{{red, 1}, {green, 2}, {blue, 4}}));
+
+    m.erase(m.find(green));
+    EXPECT_EQ(m, (enum_t{{red, 1}, {blue, 3}}));
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.begin(), m.end());
+}
+
+TEST(std_enum_flat_map, domain)
+{
+    using enum_t = std::enum_flat_map<opcode, std::string>;
+
+    enum_t m;
+    m.insert_or_assign(opcode::add, "add");
+    m.insert_or_assign(opcode::nop, "nop");
+    m.insert_or_assign(opcode::add, "iadd");
+    EXPECT_EQ(m.at(opcode::add), "iadd");
+
+    // Keys outside [0, max] are never found, and cannot be inserted.
+    EXPECT_EQ(m.find(opcode(-1)), m.end());
+    EXPECT_EQ(m.find(opcode(6)), m.end());
+    EXPECT_EQ(m.lower_bound(opcode(-1))->first, opcode::nop);
+    EXPECT_EQ(m.upper_bound(opcode(6)), m.end());
+    EXPECT_THROW(m.try_emplace(opcode(6), "x"), std::out_of_range);
+    EXPECT_THROW(m.try_emplace(opcode(-1), "x"), std::out_of_range);
+    EXPECT_EQ(m.size(), 2u);
+
+    std::flat_map<color, int> const flat = {{blue, 3}, {red, 1}};
+    std::enum_flat_map<color, int> const from_flat(flat);
+    EXPECT_EQ(from_flat, (std::enum_flat_map<color, int>{{red, 1}, {blue, 3}}));
+
+    std::enum_flat_map<bool, int> b = {{true, 1}, {false, 0}};
+    EXPECT_EQ(b.size(), 2u);
+    EXPECT_EQ(b.begin()->first, false);
+    EXPECT_EQ(std::prev(b.end())->second, 1);
+}
@@ -0,0 +1,139 @@
+#include "expiring_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+
+namespace {
+    using clock_type = std::chrono::steady_clock;
+    using seconds = std::chrono::seconds;
+
+    clock_type::time_point at(int s)
+    {
+        return clock_type::time_point(seconds(s));
+    }
+}
+
+// Test instantiations.
+template class std::expiring_flat_map<int, std::string>;
+template class std::
+    expiring_flat_map<std::string, int, clock_type, std::greater<std::string>>;
+
+TEST(std_expiring_flat_map, expire)
+{
+    std::expiring_flat_map<int, std::string> map;
+    EXPECT_TRUE(map.try_emplace(3, "three", at(30)).second);
+    EXPECT_TRUE(map.try_emplace(1, "one", at(10)).second);
+    EXPECT_TRUE(map.try_emplace(2, "two", at(20)).second);
+    EXPECT_FALSE(map.try_emplace(2, "deux", at(5)).second);
+    EXPECT_EQ(map.at(2), "two");
+    EXPECT_EQ(map.expiry(map.find(2)), at(20));
+    EXPECT_EQ(map.next_expiry(), at(10));
+
+    EXPECT_EQ(map.expire(at(9)), 0u);
+    EXPECT_EQ(map.size(), 3u);
+    EXPECT_EQ(map.expire(at(20)), 2u);
+    ASSERT_EQ(map.size(), 1u);
+    EXPECT_EQ(map.begin()->first, 3);
+    EXPECT_EQ(map.expiry(map.begin()), at(30));
+    EXPECT_EQ(map.next_expiry(), at(30));
+
+    // Assigning moves the deadline.
+    EXPECT_FALSE(map.insert_or_assign(3, "drei", at(40)).second);
+    EXPECT_EQ(map.at(3), "drei");
+    EXPECT_EQ(map.expire(at(30)), 0u);
+    map.set_expiry(map.find(3), at(35));
+    EXPECT_EQ(map.next_expiry(), at(35));
+    EXPECT_EQ(map.expire(at(35)), 1u);
+    EXPECT_TRUE(map.empty());
+}
+
+TEST(std_expiring_flat_map, matches_reference)
+{
+    using map_t = std::expiring_flat_map<
+        std::string,
+        int,
+        clock_type,
+        std::greater<std::string>>;
+    map_t map;
+    std::map<std::string, std::pair<int, int>, std::greater<std::string>>
+        reference;
+    std::mt19937 gen(42);
+    int now = 0;
+    for (int i = 0; i < 5000; ++i) {
+        std::string const key = std::to_string(gen() % 400);
+        int const deadline = now + int(gen() % 50);
+        switch (gen() % 6) {
+        case 0:
+        case 1:
+            EXPECT_EQ(
+                map.try_emplace(key, i, at(deadline)).second,
+                reference.try_emplace(key, i, deadline).second);
+            break;
+        case 2:
+            map.insert_or_assign(key, i, at(deadline));
+            reference.insert_or_assign(key, std::make_pair(i, deadline));
+            break;
+        case 3:
+            EXPECT_EQ(map.erase(key), reference.erase(key));
+            break;
+        case 4: {
+            auto const it = map.find(key);
+            if (it != map.end()) {
+                map.set_expiry(it, at(deadline));
+                reference[key].second = deadline;
+            }
+            break;
+        }
+        default: {
+            now += int(gen() % 10);
+            std::size_t expected = 0;
+            for (auto it = reference.begin(); it != reference.end();) {
+                if (it->second.second <= now) {
+                    it = reference.erase(it);
+                    ++expected;
+                } else {
+                    ++it;
+                }
+            }
+            EXPECT_EQ(map.expire(at(now)), expected);
+            break;
+        }
+        }
+
+        ASSERT_EQ(map.size(), reference.size());
+        auto ref = reference.begin();
+        for (auto it = map.begin(); it != map.end(); ++it, ++ref) {
+            EXPECT_EQ(it->first, ref->first);
+            EXPECT_EQ(it->second, ref->second.first);
+            EXPECT_EQ(map.expiry(it), at(ref->second.second));
+        }
+        if (!map.empty()) {
+            int earliest = reference.begin()->second.second;
+            for (auto const & x : reference) {
+                earliest = std::min(earliest, x.second.second);
+            }
+            EXPECT_EQ(map.next_expiry(), at(earliest));
+        }
+    }
+}
+
+TEST(std_expiring_flat_map, swap_and_clear)
+{
+    std::expiring_flat_map<int, int> a;
+    std::expiring_flat_map<int, int> b;
+    a.try_emplace(1, 10, at(1));
+    b.try_emplace(2, 20, at(2));
+    b.try_emplace(3, 30, at(3));
+    swap(a, b);
+    EXPECT_EQ(a.size(), 2u);
+    EXPECT_EQ(b.size(), 1u);
+    EXPECT_EQ(a.next_expiry(), at(2));
+    EXPECT_EQ(a.expire(at(2)), 1u);
+    EXPECT_EQ(a.keys(), std::vector<int>{3});
+    a.clear();
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(a.expire(at(100)), 0u);
+}
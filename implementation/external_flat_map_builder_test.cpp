@@ -0,0 +1,99 @@
+#include "external_flat_map_builder"
+#include "mapped_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+// Test instantiations.
+template class std::external_flat_map_builder<int, double>;
+template class std::external_flat_map_builder<long, int, std::greater<long>>;
+
+namespace {
+    bool exists(std::string const & path)
+    {
+        return std::ifstream(path).good();
+    }
+}
+
+TEST(external_flat_map_builder, spills_and_merges)
+{
+    char const * const path = "external_flat_map_builder_test.merge.bin";
+    std::flat_map<int, double> expected;
+    std::size_t runs = 0;
+    {
+        // 4000 bytes hold 333 elements, so about 60 runs are spilled.
+        std::external_flat_map_builder<int, double> builder(path, 4000);
+        std::mt19937 gen(9);
+        for (int i = 0; i < 20000; ++i) {
+            int const k = int(gen() % 15000) - 5000;
+            builder.insert(k, double(i));
+            expected.emplace(k, double(i));
+        }
+        runs = builder.run_count();
+        EXPECT_EQ(builder.finish(), expected.size());
+        EXPECT_FALSE(exists(std::string(path) + ".run0"));
+        EXPECT_FALSE(exists(std::string(path) + ".values"));
+        EXPECT_FALSE(exists(std::string(path) + ".partial"));
+    }
+    EXPECT_GT(runs, 50u);
+
+    {
+        std::mapped_flat_map<int, double> const mapped(path);
+        ASSERT_EQ(mapped.size(), expected.size());
+        EXPECT_TRUE(std::equal(
+            mapped.begin(),
+            mapped.end(),
+            expected.begin(),
+            expected.end(),
+            [](auto const & x, auto const & y) {
+                return x.first == y.first && x.second == y.second;
+            }));
+    }
+
+    // The checksum is that of save().
+    std::flat_map<int, double> loaded;
+    std::ifstream in(path, std::ios::binary);
+    std::load(in, loaded);
+    EXPECT_EQ(loaded, expected);
+    std::remove(path);
+}
+
+TEST(external_flat_map_builder, in_memory_and_empty)
+{
+    char const * const path = "external_flat_map_builder_test.small.bin";
+    {
+        std::external_flat_map_builder<long, int, std::greater<long>> builder(
+            path);
+        std::vector<std::pair<long, int>> const elements = {
+            {3, 0}, {1, 1}, {3, 2}, {7, 3}};
+        builder.insert(elements.begin(), elements.end());
+        EXPECT_EQ(builder.finish(), 3u);
+        EXPECT_EQ(builder.run_count(), 0u);
+        std::mapped_flat_map<long, int, std::greater<long>> const mapped(
+            path);
+        EXPECT_EQ(mapped.begin()->first, 7);
+        EXPECT_EQ(mapped.at(3), 0);
+    }
+    {
+        std::external_flat_map_builder<long, int, std::greater<long>> builder(
+            path, 16);
+        builder.insert(5, 5);
+        builder.insert(5, 6);
+        builder.insert(4, 4);
+        EXPECT_EQ(builder.finish(), 2u);
+        std::mapped_flat_map<long, int, std::greater<long>> const mapped(
+            path);
+        EXPECT_EQ(mapped.at(5), 5);
+        EXPECT_EQ(mapped.at(4), 4);
+    }
+    {
+        std::external_flat_map_builder<int, double> builder(path, 64);
+        EXPECT_EQ(builder.finish(), 0u);
+        std::mapped_flat_map<int, double> const mapped(path);
+        EXPECT_TRUE(mapped.empty());
+    }
+    std::remove(path);
+}
@@ -0,0 +1,110 @@
+#include "fenced_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+
+// Test instantiations.
+template class std::fenced_flat_map<std::flat_map<std::string, int>>;
+
+TEST(std_fenced_flat_map, insert_erase_lookup)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t initial;
+    std::map<int, int> std_map;
+    for (int i = 0; i < 4000; i += 2) {
+        initial.emplace(i, -i);
+        std_map.emplace(i, -i);
+    }
+    std::fenced_flat_map<fmap_t> map(std::move(initial), 8);
+    EXPECT_EQ(map.stride(), 8u);
+    EXPECT_EQ(map.fence_count(), 249u);
+    std::mt19937 gen(11);
+    for (int i = 0; i < 20000; ++i) {
+        int const key = int(gen() % 4000);
+        switch (gen() % 4) {
+        case 0:
+            EXPECT_EQ(map.erase(key), std_map.erase(key));
+            break;
+        case 1: {
+            auto const it = map.find(key);
+            if (it != map.end())
+                map.erase(it);
+            std_map.erase(key);
+            break;
+        }
+        default:
+            map[key] = i;
+            std_map[key] = i;
+            break;
+        }
+        int const probe = int(gen() % 4400) - 200;
+        auto const it = std_map.find(probe);
+        EXPECT_EQ(map.contains(probe), it != std_map.end());
+        EXPECT_EQ(map.count(probe), std_map.count(probe));
+        if (it != std_map.end()) {
+            EXPECT_EQ(map.find(probe)->second, it->second);
+            EXPECT_EQ(map.at(probe), it->second);
+        } else {
+            EXPECT_EQ(map.find(probe), map.end());
+            EXPECT_THROW(map.at(probe), std::out_of_range);
+        }
+        EXPECT_EQ(
+            map.lower_bound(probe) - map.begin(),
+            std::distance(std_map.begin(), std_map.lower_bound(probe)));
+        EXPECT_EQ(
+            map.upper_bound(probe) - map.begin(),
+            std::distance(std_map.begin(), std_map.upper_bound(probe)));
+        auto const range = map.equal_range(probe);
+        EXPECT_EQ(range.first, map.lower_bound(probe));
+        EXPECT_EQ(range.second, map.upper_bound(probe));
+    }
+    EXPECT_EQ(map.size(), std_map.size());
+    EXPECT_TRUE(std::equal(
+        map.begin(),
+        map.end(),
+        std_map.begin(),
+        std_map.end(),
+        [](auto lhs, auto rhs) {
+            return lhs.first == rhs.first && lhs.second == rhs.second;
+        }));
+}
+
+TEST(std_fenced_flat_map, bulk_operations)
+{
+    using fmap_t = std::flat_map<std::string, int>;
+
+    std::fenced_flat_map<fmap_t> map;
+    EXPECT_EQ(map.fence_count(), 0u);
+    EXPECT_FALSE(map.contains("key1"));
+    std::vector<std::pair<std::string, int>> pairs;
+    for (int i = 0; i < 1000; ++i) {
+        pairs.emplace_back("key" + std::to_string(i), i);
+    }
+    map.insert(pairs.begin(), pairs.end());
+    EXPECT_EQ(map.size(), 1000u);
+    EXPECT_EQ(map.fence_count(), 15u);
+    for (auto const & x : pairs) {
+        EXPECT_EQ(map.at(x.first), x.second);
+    }
+    EXPECT_FALSE(map.contains("key1000"));
+
+    map.stride(10);
+    EXPECT_EQ(map.fence_count(), 99u);
+    for (auto const & x : pairs) {
+        EXPECT_EQ(map.at(x.first), x.second);
+    }
+
+    map.replace({"a", "b"}, {1, 2});
+    EXPECT_EQ(map.fence_count(), 0u);
+    EXPECT_FALSE(map.contains("key1"));
+    EXPECT_TRUE(map.contains("b"));
+    map.insert({{"c", 3}, {"a", 10}});
+    EXPECT_EQ(map.at("a"), 1);
+    EXPECT_EQ(map.at("c"), 3);
+    fmap_t const expected = {{"a", 1}, {"b", 2}, {"c", 3}};
+    EXPECT_EQ(std::move(map).release(), expected);
+}
@@ -0,0 +1,93 @@
+#include "filtered_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+
+// Test instantiations.
+template class std::filtered_flat_map<std::flat_map<std::string, int>>;
+
+TEST(std_filtered_flat_map, insert_erase_lookup)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    std::filtered_flat_map<fmap_t> map(fmap_t{{-1, -1}});
+    EXPECT_EQ(map.bits_per_key(), 10u);
+    std::map<int, int> std_map = {{-1, -1}};
+    std::mt19937 gen(7);
+    for (int i = 0; i < 20000; ++i) {
+        int const key = int(gen() % 4000);
+        switch (gen() % 4) {
+        case 0:
+            EXPECT_EQ(map.erase(key), std_map.erase(key));
+            break;
+        case 1: {
+            auto const it = map.find(key);
+            if (it != map.end())
+                map.erase(it);
+            std_map.erase(key);
+            break;
+        }
+        default:
+            map[key] = i;
+            std_map[key] = i;
+            break;
+        }
+        int const probe = int(gen() % 4400);
+        auto const it = std_map.find(probe);
+        EXPECT_EQ(map.contains(probe), it != std_map.end());
+        EXPECT_EQ(map.count(probe), std_map.count(probe));
+        if (it != std_map.end()) {
+            EXPECT_EQ(map.find(probe)->second, it->second);
+            EXPECT_EQ(map.at(probe), it->second);
+        } else {
+            EXPECT_EQ(map.find(probe), map.end());
+            EXPECT_THROW(map.at(probe), std::out_of_range);
+        }
+    }
+    EXPECT_EQ(map.size(), std_map.size());
+    EXPECT_TRUE(std::equal(
+        map.begin(),
+        map.end(),
+        std_map.begin(),
+        std_map.end(),
+        [](auto lhs, auto rhs) {
+            return lhs.first == rhs.first && lhs.second == rhs.second;
+        }));
+}
+
+TEST(std_filtered_flat_map, bulk_operations)
+{
+    using fmap_t = std::flat_map<std::string, int>;
+
+    std::filtered_flat_map<fmap_t> map;
+    std::vector<std::pair<std::string, int>> pairs;
+    for (int i = 0; i < 1000; ++i) {
+        pairs.emplace_back("key" + std::to_string(i), i);
+    }
+    map.insert(pairs.begin(), pairs.end());
+    EXPECT_EQ(map.size(), 1000u);
+    EXPECT_GT(map.filter_memory_usage(), 1000u);
+
+    // Absent keys are rejected, by the filter or by the search behind it.
+    int found = 0;
+    for (int i = 1000; i < 2000; ++i) {
+        found += map.contains("key" + std::to_string(i));
+    }
+    EXPECT_EQ(found, 0);
+    for (auto const & x : pairs) {
+        EXPECT_EQ(map.at(x.first), x.second);
+    }
+
+    map.replace({"a", "b"}, {1, 2});
+    EXPECT_FALSE(map.contains("key1"));
+    EXPECT_TRUE(map.contains("b"));
+    map.insert({{"c", 3}, {"a", 10}});
+    map.bits_per_key(16);
+    EXPECT_EQ(map.at("a"), 1);
+    EXPECT_EQ(map.at("c"), 3);
+    fmap_t const expected = {{"a", 1}, {"b", 2}, {"c", 3}};
+    EXPECT_EQ(std::move(map).release(), expected);
+}
@@ -0,0 +1,127 @@
+#include "flat_map_aggregate"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+
+namespace {
+    // Concatenation, which is associative but not commutative.
+    struct concat
+    {
+        std::string operator()(std::string const & x, std::string const & y)
+            const
+        {
+            return x + y;
+        }
+    };
+}
+
+// Test instantiations.
+template class std::range_aggregate_index<std::flat_map<int, long>>;
+template class std::range_aggregate_index<
+    std::flat_map<int, double>,
+    std::aggregate_min<double>>;
+template class std::range_aggregate_index<
+    std::flat_multimap<int, int>,
+    std::aggregate_max<int>>;
+
+TEST(flat_map_aggregate, matches_scan)
+{
+    using map_t = std::flat_map<int, long>;
+    map_t map;
+    std::mt19937 gen(42);
+    for (int i = 0; i < 1000; ++i) {
+        map.insert_or_assign(int(gen() % 5000), long(gen() % 1000) - 500);
+    }
+
+    std::range_aggregate_index<map_t> sum(map);
+    std::range_aggregate_index<map_t, std::aggregate_min<long>> min(map);
+    std::range_aggregate_index<map_t, std::aggregate_max<long>> max(map);
+
+    auto const check = [&](int a, int b) {
+        auto const first = map.lower_bound(a);
+        auto const last = std::max(first, map.lower_bound(b));
+        long expected_sum = 0;
+        long expected_min = std::numeric_limits<long>::max();
+        long expected_max = std::numeric_limits<long>::lowest();
+        for (auto it = first; it != last; ++it) {
+            expected_sum += it->second;
+            expected_min = std::min(expected_min, long(it->second));
+            expected_max = std::max(expected_max, long(it->second));
+        }
+        EXPECT_EQ(sum.aggregate(a, b), expected_sum) << a << ' ' << b;
+        EXPECT_EQ(min.aggregate(a, b), expected_min) << a << ' ' << b;
+        EXPECT_EQ(max.aggregate(a, b), expected_max) << a << ' ' << b;
+    };
+
+    for (int i = 0; i < 2000; ++i) {
+        int const a = int(gen() % 5200) - 100;
+        int const b = a + int(gen() % 1000);
+        check(a, b);
+    }
+    check(0, 0);
+    check(100, 50);
+    check(-1000, 10000);
+    EXPECT_EQ(
+        sum.aggregate(),
+        std::accumulate(map.values().begin(), map.values().end(), 0L));
+
+    // Assigning one value needs only update().
+    for (int i = 0; i < 200; ++i) {
+        auto const it = map.begin() + (gen() % map.size());
+        it->second = long(gen() % 1000) - 500;
+        sum.update(it);
+        min.update(it);
+        max.update(it);
+        check(it->first - 300, it->first + 300);
+    }
+
+    // Insertions need rebuild().
+    for (int i = 0; i < 100; ++i) {
+        map.insert_or_assign(int(gen() % 5000), long(i));
+    }
+    sum.rebuild();
+    min.rebuild();
+    max.rebuild();
+    for (int i = 0; i < 500; ++i) {
+        int const a = int(gen() % 5000);
+        check(a, a + int(gen() % 2000));
+    }
+}
+
+TEST(flat_map_aggregate, order_is_kept)
+{
+    using map_t = std::flat_map<int, std::string>;
+    map_t map;
+    for (int i = 0; i < 37; ++i) {
+        map.try_emplace(i, std::string(1, char('a' + i % 26)));
+    }
+    std::range_aggregate_index<map_t, concat> index(map);
+    for (int a = 0; a <= 37; ++a) {
+        for (int b = a; b <= 37; ++b) {
+            std::string expected;
+            for (int i = a; i < b; ++i) {
+                expected += map.at(i);
+            }
+            ASSERT_EQ(index.aggregate(a, b), expected) << a << ' ' << b;
+        }
+    }
+    EXPECT_EQ(index.aggregate(), index.aggregate(0, 37));
+    EXPECT_EQ(&index.indexed_map(), &map);
+}
+
+TEST(flat_map_aggregate, empty_and_single)
+{
+    using map_t = std::flat_map<int, double>;
+    map_t map;
+    std::range_aggregate_index<map_t, std::aggregate_min<double>> min(map);
+    EXPECT_EQ(min.aggregate(), std::numeric_limits<double>::infinity());
+    map.try_emplace(5, 2.5);
+    min.rebuild();
+    EXPECT_EQ(min.aggregate(), 2.5);
+    EXPECT_EQ(min.aggregate(5, 6), 2.5);
+    EXPECT_EQ(min.aggregate(6, 7), min.identity());
+}
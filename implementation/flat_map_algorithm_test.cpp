@@ -0,0 +1,323 @@
+#include "flat_map_algorithm"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+
+TEST(flat_map_algorithm, intersection)
+{
+    std::flat_map<int, std::string> const x = {
+        {1, "a"}, {3, "b"}, {5, "c"}, {7, "d"}};
+    std::flat_map<int, int> y;
+    for (int i = 0; i < 1000; i += 5) {
+        y.emplace(i, i * 2);
+    }
+
+    std::vector<std::pair<std::string, int>> result;
+    std::for_each_intersection(x, y, [&](auto const & lhs, auto const & rhs) {
+        EXPECT_EQ(lhs.first, rhs.first);
+        result.emplace_back(lhs.second, rhs.second);
+    });
+    std::vector<std::pair<std::string, int>> const expected = {{"c", 10}};
+    EXPECT_EQ(result, expected);
+
+    // The elements are passed as references into the maps.
+    std::for_each_intersection(y, x, [](auto const & lhs, auto const &) {
+        lhs.second = -1;
+    });
+    EXPECT_EQ(y[5], -1);
+    EXPECT_EQ(y[10], 20);
+
+    std::vector<int> const keys = {0, 1, 2, 7, 8};
+    std::vector<int> matched;
+    std::for_each_intersection(
+        x,
+        std::sorted_unique,
+        keys.begin(),
+        keys.end(),
+        [&](auto const & lhs, int k) {
+            EXPECT_EQ(lhs.first, k);
+            matched.push_back(k);
+        });
+    std::vector<int> const expected_matched = {1, 7};
+    EXPECT_EQ(matched, expected_matched);
+
+    std::flat_map<int, int> const empty;
+    int calls = 0;
+    std::for_each_intersection(
+        x, empty, [&](auto const &, auto const &) { ++calls; });
+    std::for_each_intersection(
+        empty, x, [&](auto const &, auto const &) { ++calls; });
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(flat_map_algorithm, difference_left_join)
+{
+    std::flat_map<int, int> const x = {{1, 1}, {2, 2}, {3, 3}, {4, 4}};
+    std::flat_map<int, int> const y = {{0, 0}, {2, 20}, {4, 40}, {5, 50}};
+
+    std::vector<int> diff;
+    std::for_each_difference(
+        x, y, [&](auto const & elem) { diff.push_back(elem.first); });
+    std::vector<int> const expected_diff = {1, 3};
+    EXPECT_EQ(diff, expected_diff);
+
+    std::vector<int> const keys = {1, 4};
+    diff.clear();
+    std::for_each_difference(
+        x, std::sorted_unique, keys.begin(), keys.end(), [&](auto const & e) {
+            diff.push_back(e.first);
+        });
+    std::vector<int> const expected_diff_2 = {2, 3};
+    EXPECT_EQ(diff, expected_diff_2);
+
+    std::vector<std::pair<int, int>> joined;
+    std::for_each_left_join(x, y, [&](auto const & lhs, auto it) {
+        joined.emplace_back(lhs.first, it == y.end() ? -1 : it->second);
+    });
+    std::vector<std::pair<int, int>> const expected_joined = {
+        {1, -1}, {2, 20}, {3, -1}, {4, 40}};
+    EXPECT_EQ(joined, expected_joined);
+}
+
+TEST(flat_map_algorithm, diff_apply_diff)
+{
+    using fmap_t = std::flat_map<int, std::string>;
+
+    fmap_t const old_map = {{1, "a"}, {2, "b"}, {3, "c"}, {5, "e"}};
+    fmap_t const new_map = {{0, "z"}, {2, "b"}, {3, "C"}, {6, "f"}};
+    auto d = std::diff(old_map, new_map);
+    std::vector<int> const expected_erased = {1, 5};
+    std::vector<int> const expected_keys = {0, 3, 6};
+    std::vector<std::string> const expected_values = {"z", "C", "f"};
+    EXPECT_EQ(d.erased, expected_erased);
+    EXPECT_EQ(d.assigned_keys, expected_keys);
+    EXPECT_EQ(d.assigned_values, expected_values);
+    EXPECT_FALSE(d.empty());
+    EXPECT_TRUE(std::diff(new_map, new_map).empty());
+
+    fmap_t map = old_map;
+    std::apply_diff(map, std::move(d));
+    EXPECT_EQ(map, new_map);
+
+    std::apply_diff(map, std::diff(new_map, fmap_t()));
+    EXPECT_TRUE(map.empty());
+    std::apply_diff(map, std::diff(fmap_t(), old_map));
+    EXPECT_EQ(map, old_map);
+
+    // Random pairs of maps, with keys erased at both ends and in runs.
+    std::mt19937 gen(9);
+    for (int i = 0; i < 100; ++i) {
+        std::flat_map<int, int> x;
+        std::flat_map<int, int> y;
+        for (int j = 0; j < 200; ++j) {
+            x[int(gen() % 300)] = int(gen() % 3);
+            y[int(gen() % 300)] = int(gen() % 3);
+        }
+        auto z = x;
+        std::apply_diff(z, std::diff(x, y));
+        EXPECT_EQ(z, y);
+    }
+}
+
+namespace {
+    template<typename Set>
+    std::vector<std::size_t>
+    reference_indices(Set const & x, Set const & y, bool intersection)
+    {
+        std::vector<std::size_t> result;
+        std::size_t i = 0;
+        for (auto it = x.begin(); it != x.end(); ++it, ++i) {
+            if (y.contains(*it) == intersection)
+                result.push_back(i);
+        }
+        return result;
+    }
+
+    std::flat_set<std::uint32_t>
+    random_set(std::mt19937 & gen, std::size_t n, std::uint32_t range)
+    {
+        std::vector<std::uint32_t> keys;
+        for (std::size_t i = 0; i < n; ++i) {
+            keys.push_back(gen() % range);
+        }
+        return std::flat_set<std::uint32_t>(keys.begin(), keys.end());
+    }
+}
+
+TEST(flat_map_algorithm, set_indices)
+{
+    std::mt19937 gen(3);
+    // Sizes around the kernels' block sizes, and skewed ones, which
+    // gallop.
+    std::size_t const sizes[] = {0, 1, 7, 8, 9, 15, 16, 17, 100, 1000, 5000};
+    for (std::size_t nx : sizes) {
+        for (std::size_t ny : sizes) {
+            auto const x = random_set(gen, nx, 3000);
+            auto const y = random_set(gen, ny, 3000);
+            ASSERT_EQ(
+                std::intersection_indices(x, y), reference_indices(x, y, true))
+                << nx << " " << ny;
+            ASSERT_EQ(
+                std::difference_indices(x, y), reference_indices(x, y, false))
+                << nx << " " << ny;
+        }
+    }
+
+    // Equal sets, and keys at the ends of the range.
+    std::flat_set<std::uint32_t> const ends = {
+        0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 0xfffffffeu, 0xffffffffu};
+    EXPECT_EQ(std::intersection_indices(ends, ends).size(), ends.size());
+    EXPECT_TRUE(std::difference_indices(ends, ends).empty());
+
+    // Signed keys in descending order.
+    std::flat_set<int, std::greater<int>> desc;
+    std::flat_set<int, std::greater<int>> odd;
+    for (int i = -100; i < 100; ++i) {
+        desc.insert(i);
+        if (i % 2)
+            odd.insert(i);
+    }
+    auto const desc_indices = std::intersection_indices(desc, odd);
+    ASSERT_EQ(desc_indices.size(), odd.size());
+    for (std::size_t i : desc_indices) {
+        EXPECT_TRUE(desc.begin()[i] % 2);
+    }
+}
+
+#if FLAT_MAP_X86_SET_KERNELS
+TEST(flat_map_algorithm, set_kernels)
+{
+    std::mt19937 gen(4);
+    for (int round = 0; round < 200; ++round) {
+        auto const x = random_set(gen, gen() % 300, 1000);
+        auto const y = random_set(gen, gen() % 300, 1000);
+        auto const expected = reference_indices(x, y, true);
+
+        std::vector<std::size_t> found;
+        auto emit = [&](std::size_t i, std::uint32_t matched, unsigned n) {
+            for (unsigned k = 0; k < n; ++k) {
+                if (matched >> k & 1)
+                    found.push_back(i + k);
+            }
+        };
+        std::less<std::uint32_t> const comp;
+        if (__builtin_cpu_supports("avx2")) {
+            found.clear();
+            std::__match_runs_avx2(
+                &*x.begin(), x.size(), &*y.begin(), y.size(), comp, emit);
+            ASSERT_EQ(found, expected);
+        }
+        if (__builtin_cpu_supports("avx512f")) {
+            found.clear();
+            std::__match_runs_avx512(
+                &*x.begin(), x.size(), &*y.begin(), y.size(), comp, emit);
+            ASSERT_EQ(found, expected);
+        }
+    }
+}
+#endif
+
+TEST(flat_map_algorithm, set_operations)
+{
+    std::flat_map<std::uint32_t, std::string> x;
+    std::flat_map<std::uint32_t, std::string> y;
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        x.emplace(i * 2, "x" + std::to_string(i * 2));
+        y.emplace(i * 3, "y" + std::to_string(i * 3));
+    }
+
+    auto const both = std::flat_intersection(x, y);
+    ASSERT_EQ(both.size(), 34u);
+    for (auto const & e : both) {
+        EXPECT_EQ(e.first % 6, 0u);
+        EXPECT_EQ(e.second, "x" + std::to_string(e.first));
+    }
+
+    auto const only_x = std::flat_difference(x, y);
+    EXPECT_EQ(only_x.size(), 66u);
+    for (auto const & e : only_x) {
+        EXPECT_NE(e.first % 3, 0u);
+    }
+
+    auto const either = std::flat_union(x, y);
+    EXPECT_EQ(either.size(), 100u + 100u - 34u);
+    EXPECT_TRUE(std::is_sorted(either.keys().begin(), either.keys().end()));
+    EXPECT_EQ(either.at(6), "x6");
+    EXPECT_EQ(either.at(9), "y9");
+    EXPECT_EQ(either.at(297), "y297");
+
+    std::flat_set<std::string> const a = {"a", "b", "c", "d"};
+    std::flat_set<std::string> const b = {"b", "d", "e"};
+    EXPECT_EQ(
+        std::flat_intersection(a, b), std::flat_set<std::string>({"b", "d"}));
+    EXPECT_EQ(
+        std::flat_difference(a, b), std::flat_set<std::string>({"a", "c"}));
+    EXPECT_EQ(
+        std::flat_union(a, b),
+        std::flat_set<std::string>({"a", "b", "c", "d", "e"}));
+}
+
+TEST(flat_map_algorithm, prefix_range)
+{
+    std::flat_map<std::string, int> const words = {
+        {"a", 0},
+        {"ab", 1},
+        {std::string("ab\0", 3), 2},
+        {"abc", 3},
+        {"abd", 4},
+        {"ac", 5},
+        {"b", 6}};
+    auto keys = [](auto range) {
+        std::vector<std::string> result;
+        for (auto it = range.first; it != range.second; ++it) {
+            result.push_back((*it).first);
+        }
+        return result;
+    };
+    using strings = std::vector<std::string>;
+    EXPECT_EQ(
+        keys(std::prefix_range(words, "ab")),
+        strings({"ab", std::string("ab\0", 3), "abc", "abd"}));
+    EXPECT_EQ(keys(std::prefix_range(words, "abc")), strings({"abc"}));
+    EXPECT_EQ(keys(std::prefix_range(words, "b")), strings({"b"}));
+    EXPECT_EQ(std::prefix_range(words, "").second, words.end());
+    auto const none = std::prefix_range(words, "aa");
+    EXPECT_EQ(none.first, none.second);
+    EXPECT_EQ(none.first->first, "ab");
+
+    std::flat_map<std::tuple<int, std::string, int>, int> composite;
+    std::mt19937 gen(3);
+    for (int i = 0; i < 1000; ++i) {
+        composite.emplace(
+            std::make_tuple(
+                int(gen() % 20) - 10, std::to_string(gen() % 5), i),
+            i);
+    }
+    for (int first = -11; first <= 10; ++first) {
+        auto const range = std::prefix_range(composite, first);
+        auto const expected = std::count_if(
+            composite.begin(), composite.end(), [&](auto const & e) {
+                return std::get<0>(e.first) == first;
+            });
+        EXPECT_EQ(range.second - range.first, expected);
+        for (auto it = range.first; it != range.second; ++it) {
+            EXPECT_EQ(std::get<0>(it->first), first);
+        }
+        auto const narrower = std::prefix_range(
+            composite, std::make_tuple(first, std::string("3")));
+        for (auto it = narrower.first; it != narrower.second; ++it) {
+            EXPECT_EQ(std::get<1>(it->first), "3");
+        }
+        EXPECT_LE(range.first, narrower.first);
+        EXPECT_LE(narrower.second, range.second);
+    }
+
+    std::flat_set<std::pair<int, int>> const pairs = {
+        {1, 1}, {2, 0}, {2, 5}, {3, 0}};
+    auto const twos = std::prefix_range(pairs, 2);
+    EXPECT_EQ(twos.second - twos.first, 2);
+    EXPECT_EQ(*twos.first, std::make_pair(2, 0));
+}
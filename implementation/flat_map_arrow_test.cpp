@@ -0,0 +1,102 @@
+#include "flat_map_arrow"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+TEST(flat_map_arrow, export_is_zero_copy)
+{
+    std::flat_map<std::int64_t, double> map;
+    for (int i = 0; i < 1000; ++i) {
+        map.try_emplace(i * 3, i * 0.5);
+    }
+    auto const expected = map;
+    auto const key_data = map.keys().data();
+    auto const value_data = map.values().data();
+
+    ArrowSchema schema;
+    ArrowArray array;
+    std::to_arrow(std::move(map), &schema, &array);
+    EXPECT_TRUE(map.empty());
+
+    EXPECT_STREQ(schema.format, "+s");
+    ASSERT_EQ(schema.n_children, 2);
+    EXPECT_STREQ(schema.children[0]->format, "l");
+    EXPECT_STREQ(schema.children[0]->name, "key");
+    EXPECT_STREQ(schema.children[1]->format, "g");
+    EXPECT_STREQ(schema.children[1]->name, "value");
+
+    EXPECT_EQ(array.length, 1000);
+    EXPECT_EQ(array.null_count, 0);
+    ASSERT_EQ(array.n_children, 2);
+    EXPECT_EQ(array.children[0]->length, 1000);
+    EXPECT_EQ(array.children[0]->buffers[0], nullptr);
+    EXPECT_EQ(array.children[0]->buffers[1], key_data);
+    EXPECT_EQ(array.children[1]->buffers[1], value_data);
+
+    auto const round_trip =
+        std::from_arrow<std::flat_map<std::int64_t, double>>(&array, &schema);
+    EXPECT_EQ(array.release, nullptr);
+    EXPECT_EQ(round_trip, expected);
+
+    schema.release(&schema);
+    EXPECT_EQ(schema.release, nullptr);
+}
+
+TEST(flat_map_arrow, moved_child_outlives_parent)
+{
+    std::flat_map<std::uint32_t, float> map = {{1, 1.5f}, {2, 2.5f}};
+    ArrowSchema schema;
+    ArrowArray array;
+    std::to_arrow(std::move(map), &schema, &array);
+
+    // A consumer may move a child out, and release it after the parent.
+    ArrowArray values = *array.children[1];
+    array.children[1]->release = nullptr;
+    array.release(&array);
+    EXPECT_EQ(array.release, nullptr);
+
+    ASSERT_NE(values.release, nullptr);
+    auto const data = static_cast<float const *>(values.buffers[1]);
+    EXPECT_EQ(data[0], 1.5f);
+    EXPECT_EQ(data[1], 2.5f);
+    values.release(&values);
+    EXPECT_EQ(values.release, nullptr);
+    schema.release(&schema);
+}
+
+TEST(flat_map_arrow, import_checks_the_schema)
+{
+    using map_t = std::flat_map<std::int32_t, std::int16_t>;
+    map_t map;
+    for (int i = 0; i < 10; ++i) {
+        map.try_emplace(i, std::int16_t(i * 10));
+    }
+
+    {
+        ArrowSchema schema;
+        ArrowArray array;
+        std::to_arrow(map_t(map), &schema, &array);
+        using wrong_t = std::flat_map<std::int64_t, std::int16_t>;
+        EXPECT_THROW(
+            std::from_arrow<wrong_t>(&array, &schema), std::invalid_argument);
+        // The array is released even when the import throws.
+        EXPECT_EQ(array.release, nullptr);
+        schema.release(&schema);
+    }
+
+    {
+        // A slice of the struct array is imported from its offset.
+        ArrowSchema schema;
+        ArrowArray array;
+        std::to_arrow(map_t(map), &schema, &array);
+        array.offset = 3;
+        array.length = 4;
+        auto const slice = std::from_arrow<map_t>(&array, &schema);
+        ASSERT_EQ(slice.size(), 4u);
+        EXPECT_EQ(slice.begin()->first, 3);
+        EXPECT_EQ(slice.at(6), 60);
+        schema.release(&schema);
+    }
+}
@@ -0,0 +1,75 @@
+#include "flat_map_boost"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <string>
+
+TEST(flat_map_boost, flat_map_round_trip)
+{
+    boost::container::flat_map<std::string, int, std::greater<>> b;
+    for (int i = 0; i < 100; ++i) {
+        b.emplace(std::to_string(i), i);
+    }
+    auto const expected = b;
+
+    auto m = std::from_boost_flat_map(std::move(b));
+    using map_t = std::flat_map<std::string, int, std::greater<>>;
+    EXPECT_TRUE((std::is_same<decltype(m), map_t>::value));
+    ASSERT_EQ(m.size(), 100u);
+    EXPECT_EQ(m.begin()->first, "99");
+    EXPECT_TRUE(std::equal(
+        m.begin(),
+        m.end(),
+        expected.begin(),
+        expected.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second == y.second;
+        }));
+
+    // An lvalue is copied.
+    auto const copy = std::to_boost_flat_map(m);
+    EXPECT_EQ(copy, expected);
+    EXPECT_EQ(m.size(), 100u);
+
+    auto const moved = std::to_boost_flat_map(std::move(m));
+    EXPECT_EQ(moved, expected);
+}
+
+TEST(flat_map_boost, flat_multimap_round_trip)
+{
+    boost::container::flat_multimap<int, int> b;
+    b.emplace(2, 20);
+    b.emplace(1, 10);
+    b.emplace(2, 21);
+    b.emplace(2, 22);
+
+    auto const m = std::from_boost_flat_multimap(b);
+    ASSERT_EQ(m.size(), 4u);
+    EXPECT_EQ(m.count(2), 3u);
+    EXPECT_TRUE(std::equal(
+        m.begin(),
+        m.end(),
+        b.begin(),
+        b.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second == y.second;
+        }));
+
+    EXPECT_EQ(std::to_boost_flat_multimap(m), b);
+}
+
+TEST(flat_map_boost, result_type)
+{
+    boost::container::flat_map<int, double> b;
+    b.emplace(1, 1.5);
+    b.emplace(0, 0.5);
+
+    using deque_map_t =
+        std::flat_map<int, double, std::less<int>, std::deque<int>>;
+    auto const m = std::from_boost_flat_map<deque_map_t>(b);
+    EXPECT_TRUE((std::is_same<decltype(m), deque_map_t const>::value));
+    EXPECT_EQ(m.at(0), 0.5);
+    EXPECT_EQ(m.at(1), 1.5);
+    EXPECT_EQ(std::to_boost_flat_map(m), b);
+}
@@ -0,0 +1,95 @@
+#include "flat_map_builder"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+
+// Test instantiations.
+template class std::flat_map_builder<int, double>;
+template class std::flat_map_builder<std::string, int, std::greater<>>;
+
+TEST(flat_map_builder, keeps_first)
+{
+    std::flat_map_builder<int, int> builder;
+    std::map<int, int> expected;
+    std::mt19937 gen(3);
+    for (int i = 0; i < 10000; ++i) {
+        int const k = int(gen() % 3000) - 1000;
+        builder.push(k, i);
+        expected.emplace(k, i);
+    }
+    EXPECT_EQ(builder.size(), 10000u);
+
+    auto const m = builder.build();
+    EXPECT_TRUE(builder.empty());
+    EXPECT_TRUE(std::equal(
+        m.begin(),
+        m.end(),
+        expected.begin(),
+        expected.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second == y.second;
+        }));
+}
+
+TEST(flat_map_builder, combine_duplicates)
+{
+    std::flat_map_builder<std::string, int, std::greater<>> builder;
+    std::vector<std::pair<std::string, int>> const elements = {
+        {"b", 1}, {"a", 2}, {"b", 3}, {"c", 4}, {"a", 5}};
+    builder.push(elements.begin(), elements.end());
+
+    auto const sums =
+        builder.build(std::combine_duplicates, std::plus<int>());
+    using map_t = std::flat_map<std::string, int, std::greater<>>;
+    EXPECT_EQ(sums, (map_t{{"a", 7}, {"b", 4}, {"c", 4}}));
+    EXPECT_EQ(sums.begin()->first, "c");
+
+    builder.push(elements.begin(), elements.end());
+    auto const lasts = builder.build(
+        std::combine_duplicates, [](int, int y) { return y; });
+    EXPECT_EQ(lasts, (map_t{{"a", 5}, {"b", 3}, {"c", 4}}));
+}
+
+TEST(flat_map_builder, reuses_containers)
+{
+    std::flat_map_builder<int, double> builder;
+    std::flat_map<int, double> m;
+    builder.reserve(1000);
+
+    // After the first two batches, the builder and the map trade the same
+    // two buffers back and forth.
+    std::set<int const *> buffers;
+    for (int batch = 0; batch < 6; ++batch) {
+        for (int i = 0; i < 1000; ++i) {
+            builder.push((i * 7919 + batch) % 1000, double(batch));
+        }
+        builder.build(m);
+        EXPECT_TRUE(builder.empty());
+        ASSERT_EQ(m.size(), 1000u);
+        EXPECT_EQ(m.begin()->second, double(batch));
+        if (2 <= batch) {
+            buffers.insert(m.keys().data());
+            EXPECT_GE(builder.keys().capacity(), 1000u);
+        }
+    }
+    EXPECT_EQ(buffers.size(), 2u);
+}
+
+#if USE_EXECUTION_POLICIES
+TEST(flat_map_builder, execution_policy)
+{
+    std::flat_map_builder<int, int> builder;
+    std::flat_map<int, int> expected;
+    std::mt19937 gen(17);
+    for (int i = 0; i < 100000; ++i) {
+        int const k = int(gen() % 50000);
+        builder.push(k, i);
+        expected.emplace(k, i);
+    }
+    EXPECT_EQ(builder.build(std::execution::par), expected);
+}
+#endif
@@ -0,0 +1,118 @@
+#include "flat_map_coroutine"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+TEST(flat_map_coroutine, find_then_update)
+{
+    std::flat_map<int, int> map;
+    for (int i = 0; i < 1000; i += 2) {
+        map.emplace(i, 0);
+    }
+
+    std::vector<int> keys;
+    for (int i = 0; i < 3000; ++i) {
+        keys.push_back((i * 7) % 1001);
+    }
+    int misses = 0;
+    std::run_interleaved(
+        keys.begin(), keys.end(), [&](int k) -> std::lookup_task {
+            auto const it = co_await std::async_find(map, k);
+            if (it == map.end())
+                ++misses;
+            else
+                ++it->second;
+        });
+
+    std::flat_map<int, int> expected;
+    int expected_misses = 0;
+    for (int k : keys) {
+        auto const it = expected.find(k);
+        if (k % 2 || 1000 <= k)
+            ++expected_misses;
+        else if (it == expected.end())
+            expected.emplace(k, 1);
+        else
+            ++it->second;
+    }
+    for (auto const & element : map) {
+        if (!expected.contains(element.first))
+            expected.emplace(element.first, 0);
+    }
+    EXPECT_EQ(map, expected);
+    EXPECT_EQ(misses, expected_misses);
+}
+
+TEST(flat_map_coroutine, chained_lookups)
+{
+    std::flat_map<int, std::string> ids;
+    std::flat_map<std::string, int> scores;
+    for (int i = 0; i < 500; ++i) {
+        ids.emplace(i, "user" + std::to_string(i));
+        if (i % 3 == 0)
+            scores.emplace("user" + std::to_string(i), i * 10);
+    }
+    auto const & cids = ids;
+    auto const & cscores = scores;
+
+    std::vector<int> const keys = {0, 1, 3, 299, 300, 499, 500, 999};
+    std::vector<int> results(keys.size(), -1);
+    for (std::size_t window : {1u, 3u, 16u}) {
+        std::fill(results.begin(), results.end(), -1);
+        std::vector<std::size_t> indices(keys.size());
+        std::iota(indices.begin(), indices.end(), 0);
+        std::run_interleaved(
+            indices.begin(),
+            indices.end(),
+            [&](std::size_t q) -> std::lookup_task {
+                auto const id = co_await std::async_find(cids, keys[q]);
+                if (id == cids.end())
+                    co_return;
+                auto const score =
+                    co_await std::async_find(cscores, id->second);
+                if (score != cscores.end())
+                    results[q] = score->second;
+            },
+            window);
+        std::vector<int> const expected = {0, -1, 30, -1, 3000, -1, -1, -1};
+        EXPECT_EQ(results, expected);
+    }
+
+    std::flat_map<int, int> empty;
+    bool ran = false;
+    std::vector<int> const one = {1};
+    std::run_interleaved(
+        one.begin(), one.end(), [&](int k) -> std::lookup_task {
+            ran = co_await std::async_find(empty, k) == empty.end();
+        });
+    EXPECT_TRUE(ran);
+}
+
+TEST(flat_map_coroutine, exceptions)
+{
+    std::flat_map<int, int> map;
+    for (int i = 0; i < 100; ++i) {
+        map.emplace(i, i);
+    }
+    std::vector<int> keys(50);
+    std::iota(keys.begin(), keys.end(), 0);
+    int finished = 0;
+    auto const run = [&] {
+        std::run_interleaved(
+            keys.begin(), keys.end(), [&](int k) -> std::lookup_task {
+                auto const it = co_await std::async_find(map, k);
+                if (it->second == 20)
+                    throw std::runtime_error("twenty");
+                ++finished;
+            });
+    };
+    EXPECT_THROW(run(), std::runtime_error);
+    EXPECT_LT(finished, 50);
+}
+
+#endif
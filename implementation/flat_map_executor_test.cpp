@@ -0,0 +1,216 @@
+#include "flat_map_executor"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Test instantiations.
+template void std::inline_executor::bulk(std::size_t, void (*)(std::size_t))
+    const;
+
+TEST(std_flat_map_executor, bulk)
+{
+    std::work_stealing_executor ex(4);
+    EXPECT_EQ(ex.concurrency(), 4u);
+
+    // Every task runs exactly once.
+    std::vector<std::atomic<int>> runs(10000);
+    ex.bulk(runs.size(), [&](std::size_t i) { ++runs[i]; });
+    for (auto const & r : runs) {
+        ASSERT_EQ(r.load(), 1);
+    }
+
+    // Tasks dealt to a busy thread are stolen by the idle ones.
+    std::atomic<int> done{0};
+    ex.bulk(64, [&](std::size_t i) {
+        if (i == 0) {
+            while (done.load() < 60)
+                std::this_thread::yield();
+        }
+        ++done;
+    });
+    EXPECT_EQ(done.load(), 64);
+    EXPECT_LT(0u, ex.steal_count());
+
+    // bulk() nests, and rethrows.
+    std::atomic<int> inner{0};
+    ex.bulk(8, [&](std::size_t) {
+        ex.bulk(100, [&](std::size_t) { ++inner; });
+    });
+    EXPECT_EQ(inner.load(), 800);
+    EXPECT_THROW(
+        ex.bulk(
+            100,
+            [](std::size_t i) {
+                if (i == 57)
+                    throw std::runtime_error("57");
+            }),
+        std::runtime_error);
+
+    std::work_stealing_executor single(1);
+    EXPECT_EQ(single.concurrency(), 1u);
+    int sum = 0;
+    single.bulk(10, [&](std::size_t i) { sum += int(i); });
+    EXPECT_EQ(sum, 45);
+}
+
+TEST(std_flat_map_executor, kernels)
+{
+    using fmap_t = std::flat_map<int, int>;
+    std::mt19937 gen(5);
+    std::work_stealing_executor ex(4);
+
+    // Maps of very different sizes.
+    std::vector<fmap_t::containers> inputs;
+    std::vector<std::map<int, int>> expected;
+    for (int size : {50000, 3, 0, 1200, 7, 20000}) {
+        fmap_t::containers c;
+        std::map<int, int> e;
+        for (int i = 0; i < size; ++i) {
+            int const k = int(gen() % 100000);
+            if (!e.emplace(k, i).second)
+                continue;
+            c.keys.push_back(k);
+            c.values.push_back(i);
+        }
+        inputs.push_back(std::move(c));
+        expected.push_back(std::move(e));
+    }
+    std::vector<fmap_t> maps =
+        std::build_each<fmap_t>(ex, std::move(inputs));
+    ASSERT_EQ(maps.size(), expected.size());
+    for (std::size_t i = 0; i < maps.size(); ++i) {
+        EXPECT_TRUE(std::equal(
+            maps[i].begin(),
+            maps[i].end(),
+            expected[i].begin(),
+            expected[i].end()));
+    }
+
+    // Every element is visited once, in index ranges of the grain.
+    std::atomic<std::size_t> visited{0};
+    std::for_each_index_range(
+        ex,
+        maps.begin(),
+        maps.end(),
+        1000,
+        [&](fmap_t const & m, std::size_t first, std::size_t last) {
+            EXPECT_LT(first, last);
+            EXPECT_LE(last - first, 1000u);
+            EXPECT_LE(last, m.size());
+            visited += last - first;
+        });
+    std::size_t total = 0;
+    for (auto const & e : expected) {
+        total += e.size();
+    }
+    EXPECT_EQ(visited.load(), total);
+
+    // Batch lookups match the serial ones.
+    std::vector<int> queries;
+    for (int i = 0; i < 30000; ++i) {
+        queries.push_back(int(gen() % 100000));
+    }
+    std::vector<fmap_t::const_iterator> found(queries.size());
+    fmap_t const & big = maps[0];
+    std::find_many(
+        ex, big, queries.begin(), queries.end(), found.begin(), 777);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        ASSERT_EQ(found[i], big.find(queries[i]));
+    }
+
+    // Merges into each map.
+    std::vector<fmap_t> sources(maps.size());
+    for (std::size_t i = 0; i < maps.size(); ++i) {
+        for (int k = 100000; k < 100000 + int(i) * 10; ++k) {
+            sources[i].emplace_hint(sources[i].end(), k, -k);
+            expected[i].emplace(k, -k);
+        }
+        sources[i].emplace(maps[i].empty() ? 0 : maps[i].begin()->first, 0);
+        expected[i].emplace(sources[i].begin()->first, 0);
+    }
+    std::merge_each(ex, maps.begin(), maps.end(), sources.begin());
+    for (std::size_t i = 0; i < maps.size(); ++i) {
+        EXPECT_TRUE(std::equal(
+            maps[i].begin(),
+            maps[i].end(),
+            expected[i].begin(),
+            expected[i].end()));
+    }
+
+    // erase_if_each() counts and keeps the order.
+    auto const odd = [](auto const & x) { return x.second % 2 != 0; };
+    std::size_t expected_erased = 0;
+    for (auto & e : expected) {
+        for (auto it = e.begin(); it != e.end();) {
+            if (odd(*it)) {
+                it = e.erase(it);
+                ++expected_erased;
+            } else {
+                ++it;
+            }
+        }
+    }
+    EXPECT_EQ(
+        std::erase_if_each(ex, maps.begin(), maps.end(), odd, 500),
+        expected_erased);
+    for (std::size_t i = 0; i < maps.size(); ++i) {
+        EXPECT_TRUE(std::equal(
+            maps[i].begin(),
+            maps[i].end(),
+            expected[i].begin(),
+            expected[i].end()));
+    }
+
+    // The same kernels run serially on inline_executor.
+    auto const low = [](auto const & x) { return x.first < 50000; };
+    std::size_t low_count = 0;
+    for (auto const & m : maps) {
+        low_count += std::count_if(m.begin(), m.end(), low);
+    }
+    std::inline_executor serial;
+    EXPECT_EQ(
+        std::erase_if_each(serial, maps.begin(), maps.end(), low),
+        low_count);
+    for (auto const & m : maps) {
+        EXPECT_TRUE(m.empty() || 50000 <= m.begin()->first);
+    }
+}
+
+TEST(std_flat_map_executor, merge_runs)
+{
+    using fmap_t = std::flat_map<int, int>;
+    std::mt19937 gen(17);
+    std::work_stealing_executor ex(4);
+
+    // Overlapping runs of very different sizes; of equivalent keys, the
+    // earliest run's element wins.
+    std::vector<fmap_t> runs;
+    std::map<int, int> expected;
+    for (int size : {3000, 0, 20000, 1, 500, 20000, 7}) {
+        fmap_t run;
+        for (int i = 0; i < size; ++i) {
+            run.emplace(int(gen() % 30000), int(runs.size()));
+        }
+        for (auto const & x : run) {
+            expected.emplace(x.first, x.second);
+        }
+        runs.push_back(std::move(run));
+    }
+    fmap_t const merged = std::merge_runs(ex, std::move(runs));
+    EXPECT_TRUE(std::equal(
+        merged.begin(), merged.end(), expected.begin(), expected.end()));
+
+    std::inline_executor serial;
+    std::vector<fmap_t> one_run(1, fmap_t{{1, 2}, {3, 4}});
+    EXPECT_EQ(
+        std::merge_runs(serial, std::move(one_run)),
+        (fmap_t{{1, 2}, {3, 4}}));
+    EXPECT_TRUE(std::merge_runs(serial, std::vector<fmap_t>()).empty());
+}
@@ -0,0 +1,23 @@
+// Copyright (C) 2019-2022 T. Zachary Laine
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// The explicit instantiation definitions that flat_map_instantiations
+// declares extern.
+
+#include "flat_map_instantiations"
+
+
+namespace std {
+
+#define __FLAT_MAP_INSTANTIATE_MAP(_Key, _T) template class flat_map<_Key, _T>;
+#define __FLAT_MAP_INSTANTIATE_SET(_Key) template class flat_set<_Key>;
+
+    FLAT_MAP_COMMON_MAPS(__FLAT_MAP_INSTANTIATE_MAP)
+    FLAT_MAP_COMMON_SETS(__FLAT_MAP_INSTANTIATE_SET)
+
+#undef __FLAT_MAP_INSTANTIATE_SET
+#undef __FLAT_MAP_INSTANTIATE_MAP
+}
@@ -0,0 +1,45 @@
+#include "flat_map_instantiations"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+// The specializations below are declared extern, so this test links only
+// because the flat_map_instantiations library defines them.
+
+TEST(std_flat_map_instantiations, maps)
+{
+    std::flat_map<std::string, std::string> names = {
+        {"b", "beta"}, {"a", "alpha"}, {"c", "gamma"}};
+    names.insert_or_assign("c", "charlie");
+    EXPECT_EQ(names.at("c"), "charlie");
+    EXPECT_EQ(names.erase("a"), 1u);
+    EXPECT_EQ(names.begin()->first, "b");
+
+    std::flat_map<std::int64_t, std::int64_t> counts;
+    for (std::int64_t i = 0; i < 1000; ++i) {
+        counts[i % 37] += i;
+    }
+    EXPECT_EQ(counts.size(), 37u);
+    std::int64_t expected = 0;
+    for (std::int64_t i = 36; i < 1000; i += 37) {
+        expected += i;
+    }
+    EXPECT_EQ(counts.find(36)->second, expected);
+
+    std::flat_map<std::string, std::int64_t> const ids = {{"x", 1}, {"y", 2}};
+    EXPECT_TRUE(ids.contains("y"));
+    std::flat_map<std::int64_t, std::string> const rev = {{1, "x"}, {2, "y"}};
+    EXPECT_EQ(rev.lower_bound(2)->second, "y");
+}
+
+TEST(std_flat_map_instantiations, sets)
+{
+    std::flat_set<std::string> s = {"b", "a", "b"};
+    EXPECT_EQ(s.size(), 2u);
+    std::flat_set<std::int64_t> t = {3, 1, 2, 3};
+    EXPECT_EQ(*t.begin(), 1);
+    EXPECT_EQ(t.erase(2), 1u);
+    EXPECT_FALSE(t.contains(2));
+}
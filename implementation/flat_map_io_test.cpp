@@ -0,0 +1,104 @@
+#include "flat_map_io"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+
+TEST(std_flat_map_io, save_load)
+{
+    using fmap_t = std::flat_map<int, double>;
+
+    for (int size : {0, 1, 2, 17, 1000}) {
+        fmap_t map;
+        for (int i = 0; i < size; ++i) {
+            map.emplace(i * 3, i * 0.25);
+        }
+        std::stringstream ss;
+        std::save(ss, map);
+
+        fmap_t loaded = {{-1, 1.0}};
+        std::load(ss, loaded);
+        EXPECT_EQ(loaded, map);
+    }
+
+    {
+        using gmap_t = std::flat_map<long, char, std::greater<long>>;
+        gmap_t const map = {{1, 'a'}, {3, 'c'}, {2, 'b'}};
+        std::stringstream ss;
+        std::save(ss, map);
+
+        gmap_t loaded;
+        std::load(ss, loaded);
+        EXPECT_EQ(loaded, map);
+        EXPECT_EQ(loaded.begin()->first, 3);
+    }
+}
+
+TEST(std_flat_map_io, bad_input)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t const map = {{1, 10}, {2, 20}, {3, 30}};
+    std::stringstream ss;
+    std::save(ss, map);
+    std::string const good = ss.str();
+
+    fmap_t const original = {{7, 70}};
+    auto expect_failure = [&](std::string const & bytes) {
+        fmap_t loaded = original;
+        std::istringstream in(bytes);
+        EXPECT_THROW(std::load(in, loaded), std::runtime_error);
+        EXPECT_EQ(loaded, original);
+    };
+
+    expect_failure("");
+    expect_failure(std::string(good.size(), 'x'));
+    expect_failure(good.substr(0, good.size() - 1));
+
+    {
+        std::string corrupt = good;
+        corrupt.back() ^= 1;
+        expect_failure(corrupt);
+    }
+
+    {
+        std::flat_map<int, double> const other = {{1, 1.0}};
+        std::stringstream other_ss;
+        std::save(other_ss, other);
+        expect_failure(other_ss.str());
+    }
+
+    {
+        // Saved in the opposite order; the trusting overload takes it as-is.
+        std::flat_map<int, int, std::greater<int>> const reversed = {
+            {1, 10}, {2, 20}};
+        std::stringstream reversed_ss;
+        std::save(reversed_ss, reversed);
+        expect_failure(reversed_ss.str());
+
+        fmap_t loaded;
+        std::istringstream in(reversed_ss.str());
+        std::load(in, loaded, std::sorted_unique);
+        EXPECT_EQ(loaded.keys().front(), 2);
+    }
+}
+
+TEST(std_flat_map_io, is_strictly_sorted)
+{
+    std::vector<int> ints(1000);
+    std::iota(ints.begin(), ints.end(), 0);
+    EXPECT_TRUE(std::__is_strictly_sorted(
+        ints.data(), ints.size(), std::less<int>()));
+    EXPECT_FALSE(std::__is_strictly_sorted(
+        ints.data(), ints.size(), std::greater<int>()));
+    ints[700] = ints[699];
+    EXPECT_FALSE(std::__is_strictly_sorted(
+        ints.data(), ints.size(), std::less<int>()));
+
+    std::string const strings[] = {"a", "ab", "b"};
+    EXPECT_TRUE(
+        std::__is_strictly_sorted(strings, 3, std::less<std::string>()));
+    EXPECT_FALSE(
+        std::__is_strictly_sorted(strings, 3, std::greater<std::string>()));
+}
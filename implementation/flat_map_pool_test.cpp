@@ -0,0 +1,126 @@
+#include "flat_map_pool"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+
+namespace {
+    std::atomic<long> allocations{0};
+}
+
+void * operator new(std::size_t n)
+{
+    ++allocations;
+    if (void * const p = std::malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void * p) noexcept { std::free(p); }
+void operator delete(void * p, std::size_t) noexcept { std::free(p); }
+
+// Test instantiations.
+template class std::flat_map_pool<std::flat_map<int, double>>;
+template class std::flat_map_pool<std::flat_multimap<int, std::string>>;
+template class std::pooled_flat_map<std::flat_map<int, int>>;
+
+TEST(std_flat_map_pool, acquire_recycle)
+{
+    using fmap_t = std::flat_map<int, int, std::greater<int>>;
+    std::flat_map_pool<fmap_t> pool(2, 100);
+    EXPECT_EQ(pool.free_count(), 0u);
+
+    fmap_t a = pool.acquire();
+    a.insert_or_assign(1, 10);
+    a.insert_or_assign(2, 20);
+    auto const * const storage = a.keys().data();
+    pool.recycle(std::move(a));
+    EXPECT_EQ(pool.free_count(), 1u);
+
+    // The storage comes back empty, with its order, and its capacity.
+    fmap_t b = pool.acquire(std::greater<int>());
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(b.keys().data(), storage);
+    EXPECT_LE(2u, b.keys().capacity());
+    EXPECT_EQ(pool.reused_count(), 1u);
+    EXPECT_EQ(pool.free_count(), 0u);
+    b.insert_or_assign(3, 30);
+    b.insert_or_assign(4, 40);
+    EXPECT_EQ(b.begin()->first, 4);
+
+    // Storage past max_capacity() is let go, as is storage past
+    // max_free() pairs.
+    fmap_t big = pool.acquire();
+    for (int i = 0; i < 200; ++i) {
+        big.emplace(i, i);
+    }
+    pool.recycle(std::move(big));
+    EXPECT_EQ(pool.free_count(), 0u);
+    pool.recycle(std::move(b));
+    pool.recycle(pool.acquire());
+    pool.recycle(fmap_t());
+    pool.recycle(fmap_t());
+    EXPECT_EQ(pool.free_count(), 2u);
+    pool.max_free(1);
+    EXPECT_EQ(pool.free_count(), 1u);
+    pool.clear();
+    EXPECT_EQ(pool.free_count(), 0u);
+}
+
+TEST(std_flat_map_pool, steady_state_allocates_nothing)
+{
+    using fmap_t = std::flat_map<int, int>;
+    auto handle_request = [](int seed) {
+        std::pooled_flat_map<fmap_t> m;
+        for (int i = 0; i < 50; ++i) {
+            m->insert_or_assign((seed * 31 + i * 17) % 97, i);
+        }
+        int sum = 0;
+        for (auto const & x : *m) {
+            sum += x.second;
+        }
+        return sum;
+    };
+
+    // Warm the pool up, and then handle requests, each with two maps live
+    // at once.
+    for (int r = 0; r < 4; ++r) {
+        std::pooled_flat_map<fmap_t> outer;
+        outer->emplace(r, handle_request(r));
+    }
+    long const before = allocations;
+    for (int r = 0; r < 1000; ++r) {
+        std::pooled_flat_map<fmap_t> outer;
+        outer->emplace(r, handle_request(r));
+        EXPECT_EQ(outer->size(), 1u);
+    }
+    EXPECT_EQ(allocations - before, 0);
+    EXPECT_LE(
+        2000u, std::flat_map_pool<fmap_t>::local().reused_count());
+
+    // Each thread has its own pool.
+    std::size_t other_reused = 1;
+    std::thread([&] {
+        handle_request(0);
+        other_reused = std::flat_map_pool<fmap_t>::local().reused_count();
+    }).join();
+    EXPECT_EQ(other_reused, 0u);
+}
+
+TEST(std_flat_map_pool, multimap)
+{
+    using fmmap_t = std::flat_multimap<int, std::string>;
+    std::flat_map_pool<fmmap_t> pool;
+    fmmap_t m = pool.acquire();
+    m.emplace(1, "a");
+    m.emplace(1, "b");
+    pool.recycle(std::move(m));
+    fmmap_t n = pool.acquire();
+    EXPECT_TRUE(n.empty());
+    n.emplace(2, "c");
+    EXPECT_EQ(n.count(2), 1u);
+    EXPECT_EQ(pool.reused_count(), 1u);
+}
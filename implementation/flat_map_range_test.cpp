@@ -0,0 +1,136 @@
+#include "flat_map_range"
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <string>
+#if USE_EXECUTION_POLICIES
+#include <execution>
+#endif
+#if USE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
+#endif
+
+// Test instantiations.
+template class std::flat_map_range<std::flat_map<int, std::string>>;
+template class std::flat_map_range<const std::flat_map<int, int>>;
+template class std::flat_map_chunks<std::flat_map<int, int>>;
+
+namespace {
+    struct split_t
+    {};
+    struct proportional_split_t
+    {
+        std::size_t left() const { return 1; }
+        std::size_t right() const { return 3; }
+    };
+
+    std::flat_map<int, int> make_map(int n)
+    {
+        std::flat_map<int, int> map;
+        for (int i = 0; i < n; ++i) {
+            map.emplace(i * 2, i);
+        }
+        return map;
+    }
+
+    template<typename Range>
+    long long sum_values(Range const & r)
+    {
+        long long sum = 0;
+        for (auto const & e : r) {
+            sum += e.second;
+        }
+        return sum;
+    }
+}
+
+TEST(flat_map_range, split)
+{
+    auto const map = make_map(1000);
+    using range_t = std::flat_map_range<const std::flat_map<int, int>>;
+    static_assert(range_t::alignment == 16, "");
+
+    range_t lower(map, 10);
+    EXPECT_EQ(lower.size(), 1000u);
+    EXPECT_TRUE(lower.is_divisible());
+    range_t upper(lower, split_t{});
+    // The split point 500 is rounded to a multiple of 16 elements.
+    EXPECT_EQ(lower.first_index(), 0u);
+    EXPECT_EQ(lower.last_index(), 496u);
+    EXPECT_EQ(upper.first_index(), 496u);
+    EXPECT_EQ(upper.last_index(), 1000u);
+    EXPECT_EQ(upper.begin()->first, 992);
+    EXPECT_EQ(upper.end(), map.end());
+    EXPECT_EQ(sum_values(lower) + sum_values(upper), 999 * 1000 / 2);
+
+    range_t quarter(upper, proportional_split_t{});
+    EXPECT_EQ(upper.last_index(), quarter.first_index());
+    EXPECT_EQ(quarter.first_index(), 624u);
+
+    // Small ranges split exactly, into nonempty parts.
+    range_t small(map, 3, 6, 1);
+    range_t small_upper(small, split_t{});
+    EXPECT_EQ(small.size() + small_upper.size(), 3u);
+    EXPECT_FALSE(small.empty());
+    EXPECT_FALSE(small_upper.empty());
+    range_t tiny(map, 5, 7, 1);
+    range_t tiny_upper(tiny, proportional_split_t{});
+    EXPECT_EQ(tiny.size(), 1u);
+    EXPECT_EQ(tiny_upper.size(), 1u);
+    EXPECT_FALSE(tiny_upper.is_divisible());
+
+    // Ranges over a non-const map give mutable elements.
+    auto mutable_map = map;
+    std::flat_map_range all(mutable_map);
+    for (auto e : all) {
+        e.second = 1;
+    }
+    EXPECT_EQ(sum_values(mutable_map), 1000);
+}
+
+TEST(flat_map_range, chunks)
+{
+    auto map = make_map(1000);
+    std::flat_map_chunks chunks(map, 100);
+    EXPECT_EQ(chunks.chunk_size(), 112u);
+    EXPECT_EQ(chunks.size(), 9u);
+    EXPECT_EQ(chunks.end() - chunks.begin(), 9);
+    EXPECT_EQ(chunks[8].size(), 1000u - 8 * 112u);
+    std::size_t expected_first = 0;
+    for (auto chunk : chunks) {
+        EXPECT_EQ(chunk.first_index(), expected_first);
+        expected_first = chunk.last_index();
+    }
+    EXPECT_EQ(expected_first, 1000u);
+
+    std::flat_map<int, int> empty;
+    EXPECT_TRUE(std::flat_map_chunks(empty, 10).empty());
+    using chunks_t = std::flat_map_chunks<std::flat_map<int, int>>;
+    EXPECT_TRUE(chunks_t().empty());
+
+#if USE_EXECUTION_POLICIES
+    std::for_each(
+        std::execution::par, chunks.begin(), chunks.end(), [](auto chunk) {
+            for (auto e : chunk) {
+                e.second *= 2;
+            }
+        });
+    EXPECT_EQ(sum_values(map), 999 * 1000);
+#endif
+}
+
+#if USE_TBB
+TEST(flat_map_range, tbb)
+{
+    auto const map = make_map(100000);
+    using range_t = std::flat_map_range<const std::flat_map<int, int>>;
+    long long const sum = tbb::parallel_reduce(
+        range_t(map, 1000),
+        0ll,
+        [](range_t const & r, long long init) { return init + sum_values(r); },
+        std::plus<>());
+    EXPECT_EQ(sum, 99999ll * 100000 / 2);
+}
+#endif
@@ -0,0 +1,189 @@
+#include "flat_map_sender"
+
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // A scheduler whose work runs, in order, on one thread of its own.
+    class worker_thread
+    {
+    public:
+        worker_thread() : thread_([this] { run(); }) {}
+        ~worker_thread()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_ = true;
+            }
+            cv_.notify_one();
+            thread_.join();
+        }
+
+        std::thread::id id() const { return thread_.get_id(); }
+
+        template<class Receiver>
+        struct operation
+        {
+            worker_thread * worker;
+            Receiver r;
+
+            void start() & noexcept
+            {
+                worker->post([this] { std::move(r).set_value(); });
+            }
+        };
+        struct sender
+        {
+            worker_thread * worker;
+
+            template<class Receiver>
+            operation<Receiver> connect(Receiver r) &&
+            {
+                return {worker, std::move(r)};
+            }
+        };
+        struct scheduler
+        {
+            worker_thread * worker;
+
+            sender schedule() const { return {worker}; }
+        };
+
+        scheduler get_scheduler() { return {this}; }
+
+    private:
+        void post(std::function<void()> f)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                queue_.push_back(std::move(f));
+            }
+            cv_.notify_one();
+        }
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true) {
+                cv_.wait(lock, [this] { return done_ || !queue_.empty(); });
+                if (queue_.empty())
+                    return;
+                auto f = std::move(queue_.front());
+                queue_.pop_front();
+                lock.unlock();
+                f();
+                lock.lock();
+            }
+        }
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<std::function<void()>> queue_;
+        bool done_ = false;
+        std::thread thread_;
+    };
+
+    // A receiver that fulfils a promise, to wait for a sender with.
+    template<class T>
+    struct promise_receiver
+    {
+        std::promise<T> * p;
+        std::thread::id * id;
+
+        template<class... U>
+        void set_value(U &&... u) && noexcept
+        {
+            *id = std::this_thread::get_id();
+            p->set_value(std::forward<U>(u)...);
+        }
+        void set_error(std::exception_ptr e) && noexcept
+        {
+            p->set_exception(e);
+        }
+        void set_stopped() && noexcept {}
+    };
+
+    template<class Sender>
+    auto sync_wait(Sender && s, std::thread::id * id)
+    {
+        using value_type = typename std::decay_t<Sender>::value_type;
+        std::promise<value_type> p;
+        auto op = std::forward<Sender>(s).connect(
+            promise_receiver<value_type>{&p, id});
+        op.start();
+        return p.get_future().get();
+    }
+}
+
+TEST(std_flat_map_sender, bulk_operations)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    worker_thread worker;
+    auto const sch = worker.get_scheduler();
+    std::thread::id id;
+
+    std::vector<int> keys;
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i) {
+        keys.push_back((i * 7) % 1000);
+        values.push_back(i);
+    }
+    fmap_t map = sync_wait(std::async_build<fmap_t>(sch, keys, values), &id);
+    EXPECT_EQ(id, worker.id());
+    EXPECT_EQ(map, fmap_t(keys, values));
+
+    std::vector<std::pair<int, int>> pairs = {{-1, 1}, {2000, 2}, {0, 3}};
+    sync_wait(std::async_insert(sch, map, pairs.begin(), pairs.end()), &id);
+    EXPECT_EQ(map.size(), 1002u);
+    EXPECT_EQ(map[0], 0);
+
+    fmap_t source = {{-1, 5}, {-2, 6}};
+    sync_wait(std::async_merge(sch, map, source), &id);
+    EXPECT_EQ(map.size(), 1003u);
+    EXPECT_EQ(source, fmap_t({{-1, 5}}));
+
+    auto const erased = sync_wait(
+        std::async_erase_if(
+            sch, map, [](auto const & x) { return x.first % 2 != 0; }),
+        &id);
+    EXPECT_EQ(erased, 501u);
+    EXPECT_EQ(map.size(), 502u);
+
+    std::vector<int> const probes = {4, 5, 2000, -2};
+    std::vector<fmap_t::iterator> found(probes.size());
+    auto const last = sync_wait(
+        std::async_find_many(
+            sch, map, probes.begin(), probes.end(), found.begin()),
+        &id);
+    EXPECT_EQ(last, found.end());
+    EXPECT_EQ(found[0], map.find(4));
+    EXPECT_EQ(found[1], map.end());
+    EXPECT_EQ(found[2], map.find(2000));
+    EXPECT_EQ(found[3], map.find(-2));
+    EXPECT_EQ(id, worker.id());
+}
+
+TEST(std_flat_map_sender, errors)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    worker_thread worker;
+    std::thread::id id;
+    fmap_t map = {{1, 1}, {2, 2}};
+    auto s = std::async_erase_if(
+        worker.get_scheduler(), map, [](auto const & x) -> bool {
+            if (x.first == 2)
+                throw std::runtime_error("bad element");
+            return false;
+        });
+    EXPECT_THROW(sync_wait(std::move(s), &id), std::runtime_error);
+}
@@ -0,0 +1,92 @@
+#include "flat_map_text_loader"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+
+// Test instantiations.
+template std::flat_map<int, double>
+std::load_text<std::flat_map<int, double>, std::inline_executor>(
+    std::inline_executor &,
+    char const *,
+    char const *,
+    std::text_load_options const &,
+    std::less<int> const &);
+
+TEST(std_flat_map_text_loader, parses)
+{
+    std::inline_executor serial;
+    std::string const text =
+        "id\tscore\n"
+        "3\t1.5\textra\n"
+        "\n"
+        "-1\t2\r\n"
+        "3\t9\n"
+        "7\t-0.25";
+    std::text_load_options opts;
+    opts.header = true;
+    auto const m = std::load_text<std::flat_map<int, double>>(
+        serial, text.data(), text.data() + text.size(), opts);
+    EXPECT_EQ(m, (std::flat_map<int, double>{{-1, 2}, {3, 1.5}, {7, -0.25}}));
+
+    // Strings are copied from the fields, and other delimiters work.
+    std::string const csv = "b,x\na,yy\nb,z\n";
+    opts = std::text_load_options();
+    opts.delimiter = ',';
+    auto const s = std::load_text<std::flat_map<std::string, std::string>>(
+        serial, csv.data(), csv.data() + csv.size(), opts);
+    EXPECT_EQ(
+        s,
+        (std::flat_map<std::string, std::string>{{"a", "yy"}, {"b", "x"}}));
+
+    auto const empty = std::load_text<std::flat_map<int, int>>(
+        serial, csv.data(), csv.data());
+    EXPECT_TRUE(empty.empty());
+
+    std::string const bad = "1\t2\n2\tx\n";
+    try {
+        std::load_text<std::flat_map<int, int>>(
+            serial, bad.data(), bad.data() + bad.size());
+        ADD_FAILURE();
+    } catch (std::runtime_error const & e) {
+        EXPECT_EQ(
+            std::string(e.what()), "Malformed line at byte 4 of text input");
+    }
+    std::string const short_line = "1\n";
+    EXPECT_THROW(
+        (std::load_text<std::flat_map<int, int>>(
+            serial, short_line.data(), short_line.data() + short_line.size())),
+        std::runtime_error);
+}
+
+TEST(std_flat_map_text_loader, parallel_file)
+{
+    char const * const path = "flat_map_text_loader_test.tsv";
+    std::map<long, long> expected;
+    {
+        std::ofstream out(path);
+        std::mt19937 gen(21);
+        for (int i = 0; i < 100000; ++i) {
+            long const k = long(gen() % 60000) - 30000;
+            long const v = long(gen());
+            out << k << '\t' << v << '\n';
+            expected.emplace(k, v);
+        }
+    }
+    std::work_stealing_executor ex(4);
+    std::text_load_options opts;
+    opts.chunk_size = 20000;
+    auto const m =
+        std::load_text_file<std::flat_map<long, long>>(ex, path, opts);
+    EXPECT_TRUE(
+        std::equal(m.begin(), m.end(), expected.begin(), expected.end()));
+    std::remove(path);
+
+    EXPECT_THROW(
+        (std::load_text_file<std::flat_map<long, long>>(ex, path)),
+        std::system_error);
+}
@@ -0,0 +1,76 @@
+#include "flat_map_view"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+// Test instantiations.
+template class std::flat_map_view<std::string, int>;
+
+namespace {
+    int sum_of(std::flat_map_view<int, int> view, int first, int last)
+    {
+        int sum = 0;
+        auto const range_last = view.lower_bound(last);
+        for (auto it = view.lower_bound(first); it != range_last; ++it) {
+            sum += it->second;
+        }
+        return sum;
+    }
+}
+
+TEST(std_flat_map_view, lookup)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    for (int size : {0, 1, 2, 17, 1000}) {
+        fmap_t map;
+        for (int i = 0; i < size; ++i) {
+            map.emplace(i * 2, i);
+        }
+        std::flat_map_view const view(map);
+
+        EXPECT_EQ(view.size(), map.size());
+        EXPECT_EQ(view.empty(), map.empty());
+        EXPECT_TRUE(
+            std::equal(view.begin(), view.end(), map.cbegin(), map.cend()));
+        EXPECT_TRUE(std::equal(
+            view.rbegin(), view.rend(), map.crbegin(), map.crend()));
+        for (int k = -2; k < size * 2 + 2; ++k) {
+            EXPECT_EQ(view.find(k) - view.begin(), map.find(k) - map.begin());
+            EXPECT_EQ(
+                view.lower_bound(k) - view.begin(),
+                map.lower_bound(k) - map.begin());
+            EXPECT_EQ(
+                view.upper_bound(k) - view.begin(),
+                map.upper_bound(k) - map.begin());
+            EXPECT_EQ(view.contains(k), map.contains(k));
+            auto const eq_range = view.equal_range(k);
+            EXPECT_EQ(
+                std::size_t(eq_range.second - eq_range.first), view.count(k));
+        }
+    }
+}
+
+TEST(std_flat_map_view, arrays_no_copies)
+{
+    std::string const keys[] = {"a", "b", "c"};
+    int const values[] = {1, 2, 3};
+    std::flat_map_view<std::string, int> const view(keys, values, 3);
+
+    EXPECT_EQ(view.at("b"), 2);
+    EXPECT_THROW(view.at("d"), std::out_of_range);
+    EXPECT_EQ(&view.find("c")->first, keys + 2);
+    EXPECT_EQ(&view.find("c")->second, values + 2);
+    EXPECT_EQ(view.key_data(), keys);
+    EXPECT_EQ(view.mapped_data(), values);
+
+    std::flat_map<std::string, int> const map = {{"a", 1}, {"b", 2}, {"c", 3}};
+    EXPECT_EQ(view, std::flat_map_view(map));
+    using view_t = std::flat_map_view<std::string, int>;
+    EXPECT_NE(view, view_t(keys, values, 2));
+
+    std::flat_map<int, int> const ints = {{1, 10}, {3, 30}, {5, 50}, {7, 70}};
+    EXPECT_EQ(sum_of(ints, 2, 6), 80);
+    EXPECT_EQ(sum_of(ints, 0, 100), 160);
+}
@@ -0,0 +1,188 @@
+#include "flat_set"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+
+// Test instantiations.
+template class std::flat_set<std::string>;
+template class std::flat_multiset<std::string>;
+
+TEST(std_flat_set, ctors_insert)
+{
+    using fset_t = std::flat_set<std::string>;
+
+    {
+        fset_t set = {"key2", "key0", "key1", "key0"};
+        std::vector<std::string> const expected = {"key0", "key1", "key2"};
+        EXPECT_TRUE(std::equal(
+            set.begin(), set.end(), expected.begin(), expected.end()));
+    }
+
+    {
+        fset_t set(std::vector<std::string>{"key1", "key1", "key0"});
+        EXPECT_EQ(set.size(), 2u);
+        EXPECT_EQ(*set.begin(), "key0");
+    }
+
+    {
+        fset_t set(std::sorted_unique, {"key0", "key1"});
+        EXPECT_EQ(set.size(), 2u);
+    }
+
+    {
+        fset_t set = {"key0", "key2"};
+        auto result = set.insert("key1");
+        EXPECT_TRUE(result.second);
+        EXPECT_EQ(result.first - set.begin(), 1);
+        result = set.emplace("key1");
+        EXPECT_FALSE(result.second);
+        EXPECT_EQ(result.first - set.begin(), 1);
+
+        auto it = set.insert(set.end(), "key3");
+        EXPECT_EQ(it - set.begin(), 3);
+        it = set.emplace_hint(set.end(), "key");
+        EXPECT_EQ(it - set.begin(), 0);
+
+        std::vector<std::string> const vec = {"key5", "key0", "key4", "key5"};
+        set.insert(vec.begin(), vec.end());
+        std::vector<std::string> const expected = {
+            "key", "key0", "key1", "key2", "key3", "key4", "key5"};
+        EXPECT_TRUE(std::equal(
+            set.begin(), set.end(), expected.begin(), expected.end()));
+
+        std::vector<std::string> c = std::move(set).extract();
+        EXPECT_EQ(c, expected);
+        EXPECT_TRUE(set.empty());
+        set.replace(std::move(c));
+        EXPECT_EQ(set.size(), 7u);
+    }
+}
+
+TEST(std_flat_set, lookup_erase)
+{
+    using fset_t = std::flat_set<int>;
+
+    fset_t set;
+    for (int i = 0; i < 100; i += 2) {
+        set.insert(i);
+    }
+    fset_t const & cset = set;
+
+    for (int k = -1; k < 101; ++k) {
+        auto const eq_range = set.equal_range(k);
+        EXPECT_EQ(eq_range.first, set.lower_bound(k));
+        EXPECT_EQ(eq_range.second, cset.upper_bound(k));
+        EXPECT_EQ(set.contains(k), 0 <= k && k < 100 && k % 2 == 0);
+        EXPECT_EQ(set.count(k), set.contains(k) ? 1u : 0u);
+        EXPECT_EQ(cset.find(k) != cset.end(), set.contains(k));
+    }
+
+    EXPECT_EQ(set.erase(4), 1u);
+    EXPECT_EQ(set.erase(4), 0u);
+    EXPECT_EQ(*set.erase(set.begin()), 2);
+    EXPECT_EQ(set.size(), 48u);
+
+    auto const multiple_of_4 = [](int x) { return x % 4 == 0; };
+    EXPECT_EQ(std::erase_if(set, multiple_of_4), 23u);
+    EXPECT_EQ(set.size(), 25u);
+    EXPECT_EQ(*set.begin(), 2);
+
+    fset_t other = {2, 6};
+    EXPECT_NE(set, other);
+    EXPECT_LT(other, set);
+    swap(set, other);
+    EXPECT_EQ(set.size(), 2u);
+}
+
+// Inserts sorted batches of random keys, which overlap the set and each
+// other, and checks the result against std::set.  Batches of 4-byte
+// integral keys are merged by the vector kernels, where the CPU has them.
+template<typename Key, typename Compare>
+void check_sorted_batches(Key lo, Key hi)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<Key> dist(lo, hi);
+    std::flat_set<Key, Compare> set;
+    std::set<Key, Compare> expected;
+    for (std::size_t n : {5u, 40u, 17u, 300u, 1000u, 64u, 3u, 5000u, 129u}) {
+        std::set<Key, Compare> batch;
+        while (batch.size() < n) {
+            batch.insert(dist(gen));
+        }
+        std::vector<Key> const v(batch.begin(), batch.end());
+        set.insert(std::sorted_unique, v.begin(), v.end());
+        expected.insert(batch.begin(), batch.end());
+        EXPECT_TRUE(std::equal(
+            set.begin(), set.end(), expected.begin(), expected.end()));
+    }
+
+    // A batch that sorts entirely after the set is appended as it is.
+    Key const last = Compare()(lo, hi) ? hi : lo;
+    std::vector<Key> tail;
+    for (Key k = *set.rbegin(); tail.size() < 20u && k != last;) {
+        k = Compare()(lo, hi) ? Key(k + 1) : Key(k - 1);
+        tail.push_back(k);
+    }
+    set.insert(std::sorted_unique, tail.begin(), tail.end());
+    expected.insert(tail.begin(), tail.end());
+    EXPECT_TRUE(std::equal(
+        set.begin(), set.end(), expected.begin(), expected.end()));
+}
+
+TEST(std_flat_set, sorted_batches)
+{
+    check_sorted_batches<int, std::less<int>>(-3000, 3000);
+    check_sorted_batches<std::int32_t, std::less<>>(-(1 << 30), 1 << 30);
+    check_sorted_batches<std::uint32_t, std::less<std::uint32_t>>(
+        0x7fffe000u, 0x80002000u);
+    check_sorted_batches<int, std::greater<int>>(-3000, 3000);
+    check_sorted_batches<std::uint32_t, std::greater<>>(0u, 20000u);
+    check_sorted_batches<long long, std::less<long long>>(-3000, 3000);
+}
+
+TEST(std_flat_multiset, ctors_insert)
+{
+    using fmset_t = std::flat_multiset<int>;
+
+    {
+        fmset_t set = {2, 0, 1, 0};
+        std::vector<int> const expected = {0, 0, 1, 2};
+        EXPECT_TRUE(std::equal(
+            set.begin(), set.end(), expected.begin(), expected.end()));
+    }
+
+    {
+        fmset_t set(std::sorted_equivalent, {0, 1, 1});
+        EXPECT_EQ(set.count(1), 2u);
+
+        auto it = set.insert(1);
+        EXPECT_EQ(it - set.begin(), 3);
+        it = set.emplace_hint(set.begin() + 1, 1);
+        EXPECT_EQ(it - set.begin(), 1);
+        it = set.emplace_hint(set.end(), 0);
+        EXPECT_EQ(it - set.begin(), 1);
+
+        std::vector<int> const vec = {3, 1, 0};
+        set.insert(vec.begin(), vec.end());
+        std::vector<int> const expected = {0, 0, 0, 1, 1, 1, 1, 1, 3};
+        EXPECT_TRUE(std::equal(
+            set.begin(), set.end(), expected.begin(), expected.end()));
+        EXPECT_EQ(set.count(1), 5u);
+        EXPECT_EQ(set.count(2), 0u);
+
+        auto const eq_range = set.equal_range(1);
+        EXPECT_EQ(eq_range.first - set.begin(), 3);
+        EXPECT_EQ(eq_range.second - set.begin(), 8);
+
+        EXPECT_EQ(set.erase(1), 5u);
+        EXPECT_EQ(set.size(), 4u);
+        auto const is_zero = [](int x) { return x == 0; };
+        EXPECT_EQ(std::erase_if(set, is_zero), 3u);
+        EXPECT_EQ(set.size(), 1u);
+    }
+}
@@ -0,0 +1,281 @@
+#include "frozen_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+
+// Test instantiations.
+template class std::frozen_flat_map<std::flat_map<std::string, int>>;
+template class std::frozen_flat_map<
+    std::flat_map<std::string, int>,
+    std::perfect_hash_layout>;
+template class std::frozen_flat_map<
+    std::flat_map<std::string, int>,
+    std::string_prefix_layout>;
+template class std::
+    frozen_flat_map<std::flat_map<float, int>, std::s_tree_layout>;
+
+TEST(std_frozen_flat_map, eytzinger_lookup)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    for (int size : {0, 1, 2, 3, 7, 8, 15, 16, 17, 100, 1000}) {
+        fmap_t::containers c;
+        for (int i = 0; i < size; ++i) {
+            c.keys.push_back(i * 2);
+            c.values.push_back(i);
+        }
+        fmap_t const map(std::sorted_unique, c.keys, c.values);
+        auto const frozen = std::freeze(map);
+
+        EXPECT_EQ(frozen.size(), map.size());
+        EXPECT_TRUE(std::equal(
+            frozen.begin(), frozen.end(), map.begin(), map.end()));
+        for (int k = -2; k < size * 2 + 2; ++k) {
+            EXPECT_EQ(
+                frozen.find(k) - frozen.begin(), map.find(k) - map.begin());
+            EXPECT_EQ(
+                frozen.lower_bound(k) - frozen.begin(),
+                map.lower_bound(k) - map.begin());
+            EXPECT_EQ(
+                frozen.upper_bound(k) - frozen.begin(),
+                map.upper_bound(k) - map.begin());
+            EXPECT_EQ(frozen.contains(k), map.contains(k));
+            auto const eq_range = frozen.equal_range(k);
+            EXPECT_EQ(
+                std::size_t(eq_range.second - eq_range.first), frozen.count(k));
+        }
+    }
+}
+
+TEST(std_frozen_flat_map, s_tree_lookup)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    // Sizes around the 16-key leaves and the 17-way inner nodes.
+    for (int size : {0, 1, 15, 16, 17, 33, 271, 272, 273, 4624, 4625, 5000}) {
+        fmap_t::containers c;
+        for (int i = 0; i < size; ++i) {
+            c.keys.push_back(i * 2);
+            c.values.push_back(i);
+        }
+        fmap_t const map(std::sorted_unique, c.keys, c.values);
+        auto const frozen = std::freeze<std::s_tree_layout>(map);
+
+        for (int k = -2; k < size * 2 + 2; ++k) {
+            ASSERT_EQ(
+                frozen.find(k) - frozen.begin(), map.find(k) - map.begin());
+            ASSERT_EQ(
+                frozen.lower_bound(k) - frozen.begin(),
+                map.lower_bound(k) - map.begin());
+            ASSERT_EQ(
+                frozen.upper_bound(k) - frozen.begin(),
+                map.upper_bound(k) - map.begin());
+        }
+    }
+}
+
+TEST(std_frozen_flat_map, s_tree_key_types)
+{
+    // The largest key equals the padding past the last leaf.
+    std::flat_map<std::uint32_t, int> u;
+    std::mt19937 gen(9);
+    for (int i = 0; i < 100000; ++i) {
+        u.emplace(std::uint32_t(gen()), i);
+    }
+    u.emplace(std::numeric_limits<std::uint32_t>::max(), -1);
+    u.emplace(0u, -2);
+    auto const frozen_u = std::freeze<std::s_tree_layout>(u);
+    for (int i = 0; i < 20000; ++i) {
+        std::uint32_t const k =
+            i < 4 ? std::uint32_t(-i) : std::uint32_t(gen());
+        ASSERT_EQ(
+            frozen_u.lower_bound(k) - frozen_u.begin(),
+            u.lower_bound(k) - u.begin());
+        ASSERT_EQ(
+            frozen_u.upper_bound(k) - frozen_u.begin(),
+            u.upper_bound(k) - u.begin());
+    }
+    for (auto const & x : u) {
+        ASSERT_EQ(frozen_u.at(x.first), x.second);
+    }
+
+    std::flat_map<float, int, std::greater<>> f;
+    for (int i = 0; i < 3000; ++i) {
+        f.emplace(float(i) * 0.5f - 100.0f, i);
+    }
+    auto const frozen_f = std::freeze<std::s_tree_layout>(f);
+    float const inf = std::numeric_limits<float>::infinity();
+    for (float k : {inf, -inf, 1000.0f, -101.0f, 0.25f, 0.5f, -100.0f}) {
+        EXPECT_EQ(
+            frozen_f.lower_bound(k) - frozen_f.begin(),
+            f.lower_bound(k) - f.begin());
+        EXPECT_EQ(
+            frozen_f.upper_bound(k) - frozen_f.begin(),
+            f.upper_bound(k) - f.begin());
+        EXPECT_EQ(frozen_f.contains(k), f.contains(k));
+    }
+}
+
+TEST(std_frozen_flat_map, perfect_hash_lookup)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    for (int size : {0, 1, 7, 8, 9, 16, 17, 100, 1000, 20000}) {
+        fmap_t::containers c;
+        for (int i = 0; i < size; ++i) {
+            c.keys.push_back(i * 2);
+            c.values.push_back(i);
+        }
+        fmap_t const map(std::sorted_unique, c.keys, c.values);
+        auto const frozen = std::freeze<std::perfect_hash_layout>(map);
+
+        EXPECT_EQ(frozen.size(), map.size());
+        EXPECT_TRUE(std::equal(
+            frozen.begin(), frozen.end(), map.begin(), map.end()));
+        for (int k = -2; k < size * 2 + 2; ++k) {
+            EXPECT_EQ(
+                frozen.find(k) - frozen.begin(), map.find(k) - map.begin());
+            EXPECT_EQ(
+                frozen.lower_bound(k) - frozen.begin(),
+                map.lower_bound(k) - map.begin());
+            EXPECT_EQ(
+                frozen.upper_bound(k) - frozen.begin(),
+                map.upper_bound(k) - map.begin());
+            EXPECT_EQ(frozen.contains(k), map.contains(k));
+        }
+    }
+
+    {
+        std::flat_map<std::string, int> map;
+        for (int i = 0; i < 500; ++i) {
+            map["symbol" + std::to_string(i * 3)] = i;
+        }
+        auto const frozen = std::freeze<std::perfect_hash_layout>(map);
+        for (int i = 0; i < 1500; ++i) {
+            std::string const key = "symbol" + std::to_string(i);
+            EXPECT_EQ(frozen.contains(key), i % 3 == 0);
+            if (i % 3 == 0) {
+                EXPECT_EQ(frozen.at(key), i / 3);
+            } else {
+                EXPECT_THROW(frozen.at(key), std::out_of_range);
+            }
+        }
+    }
+}
+
+TEST(std_frozen_flat_map, string_prefix_lookup)
+{
+    // Many keys tie on their first eight bytes, some are shorter than
+    // eight bytes, and some differ only by a trailing NUL.
+    std::vector<std::string> keys = {"", "a", "ab", std::string("ab\0", 3)};
+    for (int i = 0; i < 300; ++i) {
+        keys.push_back("/api/v1/users/" + std::to_string(i * 7));
+        keys.push_back("\xff" + std::to_string(i));
+        keys.push_back(std::to_string(i));
+    }
+    std::flat_map<std::string, int> map;
+    for (auto const & k : keys) {
+        map.emplace(k, int(map.size()));
+    }
+    auto const frozen = std::freeze<std::string_prefix_layout>(map);
+
+    std::vector<std::string> probes = keys;
+    for (auto const & k : keys) {
+        probes.push_back(k + "0");
+        if (!k.empty())
+            probes.push_back(k.substr(0, k.size() - 1));
+    }
+    for (auto const & k : probes) {
+        EXPECT_EQ(
+            frozen.find(k) - frozen.begin(), map.find(k) - map.begin());
+        EXPECT_EQ(
+            frozen.lower_bound(k) - frozen.begin(),
+            map.lower_bound(k) - map.begin());
+        EXPECT_EQ(
+            frozen.upper_bound(k) - frozen.begin(),
+            map.upper_bound(k) - map.begin());
+        EXPECT_EQ(frozen.contains(k), map.contains(k));
+    }
+    EXPECT_EQ(frozen.at("ab"), map.at("ab"));
+
+    // The bytes compared start after the prefix all the keys share.
+    std::flat_map<std::string, int> urls;
+    for (int i = 0; i < 200; ++i) {
+        urls.emplace("/api/v1/items/" + std::to_string(i * 3), i);
+    }
+    auto const frozen_urls = std::freeze<std::string_prefix_layout>(urls);
+    std::vector<std::string> url_probes = {
+        "", "/", "/api", "/api/v1/", "/api/v1/items/", "/api/v0/items/1",
+        "/api/v2/items/", "/b", "/api/v1/items/1", "/api/v1/items/10"};
+    for (int i = 0; i < 600; ++i) {
+        url_probes.push_back("/api/v1/items/" + std::to_string(i));
+    }
+    for (auto const & k : url_probes) {
+        EXPECT_EQ(
+            frozen_urls.find(k) - frozen_urls.begin(),
+            urls.find(k) - urls.begin());
+        EXPECT_EQ(
+            frozen_urls.lower_bound(k) - frozen_urls.begin(),
+            urls.lower_bound(k) - urls.begin());
+        EXPECT_EQ(
+            frozen_urls.upper_bound(k) - frozen_urls.begin(),
+            urls.upper_bound(k) - urls.begin());
+    }
+}
+
+// All keys share a hash value, so the index falls back to binary search.
+struct colliding
+{
+    int value;
+    friend bool operator<(colliding x, colliding y)
+    {
+        return x.value < y.value;
+    }
+    friend bool operator==(colliding x, colliding y)
+    {
+        return x.value == y.value;
+    }
+};
+
+namespace std {
+    template<>
+    struct hash<colliding>
+    {
+        size_t operator()(colliding) const { return 42; }
+    };
+}
+
+TEST(std_frozen_flat_map, perfect_hash_collisions)
+{
+    std::flat_map<colliding, int> map;
+    for (int i = 0; i < 100; ++i) {
+        map[colliding{i * 2}] = i;
+    }
+    auto const frozen = std::freeze<std::perfect_hash_layout>(map);
+    for (int k = -1; k < 201; ++k) {
+        EXPECT_EQ(frozen.count(colliding{k}), map.count(colliding{k}));
+        EXPECT_EQ(
+            frozen.find(colliding{k}) - frozen.begin(),
+            map.find(colliding{k}) - map.begin());
+    }
+}
+
+TEST(std_frozen_flat_map, at_thaw)
+{
+    using fmap_t = std::flat_map<std::string, int>;
+
+    fmap_t map = {{"key1", 1}, {"key2", 2}, {"key0", 0}};
+    fmap_t const map_copy = map;
+
+    auto frozen = std::freeze(std::move(map));
+    EXPECT_EQ(frozen.at("key0"), 0);
+    EXPECT_EQ(frozen.at("key2"), 2);
+    EXPECT_THROW(frozen.at("bar"), std::out_of_range);
+
+    fmap_t thawed = std::move(frozen).thaw();
+    EXPECT_EQ(thawed, map_copy);
+}
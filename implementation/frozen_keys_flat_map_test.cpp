@@ -0,0 +1,151 @@
+#include "frozen_keys_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+namespace {
+    struct wide
+    {
+        long a;
+        long b;
+        long c;
+
+        wide operator+(wide const & other) const
+        {
+            return {a + other.a, b + other.b, c + other.c};
+        }
+        bool operator==(wide const & other) const
+        {
+            return a == other.a && b == other.b && c == other.c;
+        }
+    };
+}
+
+// Test instantiations.
+template class std::frozen_keys_flat_map<std::flat_map<int, long>>;
+template class std::frozen_keys_flat_map<std::flat_map<std::string, double>>;
+template class std::frozen_keys_flat_map<std::flat_map<int, wide>>;
+template class std::frozen_keys_flat_map<
+    std::flat_map<int, long>,
+    std::seqlock_value<long>>;
+
+TEST(std_frozen_keys_flat_map, slots)
+{
+    using atomic_slot_t =
+        std::frozen_keys_flat_map<std::flat_map<int, long>>::slot_type;
+    using seqlock_slot_t =
+        std::frozen_keys_flat_map<std::flat_map<int, wide>>::slot_type;
+    EXPECT_TRUE(
+        (std::is_same<atomic_slot_t, std::atomic_value<long>>::value));
+    EXPECT_TRUE(
+        (std::is_same<seqlock_slot_t, std::seqlock_value<wide>>::value));
+}
+
+TEST(std_frozen_keys_flat_map, lookup)
+{
+    std::flat_map<std::string, double> m;
+    m["a"] = 1.0;
+    m["c"] = 3.0;
+    m["e"] = 5.0;
+    std::frozen_keys_flat_map<std::flat_map<std::string, double>> frozen(m);
+
+    EXPECT_EQ(frozen.size(), 3u);
+    EXPECT_EQ(frozen.keys(), m.keys());
+    EXPECT_EQ(frozen.index_of("c"), 1u);
+    EXPECT_EQ(frozen.index_of("d"), 3u);
+    EXPECT_EQ(frozen.find("b"), nullptr);
+    EXPECT_TRUE(frozen.contains("e"));
+    EXPECT_FALSE(frozen.contains("f"));
+    EXPECT_EQ(frozen.load("a"), 1.0);
+    EXPECT_EQ(frozen.load("b"), std::nullopt);
+
+    EXPECT_TRUE(frozen.store("a", 10.0));
+    EXPECT_FALSE(frozen.store("b", 20.0));
+    EXPECT_TRUE(frozen.update("c", [](double x) { return x * 2; }));
+    EXPECT_EQ(frozen.find("e")->fetch_add(0.5), 5.0);
+    EXPECT_EQ(frozen.slot(2).load(), 5.5);
+
+    auto const copy = frozen.snapshot();
+    auto const thawed = std::move(frozen).thaw();
+    EXPECT_EQ(copy, thawed);
+    EXPECT_EQ(thawed.at("a"), 10.0);
+    EXPECT_EQ(thawed.at("c"), 6.0);
+    EXPECT_EQ(thawed.at("e"), 5.5);
+    EXPECT_EQ(thawed.size(), 3u);
+}
+
+TEST(std_frozen_keys_flat_map, concurrent_counters)
+{
+    std::flat_map<int, long> m;
+    for (int i = 0; i < 100; ++i) {
+        m[i * 3] = 0;
+    }
+    std::frozen_keys_flat_map<std::flat_map<int, long>> counters(m);
+
+    constexpr int threads = 4;
+    constexpr int increments = 20000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < increments; ++i) {
+                counters.find((i + t) % 100 * 3)->fetch_add(1);
+                counters.update(
+                    (i * 7 + t) % 100 * 3, [](long x) { return x + 1; });
+            }
+        });
+    }
+    for (auto & w : workers) {
+        w.join();
+    }
+
+    long total = 0;
+    for (auto const & x : counters.snapshot()) {
+        total += x.second;
+    }
+    EXPECT_EQ(total, 2L * threads * increments);
+}
+
+TEST(std_frozen_keys_flat_map, seqlock_reads_are_never_torn)
+{
+    std::flat_map<int, wide> m;
+    for (int i = 0; i < 8; ++i) {
+        m[i] = wide{0, 0, 0};
+    }
+    std::frozen_keys_flat_map<std::flat_map<int, wide>> frozen(m);
+
+    // Writers keep a == b == c in every slot; readers must never see a
+    // value that breaks that.
+    constexpr int writes = 20000;
+    std::atomic<bool> torn{false};
+    std::atomic<int> writers_done{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 2; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < writes; ++i) {
+                if (i % 2) {
+                    frozen.find(i % 8)->fetch_add(wide{1, 1, 1});
+                } else {
+                    frozen.store(i % 8, wide{i + t, i + t, i + t});
+                }
+            }
+            ++writers_done;
+        });
+    }
+    for (int t = 0; t < 2; ++t) {
+        workers.emplace_back([&] {
+            while (writers_done < 2) {
+                for (int k = 0; k < 8; ++k) {
+                    wide const w = *frozen.load(k);
+                    if (w.a != w.b || w.b != w.c)
+                        torn = true;
+                }
+            }
+        });
+    }
+    for (auto & w : workers) {
+        w.join();
+    }
+    EXPECT_FALSE(torn);
+}
@@ -0,0 +1,138 @@
+#include "hot_cold_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace {
+    struct header
+    {
+        int version;
+        int flags;
+
+        bool operator==(header const & other) const
+        {
+            return version == other.version && flags == other.flags;
+        }
+    };
+
+    struct payload
+    {
+        std::array<char, 184> bytes;
+        std::string name;
+
+        bool operator==(payload const & other) const
+        {
+            return bytes == other.bytes && name == other.name;
+        }
+    };
+
+    bool cold_copies_throw = false;
+
+    struct throwing_cold
+    {
+        throwing_cold(int x) : x(x) {}
+        throwing_cold(throwing_cold const & other) : x(other.x)
+        {
+            if (cold_copies_throw)
+                throw std::runtime_error("cold");
+        }
+        throwing_cold & operator=(throwing_cold const &) = default;
+        int x;
+    };
+}
+
+// Test instantiations.
+template class std::hot_cold_flat_map<int, header, payload>;
+template class std::
+    hot_cold_flat_map<std::string, int, std::string, std::less<>>;
+
+TEST(std_hot_cold_flat_map, columns_stay_in_step)
+{
+    using map_t = std::hot_cold_flat_map<int, header, payload>;
+    static_assert(std::is_same<
+                  map_t::iterator,
+                  std::flat_map<int, header>::iterator>::value);
+
+    map_t map;
+    std::map<int, std::pair<header, std::string>> reference;
+    std::mt19937 gen(42);
+    for (int i = 0; i < 4000; ++i) {
+        int const key = int(gen() % 300);
+        header const h{i, int(gen() % 8)};
+        payload const p{{}, std::to_string(i)};
+        switch (gen() % 3) {
+        case 0:
+            EXPECT_EQ(
+                map.try_emplace(key, h, p).second,
+                reference.try_emplace(key, h, p.name).second);
+            break;
+        case 1:
+            map.insert_or_assign(key, h, p);
+            reference.insert_or_assign(key, std::make_pair(h, p.name));
+            break;
+        default:
+            EXPECT_EQ(map.erase(key), reference.erase(key));
+            break;
+        }
+    }
+    ASSERT_EQ(map.size(), reference.size());
+    ASSERT_EQ(map.cold_values().size(), reference.size());
+    auto ref_it = reference.begin();
+    for (auto it = map.begin(); it != map.end(); ++it, ++ref_it) {
+        EXPECT_EQ(it->first, ref_it->first);
+        EXPECT_EQ(it->second, ref_it->second.first);
+        EXPECT_EQ(map.cold(it).name, ref_it->second.second);
+    }
+
+    int const key = reference.begin()->first;
+    EXPECT_EQ(map.at(key), reference.begin()->second.first);
+    map.cold_at(key).name = "renamed";
+    EXPECT_EQ(map.cold(map.find(key)).name, "renamed");
+    EXPECT_THROW(map.cold_at(-1), std::out_of_range);
+    EXPECT_THROW(map.at(-1), std::out_of_range);
+    EXPECT_TRUE(map.contains(key));
+    EXPECT_EQ(map.lower_bound(key), map.begin());
+
+    map_t copy = map;
+    EXPECT_EQ(copy, map);
+    copy.cold(copy.begin()).name = "changed";
+    EXPECT_NE(copy, map);
+    copy.clear();
+    swap(copy, map);
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(copy.size(), reference.size());
+}
+
+TEST(std_hot_cold_flat_map, heterogeneous_lookup)
+{
+    std::hot_cold_flat_map<std::string, int, std::string, std::less<>> map;
+    map.try_emplace("b", 2, "bee");
+    map.try_emplace("a", 1, "ay");
+    std::string_view const b = "b";
+    EXPECT_TRUE(map.contains(b));
+    EXPECT_EQ(map.count(b), 1u);
+    EXPECT_EQ(map.cold(map.find(b)), "bee");
+    EXPECT_EQ(map.equal_range(b).first, map.begin() + 1);
+    EXPECT_EQ(map.upper_bound(b), map.end());
+}
+
+TEST(std_hot_cold_flat_map, cold_throw_undoes_insertion)
+{
+    std::hot_cold_flat_map<int, int, throwing_cold> map;
+    map.try_emplace(1, 1, throwing_cold(1));
+    map.try_emplace(3, 3, throwing_cold(3));
+
+    throwing_cold const cold(2);
+    cold_copies_throw = true;
+    EXPECT_THROW(map.try_emplace(2, 2, cold), std::runtime_error);
+    cold_copies_throw = false;
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(map.cold_values().size(), 2u);
+    EXPECT_FALSE(map.contains(2));
+    EXPECT_EQ(map.cold_at(3).x, 3);
+}
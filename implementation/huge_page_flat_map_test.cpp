@@ -0,0 +1,79 @@
+#include "huge_page_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+// Test instantiations.
+template class std::huge_page_allocator<int>;
+template class std::flat_map<
+    int,
+    std::string,
+    std::less<int>,
+    std::vector<int, std::huge_page_allocator<int>>,
+    std::vector<std::string, std::huge_page_allocator<std::string>>>;
+
+TEST(std_huge_page_flat_map, large_and_small_allocations)
+{
+    std::huge_page_policy policy;
+    policy.threshold = 1 << 16;
+    policy.node = 0;
+    std::huge_page_allocator<char> const alloc(policy);
+
+    std::huge_page_flat_map<int, int> map(alloc);
+    EXPECT_EQ(map.keys().get_allocator().policy().threshold, 1u << 16);
+    EXPECT_EQ(map.values().get_allocator().policy().node, 0);
+
+    // The first inserts come from operator new, the later ones from
+    // mapped pages.
+    for (int i = 0; i < 100000; ++i) {
+        map.emplace_hint(map.end(), i, -i);
+    }
+    EXPECT_EQ(map.size(), 100000u);
+    EXPECT_EQ(map.at(77777), -77777);
+    EXPECT_EQ(
+        reinterpret_cast<std::uintptr_t>(map.keys().data()) % 4096, 0u);
+
+    map.erase(map.begin() + 10, map.end());
+    map.shrink_to_fit();
+    EXPECT_EQ(map.size(), 10u);
+    EXPECT_EQ(map.at(9), -9);
+
+    std::huge_page_policy interleaved;
+    interleaved.threshold = 0;
+    interleaved.interleave = true;
+    interleaved.hugetlb = true;
+    std::huge_page_allocator<int> ia(interleaved);
+    int * const p = ia.allocate(3);
+    p[2] = 42;
+    EXPECT_EQ(p[2], 42);
+    ia.deallocate(p, 3);
+    EXPECT_NE(ia, std::huge_page_allocator<int>());
+}
+
+TEST(std_huge_page_flat_map, numa_replicas)
+{
+    std::flat_map<int, std::string> source;
+    for (int i = 0; i < 1000; ++i) {
+        source.emplace(i * 2, std::to_string(i));
+    }
+    EXPECT_LE(1, std::numa_node_count());
+
+    std::numa_replicated_flat_map<int, std::string> const replicated(
+        source, 3);
+    EXPECT_EQ(replicated.replicas(), 3);
+    for (int node = 0; node < 3; ++node) {
+        auto const & replica = replicated.replica(node);
+        EXPECT_EQ(replica.size(), source.size());
+        EXPECT_EQ(replica.keys().get_allocator().policy().node, node);
+        EXPECT_EQ(replica.at(500), "250");
+    }
+    EXPECT_NE(
+        replicated.replica(0).keys().data(),
+        replicated.replica(1).keys().data());
+    EXPECT_EQ(replicated.at(1998), "999");
+    EXPECT_TRUE(replicated.contains(4));
+    EXPECT_FALSE(replicated.contains(5));
+    EXPECT_EQ(replicated.find(5), replicated.local().end());
+    EXPECT_EQ(replicated.size(), 1000u);
+}
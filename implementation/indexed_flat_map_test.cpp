@@ -0,0 +1,205 @@
+#include "indexed_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    struct order
+    {
+        int price;
+        int quantity;
+        std::string owner;
+
+        int notional() const { return price * quantity; }
+
+        friend bool operator==(order const & lhs, order const & rhs)
+        {
+            return lhs.price == rhs.price && lhs.quantity == rhs.quantity &&
+                   lhs.owner == rhs.owner;
+        }
+    };
+
+    using orders_t = std::indexed_flat_map<
+        std::flat_map<int, order>,
+        std::mapped_index<&order::price>,
+        std::mapped_index<&order::quantity, std::greater<>>,
+        std::mapped_index<&order::notional>>;
+
+    // Checks an index against a stable sort of the map's positions.
+    template<std::size_t I, class Map, class Less>
+    bool index_valid(Map const & map, Less less)
+    {
+        std::vector<std::size_t> expected(map.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            expected[i] = i;
+        }
+        auto const & values = map.map().values();
+        std::stable_sort(
+            expected.begin(),
+            expected.end(),
+            [&](std::size_t i, std::size_t j) {
+                return less(values[i], values[j]);
+            });
+        return map.template index<I>() == expected;
+    }
+
+    bool indexes_valid(orders_t const & map)
+    {
+        return index_valid<0>(
+                   map,
+                   [](order const & x, order const & y) {
+                       return x.price < y.price;
+                   }) &&
+               index_valid<1>(
+                   map,
+                   [](order const & x, order const & y) {
+                       return x.quantity > y.quantity;
+                   }) &&
+               index_valid<2>(map, [](order const & x, order const & y) {
+                   return x.notional() < y.notional();
+               });
+    }
+}
+
+// Test instantiations.
+template class std::indexed_flat_map<
+    std::flat_map<int, order>,
+    std::mapped_index<&order::price>,
+    std::mapped_index<&order::quantity, std::greater<>>,
+    std::mapped_index<&order::notional>>;
+
+TEST(std_indexed_flat_map, lookups)
+{
+    orders_t map = {
+        {1, {10, 5, "a"}},
+        {2, {12, 1, "b"}},
+        {3, {10, 2, "c"}},
+        {4, {11, 5, "d"}}};
+    static_assert(orders_t::index_count == 3);
+    EXPECT_TRUE(indexes_valid(map));
+
+    EXPECT_EQ(map.find_by<0>(10)->first, 1);
+    EXPECT_EQ(map.count_by<0>(10), 2u);
+    EXPECT_EQ(map.find_by<0>(13), map.end());
+    EXPECT_EQ(map.find_by<1>(5)->first, 1);
+    EXPECT_EQ(map.count_by<1>(5), 2u);
+    EXPECT_EQ(map.find_by<2>(20)->first, 3);
+    EXPECT_EQ(map.count_by<2>(12), 1u);
+
+    // The orders priced from 10 to 11, cheapest first.
+    std::vector<int> keys;
+    for (auto it = map.lower_bound_by<0>(10); it != map.upper_bound_by<0>(11);
+         ++it) {
+        keys.push_back(map.begin()[*it].first);
+    }
+    EXPECT_EQ(keys, (std::vector<int>{1, 3, 4}));
+
+    // modify() moves the element in every index.
+    map.modify(map.find(2), [](order & o) {
+        o.price = 9;
+        o.quantity = 6;
+    });
+    EXPECT_TRUE(indexes_valid(map));
+    EXPECT_EQ(map.find_by<0>(9)->first, 2);
+    EXPECT_EQ(map.find_by<1>(6)->first, 2);
+    EXPECT_EQ(map.find_by<2>(54)->first, 2);
+    EXPECT_EQ(map.find_by<2>(12), map.end());
+
+    EXPECT_FALSE(map.insert_or_assign(3, order{20, 1, "c"}).second);
+    EXPECT_EQ(map.find_by<0>(20)->first, 3);
+    EXPECT_EQ(map.erase(1), 1u);
+    EXPECT_EQ(map.count_by<0>(10), 0u);
+    EXPECT_TRUE(indexes_valid(map));
+
+    std::flat_map<int, order> source = {{0, {1, 1, "z"}}, {3, {0, 0, "y"}}};
+    map.merge(source);
+    EXPECT_EQ(source.size(), 1u);
+    EXPECT_EQ(map.find_by<0>(1)->first, 0);
+    EXPECT_TRUE(indexes_valid(map));
+
+    auto const cheap = [](auto const & x) { return x.second.price < 15; };
+    EXPECT_EQ(erase_if(map, cheap), 3u);
+    EXPECT_TRUE(indexes_valid(map));
+    EXPECT_EQ(map.size(), 1u);
+    EXPECT_EQ(map.begin()->second.owner, "c");
+}
+
+TEST(std_indexed_flat_map, random_operations)
+{
+    orders_t map;
+    std::map<int, order> std_map;
+    std::mt19937 gen(23);
+    auto const random_order = [&] {
+        return order{int(gen() % 40), int(gen() % 10), "x"};
+    };
+    for (int i = 0; i < 4000; ++i) {
+        int const k = int(gen() % 400);
+        switch (gen() % 6) {
+        case 0:
+        case 1: {
+            order const o = random_order();
+            EXPECT_EQ(
+                map.try_emplace(k, o).second, std_map.try_emplace(k, o).second);
+            break;
+        }
+        case 2: {
+            order const o = random_order();
+            map.insert_or_assign(k, o);
+            std_map[k] = o;
+            break;
+        }
+        case 3:
+            EXPECT_EQ(map.erase(k), std_map.erase(k));
+            break;
+        case 4: {
+            std::vector<std::pair<int, order>> elements;
+            for (int j = 0; j < 10; ++j) {
+                elements.emplace_back(int(gen() % 400), random_order());
+            }
+            map.insert(elements.begin(), elements.end());
+            std_map.insert(elements.begin(), elements.end());
+            break;
+        }
+        case 5: {
+            auto const it = map.find(k);
+            if (it != map.end()) {
+                int const price = int(gen() % 40);
+                map.modify(it, [&](order & o) { o.price = price; });
+                std_map[k].price = price;
+            }
+            break;
+        }
+        }
+        if (i % 200 == 0) {
+            ASSERT_TRUE(indexes_valid(map));
+        }
+    }
+    EXPECT_TRUE(indexes_valid(map));
+    EXPECT_TRUE(std::equal(
+        map.begin(),
+        map.end(),
+        std_map.begin(),
+        std_map.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second == y.second;
+        }));
+    for (int price = 0; price < 40; ++price) {
+        std::size_t n = 0;
+        int first = -1;
+        for (auto const & x : std_map) {
+            if (x.second.price == price) {
+                if (!n)
+                    first = x.first;
+                ++n;
+            }
+        }
+        EXPECT_EQ(map.count_by<0>(price), n);
+        auto const it = map.find_by<0>(price);
+        EXPECT_EQ(it == map.end() ? -1 : it->first, first);
+    }
+}
@@ -0,0 +1,123 @@
+#include "lazy_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Test instantiations.
+template class std::lazy_flat_map<std::flat_map<int, double>>;
+template class std::lazy_flat_map<
+    std::flat_map<std::string, int, std::greater<>>>;
+
+TEST(std_lazy_flat_map, sorts_on_first_query)
+{
+    using fmap_t = std::flat_map<int, std::string>;
+    std::lazy_flat_map<fmap_t> map(
+        {5, 1, 3, 1, 5, 2}, {"five", "one", "three", "uno", "cinco", "two"});
+    EXPECT_FALSE(map.is_sorted_state());
+    EXPECT_FALSE(map.empty());
+    EXPECT_FALSE(map.is_sorted_state());
+
+    // Visiting in the order held does not sort.
+    std::vector<int> seen;
+    map.for_each_unordered(
+        [&](int k, std::string const &) { seen.push_back(k); });
+    EXPECT_EQ(seen, (std::vector<int>{5, 1, 3, 1, 5, 2}));
+    EXPECT_FALSE(map.is_sorted_state());
+
+    // The first lookup sorts, keeping the first of each key.
+    EXPECT_TRUE(map.contains(3));
+    EXPECT_TRUE(map.is_sorted_state());
+    EXPECT_EQ(
+        map.map(),
+        (fmap_t{{1, "one"}, {2, "two"}, {3, "three"}, {5, "five"}}));
+    EXPECT_EQ(map.size(), 4u);
+
+    seen.clear();
+    map.for_each_unordered(
+        [&](int k, std::string const &) { seen.push_back(k); });
+    EXPECT_EQ(seen, (std::vector<int>{1, 2, 3, 5}));
+
+    map.try_emplace(4, "four");
+    map.insert_or_assign(1, "ein");
+    EXPECT_EQ(map.erase(2), 1u);
+    EXPECT_EQ(map.at(1), "ein");
+    EXPECT_EQ(map.begin()->first, 1);
+    EXPECT_EQ(map.rbegin()->first, 5);
+    EXPECT_EQ(map.lower_bound(2)->first, 3);
+    EXPECT_THROW(map.at(2), std::out_of_range);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.is_sorted_state());
+}
+
+TEST(std_lazy_flat_map, pass_through)
+{
+    using fmap_t = std::flat_map<int, int, std::greater<int>>;
+    std::vector<int> keys = {3, 9, 1, 3};
+    std::vector<int> values = {30, 90, 10, 31};
+
+    // A map that is only forwarded gives back its containers as given.
+    std::lazy_flat_map<fmap_t> map(keys, values);
+    std::vector<std::pair<int, int>> more = {{7, 70}, {9, 91}};
+    map.insert(more.begin(), more.end());
+    EXPECT_FALSE(map.is_sorted_state());
+    std::lazy_flat_map<fmap_t> forwarded = std::move(map);
+    EXPECT_FALSE(forwarded.is_sorted_state());
+    auto const c = std::move(forwarded).extract();
+    EXPECT_EQ(c.keys, (std::vector<int>{3, 9, 1, 3, 7, 9}));
+    EXPECT_EQ(c.values, (std::vector<int>{30, 90, 10, 31, 70, 91}));
+
+    // Sorted, the appended elements are inserted as flat_map's range
+    // insert would: the first of each key wins.
+    std::lazy_flat_map<fmap_t> sorted(keys, values);
+    sorted.insert(more.begin(), more.end());
+    EXPECT_EQ(
+        std::move(sorted).release(),
+        (fmap_t{{9, 90}, {7, 70}, {3, 30}, {1, 10}}));
+
+    // Once sorted, the containers come back sorted.
+    std::lazy_flat_map<fmap_t> queried(keys, values);
+    EXPECT_EQ(queried.count(9), 1u);
+    queried.insert(more.begin(), more.end());
+    auto const q = std::move(queried).extract();
+    EXPECT_EQ(q.keys, (std::vector<int>{9, 7, 3, 1}));
+    EXPECT_EQ(q.values, (std::vector<int>{90, 70, 30, 10}));
+
+    std::lazy_flat_map<fmap_t> presorted(
+        std::sorted_unique, {3, 2}, {30, 20});
+    EXPECT_TRUE(presorted.is_sorted_state());
+    std::lazy_flat_map<fmap_t> empty({}, {});
+    EXPECT_TRUE(empty.is_sorted_state());
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST(std_lazy_flat_map, against_std_map)
+{
+    std::mt19937 gen(17);
+    std::vector<int> keys;
+    std::vector<int> values;
+    std::map<int, int> expected;
+    for (int i = 0; i < 2000; ++i) {
+        int const k = int(gen() % 500);
+        keys.push_back(k);
+        values.push_back(i);
+        expected.emplace(k, i);
+    }
+    std::lazy_flat_map<std::flat_map<int, int>> const map(keys, values);
+    EXPECT_FALSE(map.is_sorted_state());
+    for (int k = -1; k < 501; ++k) {
+        auto const it = expected.find(k);
+        ASSERT_EQ(map.count(k), it != expected.end() ? 1u : 0u);
+        if (it != expected.end()) {
+            EXPECT_EQ(map.at(k), it->second);
+        }
+    }
+    EXPECT_TRUE(map.is_sorted_state());
+    EXPECT_TRUE(std::equal(
+        map.begin(), map.end(), expected.begin(), expected.end()));
+}
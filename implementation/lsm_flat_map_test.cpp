@@ -0,0 +1,119 @@
+#include "lsm_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Test instantiations.
+template class std::lsm_flat_map<std::flat_map<std::string, int>>;
+
+TEST(std_lsm_flat_map, writes_lookups)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    for (std::size_t bloom_bits : {0, 10}) {
+        std::lsm_flat_map<fmap_t> map(fmap_t{{-1, -1}}, 16, bloom_bits);
+        EXPECT_EQ(map.bloom_bits_per_key(), bloom_bits);
+        std::map<int, int> std_map = {{-1, -1}};
+        std::mt19937 gen(bloom_bits);
+        for (int i = 0; i < 5000; ++i) {
+            int const key = int(gen() % 1000);
+            if (gen() % 4 == 0) {
+                map.erase(key);
+                std_map.erase(key);
+            } else {
+                map.insert_or_assign(key, i);
+                std_map[key] = i;
+            }
+            int const probe = int(gen() % 1100);
+            auto const it = std_map.find(probe);
+            if (it == std_map.end()) {
+                EXPECT_EQ(map.lookup(probe), nullptr);
+                EXPECT_FALSE(map.contains(probe));
+            } else {
+                ASSERT_NE(map.lookup(probe), nullptr);
+                EXPECT_EQ(*map.lookup(probe), it->second);
+                EXPECT_EQ(map.at(probe), it->second);
+            }
+            // The runs stay logarithmic in number.
+            EXPECT_LE(map.level_count(), 12u);
+        }
+        EXPECT_THROW(map.at(5000), std::out_of_range);
+
+        EXPECT_EQ(map.size(), std_map.size());
+        EXPECT_EQ(map.level_count(), 1u);
+        EXPECT_TRUE(std::equal(
+            map.begin(),
+            map.end(),
+            std_map.begin(),
+            std_map.end(),
+            [](auto lhs, auto rhs) {
+                return lhs.first == rhs.first && lhs.second == rhs.second;
+            }));
+    }
+}
+
+TEST(std_lsm_flat_map, tombstones_insert)
+{
+    using fmap_t = std::flat_map<std::string, int>;
+
+    std::lsm_flat_map<fmap_t> map(fmap_t{{"a", 1}, {"b", 2}, {"c", 3}}, 2, 8);
+    map.erase("b");
+    EXPECT_FALSE(map.contains("b"));
+    EXPECT_FALSE(map.insert({"a", 10}));
+    EXPECT_TRUE(map.insert({"b", 20}));
+    map.insert_or_assign("d", 4);
+    map.erase("a");
+    map.flush();
+    EXPECT_EQ(map.count("a"), 0u);
+    EXPECT_EQ(map.at("b"), 20);
+
+    fmap_t const expected = {{"b", 20}, {"c", 3}, {"d", 4}};
+    EXPECT_EQ(map.map(), expected);
+    map.erase("c");
+    EXPECT_EQ(std::move(map).release(), fmap_t({{"b", 20}, {"d", 4}}));
+}
+
+TEST(std_lsm_flat_map, large_compaction)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    // Merges large enough to be split into segments, where execution
+    // policies are enabled.
+    std::vector<std::pair<int, int>> base;
+    for (int i = 0; i < 60000; ++i) {
+        base.emplace_back(2 * i, i);
+    }
+    std::lsm_flat_map<fmap_t> map(fmap_t(base.begin(), base.end()), 4096);
+    std::map<int, int> std_map(base.begin(), base.end());
+    std::mt19937 gen(3);
+    for (int i = 0; i < 100000; ++i) {
+        int const key = int(gen() % 150000);
+        if (gen() % 5 == 0) {
+            map.erase(key);
+            std_map.erase(key);
+        } else {
+            map.insert_or_assign(key, -i);
+            std_map[key] = -i;
+        }
+    }
+    for (int probe = 0; probe < 150000; probe += 7) {
+        auto const it = std_map.find(probe);
+        ASSERT_EQ(map.lookup(probe) != nullptr, it != std_map.end());
+        if (it != std_map.end()) {
+            EXPECT_EQ(*map.lookup(probe), it->second);
+        }
+    }
+    EXPECT_EQ(map.size(), std_map.size());
+    EXPECT_TRUE(std::equal(
+        map.begin(),
+        map.end(),
+        std_map.begin(),
+        std_map.end(),
+        [](auto lhs, auto rhs) {
+            return lhs.first == rhs.first && lhs.second == rhs.second;
+        }));
+}
@@ -0,0 +1,227 @@
+#include "mapped_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Test instantiations.
+template class std::mapped_flat_map<int, double>;
+
+TEST(std_mapped_flat_map, lookup)
+{
+    using fmap_t = std::flat_map<int, double>;
+    char const * const path = "mapped_flat_map_test.lookup.bin";
+
+    for (int size : {0, 1, 2, 17, 1000}) {
+        fmap_t map;
+        for (int i = 0; i < size; ++i) {
+            map.emplace(i * 2, i * 0.5);
+        }
+        std::write_flat_map_file(path, map);
+        std::mapped_flat_map<int, double> const mapped(path);
+
+        EXPECT_EQ(mapped.size(), map.size());
+        EXPECT_EQ(mapped.empty(), map.empty());
+        EXPECT_TRUE(std::equal(
+            mapped.begin(), mapped.end(), map.cbegin(), map.cend()));
+        EXPECT_TRUE(std::equal(
+            mapped.rbegin(), mapped.rend(), map.crbegin(), map.crend()));
+        for (int k = -2; k < size * 2 + 2; ++k) {
+            EXPECT_EQ(
+                mapped.find(k) - mapped.begin(), map.find(k) - map.begin());
+            EXPECT_EQ(
+                mapped.lower_bound(k) - mapped.begin(),
+                map.lower_bound(k) - map.begin());
+            EXPECT_EQ(
+                mapped.upper_bound(k) - mapped.begin(),
+                map.upper_bound(k) - map.begin());
+            EXPECT_EQ(mapped.contains(k), map.contains(k));
+            auto const eq_range = mapped.equal_range(k);
+            EXPECT_EQ(
+                std::size_t(eq_range.second - eq_range.first), mapped.count(k));
+        }
+    }
+    std::remove(path);
+}
+
+TEST(std_mapped_flat_map, at_zero_copy)
+{
+    using fmap_t = std::flat_map<long, int, std::greater<long>>;
+    char const * const path = "mapped_flat_map_test.at.bin";
+
+    fmap_t const map = {{3, 30}, {1, 10}, {2, 20}};
+    std::write_flat_map_file(path, map);
+    std::mapped_flat_map<long, int, std::greater<long>> mapped(path);
+
+    EXPECT_EQ(mapped.at(3), 30);
+    EXPECT_EQ(mapped.at(1), 10);
+    EXPECT_THROW(mapped.at(4), std::out_of_range);
+    EXPECT_EQ(mapped.begin()->first, 3);
+
+    // The elements live in the mapping, not in a copy.
+    EXPECT_EQ(&mapped.begin()->first, mapped.key_data());
+    EXPECT_EQ(&mapped.begin()->second, mapped.mapped_data());
+    EXPECT_EQ(std::uintptr_t(mapped.key_data()) % 64, 0u);
+    EXPECT_EQ(std::uintptr_t(mapped.mapped_data()) % 64, 0u);
+
+    auto moved = std::move(mapped);
+    EXPECT_EQ(moved.at(2), 20);
+    std::remove(path);
+}
+
+namespace {
+    long minor_faults()
+    {
+        rusage usage;
+        ::getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_minflt;
+    }
+
+    // The minor page faults taken by looking up every 64th key.
+    template<typename Map>
+    long lookup_faults(Map const & mapped, int size)
+    {
+        long const before = minor_faults();
+        int found = 0;
+        for (int k = 0; k < size; k += 64) {
+            found += mapped.contains(k * 2);
+        }
+        long const faults = minor_faults() - before;
+        EXPECT_EQ(found, (size + 63) / 64);
+        return faults;
+    }
+}
+
+TEST(std_mapped_flat_map, load_options)
+{
+    using fmap_t = std::flat_map<int, int>;
+    using mapped_t = std::mapped_flat_map<int, int>;
+    char const * const path = "mapped_flat_map_test.load.bin";
+
+    int const size = 1 << 20;
+    fmap_t map;
+    for (int i = 0; i < size; ++i) {
+        map.emplace_hint(map.end(), i * 2, i);
+    }
+    std::write_flat_map_file(path, map);
+
+    long const cold = lookup_faults(mapped_t(path), size);
+    EXPECT_LT(0, cold);
+
+    for (auto const opts :
+         {std::mapped_load_options{true, false, 0, 0},
+          std::mapped_load_options{false, true, 0, 0},
+          std::mapped_load_options{false, false, 4, 0},
+          std::mapped_load_options{false, false, 1, 0},
+          std::mapped_load_options{true, true, 2, 8}}) {
+        mapped_t const mapped(path, opts);
+        EXPECT_TRUE(std::equal(
+            mapped.begin(), mapped.end(), map.cbegin(), map.cend()));
+        if (opts.populate || opts.prefault_threads) {
+            EXPECT_LT(lookup_faults(mapped, size), cold);
+        }
+    }
+
+    // Warming the top levels of the search leaves the lookups only the
+    // faults of their last steps; with enough levels, none.
+    {
+        mapped_t const mapped(
+            path, std::mapped_load_options{false, false, 0, 30});
+        EXPECT_LT(lookup_faults(mapped, size), cold);
+        EXPECT_EQ(mapped.at(size), size / 2);
+        EXPECT_EQ(mapped.find(1), mapped.end());
+        mapped.warm_search_levels(0);
+        mapped.warm_search_levels(100);
+    }
+
+    std::write_flat_map_file(path, fmap_t());
+    mapped_t const empty(path, std::mapped_load_options{true, true, 4, 8});
+    EXPECT_TRUE(empty.empty());
+    std::remove(path);
+}
+
+TEST(std_mapped_flat_map, bad_files)
+{
+    using mapped_t = std::mapped_flat_map<int, int>;
+    char const * const path = "mapped_flat_map_test.bad.bin";
+
+    EXPECT_THROW(
+        mapped_t("mapped_flat_map_test.missing.bin"), std::system_error);
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a flat_map file, but long enough to hold a header "
+               "if it were one";
+    }
+    EXPECT_THROW(mapped_t{path}, std::runtime_error);
+
+    std::write_flat_map_file(path, std::flat_map<int, double>{{1, 1.0}});
+    EXPECT_THROW(mapped_t{path}, std::runtime_error);
+
+    std::write_flat_map_file(path, std::flat_map<int, int>{{1, 1}, {2, 2}});
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string const contents(
+            (std::istreambuf_iterator<char>(in)),
+            std::istreambuf_iterator<char>());
+        in.close();
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), contents.size() - 4);
+    }
+    EXPECT_THROW(mapped_t{path}, std::runtime_error);
+    std::remove(path);
+}
+
+TEST(std_mapped_flat_map, shared_memory)
+{
+    using fmap_t = std::flat_map<int, double>;
+    using mapped_t = std::mapped_flat_map<int, double>;
+    char const * const name = "/mapped_flat_map_test.shared";
+
+    fmap_t map;
+    for (int i = 0; i < 1000; ++i) {
+        map.emplace(i * 3, i * 0.25);
+    }
+    std::write_shared_flat_map(name, map);
+
+    // Another process attaches to the same object by name.
+    pid_t const pid = ::fork();
+    ASSERT_LE(0, pid);
+    if (!pid) {
+        mapped_t const child(std::shared_memory, name);
+        bool const ok = child.size() == map.size() &&
+                        std::equal(
+                            child.begin(),
+                            child.end(),
+                            map.cbegin(),
+                            map.cend()) &&
+                        child.at(2997) == 999 * 0.25 && !child.contains(1);
+        ::_exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(::waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+
+    mapped_t const mapped(std::shared_memory, name);
+    EXPECT_TRUE(
+        std::equal(mapped.begin(), mapped.end(), map.cbegin(), map.cend()));
+
+    // Rewriting the object replaces the map for new attachments, and
+    // leaves the old one to those already attached.
+    std::write_shared_flat_map(name, fmap_t{{1, 1.0}});
+    mapped_t const rewritten(std::shared_memory, name);
+    EXPECT_EQ(rewritten.size(), 1u);
+    EXPECT_EQ(rewritten.at(1), 1.0);
+    EXPECT_TRUE(
+        std::equal(mapped.begin(), mapped.end(), map.cbegin(), map.cend()));
+
+    std::remove_shared_flat_map(name);
+    EXPECT_THROW(mapped_t(std::shared_memory, name), std::system_error);
+    EXPECT_THROW(std::remove_shared_flat_map(name), std::system_error);
+}
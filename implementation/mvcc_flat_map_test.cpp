@@ -0,0 +1,217 @@
+#include "mvcc_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+
+// Test instantiations.
+template class std::mvcc_flat_map<int, double>;
+template class std::mvcc_flat_map<std::string, std::string, std::greater<>>;
+
+TEST(std_mvcc_flat_map, reads_at_timestamps)
+{
+    std::mvcc_flat_map<int, std::string> map;
+    EXPECT_EQ(map.now(), 0u);
+    EXPECT_EQ(map.find(1, 0), nullptr);
+
+    EXPECT_TRUE(map.insert_or_assign(1, "one"));
+    auto const t1 = map.now();
+    std::string const * const one = map.find(1, t1);
+    EXPECT_TRUE(map.insert_or_assign(2, "two"));
+    EXPECT_FALSE(map.insert_or_assign(1, "uno"));
+    auto const t2 = map.now();
+    EXPECT_EQ(map.erase(2), 1u);
+    EXPECT_EQ(map.erase(2), 0u);
+    EXPECT_EQ(map.erase(3), 0u);
+    auto const t3 = map.now();
+    EXPECT_EQ(t3, 4u);
+
+    // Versions never move, so later writes leave pointers valid.
+    EXPECT_EQ(map.find(1, t1), one);
+    EXPECT_EQ(*one, "one");
+    EXPECT_FALSE(map.contains(2, t1));
+    EXPECT_EQ(*map.find(1, t2), "uno");
+    EXPECT_EQ(*map.find(2, t2), "two");
+    EXPECT_EQ(*map.find(1, t3), "uno");
+    EXPECT_FALSE(map.contains(2, t3));
+    EXPECT_FALSE(map.contains(1, 0));
+
+    // A key written again after its erasure counts as new.
+    EXPECT_TRUE(map.insert_or_assign(2, "dos"));
+    EXPECT_EQ(*map.find(2, map.now()), "dos");
+    EXPECT_FALSE(map.contains(2, t3));
+
+    std::vector<std::pair<int, std::string>> seen;
+    map.for_each(t2, [&](int k, std::string const & v) {
+        seen.emplace_back(k, v);
+    });
+    EXPECT_EQ(
+        seen,
+        (std::vector<std::pair<int, std::string>>{{1, "uno"}, {2, "two"}}));
+    seen.clear();
+    map.for_each(t3, [&](int k, std::string const & v) {
+        seen.emplace_back(k, v);
+    });
+    EXPECT_EQ(seen, (std::vector<std::pair<int, std::string>>{{1, "uno"}}));
+
+    map.clear();
+    EXPECT_EQ(map.size(), 0u);
+    EXPECT_EQ(map.version_count(), 0u);
+    EXPECT_FALSE(map.contains(1, map.now()));
+}
+
+TEST(std_mvcc_flat_map, collect)
+{
+    std::mvcc_flat_map<int, int> map;
+    map.insert_or_assign(1, 10);
+    map.insert_or_assign(1, 11);
+    map.insert_or_assign(2, 20);
+    map.erase(2);
+    auto const t = map.now();
+    map.insert_or_assign(1, 12);
+    map.insert_or_assign(3, 30);
+    map.erase(3);
+    EXPECT_EQ(map.version_count(), 7u);
+    EXPECT_EQ(map.size(), 3u);
+
+    // At t, 1 is 11 and 2 is erased; 3's versions are all newer than t.
+    EXPECT_EQ(map.collect(t), 3u);
+    EXPECT_EQ(map.version_count(), 4u);
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(*map.find(1, t), 11);
+    EXPECT_EQ(*map.find(1, map.now()), 12);
+    EXPECT_FALSE(map.contains(2, t));
+    EXPECT_FALSE(map.contains(3, map.now()));
+
+    EXPECT_EQ(map.collect(t), 0u);
+    EXPECT_EQ(map.collect(map.now()), 3u);
+    EXPECT_EQ(map.version_count(), 1u);
+    EXPECT_EQ(map.keys(), std::vector<int>{1});
+    EXPECT_EQ(*map.find(1, map.now()), 12);
+}
+
+TEST(std_mvcc_flat_map, against_std_map_history)
+{
+    // Records the whole map after each write, and checks reads at every
+    // timestamp still readable against those records.
+    std::mvcc_flat_map<int, int> map;
+    std::vector<std::map<int, int>> history(1);
+    std::mt19937 gen(7);
+    std::uint64_t oldest = 0;
+    for (int i = 0; i < 2000; ++i) {
+        int const k = int(gen() % 50);
+        std::map<int, int> next = history.back();
+        if (gen() % 3) {
+            bool const inserted = !next.count(k);
+            next[k] = i;
+            EXPECT_EQ(map.insert_or_assign(k, i), inserted);
+            history.push_back(std::move(next));
+        } else if (map.erase(k)) {
+            next.erase(k);
+            history.push_back(std::move(next));
+        }
+        ASSERT_EQ(map.now() + 1, history.size());
+
+        if (i % 100 == 99) {
+            oldest = map.now() - gen() % 20;
+            map.collect(oldest);
+        }
+        std::uint64_t const t = oldest + gen() % (map.now() - oldest + 1);
+        for (int x = 0; x < 50; ++x) {
+            auto const it = history[t].find(x);
+            int const * const v = map.find(x, t);
+            if (it == history[t].end()) {
+                EXPECT_EQ(v, nullptr);
+            } else {
+                ASSERT_NE(v, nullptr);
+                EXPECT_EQ(*v, it->second);
+            }
+        }
+    }
+    EXPECT_LE(map.size(), 50u);
+}
+
+TEST(std_mvcc_flat_map, concurrent_readers)
+{
+    // The writer writes "k@t" to key k at timestamp t, and collects at the
+    // oldest timestamp a reader may still be using.  Each reader pins a
+    // timestamp, and then reads every key at it twice; both reads must
+    // give the same version, of the right key, written no later than the
+    // timestamp.
+    std::mvcc_flat_map<int, std::string> map;
+    constexpr int keys = 64;
+    constexpr int reader_count = 3;
+    constexpr auto unpinned = std::numeric_limits<std::uint64_t>::max();
+    std::atomic<std::uint64_t> collect_floor{0};
+    std::array<std::atomic<std::uint64_t>, reader_count> pinned;
+    for (auto & p : pinned) {
+        p = unpinned;
+    }
+    std::atomic<bool> done{false};
+    std::atomic<bool> bad{false};
+    std::atomic<long> passes{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < reader_count; ++r) {
+        readers.emplace_back([&, r] {
+            while (!done) {
+                std::uint64_t const t = map.now();
+                pinned[r] = t;
+                // The writer either sees the pin, or has already raised
+                // the floor past t, and may collect past it.
+                if (t < collect_floor)
+                    continue;
+                for (int k = 0; k < keys; ++k) {
+                    std::string const * const v = map.find(k, t);
+                    if (v != map.find(k, t))
+                        bad = true;
+                    if (!v)
+                        continue;
+                    std::string const prefix = std::to_string(k) + "@";
+                    if (v->compare(0, prefix.size(), prefix) ||
+                        t < std::stoull(v->substr(prefix.size()))) {
+                        bad = true;
+                    }
+                }
+                pinned[r] = unpinned;
+                ++passes;
+            }
+        });
+    }
+
+    std::mt19937 gen(11);
+    for (int i = 0; i < 20000; ++i) {
+        int const k = int(gen() % keys);
+        std::uint64_t const t = map.now() + 1;
+        if (gen() % 4) {
+            map.insert_or_assign(
+                k, std::to_string(k) + "@" + std::to_string(t));
+        } else {
+            map.erase(k);
+        }
+        if (i % 500 == 499) {
+            std::uint64_t oldest = map.now();
+            collect_floor = oldest;
+            for (auto const & p : pinned) {
+                oldest = (std::min)(oldest, p.load());
+            }
+            map.collect(oldest);
+        }
+    }
+    done = true;
+    for (auto & r : readers) {
+        r.join();
+    }
+
+    EXPECT_FALSE(bad);
+    EXPECT_GT(passes, 0);
+    map.collect(map.now());
+    EXPECT_LE(map.size(), std::size_t(keys));
+    EXPECT_EQ(map.version_count(), map.size());
+}
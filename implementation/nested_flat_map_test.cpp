@@ -0,0 +1,223 @@
+#include "nested_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Test instantiations.
+template class std::nested_flat_map<std::string, int, std::string>;
+
+namespace {
+    using std_nested_t = std::map<int, std::map<int, int>>;
+
+    template<class NestedMap>
+    bool same_elements(NestedMap const & map, std_nested_t const & std_map)
+    {
+        return std::equal(
+            map.begin(),
+            map.end(),
+            std_map.begin(),
+            std_map.end(),
+            [](auto const & x, auto const & y) {
+                return x.first == y.first &&
+                       std::equal(
+                           x.second.begin(),
+                           x.second.end(),
+                           y.second.begin(),
+                           y.second.end(),
+                           [](auto const & a, auto const & b) {
+                               return a.first == b.first &&
+                                      a.second == b.second;
+                           });
+            });
+    }
+}
+
+TEST(std_nested_flat_map, construction)
+{
+    using inner_t = std::flat_map<int, int>;
+    using outer_t = std::flat_map<int, inner_t>;
+    using nmap_t = std::nested_flat_map<int, int, int>;
+
+    std::mt19937 gen(11);
+    outer_t outer;
+    std_nested_t std_map;
+    for (int i = 0; i < 3000; ++i) {
+        int const x = int(gen() % 200);
+        int const y = int(gen() % 1000);
+        outer[x].try_emplace(y, i);
+        std_map[x].try_emplace(y, i);
+    }
+    outer[500];
+    std_map[500];
+
+    nmap_t const map(outer);
+    EXPECT_EQ(map.size(), std_map.size());
+    std::size_t element_count = 0;
+    for (auto const & x : std_map) {
+        element_count += x.second.size();
+    }
+    EXPECT_EQ(map.element_count(), element_count);
+    EXPECT_TRUE(same_elements(map, std_map));
+    EXPECT_EQ(map.keys().size(), map.offsets().size());
+    EXPECT_EQ(map.offsets().back(), map.values().size());
+
+    // Lookups at both levels.
+    for (int x = -1; x < 202; ++x) {
+        auto const it = std_map.find(x);
+        EXPECT_EQ(map.contains(x), it != std_map.end());
+        EXPECT_EQ(
+            map.inner(x).size(),
+            it == std_map.end() ? 0u : it->second.size());
+        for (int y = 0; y < 1000; y += 13) {
+            bool const expected =
+                it != std_map.end() && it->second.count(y) == 1;
+            ASSERT_EQ(map.contains(x, y), expected);
+            if (expected) {
+                EXPECT_EQ(*map.lookup(x, y), it->second.at(y));
+                EXPECT_EQ(map.at(x, y), it->second.at(y));
+                EXPECT_EQ(map.at(x).at(y), it->second.at(y));
+            } else {
+                EXPECT_EQ(map.lookup(x, y), nullptr);
+                EXPECT_THROW(map.at(x, y), std::out_of_range);
+            }
+        }
+    }
+    EXPECT_TRUE(map.contains(500));
+    EXPECT_TRUE(map.at(500).empty());
+    EXPECT_THROW(map.at(501), std::out_of_range);
+    EXPECT_EQ(map.lower_bound(201)->first, 500);
+    EXPECT_EQ(map.upper_bound(500), map.end());
+    EXPECT_EQ(map.rbegin()->first, 500);
+
+    // Moving from the nested flat_map gives the same map.
+    nmap_t moved(std::move(outer));
+    EXPECT_TRUE(outer.empty());
+    EXPECT_EQ(moved, map);
+
+    // As do the containers, and unsorted elements.
+    nmap_t::containers c = nmap_t(map).extract();
+    nmap_t const from_containers(std::sorted_unique, std::move(c));
+    EXPECT_EQ(from_containers, map);
+
+    std::vector<int> keys;
+    std::vector<int> inner_keys;
+    std::vector<int> values;
+    for (auto const & x : std_map) {
+        for (auto const & y : x.second) {
+            keys.push_back(x.first);
+            inner_keys.push_back(y.first);
+            values.push_back(y.second);
+        }
+    }
+    std::vector<std::size_t> order(keys.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), gen);
+    std::vector<int> shuffled_keys;
+    std::vector<int> shuffled_inner_keys;
+    std::vector<int> shuffled_values;
+    for (std::size_t i : order) {
+        shuffled_keys.push_back(keys[i]);
+        shuffled_inner_keys.push_back(inner_keys[i]);
+        shuffled_values.push_back(values[i]);
+    }
+    // Duplicates come after the originals, and are dropped.
+    for (std::size_t i = 0; i < 100; ++i) {
+        shuffled_keys.push_back(keys[i]);
+        shuffled_inner_keys.push_back(inner_keys[i]);
+        shuffled_values.push_back(-1);
+    }
+    nmap_t const from_elements(
+        std::move(shuffled_keys),
+        std::move(shuffled_inner_keys),
+        std::move(shuffled_values));
+    std_nested_t without_empty = std_map;
+    without_empty.erase(500);
+    EXPECT_TRUE(same_elements(from_elements, without_empty));
+}
+
+TEST(std_nested_flat_map, modifiers)
+{
+    std::nested_flat_map<int, int, int> map;
+    std_nested_t std_map;
+    std::mt19937 gen(5);
+    for (int i = 0; i < 5000; ++i) {
+        int const x = int(gen() % 50);
+        int const y = int(gen() % 100);
+        switch (gen() % 5) {
+        case 0:
+        case 1: {
+            auto const result = map.try_emplace(x, y, i);
+            bool const inserted = std_map[x].try_emplace(y, i).second;
+            EXPECT_EQ(result.second, inserted);
+            EXPECT_EQ(*result.first, std_map[x][y]);
+            break;
+        }
+        case 2:
+            EXPECT_EQ(
+                map.insert_or_assign(x, y, -i).second, !std_map[x].count(y));
+            std_map[x][y] = -i;
+            break;
+        case 3: {
+            auto const it = std_map.find(x);
+            std::size_t const n =
+                it == std_map.end() ? 0 : it->second.erase(y);
+            EXPECT_EQ(map.erase(x, y), n);
+            break;
+        }
+        case 4:
+            if (gen() % 8 == 0) {
+                EXPECT_EQ(map.erase(x), std_map.erase(x));
+            }
+            break;
+        }
+    }
+    EXPECT_EQ(map.size(), std_map.size());
+    EXPECT_TRUE(same_elements(map, std_map));
+
+    for (auto const & x : std_map) {
+        for (auto const & y : x.second) {
+            map.at(x.first, y.first) += 1;
+        }
+    }
+    for (auto const & x : std_map) {
+        for (auto const & y : x.second) {
+            EXPECT_EQ(map.at(x.first, y.first), y.second + 1);
+        }
+    }
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.element_count(), 0u);
+    EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(std_nested_flat_map, strings)
+{
+    std::flat_map<std::string, std::flat_map<int, std::string>> outer;
+    outer["users"][3] = "three";
+    outer["users"][1] = "one";
+    outer["items"][2] = "two";
+    std::nested_flat_map map(outer);
+    static_assert(std::is_same_v<
+                  decltype(map),
+                  std::nested_flat_map<std::string, int, std::string>>);
+
+    EXPECT_EQ(map.begin()->first, "items");
+    EXPECT_EQ(map.at("users", 1), "one");
+    EXPECT_EQ(map.inner("users").begin()->second, "one");
+    map.insert_or_assign("users", 1, "uno");
+    map.try_emplace("orders", 7, "seven");
+    EXPECT_EQ(map.at("users", 1), "uno");
+    EXPECT_EQ(
+        map.keys(), (std::vector<std::string>{"items", "orders", "users"}));
+    EXPECT_EQ(map.offsets(), (std::vector<std::size_t>{1, 2, 4}));
+    EXPECT_EQ(map.erase("items"), 1u);
+    EXPECT_EQ(map.offsets(), (std::vector<std::size_t>{1, 3}));
+    EXPECT_EQ(map.inner_keys(), (std::vector<int>{7, 1, 3}));
+}
@@ -0,0 +1,143 @@
+#include "normalized_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+
+using composite_t = std::tuple<int, std::string, double>;
+
+// Test instantiations.
+template class std::normalized_flat_map<composite_t, int>;
+template class std::normalized_flat_map<std::pair<int, short>, int>;
+
+namespace {
+    template<typename Key>
+    std::string encode(Key const & k)
+    {
+        std::string s;
+        std::flat_map_key_normalizer<Key>::encode(k, s);
+        return s;
+    }
+
+    template<typename Key>
+    void expect_order_preserved(std::vector<Key> const & keys)
+    {
+        for (auto const & x : keys) {
+            std::string const s = encode(x);
+            char const * p = s.data();
+            EXPECT_EQ(std::flat_map_key_normalizer<Key>::decode(p), x);
+            EXPECT_EQ(p, s.data() + s.size());
+            for (auto const & y : keys) {
+                // string's < compares chars as unsigned, like memcmp().
+                EXPECT_EQ(x < y, s < encode(y));
+            }
+        }
+    }
+}
+
+TEST(std_normalized_flat_map, encodings)
+{
+    expect_order_preserved<int>(
+        {std::numeric_limits<int>::min(), -70000, -1, 0, 1, 255, 256,
+         std::numeric_limits<int>::max()});
+    expect_order_preserved<std::uint16_t>({0, 1, 255, 256, 65535});
+    expect_order_preserved<bool>({false, true});
+    expect_order_preserved<double>(
+        {-std::numeric_limits<double>::infinity(), -1e300, -2.5, -1e-300,
+         0.0, 1e-300, 2.5, 1e300, std::numeric_limits<double>::infinity()});
+    expect_order_preserved<float>({-3.5f, -0.25f, 0.0f, 0.25f, 3.5f});
+    expect_order_preserved<std::string>(
+        {"", std::string(1, '\0'), std::string(2, '\0'), "\x01", "a",
+         std::string("a\0", 2), std::string("a\0b", 3), "ab", "b", "\xff"});
+    expect_order_preserved<std::tuple<std::string, int>>(
+        {{"", 5}, {"a", -1}, {"a", 0}, {std::string("a\0", 2), -9},
+         {"ab", -100}, {"b", 0}});
+
+    enum class color : std::int8_t { red = -1, green, blue };
+    expect_order_preserved<color>({color::red, color::green, color::blue});
+
+    // -0.0 equals 0.0, so it has the same encoding.
+    EXPECT_EQ(encode(-0.0), encode(0.0));
+    EXPECT_EQ(std::flat_map_key_normalizer<composite_t>::fixed_size, 0u);
+    EXPECT_EQ(
+        (std::flat_map_key_normalizer<std::tuple<int, short, char>>::
+             fixed_size),
+        7u);
+}
+
+TEST(std_normalized_flat_map, against_std_map)
+{
+    std::normalized_flat_map<composite_t, int> map;
+    std::map<composite_t, int> reference;
+    std::mt19937 gen(8);
+    char const * const words[] = {"", "a", "ab", "b", "ba"};
+    auto random_key = [&] {
+        return composite_t(
+            int(gen() % 20) - 10, words[gen() % 5], double(gen() % 7) / 2 - 1);
+    };
+    for (int i = 0; i < 5000; ++i) {
+        composite_t const k = random_key();
+        switch (gen() % 4) {
+        case 0:
+        case 1: {
+            auto const result = map.try_emplace(k, i);
+            auto const ref_result = reference.try_emplace(k, i);
+            ASSERT_EQ(result.second, ref_result.second);
+            ASSERT_EQ(result.first->first, k);
+            ASSERT_EQ(result.first->second, ref_result.first->second);
+            break;
+        }
+        case 2:
+            ASSERT_EQ(map.erase(k), reference.erase(k));
+            break;
+        default: {
+            ASSERT_EQ(map.contains(k), reference.count(k) == 1u);
+            auto const it = map.lower_bound(k);
+            auto const ref_it = reference.lower_bound(k);
+            ASSERT_EQ(it == map.end(), ref_it == reference.end());
+            if (ref_it != reference.end()) {
+                ASSERT_EQ(it->first, ref_it->first);
+            }
+            break;
+        }
+        }
+    }
+    ASSERT_EQ(map.size(), reference.size());
+    auto it = map.begin();
+    for (auto const & e : reference) {
+        ASSERT_EQ((*it).first, e.first);
+        ASSERT_EQ(it->second, e.second);
+        ++it;
+    }
+
+    std::normalized_flat_map<composite_t, int> const built(
+        reference.begin(), reference.end());
+    EXPECT_EQ(built, map);
+    EXPECT_EQ(built.at(reference.begin()->first), reference.begin()->second);
+    EXPECT_THROW(built.at(composite_t(100, "", 0.0)), std::out_of_range);
+}
+
+TEST(std_normalized_flat_map, fixed_width_keys)
+{
+    using key_t = std::pair<int, short>;
+    using map_t = std::normalized_flat_map<key_t, std::string>;
+    using base_t = std::flat_map<std::uint64_t, std::string>;
+    static_assert(std::is_same<map_t::base_type, base_t>::value, "");
+
+    map_t map = {{{1, -2}, "b"}, {{-5, 7}, "a"}, {{1, 3}, "c"}};
+    EXPECT_EQ(map.begin()->first, key_t(-5, 7));
+    EXPECT_EQ(std::prev(map.end())->first, key_t(1, 3));
+    EXPECT_EQ(map.find({1, -2})->second, "b");
+    EXPECT_EQ(map.upper_bound({1, -2})->second, "c");
+    map[{0, 0}] = "zero";
+    map.insert_or_assign({1, 3}, "C");
+    EXPECT_EQ(map.size(), 4u);
+    EXPECT_EQ(map.at({1, 3}), "C");
+    auto const next = map.erase(map.find({0, 0}));
+    EXPECT_EQ(next->first, key_t(1, -2));
+    map_t::const_iterator const first = map.begin();
+    EXPECT_EQ(first->second, "a");
+}
@@ -0,0 +1,128 @@
+#include "offset_vector"
+#include "flat_map"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <map>
+#include <random>
+#include <string>
+
+// Test instantiations.
+template class std::offset_vector<std::string>;
+template class std::flat_map<
+    int,
+    std::string,
+    std::less<int>,
+    std::offset_vector<int>,
+    std::offset_vector<std::string>>;
+
+TEST(std_offset_vector, sequence_operations)
+{
+    using vec_t = std::offset_vector<std::string>;
+
+    vec_t v = {"a", "b", "c", "d"};
+    std::deque<std::string> d(v.begin(), v.end());
+    std::mt19937 gen(3);
+    for (int i = 0; i < 5000; ++i) {
+        switch (gen() % 6) {
+        case 0:
+        case 1:
+            v.push_back(std::to_string(i));
+            d.push_back(std::to_string(i));
+            break;
+        case 2:
+            // Pushing an element of the vector itself is safe even when
+            // the dead slots are reclaimed.
+            if (!v.empty()) {
+                v.push_back(v.front());
+                d.push_back(d.front());
+            }
+            break;
+        case 3:
+            if (!v.empty()) {
+                v.erase(v.begin());
+                d.pop_front();
+            }
+            break;
+        case 4:
+            if (!v.empty()) {
+                std::size_t const n = gen() % (v.size() + 1);
+                v.erase(v.begin(), v.begin() + n);
+                d.erase(d.begin(), d.begin() + n);
+            }
+            break;
+        default:
+            if (!v.empty()) {
+                std::size_t const i = gen() % v.size();
+                v.insert(v.begin() + i, "x");
+                d.insert(d.begin() + i, "x");
+                std::size_t const j = gen() % v.size();
+                v.erase(v.begin() + j);
+                d.erase(d.begin() + j);
+            }
+            break;
+        }
+        ASSERT_EQ(v.size(), d.size());
+        ASSERT_TRUE(std::equal(v.begin(), v.end(), d.begin(), d.end()));
+        if (!v.empty()) {
+            EXPECT_EQ(v.front(), d.front());
+            EXPECT_EQ(&v.front(), v.data());
+            EXPECT_EQ(v[v.size() - 1], d.back());
+        }
+    }
+
+    vec_t const copy = v;
+    EXPECT_EQ(copy, v);
+    vec_t moved = std::move(v);
+    EXPECT_EQ(moved, copy);
+    EXPECT_TRUE(v.empty());
+    moved.shrink_to_fit();
+    EXPECT_EQ(moved, copy);
+    EXPECT_THROW(moved.at(moved.size()), std::out_of_range);
+}
+
+TEST(std_offset_vector, sliding_window_flat_map)
+{
+    using fmap_t = std::flat_map<
+        int,
+        int,
+        std::less<int>,
+        std::offset_vector<int>,
+        std::offset_vector<int>>;
+
+    fmap_t map;
+    std::map<int, int> std_map;
+    std::mt19937 gen(17);
+    int t = 0;
+    for (int i = 0; i < 20000; ++i) {
+        t += int(gen() % 3);
+        map.emplace(t, i);
+        std_map.emplace(t, i);
+        while (map.begin()->first < t - 500) {
+            map.erase(map.begin());
+            std_map.erase(std_map.begin());
+        }
+        int const probe = t - int(gen() % 600);
+        auto const it = std_map.find(probe);
+        ASSERT_EQ(map.contains(probe), it != std_map.end());
+        if (it != std_map.end()) {
+            EXPECT_EQ(map.at(probe), it->second);
+        }
+        EXPECT_EQ(
+            map.lower_bound(probe)->first, std_map.lower_bound(probe)->first);
+    }
+    EXPECT_EQ(map.size(), std_map.size());
+    EXPECT_TRUE(std::equal(
+        map.begin(),
+        map.end(),
+        std_map.begin(),
+        std_map.end(),
+        [](auto lhs, auto rhs) {
+            return lhs.first == rhs.first && lhs.second == rhs.second;
+        }));
+
+    // Expiring a prefix at once, as erase(begin(), lower_bound(cutoff)).
+    map.erase(map.begin(), map.lower_bound(t - 100));
+    EXPECT_EQ(map.begin()->first, std_map.lower_bound(t - 100)->first);
+}
@@ -0,0 +1,174 @@
+#include "packed_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+
+// Test instantiations.
+template class std::packed_flat_map<std::string, int>;
+
+namespace {
+    template<class Map, class StdMap>
+    bool same_elements(Map const & map, StdMap const & std_map)
+    {
+        return map.size() == std_map.size() &&
+               std::equal(
+                   map.begin(),
+                   map.end(),
+                   std_map.begin(),
+                   std_map.end(),
+                   [](auto const & x, auto const & y) {
+                       return x.first == y.first && x.second == y.second;
+                   });
+    }
+}
+
+TEST(std_packed_flat_map, construction)
+{
+    using pmap_t = std::packed_flat_map<int, int>;
+
+    pmap_t empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.begin(), empty.end());
+    EXPECT_EQ(empty.find(3), empty.end());
+    EXPECT_EQ(empty.capacity(), 0u);
+
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < 100; ++i) {
+        pairs.emplace_back((i * 37) % 50, i);
+    }
+    pmap_t const map(pairs.begin(), pairs.end());
+    std::map<int, int> const std_map(pairs.begin(), pairs.end());
+    EXPECT_TRUE(same_elements(map, std_map));
+    EXPECT_EQ(map.capacity(), 128u);
+
+    pmap_t const il = {{3, 3}, {1, 1}, {2, 2}, {1, 10}};
+    EXPECT_EQ(il.size(), 3u);
+    EXPECT_EQ(il.at(1), 1);
+    EXPECT_THROW(il.at(4), std::out_of_range);
+}
+
+TEST(std_packed_flat_map, random_operations)
+{
+    using pmap_t = std::packed_flat_map<int, int>;
+
+    pmap_t map;
+    std::map<int, int> std_map;
+    std::mt19937 gen(26);
+    std::uniform_int_distribution<int> key(0, 1999);
+    for (int i = 0; i < 20000; ++i) {
+        int const k = key(gen);
+        switch (gen() % 4) {
+        case 0:
+        case 1: {
+            auto const result = map.try_emplace(k, i);
+            EXPECT_EQ(result.second, std_map.try_emplace(k, i).second);
+            EXPECT_EQ(result.first->first, k);
+            break;
+        }
+        case 2:
+            EXPECT_EQ(map.erase(k), std_map.erase(k));
+            break;
+        case 3: {
+            auto const it = map.lower_bound(k);
+            auto const std_it = std_map.lower_bound(k);
+            if (std_it == std_map.end()) {
+                EXPECT_EQ(it, map.end());
+            } else {
+                EXPECT_EQ(it->first, std_it->first);
+                it->second = -i;
+                std_it->second = -i;
+            }
+            break;
+        }
+        }
+    }
+    EXPECT_TRUE(same_elements(map, std_map));
+    EXPECT_LE(map.size() * 4, map.capacity() * 3);
+
+    for (int k = -1; k < 2001; ++k) {
+        EXPECT_EQ(map.contains(k), std_map.count(k) == 1);
+        auto const upper = map.upper_bound(k);
+        auto const std_upper = std_map.upper_bound(k);
+        EXPECT_EQ(upper == map.end(), std_upper == std_map.end());
+        if (std_upper != std_map.end()) {
+            EXPECT_EQ(upper->first, std_upper->first);
+        }
+    }
+
+    EXPECT_TRUE(std::equal(
+        map.rbegin(),
+        map.rend(),
+        std_map.rbegin(),
+        std_map.rend(),
+        [](auto const & x, auto const & y) { return x.first == y.first; }));
+}
+
+TEST(std_packed_flat_map, ascending_and_descending_inserts)
+{
+    using pmap_t = std::packed_flat_map<int, int>;
+
+    pmap_t ascending;
+    pmap_t descending;
+    std::map<int, int> std_map;
+    for (int i = 0; i < 5000; ++i) {
+        ascending[i] = i;
+        descending[4999 - i] = 4999 - i;
+        std_map[i] = i;
+    }
+    EXPECT_TRUE(same_elements(ascending, std_map));
+    EXPECT_TRUE(same_elements(descending, std_map));
+    EXPECT_EQ(ascending, descending);
+}
+
+TEST(std_packed_flat_map, erase_iterator)
+{
+    using pmap_t = std::packed_flat_map<int, int>;
+
+    pmap_t map;
+    for (int i = 0; i < 1000; ++i) {
+        map[i] = i;
+    }
+    std::size_t const full_capacity = map.capacity();
+
+    int expected = 0;
+    for (auto it = map.begin(); it != map.end(); ++expected) {
+        EXPECT_EQ(it->first, expected);
+        if (it->first % 10)
+            it = map.erase(it);
+        else
+            ++it;
+    }
+    EXPECT_EQ(map.size(), 100u);
+    EXPECT_LT(map.capacity(), full_capacity);
+    for (auto const & x : map) {
+        EXPECT_EQ(x.first % 10, 0);
+    }
+    while (!map.empty()) {
+        map.erase(std::prev(map.end()));
+    }
+    EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(std_packed_flat_map, insert_or_assign)
+{
+    using pmap_t = std::packed_flat_map<std::string, int>;
+
+    pmap_t map;
+    EXPECT_TRUE(map.insert_or_assign("a", 1).second);
+    EXPECT_FALSE(map.insert_or_assign("a", 2).second);
+    EXPECT_TRUE(map.emplace("b", 3).second);
+    EXPECT_TRUE(map.insert({"c", 4}).second);
+    EXPECT_EQ(map.at("a"), 2);
+    EXPECT_EQ(map.count("b"), 1u);
+    EXPECT_EQ(map.find("d"), map.end());
+
+    pmap_t other = {{"a", 2}, {"b", 3}, {"c", 4}};
+    EXPECT_EQ(map, other);
+    other["d"] = 5;
+    EXPECT_NE(map, other);
+    std::swap(map, other);
+    EXPECT_EQ(map.size(), 4u);
+}
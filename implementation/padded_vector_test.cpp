@@ -0,0 +1,204 @@
+#include "padded_vector"
+#include "flat_map"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+// Test instantiations.
+template class std::padded_vector<int>;
+template class std::padded_vector<double, std::greater<>>;
+template class std::flat_map<
+    std::uint32_t,
+    int,
+    std::less<std::uint32_t>,
+    std::padded_vector<std::uint32_t>>;
+
+namespace {
+    template<typename Vec>
+    void expect_padded(Vec const & v)
+    {
+        auto const p = v.data();
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % 64, 0u);
+        for (std::size_t i = 0; i < Vec::padding; ++i) {
+            EXPECT_EQ(p[v.size() + i], Vec::sentinel());
+        }
+    }
+}
+
+TEST(std_padded_vector, sequence_operations)
+{
+    using vec_t = std::padded_vector<int>;
+    static_assert(vec_t::padding == 16);
+    static_assert(vec_t::sentinel() == std::numeric_limits<int>::max());
+    static_assert(
+        std::padded_vector<int, std::greater<int>>::sentinel() ==
+        std::numeric_limits<int>::lowest());
+    static_assert(
+        std::padded_vector<float>::sentinel() ==
+        std::numeric_limits<float>::infinity());
+
+    vec_t v;
+    EXPECT_TRUE(v.empty());
+    EXPECT_NE(v.data(), nullptr);
+    expect_padded(v);
+
+    std::vector<int> expected;
+    std::mt19937 gen(11);
+    for (int i = 0; i < 3000; ++i) {
+        switch (gen() % 5) {
+        case 0:
+        case 1:
+            v.push_back(i);
+            expected.push_back(i);
+            break;
+        case 2: {
+            std::size_t const at = gen() % (v.size() + 1);
+            v.insert(v.begin() + at, -i);
+            expected.insert(expected.begin() + at, -i);
+            break;
+        }
+        case 3:
+            if (!v.empty()) {
+                std::size_t const at = gen() % v.size();
+                std::size_t const n = gen() % (v.size() - at + 1);
+                v.erase(v.begin() + at, v.begin() + at + n);
+                expected.erase(
+                    expected.begin() + at, expected.begin() + at + n);
+            }
+            break;
+        default: {
+            std::size_t const at = gen() % (v.size() + 1);
+            int const more[] = {i, i + 1, i + 2};
+            v.insert(v.begin() + at, std::begin(more), std::end(more));
+            expected.insert(
+                expected.begin() + at, std::begin(more), std::end(more));
+            break;
+        }
+        }
+        ASSERT_EQ(v.size(), expected.size());
+        ASSERT_TRUE(std::equal(v.begin(), v.end(), expected.begin()));
+        expect_padded(v);
+    }
+
+    v.reserve(5000);
+    EXPECT_LE(5000u, v.capacity());
+    expect_padded(v);
+    v.resize(10);
+    EXPECT_EQ(v.size(), 10u);
+    expect_padded(v);
+    v.resize(12, 7);
+    EXPECT_EQ(v.back(), 7);
+    expect_padded(v);
+
+    vec_t copy = v;
+    EXPECT_EQ(copy, v);
+    vec_t moved = std::move(copy);
+    EXPECT_EQ(moved, v);
+    EXPECT_TRUE(copy.empty());
+    expect_padded(copy);
+
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    expect_padded(v);
+    v.shrink_to_fit();
+    expect_padded(v);
+
+    vec_t const il = {3, 1, 2};
+    EXPECT_EQ(il.size(), 3u);
+    EXPECT_EQ(il.at(1), 1);
+    EXPECT_THROW(il.at(3), std::out_of_range);
+    expect_padded(il);
+}
+
+TEST(std_padded_vector, flat_map_keys)
+{
+    using map_t = std::flat_map<
+        std::uint32_t,
+        int,
+        std::less<std::uint32_t>,
+        std::padded_vector<std::uint32_t>>;
+    // The searches take the padded path only when the padding's order is
+    // the map's.
+    constexpr std::size_t lanes =
+        std::flat_map_linear_search_threshold<std::uint32_t>::value;
+    static_assert(std::__has_padded_tail<
+                  std::padded_vector<std::uint32_t>,
+                  std::less<>,
+                  lanes>::value);
+    static_assert(!std::__has_padded_tail<
+                  std::padded_vector<std::uint32_t>,
+                  std::greater<std::uint32_t>,
+                  lanes>::value);
+    static_assert(!std::__has_padded_tail<
+                  std::vector<std::uint32_t>,
+                  std::less<std::uint32_t>,
+                  lanes>::value);
+
+    map_t map;
+    std::map<std::uint32_t, int> expected;
+    std::uint32_t const max = std::numeric_limits<std::uint32_t>::max();
+
+    // Lookups in the empty map read only the static padding.
+    EXPECT_EQ(map.find(0), map.end());
+    EXPECT_EQ(map.lower_bound(max), map.end());
+    EXPECT_EQ(map.upper_bound(max), map.end());
+
+    std::mt19937 gen(3);
+    for (int i = 0; i < 2000; ++i) {
+        // Keys equal to the sentinel are ordinary keys.
+        std::uint32_t const k = gen() % 8 ? gen() % 500 : max - gen() % 2;
+        if (gen() % 4) {
+            map.insert_or_assign(k, i);
+            expected[k] = i;
+        } else {
+            EXPECT_EQ(map.erase(k), expected.erase(k));
+        }
+        expect_padded(map.keys());
+
+        std::uint32_t const x = gen() % 8 ? gen() % 510 : max - gen() % 3;
+        EXPECT_EQ(
+            map.lower_bound(x) - map.begin(),
+            std::distance(expected.begin(), expected.lower_bound(x)));
+        EXPECT_EQ(
+            map.upper_bound(x) - map.begin(),
+            std::distance(expected.begin(), expected.upper_bound(x)));
+        EXPECT_EQ(map.contains(x), expected.count(x) == 1);
+        auto const it = expected.find(x);
+        EXPECT_EQ(
+            map.find_index(x),
+            it == expected.end()
+                ? map.npos
+                : std::size_t(std::distance(expected.begin(), it)));
+    }
+}
+
+TEST(std_padded_vector, descending_flat_map_keys)
+{
+    using map_t = std::flat_map<
+        double,
+        int,
+        std::greater<double>,
+        std::padded_vector<double, std::greater<double>>>;
+    map_t map;
+    std::map<double, int, std::greater<double>> expected;
+    double const inf = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < 300; ++i) {
+        double const k = i % 50 ? double(i % 97) : -inf;
+        map.try_emplace(k, i);
+        expected.try_emplace(k, i);
+    }
+    EXPECT_EQ(map.keys().sentinel(), -inf);
+    for (double x : {-inf, -1.0, 0.0, 0.5, 10.0, 96.0, 200.0, inf}) {
+        EXPECT_EQ(
+            map.lower_bound(x) - map.begin(),
+            std::distance(expected.begin(), expected.lower_bound(x)));
+        EXPECT_EQ(
+            map.upper_bound(x) - map.begin(),
+            std::distance(expected.begin(), expected.upper_bound(x)));
+    }
+}
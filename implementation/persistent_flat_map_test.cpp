@@ -0,0 +1,175 @@
+#include "persistent_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <map>
+#include <random>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Test instantiations.
+template class std::persistent_flat_map<int, double>;
+template class std::persistent_flat_map<long, int, std::greater<long>>;
+
+namespace {
+    template<typename Map, typename StdMap>
+    bool same_elements(Map const & map, StdMap const & expected)
+    {
+        return std::equal(
+            map.begin(),
+            map.end(),
+            expected.begin(),
+            expected.end(),
+            [](auto const & x, auto const & y) {
+                return x.first == y.first && x.second == y.second;
+            });
+    }
+}
+
+TEST(std_persistent_flat_map, against_std_map)
+{
+    char const * const path = "persistent_flat_map_test.std_map.bin";
+    std::remove(path);
+
+    std::map<int, int> expected;
+    std::mt19937 gen(9);
+    {
+        std::persistent_flat_map<int, int> map(path);
+        EXPECT_TRUE(map.empty());
+        EXPECT_EQ(map.capacity(), 0u);
+        for (int i = 0; i < 5000; ++i) {
+            int const k = int(gen() % 2000);
+            switch (gen() % 3) {
+            case 0:
+                EXPECT_EQ(
+                    map.try_emplace(k, i).second,
+                    expected.emplace(k, i).second);
+                break;
+            case 1: {
+                bool const inserted = !expected.count(k);
+                expected[k] = i;
+                auto const result = map.insert_or_assign(k, i);
+                EXPECT_EQ(result.second, inserted);
+                EXPECT_EQ(result.first->first, k);
+                EXPECT_EQ(result.first->second, i);
+                break;
+            }
+            case 2: EXPECT_EQ(map.erase(k), expected.erase(k)); break;
+            }
+            ASSERT_EQ(map.size(), expected.size());
+            if (i % 1000 == 999)
+                map.flush();
+        }
+        EXPECT_TRUE(same_elements(map, expected));
+        EXPECT_LE(map.size(), map.capacity());
+        map.flush();
+        EXPECT_EQ(map.dirty_pages(), 0u);
+    }
+
+    // Reopening finds the map as it was left.
+    std::persistent_flat_map<int, int> map(path);
+    EXPECT_TRUE(same_elements(map, expected));
+    for (int k = -1; k < 2001; ++k) {
+        EXPECT_EQ(map.contains(k), expected.count(k) == 1);
+    }
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    map.try_emplace(1, 1);
+    EXPECT_EQ(map.at(1), 1);
+    std::remove(path);
+}
+
+TEST(std_persistent_flat_map, dirty_pages)
+{
+    char const * const path = "persistent_flat_map_test.dirty.bin";
+    std::remove(path);
+    std::size_t const page = std::size_t(::sysconf(_SC_PAGESIZE));
+    std::size_t const per_page = page / sizeof(long);
+
+    std::persistent_flat_map<long, long, std::greater<long>> map(path);
+    long const n = long(per_page * 64);
+    map.reserve(std::size_t(n));
+    EXPECT_EQ(map.capacity(), std::size_t(n));
+    for (long i = n - 1; 0 <= i; --i) {
+        map.try_emplace(i, -i);
+    }
+    EXPECT_LE(128u, map.dirty_pages());
+    map.flush();
+    EXPECT_EQ(map.dirty_pages(), 0u);
+
+    // Assigning to an existing key writes only its value's page, and
+    // assigning to its neighbors writes the same one.
+    EXPECT_FALSE(map.insert_or_assign(n / 2, 7).second);
+    EXPECT_EQ(map.dirty_pages(), 1u);
+    EXPECT_FALSE(map.insert_or_assign(n / 2 + 1, 8).second);
+    EXPECT_EQ(map.dirty_pages(), 1u);
+    EXPECT_FALSE(map.insert_or_assign(0, 9).second);
+    EXPECT_EQ(map.dirty_pages(), 2u);
+    EXPECT_FALSE(map.try_emplace(1, 10).second);
+    EXPECT_EQ(map.dirty_pages(), 2u);
+    map.flush();
+
+    // Erasing a key near the end of the order shifts only the last page
+    // or two of each array, and writes the header's page.
+    EXPECT_EQ(map.erase(long(per_page) - 1), 1u);
+    EXPECT_LE(map.dirty_pages(), 5u);
+    map.flush();
+
+    // Growth moves every value.
+    EXPECT_TRUE(map.try_emplace(n, 0).second);
+    EXPECT_EQ(map.capacity(), std::size_t(n));
+    EXPECT_TRUE(map.try_emplace(n + 1, 0).second);
+    EXPECT_EQ(map.capacity(), std::size_t(2 * n));
+    EXPECT_LE(64u, map.dirty_pages());
+    map.flush();
+
+    EXPECT_EQ(map.size(), std::size_t(n + 1));
+    EXPECT_EQ(map.at(n / 2), 7);
+    EXPECT_EQ(map.at(n / 2 + 1), 8);
+    EXPECT_EQ(map.at(0), 9);
+    EXPECT_EQ(map.at(1), -1);
+    EXPECT_FALSE(map.contains(long(per_page) - 1));
+    EXPECT_EQ(map.begin()->first, n + 1);
+    std::remove(path);
+}
+
+TEST(std_persistent_flat_map, survives_process)
+{
+    char const * const path = "persistent_flat_map_test.process.bin";
+    std::remove(path);
+
+    // The child exits without unmapping; what it flushed is in the file.
+    pid_t const pid = ::fork();
+    ASSERT_LE(0, pid);
+    if (!pid) {
+        std::persistent_flat_map<int, double> map(path);
+        for (int i = 0; i < 10000; ++i) {
+            map.try_emplace(i * 3, i * 0.5);
+        }
+        map.flush();
+        ::_exit(map.size() == 10000 ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(::waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+
+    std::persistent_flat_map<int, double> map(path);
+    ASSERT_EQ(map.size(), 10000u);
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_EQ(map.at(i * 3), i * 0.5);
+    }
+    EXPECT_FALSE(map.contains(1));
+
+    auto moved = std::move(map);
+    EXPECT_EQ(moved.size(), 10000u);
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.capacity(), 0u);
+
+    // A file of other element types is refused.
+    EXPECT_THROW(
+        (std::persistent_flat_map<int, float>(path)), std::runtime_error);
+    std::remove(path);
+}
@@ -0,0 +1,155 @@
+#include "profiled_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+
+using map_t = std::flat_map<int, std::string>;
+
+// Test instantiations.
+template class std::profiled_flat_map<map_t>;
+
+TEST(profiled_flat_map, counts)
+{
+    std::profiled_flat_map<map_t> map;
+    EXPECT_EQ(map.recommendation(), "no accesses recorded");
+
+    map.try_emplace(5, "five");
+    map.try_emplace(1, "one");
+    map.try_emplace(9, "nine");
+    map.try_emplace(5, "again");
+    map.emplace_hint(map.end(), 10, "ten");
+    map[3] = "three";
+    EXPECT_EQ(map.at(5), "five");
+    EXPECT_TRUE(map.contains(9));
+    EXPECT_EQ(map.find(4), map.end());
+    map.erase(1);
+    map.erase(100);
+    std::vector<std::pair<int, std::string>> const more = {
+        {20, "a"}, {21, "b"}, {3, "dup"}};
+    map.insert(more.begin(), more.end());
+    int n = 0;
+    for (auto const & element : map) {
+        n += !element.second.empty();
+    }
+    EXPECT_EQ(n, 6);
+
+    auto const & p = map.profile();
+    EXPECT_EQ(p.inserts, 5u);
+    EXPECT_EQ(p.appends, 3u);
+    EXPECT_EQ(p.hinted, 1u);
+    EXPECT_EQ(p.failed_inserts, 1u);
+    EXPECT_EQ(p.bulk_inserts, 2u);
+    EXPECT_EQ(p.lookups, 3u);
+    EXPECT_EQ(p.erases, 1u);
+    EXPECT_EQ(p.iterations, 1u);
+    EXPECT_EQ(p.max_size, 6u);
+
+    std::ostringstream os;
+    map.report(os);
+    EXPECT_EQ(
+        os.str(),
+        "profiled_flat_map: lookups=3 inserts=5 (appends=3 hinted=1) "
+        "bulk_inserts=2 failed_inserts=1 erases=1 iterations=1 max_size=6; "
+        "insert-heavy: use buffered mode (buffered_flat_map)\n");
+
+    map.reset_profile();
+    EXPECT_EQ(map.profile().inserts, 0u);
+    EXPECT_EQ(map.profile().max_size, 6u);
+
+    map_t const released = std::move(map).release();
+    EXPECT_EQ(released.size(), 6u);
+}
+
+TEST(profiled_flat_map, recommendations)
+{
+    {
+        map_t source;
+        source.emplace(1, "one");
+        std::profiled_flat_map<map_t> map(source);
+        for (int i = 0; i < 10; ++i) {
+            map.contains(i);
+        }
+        EXPECT_EQ(
+            map.recommendation(),
+            "read-only: freeze to Eytzinger (frozen_flat_map)");
+    }
+    {
+        std::profiled_flat_map<map_t> map;
+        for (int i = 0; i < 100; ++i) {
+            map.try_emplace(i, "x");
+        }
+        EXPECT_EQ(
+            map.recommendation(),
+            "sorted appends detected: use hinted insert "
+            "(emplace_hint(end(), ...)) or insert(sorted_unique, ...)");
+    }
+    {
+        std::profiled_flat_map<map_t> map;
+        for (int i = 0; i < 100; ++i) {
+            map.try_emplace((i * 37) % 101, "x");
+        }
+        EXPECT_EQ(
+            map.recommendation(),
+            "insert-heavy: use buffered mode (buffered_flat_map)");
+        for (int i = 0; i < 100; ++i) {
+            map.contains(i);
+            map.contains(i);
+            map.erase(i);
+        }
+        EXPECT_EQ(
+            map.recommendation(), "lookup-heavy: flat_map suits this use");
+        std::vector<std::pair<int, std::string>> bulk;
+        for (int i = 0; i < 200; ++i) {
+            bulk.emplace_back(i, "y");
+        }
+        map.insert(bulk.begin(), bulk.end());
+        for (int i = 0; i < 150; ++i) {
+            map.erase(i);
+        }
+        EXPECT_EQ(
+            map.recommendation(),
+            "erase-heavy: batch erasures with erase_if() or "
+            "erase(sorted_unique, ...)");
+    }
+    {
+        std::profiled_flat_map<std::flat_map<int, int>> map;
+        for (int i = 0; i < (1 << 16); ++i) {
+            map.try_emplace((i * 7919) % (1 << 16), i);
+        }
+        EXPECT_EQ(
+            map.recommendation(),
+            "insert-heavy and large: use segmented_flat_map");
+    }
+
+    // The stats of an instrumented map are reported too.
+    {
+        using instrumented_t = std::flat_map<
+            int,
+            int,
+            std::instrumented_compare<std::less<int>>>;
+        std::profiled_flat_map<instrumented_t> map;
+        map.try_emplace(2, 2);
+        map.try_emplace(1, 1);
+        std::ostringstream os;
+        map.report(os);
+        EXPECT_NE(os.str().find(" elements_moved=1 "), std::string::npos);
+    }
+
+    // A named map reports when it is destroyed.
+    std::streambuf * const old = std::clog.rdbuf();
+    std::ostringstream os;
+    std::clog.rdbuf(os.rdbuf());
+    {
+        std::profiled_flat_map<map_t> map(map_t(), "sessions");
+        map.contains(1);
+    }
+    std::clog.rdbuf(old);
+    EXPECT_EQ(
+        os.str(),
+        "profiled_flat_map sessions: lookups=1 inserts=0 (appends=0 "
+        "hinted=0) bulk_inserts=0 failed_inserts=0 erases=0 iterations=0 "
+        "max_size=0; read-only: freeze to Eytzinger (frozen_flat_map)\n");
+}
@@ -0,0 +1,202 @@
+#include "roaring_flat_set"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+    // Keys in a few chunks: a sparse one, a dense one that takes a bitmap,
+    // and one of long runs.
+    std::vector<std::uint32_t> mixed_keys(std::mt19937 & gen)
+    {
+        std::vector<std::uint32_t> keys;
+        for (int i = 0; i < 500; ++i) {
+            keys.push_back(gen() % 65536);
+        }
+        for (int i = 0; i < 20000; ++i) {
+            keys.push_back(3 * 65536 + gen() % 65536);
+        }
+        for (std::uint32_t run = 0; run < 10; ++run) {
+            for (std::uint32_t x = 0; x < 1000 + run; ++x) {
+                keys.push_back(7 * 65536 + run * 5000 + x);
+            }
+        }
+        keys.push_back(0xffffffff);
+        return keys;
+    }
+
+    bool
+    same(std::roaring_flat_set const & s, std::set<std::uint32_t> const & t)
+    {
+        return s.size() == t.size() &&
+               std::equal(s.begin(), s.end(), t.begin(), t.end());
+    }
+}
+
+TEST(std_roaring_flat_set, lookups)
+{
+    std::roaring_flat_set s = {5, 1, 70000, 3, 1, 0xffffffff};
+    EXPECT_EQ(s.size(), 5u);
+    EXPECT_EQ(
+        s.keys(), (std::vector<std::uint32_t>{1, 3, 5, 70000, 0xffffffff}));
+    EXPECT_TRUE(s.contains(70000));
+    EXPECT_FALSE(s.contains(4));
+    EXPECT_EQ(s.count(0xffffffff), 1u);
+    EXPECT_EQ(*s.lower_bound(6), 70000u);
+    EXPECT_EQ(*s.upper_bound(5), 70000u);
+    EXPECT_EQ(s.upper_bound(0xffffffff), s.end());
+    EXPECT_EQ(s.find(4), s.end());
+    EXPECT_EQ(*s.find(3), 3u);
+    EXPECT_EQ(s.rank(0), 0u);
+    EXPECT_EQ(s.rank(5), 2u);
+    EXPECT_EQ(s.rank(6), 3u);
+    EXPECT_EQ(s.rank(0xffffffff), 4u);
+    EXPECT_EQ(s.select(3), 70000u);
+
+    EXPECT_FALSE(s.insert(3).second);
+    EXPECT_EQ(*s.insert(4).first, 4u);
+    EXPECT_EQ(s.erase(70000), 1u);
+    EXPECT_EQ(s.erase(70000), 0u);
+    EXPECT_EQ(
+        s.to_flat_set(),
+        (std::flat_set<std::uint32_t>{1, 3, 4, 5, 0xffffffff}));
+    EXPECT_EQ(std::roaring_flat_set(s.to_flat_set()), s);
+}
+
+TEST(std_roaring_flat_set, containers)
+{
+    std::mt19937 gen(3);
+    std::vector<std::uint32_t> const keys = mixed_keys(gen);
+    std::set<std::uint32_t> const t(keys.begin(), keys.end());
+    std::roaring_flat_set s(keys.begin(), keys.end());
+    EXPECT_TRUE(same(s, t));
+    std::roaring_flat_set const sorted(std::sorted_unique, t.begin(), t.end());
+    EXPECT_EQ(sorted, s);
+
+    std::size_t const before = s.memory_usage();
+    s.run_optimize();
+    EXPECT_LT(s.memory_usage(), before);
+    EXPECT_EQ(sorted, s);
+    EXPECT_TRUE(same(s, t));
+
+    std::vector<std::uint32_t> const ordered(t.begin(), t.end());
+    for (int i = 0; i < 2000; ++i) {
+        std::uint32_t const x = i < 1000 ? gen() % (8 * 65536) : gen();
+        EXPECT_EQ(s.contains(x), t.count(x) == 1);
+        std::size_t const rank =
+            std::lower_bound(ordered.begin(), ordered.end(), x) -
+            ordered.begin();
+        EXPECT_EQ(s.rank(x), rank);
+        auto const it = s.lower_bound(x);
+        EXPECT_EQ(
+            it == s.end() ? 0 : *it,
+            rank == ordered.size() ? 0 : ordered[rank]);
+        std::size_t const i_th = gen() % ordered.size();
+        EXPECT_EQ(s.select(i_th), ordered[i_th]);
+    }
+
+    // Mutating a run chunk expands it first.
+    std::set<std::uint32_t> t2 = t;
+    for (std::uint32_t x = 7 * 65536; x < 7 * 65536 + 20000; x += 7) {
+        EXPECT_EQ(s.erase(x), t2.erase(x));
+        EXPECT_EQ(s.insert(x + 3).second, t2.insert(x + 3).second);
+    }
+    EXPECT_TRUE(same(s, t2));
+
+    // Erasures take a bitmap chunk back to an array.
+    for (std::uint32_t x = 3 * 65536; x < 4 * 65536; ++x) {
+        if (x % 11) {
+            EXPECT_EQ(s.erase(x), t2.erase(x));
+        }
+    }
+    EXPECT_TRUE(same(s, t2));
+    s.clear();
+    EXPECT_TRUE(s.empty());
+    EXPECT_EQ(s.begin(), s.end());
+}
+
+TEST(std_roaring_flat_set, set_operations)
+{
+    std::mt19937 gen(7);
+    for (int round = 0; round < 4; ++round) {
+        std::vector<std::uint32_t> a = mixed_keys(gen);
+        std::vector<std::uint32_t> b = mixed_keys(gen);
+        for (int i = 0; i < 3000; ++i) {
+            b.push_back(65536 + gen() % 65536);
+            a.push_back(5 * 65536 + gen() % 200);
+        }
+        std::set<std::uint32_t> const ta(a.begin(), a.end());
+        std::set<std::uint32_t> const tb(b.begin(), b.end());
+        std::roaring_flat_set sa(a.begin(), a.end());
+        std::roaring_flat_set sb(b.begin(), b.end());
+        if (round & 1)
+            sa.run_optimize();
+        if (round & 2)
+            sb.run_optimize();
+
+        std::set<std::uint32_t> expected;
+        std::set_intersection(
+            ta.begin(),
+            ta.end(),
+            tb.begin(),
+            tb.end(),
+            std::inserter(expected, expected.end()));
+        EXPECT_TRUE(same(flat_intersection(sa, sb), expected));
+        EXPECT_EQ(intersection_size(sa, sb), expected.size());
+
+        expected.clear();
+        std::set_union(
+            ta.begin(),
+            ta.end(),
+            tb.begin(),
+            tb.end(),
+            std::inserter(expected, expected.end()));
+        EXPECT_TRUE(same(flat_union(sa, sb), expected));
+
+        expected.clear();
+        std::set_difference(
+            ta.begin(),
+            ta.end(),
+            tb.begin(),
+            tb.end(),
+            std::inserter(expected, expected.end()));
+        EXPECT_TRUE(same(flat_difference(sa, sb), expected));
+
+        sa.insert(b.begin(), b.end());
+        EXPECT_EQ(
+            sa, flat_union(sb, std::roaring_flat_set(a.begin(), a.end())));
+    }
+}
+
+TEST(std_roaring_flat_set, random_operations)
+{
+    std::roaring_flat_set s;
+    std::set<std::uint32_t> t;
+    std::mt19937 gen(11);
+    for (int i = 0; i < 40000; ++i) {
+        // Mostly one chunk, to cross the array and bitmap bound.
+        std::uint32_t const x =
+            gen() % 8 ? gen() % 9000 : std::uint32_t(gen());
+        switch (gen() % 4) {
+        case 0:
+        case 1:
+            EXPECT_EQ(s.insert(x).second, t.insert(x).second);
+            break;
+        case 2:
+            EXPECT_EQ(s.erase(x), t.erase(x));
+            break;
+        case 3:
+            EXPECT_EQ(s.contains(x), t.count(x) == 1);
+            break;
+        }
+        if (i % 5000 == 0) {
+            s.run_optimize();
+            ASSERT_TRUE(same(s, t));
+        }
+    }
+    EXPECT_TRUE(same(s, t));
+}
@@ -0,0 +1,147 @@
+#include "sampled_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+using map_t = std::flat_map<int, std::string>;
+
+// Test instantiations.
+template class std::sampled_flat_map<map_t>;
+
+TEST(sampled_flat_map, every_operation)
+{
+    std::latency_sampler sampler(1);
+    std::sampled_flat_map<map_t> map(sampler);
+
+    map.try_emplace(5, "five");
+    map.emplace(1, "one");
+    map[3] = "three";
+    map.insert_or_assign(5, "FIVE");
+    EXPECT_EQ(map.at(5), "FIVE");
+    EXPECT_THROW(map.at(4), std::out_of_range);
+    EXPECT_TRUE(map.contains(1));
+    EXPECT_EQ(map.find(2), map.end());
+    EXPECT_EQ(map.lower_bound(2)->first, 3);
+    std::vector<std::pair<int, std::string>> const more = {
+        {7, "seven"}, {9, "nine"}};
+    map.insert(more.begin(), more.end());
+    EXPECT_EQ(map.erase(9), 1u);
+    map.erase(map.find(7));
+    auto const erased =
+        erase_if(map, [](auto const & x) { return x.first < 2; });
+    EXPECT_EQ(erased, 1u);
+    EXPECT_EQ(map.size(), 2u);
+
+    auto const lookups = sampler.histogram(std::flat_map_operation::lookup);
+    EXPECT_EQ(lookups.count, 6u);
+    EXPECT_EQ(
+        std::accumulate(
+            lookups.buckets.begin(), lookups.buckets.end(), uint64_t(0)),
+        6u);
+    EXPECT_GT(lookups.quantile(0.5).count(), 0);
+    EXPECT_EQ(sampler.histogram(std::flat_map_operation::insert).count, 4u);
+    EXPECT_EQ(sampler.histogram(std::flat_map_operation::erase).count, 2u);
+    EXPECT_EQ(sampler.histogram(std::flat_map_operation::bulk).count, 2u);
+
+    std::vector<std::flat_map_operation> ops;
+    sampler.export_to(
+        [&](std::flat_map_operation op, std::latency_histogram const & h) {
+            ops.push_back(op);
+            EXPECT_EQ(h.count, sampler.histogram(op).count);
+        });
+    EXPECT_EQ(ops.size(), 4u);
+    EXPECT_EQ(ops[0], std::flat_map_operation::lookup);
+    EXPECT_EQ(ops[3], std::flat_map_operation::bulk);
+
+    sampler.reset();
+    EXPECT_EQ(sampler.histogram(std::flat_map_operation::lookup).count, 0u);
+    EXPECT_EQ(
+        sampler.histogram(std::flat_map_operation::lookup).sum.count(), 0);
+}
+
+TEST(sampled_flat_map, buckets)
+{
+    using h = std::latency_histogram;
+    using ns = std::chrono::nanoseconds;
+
+    EXPECT_EQ(h::bucket_of(ns(0)), 0u);
+    EXPECT_EQ(h::bucket_of(ns(1)), 0u);
+    EXPECT_EQ(h::bucket_of(ns(2)), 1u);
+    EXPECT_EQ(h::bucket_of(ns(3)), 1u);
+    EXPECT_EQ(h::bucket_of(ns(1000)), 9u);
+    EXPECT_EQ(h::bucket_of(ns::max()), h::bucket_count - 1);
+    for (std::size_t i = 0; i + 1 < h::bucket_count; ++i) {
+        EXPECT_EQ(h::bucket_of(h::bucket_bound(i) - ns(1)), i);
+        EXPECT_EQ(h::bucket_of(h::bucket_bound(i)), i + 1);
+    }
+
+    h hist;
+    hist.buckets[2] = 90;
+    hist.buckets[10] = 10;
+    hist.count = 100;
+    EXPECT_EQ(hist.quantile(0.5), h::bucket_bound(2));
+    EXPECT_EQ(hist.quantile(0.9), h::bucket_bound(2));
+    EXPECT_EQ(hist.quantile(0.99), h::bucket_bound(10));
+    EXPECT_EQ(h().quantile(0.5), ns(0));
+}
+
+TEST(sampled_flat_map, one_in_n_across_threads)
+{
+    std::latency_sampler sampler(4);
+    int const threads = 4;
+    int const per_thread = 1000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&sampler, t] {
+            std::sampled_flat_map<std::flat_map<int, int>> map(sampler);
+            for (int i = 0; i < per_thread; ++i) {
+                map.try_emplace(t * per_thread + i, i);
+            }
+        });
+    }
+    for (auto & w : workers) {
+        w.join();
+    }
+    // Each thread has a shard of its own, and samples exactly 1 in 4.
+    EXPECT_EQ(
+        sampler.histogram(std::flat_map_operation::insert).count,
+        std::uint64_t(threads * per_thread / 4));
+}
+
+TEST(sampled_flat_map, prometheus)
+{
+    std::latency_sampler sampler(1);
+    std::sampled_flat_map<map_t> map(sampler);
+    map.try_emplace(1, "one");
+    map.find(1);
+    map.find(2);
+
+    std::ostringstream os;
+    std::write_prometheus(os, sampler, "flat_map_latency_seconds");
+    std::string const text = os.str();
+    EXPECT_EQ(
+        text.find("# TYPE flat_map_latency_seconds histogram\n"),
+        text.find('\n') + 1);
+    EXPECT_NE(
+        text.find(
+            "flat_map_latency_seconds_bucket{op=\"lookup\",le=\"2e-09\"}"),
+        std::string::npos);
+    EXPECT_NE(
+        text.find("flat_map_latency_seconds_bucket{op=\"lookup\",le=\"+Inf\"} "
+                  "2\n"),
+        std::string::npos);
+    EXPECT_NE(
+        text.find("flat_map_latency_seconds_count{op=\"insert\"} 1\n"),
+        std::string::npos);
+    EXPECT_NE(
+        text.find("flat_map_latency_seconds_count{op=\"erase\"} 0\n"),
+        std::string::npos);
+}
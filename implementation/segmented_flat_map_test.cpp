@@ -0,0 +1,174 @@
+#include "segmented_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+
+// Test instantiations.
+template class std::segmented_flat_map<std::string, int>;
+
+namespace {
+    template<class Map, class StdMap>
+    bool same_elements(Map const & map, StdMap const & std_map)
+    {
+        return map.size() == std_map.size() &&
+               std::equal(
+                   map.begin(),
+                   map.end(),
+                   std_map.begin(),
+                   std_map.end(),
+                   [](auto const & x, auto const & y) {
+                       return x.first == y.first && x.second == y.second;
+                   });
+    }
+
+    template<class Map>
+    bool blocks_valid(Map const & map)
+    {
+        for (std::size_t i = 0; i < map.block_count(); ++i) {
+            auto const & block = map.blocks()[i];
+            if (block.empty() || Map::block_size < block.size())
+                return false;
+            if (i && !(map.blocks()[i - 1].rbegin()->first <
+                       block.begin()->first)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST(std_segmented_flat_map, construction)
+{
+    using smap_t = std::segmented_flat_map<int, int, std::less<int>, 8>;
+
+    smap_t empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.begin(), empty.end());
+    EXPECT_EQ(empty.block_count(), 0u);
+
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < 100; ++i) {
+        pairs.emplace_back((i * 37) % 50, i);
+    }
+    smap_t const map(pairs.begin(), pairs.end());
+    std::map<int, int> const std_map(pairs.begin(), pairs.end());
+    EXPECT_TRUE(same_elements(map, std_map));
+    EXPECT_TRUE(blocks_valid(map));
+    EXPECT_EQ(map.block_count(), 9u);
+
+    smap_t const il = {{3, 3}, {1, 1}, {2, 2}, {1, 10}};
+    EXPECT_EQ(il.size(), 3u);
+    EXPECT_EQ(il.at(1), 1);
+    EXPECT_THROW(il.at(4), std::out_of_range);
+}
+
+TEST(std_segmented_flat_map, random_operations)
+{
+    using smap_t = std::segmented_flat_map<int, int, std::less<int>, 8>;
+
+    smap_t map;
+    std::map<int, int> std_map;
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<int> key(0, 499);
+    for (int i = 0; i < 5000; ++i) {
+        int const k = key(gen);
+        switch (gen() % 4) {
+        case 0:
+        case 1: {
+            auto const result = map.try_emplace(k, i);
+            EXPECT_EQ(result.second, std_map.try_emplace(k, i).second);
+            EXPECT_EQ(result.first->first, k);
+            break;
+        }
+        case 2:
+            EXPECT_EQ(map.erase(k), std_map.erase(k));
+            break;
+        case 3: {
+            auto const it = map.lower_bound(k);
+            auto const std_it = std_map.lower_bound(k);
+            if (std_it == std_map.end()) {
+                EXPECT_EQ(it, map.end());
+            } else {
+                EXPECT_EQ(it->first, std_it->first);
+                it->second = -i;
+                std_it->second = -i;
+            }
+            break;
+        }
+        }
+    }
+    EXPECT_TRUE(same_elements(map, std_map));
+    EXPECT_TRUE(blocks_valid(map));
+    EXPECT_LT(1u, map.block_count());
+
+    for (int k = -1; k < 501; ++k) {
+        EXPECT_EQ(map.contains(k), std_map.count(k) == 1);
+        auto const upper = map.upper_bound(k);
+        auto const std_upper = std_map.upper_bound(k);
+        EXPECT_EQ(upper == map.end(), std_upper == std_map.end());
+        if (std_upper != std_map.end()) {
+            EXPECT_EQ(upper->first, std_upper->first);
+        }
+    }
+
+    EXPECT_TRUE(std::equal(
+        map.rbegin(),
+        map.rend(),
+        std_map.rbegin(),
+        std_map.rend(),
+        [](auto const & x, auto const & y) { return x.first == y.first; }));
+}
+
+TEST(std_segmented_flat_map, erase_iterator)
+{
+    using smap_t = std::segmented_flat_map<int, int, std::less<int>, 4>;
+
+    smap_t map;
+    for (int i = 0; i < 40; ++i) {
+        map[i] = i;
+    }
+    EXPECT_TRUE(blocks_valid(map));
+
+    int expected = 0;
+    for (auto it = map.begin(); it != map.end();) {
+        EXPECT_EQ(it->first, expected);
+        if (it->first % 3)
+            it = map.erase(it);
+        else
+            ++it;
+        ++expected;
+        EXPECT_TRUE(blocks_valid(map));
+    }
+    EXPECT_EQ(map.size(), 14u);
+    for (auto const & x : map) {
+        EXPECT_EQ(x.first % 3, 0);
+    }
+    while (!map.empty()) {
+        map.erase(std::prev(map.end()));
+    }
+    EXPECT_EQ(map.block_count(), 0u);
+}
+
+TEST(std_segmented_flat_map, insert_or_assign)
+{
+    using smap_t = std::segmented_flat_map<std::string, int>;
+
+    smap_t map;
+    EXPECT_TRUE(map.insert_or_assign("a", 1).second);
+    EXPECT_FALSE(map.insert_or_assign("a", 2).second);
+    EXPECT_TRUE(map.emplace("b", 3).second);
+    EXPECT_TRUE(map.insert({"c", 4}).second);
+    EXPECT_EQ(map.at("a"), 2);
+    EXPECT_EQ(map.count("b"), 1u);
+    EXPECT_EQ(map.find("d"), map.end());
+
+    smap_t other = {{"a", 2}, {"b", 3}, {"c", 4}};
+    EXPECT_EQ(map, other);
+    other["d"] = 5;
+    EXPECT_NE(map, other);
+    std::swap(map, other);
+    EXPECT_EQ(map.size(), 4u);
+}
@@ -0,0 +1,129 @@
+#include "seqlock_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <thread>
+
+// Test instantiations.
+template class std::seqlock_flat_map<int, double>;
+template class std::seqlock_flat_map<long, int, std::greater<long>>;
+
+TEST(std_seqlock_flat_map, against_std_map)
+{
+    std::seqlock_flat_map<int, int> map;
+    std::map<int, int> expected;
+    std::mt19937 gen(5);
+    for (int i = 0; i < 5000; ++i) {
+        int const k = int(gen() % 300);
+        switch (gen() % 4) {
+        case 0:
+            EXPECT_EQ(map.try_emplace(k, i), expected.emplace(k, i).second);
+            break;
+        case 1: {
+            bool const inserted = !expected.count(k);
+            expected[k] = i;
+            EXPECT_EQ(map.insert_or_assign(k, i), inserted);
+            break;
+        }
+        case 2: EXPECT_EQ(map.erase(k), expected.erase(k)); break;
+        case 3: {
+            auto const it = expected.find(k);
+            if (it == expected.end()) {
+                EXPECT_EQ(map.find(k), std::nullopt);
+                EXPECT_FALSE(map.contains(k));
+            } else {
+                EXPECT_EQ(map.find(k), it->second);
+                EXPECT_TRUE(map.contains(k));
+            }
+            break;
+        }
+        }
+        ASSERT_EQ(map.size(), expected.size());
+    }
+
+    auto const snapshot = map.snapshot();
+    EXPECT_TRUE(std::equal(
+        snapshot.begin(),
+        snapshot.end(),
+        expected.begin(),
+        expected.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second == y.second;
+        }));
+    EXPECT_EQ(snapshot, map.base());
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(0), std::nullopt);
+}
+
+TEST(std_seqlock_flat_map, reserve)
+{
+    std::flat_map<long, int, std::greater<long>> m;
+    m.emplace(1, 1);
+    m.emplace(2, 2);
+    std::seqlock_flat_map<long, int, std::greater<long>> map(m);
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(map.base().begin()->first, 2);
+
+    // Inserts within the reserved room keep the elements where they are.
+    map.reserve(1000);
+    long const * const keys = map.base().keys().data();
+    for (long i = 0; i < 1000; ++i) {
+        map.try_emplace(i, int(i));
+    }
+    EXPECT_EQ(map.base().keys().data(), keys);
+    EXPECT_EQ(map.size(), 1000u);
+    EXPECT_EQ(map.find(999), 999);
+}
+
+TEST(std_seqlock_flat_map, concurrent_readers)
+{
+    // Each value holds its key, so a read that mixes two writes shows up
+    // as a value for the wrong key.
+    struct value
+    {
+        int key;
+        int generation;
+    };
+    std::seqlock_flat_map<int, value> map;
+
+    constexpr int keys = 2000;
+    std::atomic<bool> done{false};
+    std::atomic<bool> mismatch{false};
+    std::atomic<long> hits{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&, t] {
+            std::mt19937 gen(t);
+            long n = 0;
+            while (!done) {
+                int const k = int(gen() % keys);
+                if (auto const v = map.find(k)) {
+                    ++n;
+                    if (v->key != k)
+                        mismatch = true;
+                }
+            }
+            hits += n;
+        });
+    }
+
+    // The map grows from its initial room while the readers run.
+    std::mt19937 gen(99);
+    for (int i = 0; i < 100000; ++i) {
+        int const k = int(gen() % keys);
+        if (gen() % 3)
+            map.insert_or_assign(k, value{k, i});
+        else
+            map.erase(k);
+    }
+    done = true;
+    for (auto & r : readers) {
+        r.join();
+    }
+    EXPECT_FALSE(mismatch);
+    EXPECT_GT(hits, 0);
+}
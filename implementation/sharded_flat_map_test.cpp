@@ -0,0 +1,89 @@
+#include "sharded_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <thread>
+
+// Test instantiations.
+template class std::sharded_flat_map<std::flat_map<std::string, int>>;
+
+TEST(std_sharded_flat_map, hash_shards)
+{
+    using fmap_t = std::flat_map<int, int>;
+    using partitioner_t = std::hash_partitioner<int>;
+
+    std::sharded_flat_map<fmap_t> map(partitioner_t(8));
+    EXPECT_EQ(map.shard_count(), 8u);
+
+    std::map<int, int> std_map;
+    for (int i = 0; i < 3000; ++i) {
+        int const key = (i * 7919) % 2003;
+        EXPECT_EQ(map.try_emplace(key, i), std_map.try_emplace(key, i).second);
+    }
+    EXPECT_FALSE(map.insert_or_assign(5, -5));
+    std_map[5] = -5;
+    EXPECT_EQ(map.erase(6), 1u);
+    EXPECT_EQ(map.erase(6), 0u);
+    std_map.erase(6);
+
+    EXPECT_EQ(map.size(), std_map.size());
+    EXPECT_EQ(map.find(5), std::optional<int>(-5));
+    EXPECT_EQ(map.find(6), std::nullopt);
+    EXPECT_TRUE(map.contains(7));
+
+    int nonempty_shards = 0;
+    for (std::size_t i = 0; i < map.shard_count(); ++i) {
+        nonempty_shards += map.visit_shard(
+            i, [](fmap_t const & shard) { return shard.empty() ? 0 : 1; });
+    }
+    EXPECT_EQ(nonempty_shards, 8);
+
+    auto const ordered = map.ordered();
+    EXPECT_TRUE(std::equal(
+        ordered.begin(),
+        ordered.end(),
+        std_map.begin(),
+        std_map.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second == y.second;
+        }));
+}
+
+TEST(std_sharded_flat_map, range_shards_concurrent_writers)
+{
+    using fmap_t = std::flat_map<int, int>;
+    using partitioner_t = std::range_partitioner<int>;
+
+    std::sharded_flat_map<fmap_t, partitioner_t> map(
+        partitioner_t({1000, 2000, 3000}));
+    EXPECT_EQ(map.shard_count(), 4u);
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&map, t] {
+            for (int i = 0; i < 4000; ++i) {
+                if (i % 4 == t)
+                    map.try_emplace(i, -i);
+            }
+        });
+    }
+    for (auto & writer : writers) {
+        writer.join();
+    }
+
+    EXPECT_EQ(map.size(), 4000u);
+    {
+        int expected = 0;
+        auto const ordered = map.ordered();
+        for (auto const & x : ordered) {
+            EXPECT_EQ(x.first, expected);
+            EXPECT_EQ(x.second, -expected);
+            ++expected;
+        }
+        EXPECT_EQ(expected, 4000);
+    }
+    auto const first_key = [](fmap_t & m) { return m.begin()->first; };
+    EXPECT_EQ(map.visit_shard(1, first_key), 1000);
+}
@@ -0,0 +1,123 @@
+#include "small_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+// Test instantiations.
+template class std::small_vector<std::string, 4>;
+template class std::flat_map<
+    std::string,
+    int,
+    std::less<std::string>,
+    std::small_vector<std::string, 4>,
+    std::small_vector<int, 4>>;
+
+TEST(std_small_vector, inline_and_heap)
+{
+    using vec_t = std::small_vector<std::string, 4>;
+
+    vec_t v;
+    EXPECT_TRUE(v.empty());
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ(v.capacity(), 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        v.push_back(std::to_string(i));
+    }
+    EXPECT_TRUE(v.is_inline());
+    v.emplace_back("4");
+    EXPECT_FALSE(v.is_inline());
+    EXPECT_EQ(v, (vec_t{"0", "1", "2", "3", "4"}));
+
+    v.insert(v.begin() + 1, "a");
+    v.insert(v.end(), {"b", "c"});
+    v.insert(v.begin(), 2, "d");
+    EXPECT_EQ(v, (vec_t{"d", "d", "0", "a", "1", "2", "3", "4", "b", "c"}));
+
+    v.erase(v.begin(), v.begin() + 7);
+    EXPECT_EQ(v, (vec_t{"4", "b", "c"}));
+    v.shrink_to_fit();
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ(v, (vec_t{"4", "b", "c"}));
+
+    // An argument that refers to an element must survive the growth.
+    v.push_back("e");
+    v.push_back(v[0]);
+    EXPECT_EQ(v.back(), "4");
+    v.emplace(v.begin(), v[1]);
+    EXPECT_EQ(v.front(), "b");
+
+    v.resize(2);
+    EXPECT_EQ(v, (vec_t{"b", "4"}));
+    v.resize(3, "x");
+    EXPECT_EQ(v.at(2), "x");
+    EXPECT_THROW(v.at(3), std::out_of_range);
+    v.pop_back();
+    EXPECT_EQ(v.size(), 2u);
+}
+
+TEST(std_small_vector, copy_move_swap)
+{
+    using vec_t = std::small_vector<std::string, 2>;
+
+    vec_t small = {"a"};
+    vec_t big = {"b", "c", "d"};
+
+    vec_t copy = big;
+    EXPECT_EQ(copy, big);
+    copy = small;
+    EXPECT_EQ(copy, small);
+
+    vec_t moved_big = std::move(big);
+    EXPECT_EQ(moved_big, (vec_t{"b", "c", "d"}));
+    EXPECT_TRUE(big.empty());
+    vec_t moved_small = std::move(small);
+    EXPECT_EQ(moved_small, vec_t{"a"});
+
+    swap(moved_small, moved_big);
+    EXPECT_EQ(moved_small, (vec_t{"b", "c", "d"}));
+    EXPECT_EQ(moved_big, vec_t{"a"});
+    EXPECT_TRUE(moved_big.is_inline());
+
+    vec_t other_big = {"e", "f", "g", "h"};
+    swap(moved_small, other_big);
+    EXPECT_EQ(moved_small.size(), 4u);
+    EXPECT_EQ(other_big.size(), 3u);
+    EXPECT_LT(moved_big, moved_small);
+}
+
+TEST(std_small_flat_map, no_allocation_while_small)
+{
+    using map_t = std::small_flat_map<int, std::string, 8>;
+
+    map_t map;
+    std::map<int, std::string> std_map;
+    for (int i = 0; i < 8; ++i) {
+        int const key = (i * 5) % 8;
+        map[key] = std::to_string(i);
+        std_map[key] = std::to_string(i);
+    }
+    EXPECT_TRUE(map.keys().is_inline());
+    EXPECT_TRUE(map.values().is_inline());
+    EXPECT_TRUE(std::equal(
+        map.begin(),
+        map.end(),
+        std_map.begin(),
+        std_map.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second == y.second;
+        }));
+
+    map.try_emplace(100, "big");
+    EXPECT_FALSE(map.keys().is_inline());
+    EXPECT_EQ(map.erase(3), 1u);
+    EXPECT_EQ(map.size(), 8u);
+    EXPECT_EQ(map.at(100), "big");
+
+    map_t const copy = map;
+    EXPECT_EQ(copy, map);
+    map_t const moved = std::move(map);
+    EXPECT_EQ(moved, copy);
+}
@@ -0,0 +1,128 @@
+#include "static_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+// Test instantiations.
+template class std::static_flat_map<std::string, int, 8>;
+
+namespace {
+    constexpr std::static_flat_map<int, int, 8> make_squares()
+    {
+        std::static_flat_map<int, int, 8> map;
+        for (int i = 7; 0 <= i; --i) {
+            map.try_emplace(i, i * i);
+        }
+        map.erase(0);
+        map.insert_or_assign(1, -1);
+        return map;
+    }
+
+    constexpr auto squares = make_squares();
+    static_assert(squares.size() == 7);
+    static_assert(squares.full() == false);
+    static_assert(squares.at(5) == 25);
+    static_assert(squares.find(1) != squares.end());
+    static_assert((*squares.find(1)).second == -1);
+    static_assert(!squares.contains(0));
+    static_assert(squares.lower_bound(0) == squares.begin());
+    static_assert(squares.upper_bound(7) == squares.end());
+
+    constexpr std::static_flat_map<int, char, 4> letters = {
+        {3, 'c'}, {1, 'a'}, {2, 'b'}, {1, 'z'}};
+    static_assert(letters.size() == 3);
+    static_assert(letters.at(1) == 'a');
+
+    static_assert(noexcept(
+        std::declval<std::static_flat_map<int, int, 4> &>().try_emplace(1, 1)));
+    static_assert(!noexcept(
+        std::declval<std::static_flat_map<std::string, int, 4> &>()
+            .try_emplace("a", 1)));
+}
+
+namespace {
+    constexpr auto opcodes = std::make_static_flat_map<std::string_view, int>(
+        {{"sub", 2},
+         {"add", 1},
+         {"jmp", 3},
+         {"add", 4},
+         {"nop", 0},
+         {"cmp", 5},
+         {"mov", 6}});
+    static_assert(opcodes.size() == 6);
+    static_assert(opcodes.at("add") == 1);
+    static_assert(opcodes.at("nop") == 0);
+    static_assert(!opcodes.contains("xor"));
+    static_assert((*opcodes.begin()).first == "add");
+    static_assert((*opcodes.rbegin()).first == "sub");
+
+    constexpr auto descending = std::make_static_flat_map(
+        {std::pair<int, int>{1, 1}, {3, 3}, {2, 2}}, std::greater<int>());
+    static_assert((*descending.begin()).first == 3);
+}
+
+TEST(std_static_flat_map, make_static_flat_map)
+{
+    std::vector<std::string_view> keys;
+    for (auto const & x : opcodes) {
+        keys.push_back(x.first);
+    }
+    EXPECT_EQ(
+        keys,
+        (std::vector<std::string_view>{
+            "add", "cmp", "jmp", "mov", "nop", "sub"}));
+    std::string const jmp = "jmp";
+    EXPECT_EQ(opcodes.at(jmp), 3);
+    EXPECT_EQ(opcodes.find("xor"), opcodes.end());
+}
+
+TEST(std_static_flat_map, full)
+{
+    using smap_t = std::static_flat_map<int, std::string, 4>;
+
+    smap_t map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(smap_t::capacity(), 4u);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(map.try_emplace(i * 2, std::to_string(i)).second);
+    }
+    EXPECT_TRUE(map.full());
+
+    auto const rejected = map.try_emplace(1, "odd");
+    EXPECT_FALSE(rejected.second);
+    EXPECT_EQ(rejected.first, map.end());
+
+    auto const existing = map.try_emplace(2, "other");
+    EXPECT_FALSE(existing.second);
+    EXPECT_EQ((*existing.first).second, "1");
+
+    EXPECT_EQ(map.insert_or_assign(4, "four").first, map.find(4));
+    EXPECT_EQ(map.at(4), "four");
+    EXPECT_THROW(map[5], std::length_error);
+    EXPECT_THROW(map.at(5), std::out_of_range);
+
+    EXPECT_EQ(map.erase(2), 1u);
+    EXPECT_TRUE(map.insert({3, "three"}).second);
+    EXPECT_EQ(map.size(), 4u);
+
+    std::vector<int> keys;
+    for (auto const & x : map) {
+        keys.push_back(x.first);
+    }
+    EXPECT_EQ(keys, (std::vector<int>{0, 3, 4, 6}));
+    EXPECT_EQ(map.key_data()[1], 3);
+    EXPECT_EQ(map.mapped_data()[1], "three");
+
+    std::pair<int, std::string> const too_many[] = {
+        {1, "a"}, {2, "b"}, {3, "c"}, {4, "d"}, {5, "e"}};
+    EXPECT_THROW(
+        smap_t(std::begin(too_many), std::end(too_many)), std::length_error);
+
+    smap_t copy = map;
+    EXPECT_EQ(copy, map);
+    copy.clear();
+    EXPECT_TRUE(copy.empty());
+    EXPECT_NE(copy, map);
+}
@@ -0,0 +1,273 @@
+#include "string_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+
+// Test instantiations.
+template class std::string_flat_map<int>;
+template class std::front_coded_strings<>;
+
+namespace {
+    std::string random_path(std::mt19937 & gen)
+    {
+        char const * const parts[] = {
+            "/api", "/v1", "/v2", "/users", "/items", "/a", "/b", "/c"};
+        std::string path;
+        int const depth = 1 + int(gen() % 5);
+        for (int i = 0; i < depth; ++i) {
+            path += parts[gen() % 8];
+        }
+        if (gen() % 2)
+            path += std::to_string(gen() % 1000);
+        return path;
+    }
+
+    template<class Map, class StdMap>
+    bool same_elements(Map const & map, StdMap const & std_map)
+    {
+        return map.size() == std_map.size() &&
+               std::equal(
+                   map.begin(),
+                   map.end(),
+                   std_map.begin(),
+                   std_map.end(),
+                   [](auto const & x, auto const & y) {
+                       return x.first == y.first && x.second == y.second;
+                   });
+    }
+}
+
+TEST(std_string_arena, modifiers)
+{
+    std::string_arena arena = {"b", "dd", ""};
+    EXPECT_EQ(arena.size(), 3u);
+    EXPECT_EQ(arena.char_size(), 3u);
+    EXPECT_EQ(arena[1], "dd");
+    EXPECT_EQ(arena.back(), "");
+
+    arena.insert(arena.begin(), "a");
+    arena.insert(arena.begin() + 2, "ccc");
+    std::vector<std::string> const expected = {"a", "b", "ccc", "dd", ""};
+    EXPECT_TRUE(std::equal(
+        arena.begin(), arena.end(), expected.begin(), expected.end()));
+
+    arena.erase(arena.begin() + 1);
+    arena.pop_back();
+    std::vector<std::string> const erased = {"a", "ccc", "dd"};
+    EXPECT_TRUE(
+        std::equal(arena.begin(), arena.end(), erased.begin(), erased.end()));
+    EXPECT_EQ(arena.char_size(), 6u);
+
+    // Inserting part of the arena into itself.
+    arena.insert(arena.begin() + 1, arena[1].substr(1));
+    arena.push_back(arena[2]);
+    std::vector<std::string> const aliased = {"a", "cc", "ccc", "dd", "ccc"};
+    EXPECT_TRUE(
+        std::equal(arena.begin(), arena.end(), aliased.begin(), aliased.end()));
+
+    arena.pop_back();
+    EXPECT_EQ(arena.lower_bound("b") - arena.begin(), 1);
+    EXPECT_EQ(arena.lower_bound("cc") - arena.begin(), 1);
+    EXPECT_EQ(arena.upper_bound("cc") - arena.begin(), 2);
+    EXPECT_EQ(arena.lower_bound("z") - arena.begin(), 4);
+
+    arena.clear();
+    EXPECT_TRUE(arena.empty());
+    EXPECT_EQ(arena.lower_bound("a"), arena.end());
+}
+
+TEST(std_string_flat_map, against_std_map)
+{
+    std::mt19937 gen(7);
+    std::string_flat_map<int> map;
+    std::map<std::string, int, std::less<>> std_map;
+
+    for (int i = 0; i < 3000; ++i) {
+        std::string const key = random_path(gen);
+        switch (gen() % 4) {
+        case 0:
+            EXPECT_EQ(map.erase(key), std_map.erase(key));
+            break;
+        case 1:
+            map.insert_or_assign(key, i);
+            std_map.insert_or_assign(key, i);
+            break;
+        default:
+            EXPECT_EQ(
+                map.try_emplace(key, i).second,
+                std_map.try_emplace(key, i).second);
+            break;
+        }
+    }
+    EXPECT_TRUE(same_elements(map, std_map));
+    EXPECT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+
+    for (int i = 0; i < 1000; ++i) {
+        std::string const key = random_path(gen);
+        EXPECT_EQ(map.contains(key), std_map.count(key) == 1u);
+        EXPECT_EQ(
+            map.lower_bound(key) - map.begin(),
+            std::distance(std_map.begin(), std_map.lower_bound(key)));
+        EXPECT_EQ(
+            map.upper_bound(key) - map.begin(),
+            std::distance(std_map.begin(), std_map.upper_bound(key)));
+    }
+    for (auto const & x : std_map) {
+        EXPECT_EQ(map.at(x.first), x.second);
+        EXPECT_EQ(map.find(x.first)->first, x.first);
+    }
+}
+
+TEST(std_string_flat_map, element_access)
+{
+    std::string_flat_map<int> map = {{"/b", 2}, {"/a", 1}, {"/b", 3}};
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(map.at("/b"), 2);
+    EXPECT_THROW(map.at("/c"), std::out_of_range);
+
+    map["/c"] = 3;
+    ++map["/a"];
+    EXPECT_EQ(map.at("/a"), 2);
+    EXPECT_EQ(map.rbegin()->first, "/c");
+
+    auto const range = map.equal_range("/b");
+    EXPECT_EQ(range.second - range.first, 1);
+    auto const it = map.erase(range.first);
+    EXPECT_EQ(it->first, "/c");
+    EXPECT_EQ(map.count("/b"), 0u);
+
+    std::string_flat_map<int> const copy = map;
+    EXPECT_EQ(copy, map);
+    map.clear();
+    EXPECT_NE(copy, map);
+    EXPECT_EQ(copy.find("/a")->second, 2);
+}
+
+TEST(std_front_coded_strings, lookup)
+{
+    std::mt19937 gen(11);
+    std::vector<std::string> strings;
+    for (int i = 0; i < 2000; ++i) {
+        strings.push_back(random_path(gen));
+    }
+    strings.push_back("");
+    std::sort(strings.begin(), strings.end());
+    strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+
+    std::vector<std::string> probes = strings;
+    for (int i = 0; i < 2000; ++i) {
+        probes.push_back(random_path(gen));
+        probes.push_back(probes.back().substr(0, gen() % 8));
+    }
+    probes.push_back("\xff");
+
+    std::front_coded_strings<> const fc16(strings.begin(), strings.end());
+    std::front_coded_strings<1> const fc1(strings.begin(), strings.end());
+    std::front_coded_strings<3> const fc3(strings.begin(), strings.end());
+    EXPECT_EQ(fc16.size(), strings.size());
+    std::size_t total = 0;
+    for (auto const & s : strings) {
+        total += s.size();
+    }
+    EXPECT_LT(fc16.encoded_size(), total * 2 / 3);
+
+    for (std::size_t i = 0; i < strings.size(); ++i) {
+        EXPECT_EQ(fc16[i], strings[i]);
+        EXPECT_EQ(fc3[i], strings[i]);
+    }
+    for (auto const & probe : probes) {
+        std::size_t const expected =
+            std::lower_bound(strings.begin(), strings.end(), probe) -
+            strings.begin();
+        EXPECT_EQ(fc16.lower_bound(probe), expected);
+        EXPECT_EQ(fc1.lower_bound(probe), expected);
+        EXPECT_EQ(fc3.lower_bound(probe), expected);
+        bool const present =
+            expected != strings.size() && strings[expected] == probe;
+        EXPECT_EQ(fc16.contains(probe), present);
+        EXPECT_EQ(fc16.find(probe), present ? expected : strings.size());
+    }
+
+    std::front_coded_strings<> const empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.lower_bound("a"), 0u);
+    EXPECT_FALSE(empty.contains(""));
+}
+
+TEST(std_inline_string, order)
+{
+    using namespace std::string_literals;
+    using str_t = std::inline_string<15>;
+    static_assert(sizeof(str_t) == 16, "");
+    static_assert(sizeof(std::inline_string<16>) == 24, "");
+    static_assert(std::is_trivially_copyable<str_t>::value, "");
+
+    std::vector<std::string> strings = {
+        "", "a", "a\0"s, "a\0\0"s, "ab", "b", "\x7f", "\x80", "\xff",
+        "abcdefg", "abcdefgh", "abcdefgh\0"s, "abcdefgi", "abcdefghijklmno",
+        "abcdefghijklmnn", "zzzzzzzzzzzzzzz"};
+    std::mt19937 gen(2);
+    for (int i = 0; i < 500; ++i) {
+        std::string s(gen() % 16, '\0');
+        for (auto & c : s) {
+            // Mostly a few chars, so that long shared prefixes are common.
+            c = char(gen() % 4 ? 'a' + gen() % 3 : gen() % 256);
+        }
+        strings.push_back(s);
+    }
+    for (auto const & a : strings) {
+        str_t const x(a);
+        ASSERT_EQ(x.view(), a);
+        ASSERT_EQ(x.size(), a.size());
+        for (auto const & b : strings) {
+            str_t const y(b);
+            ASSERT_EQ(x < y, std::string_view(a) < std::string_view(b))
+                << a << " " << b;
+            ASSERT_EQ(x == y, a == b);
+            ASSERT_EQ(x < std::string_view(b), a < b);
+            ASSERT_EQ(std::string_view(a) < y, a < b);
+        }
+    }
+
+    EXPECT_TRUE(str_t::fits("0123456789abcde"));
+    EXPECT_FALSE(str_t::fits("0123456789abcdef"));
+    EXPECT_THROW(str_t("0123456789abcdef"), std::length_error);
+    EXPECT_TRUE(str_t().empty());
+    EXPECT_EQ(
+        std::hash<str_t>()(str_t("key")),
+        std::hash<std::string_view>()("key"));
+}
+
+TEST(std_inline_string, flat_map_keys)
+{
+    std::inline_string_flat_map<int> map;
+    std::map<std::string, int> reference;
+    std::mt19937 gen(6);
+    for (int i = 0; i < 2000; ++i) {
+        std::string const key = "k" + std::to_string(gen() % 1500);
+        map.try_emplace(std::inline_string<15>(key), i);
+        reference.try_emplace(key, i);
+    }
+    ASSERT_EQ(map.size(), reference.size());
+    auto it = map.begin();
+    for (auto const & e : reference) {
+        ASSERT_EQ(it->first, std::string_view(e.first));
+        ASSERT_EQ(it->second, e.second);
+        ++it;
+    }
+
+    // Lookups take string_views and const char *s, even too long ones.
+    for (int k = 0; k < 1600; ++k) {
+        std::string const key = "k" + std::to_string(k);
+        auto const found = map.find(std::string_view(key));
+        ASSERT_EQ(found != map.end(), reference.count(key) == 1u);
+        ASSERT_EQ(
+            map.lower_bound(key.c_str()),
+            map.lower_bound(std::inline_string<15>(key)));
+    }
+    EXPECT_FALSE(map.contains("a string much too long to be a key"));
+    EXPECT_EQ(map.erase(std::inline_string<15>("k1")), reference.erase("k1"));
+}
@@ -2,10 +2,24 @@
 
 #include <gtest/gtest.h>
 
+#include <cctype>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_set>
 
 // Test instantiations.
 template class std::flat_map<std::string, int>;
+template class std::flat_multimap<std::string, int>;
 
 TEST(std_flat_map, iterator)
 {
@@ -27,6 +41,7 @@ TEST(std_flat_map, iterator)
 
         EXPECT_EQ(first + 3, last);
         EXPECT_EQ(first, last - 3);
+        EXPECT_EQ(3 + first, last);
 
         EXPECT_EQ(first[1].first, "key1");
         EXPECT_EQ(last[-3].second, 0);
@@ -166,6 +181,39 @@ TEST(std_flat_map, iterator)
     }
 }
 
+TEST(std_flat_map, reference)
+{
+    using fmap_t = std::flat_map<std::string, int>;
+    using reference = std::iterator_traits<fmap_t::iterator>::reference;
+    using const_reference =
+        std::iterator_traits<fmap_t::const_iterator>::reference;
+    using value_type = fmap_t::value_type;
+    static_assert(std::is_trivially_copyable<reference>::value, "");
+    static_assert(std::is_trivially_copyable<const_reference>::value, "");
+
+    fmap_t map = {{"a", 0}, {"b", 1}, {"c", 2}};
+    reference const a = *map.begin();
+    reference const b = *(map.begin() + 1);
+
+    EXPECT_TRUE(a < b);
+    EXPECT_TRUE(b > a);
+    EXPECT_TRUE(a <= a);
+    EXPECT_TRUE(a >= a);
+    EXPECT_TRUE(a == *map.begin());
+    EXPECT_TRUE(a != b);
+    EXPECT_TRUE(a == value_type("a", 0));
+    EXPECT_TRUE(value_type("a", 1) > a);
+    EXPECT_TRUE(*map.cbegin() == a);
+
+    std::pair<std::string, int> const copy = a;
+    EXPECT_EQ(copy, std::make_pair(std::string("a"), 0));
+    std::pair<std::string const &, int const &> const refs = b;
+    EXPECT_EQ(&refs.second, &b.second);
+
+    b.second = 7;
+    EXPECT_EQ(map.at("b"), 7);
+}
+
 TEST(std_flat_map, ctors_iterators)
 {
     using fmap_t = std::flat_map<std::string, int>;
@@ -800,3 +848,3000 @@ TEST(std_flat_map, comparisons)
     EXPECT_GE(map_123, map_123);
     EXPECT_GT(map_123, map_12);
 }
+
+TEST(std_flat_map, arithmetic_lower_upper_bound)
+{
+    std::vector<int> keys;
+    for (int i = 0; i < 1000; ++i) {
+        keys.push_back(i * 2);
+    }
+    std::vector<int> const values(keys.size(), 1);
+
+    {
+        std::flat_map<int, int> const map(std::sorted_unique, keys, values);
+        for (int k = -3; k < 2003; ++k) {
+            EXPECT_EQ(
+                map.lower_bound(k) - map.begin(),
+                std::lower_bound(keys.begin(), keys.end(), k) - keys.begin());
+            EXPECT_EQ(
+                map.upper_bound(k) - map.begin(),
+                std::upper_bound(keys.begin(), keys.end(), k) - keys.begin());
+            EXPECT_EQ(map.contains(k), 0 <= k && k < 2000 && k % 2 == 0);
+        }
+        EXPECT_EQ(map.lower_bound(5.5) - map.begin(), 3);
+    }
+
+    {
+        std::vector<int> rev_keys(keys.rbegin(), keys.rend());
+        std::flat_map<int, int, std::greater<int>> const map(
+            std::sorted_unique, rev_keys, values);
+        for (int k = -3; k < 2003; ++k) {
+            EXPECT_EQ(
+                map.lower_bound(k) - map.begin(),
+                std::lower_bound(
+                    rev_keys.begin(), rev_keys.end(), k, std::greater<int>()) -
+                    rev_keys.begin());
+            EXPECT_EQ(
+                map.upper_bound(k) - map.begin(),
+                std::upper_bound(
+                    rev_keys.begin(), rev_keys.end(), k, std::greater<int>()) -
+                    rev_keys.begin());
+        }
+    }
+
+    {
+        std::flat_map<int, int> const map;
+        EXPECT_EQ(map.lower_bound(0), map.end());
+        EXPECT_EQ(map.upper_bound(0), map.end());
+    }
+}
+
+TEST(std_flat_map, insert_range_unique)
+{
+    using fmap_t = std::flat_map<std::string, int>;
+    using pair_t = std::pair<std::string, int>;
+
+    auto pair_cmp = [](auto lhs, auto rhs) {
+        return lhs.first == rhs.first && lhs.second == rhs.second;
+    };
+
+    {
+        std::vector<pair_t> const vec = {
+            {"key2", 2}, {"key0", 0}, {"key2", 20}, {"key1", 1}, {"key0", 10}};
+        fmap_t map;
+        map.insert(vec.begin(), vec.end());
+        std::vector<pair_t> const expected = {
+            {"key0", 0}, {"key1", 1}, {"key2", 2}};
+        EXPECT_TRUE(std::equal(
+            map.begin(),
+            map.end(),
+            expected.begin(),
+            expected.end(),
+            pair_cmp));
+    }
+
+    {
+        fmap_t map = {{"key1", 1}, {"key3", 3}, {"key5", 5}};
+        std::vector<pair_t> const vec = {
+            {"key4", 4}, {"key3", 30}, {"key0", 0}, {"key6", 6}, {"key4", 40}};
+        map.insert(vec.begin(), vec.end());
+        std::vector<pair_t> const expected = {
+            {"key0", 0},
+            {"key1", 1},
+            {"key3", 3},
+            {"key4", 4},
+            {"key5", 5},
+            {"key6", 6}};
+        EXPECT_TRUE(std::equal(
+            map.begin(),
+            map.end(),
+            expected.begin(),
+            expected.end(),
+            pair_cmp));
+    }
+
+    {
+        fmap_t map = {{"key1", 1}, {"key3", 3}};
+        std::vector<pair_t> const vec = {{"key0", 0}, {"key1", 10}, {"key2", 2}};
+        map.insert(std::sorted_unique, vec.begin(), vec.end());
+        std::vector<pair_t> const expected = {
+            {"key0", 0}, {"key1", 1}, {"key2", 2}, {"key3", 3}};
+        EXPECT_TRUE(std::equal(
+            map.begin(),
+            map.end(),
+            expected.begin(),
+            expected.end(),
+            pair_cmp));
+    }
+}
+
+TEST(std_flat_map, hinted_insert)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t map;
+    for (int i = 0; i < 100; i += 2) {
+        map.emplace_hint(map.end(), i, i);
+    }
+    EXPECT_EQ(map.size(), 50u);
+
+    for (int i = 1; i < 100; i += 2) {
+        auto const it = map.try_emplace(map.begin(), i, i);
+        EXPECT_EQ(it->first, i);
+    }
+    EXPECT_EQ(map.size(), 100u);
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(map.insert(map.end(), std::pair<int, int>(i, -1))->second, i);
+        EXPECT_EQ(map.insert_or_assign(map.begin() + 50, i, -i)->second, -i);
+    }
+    EXPECT_EQ(map.size(), 100u);
+    EXPECT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+
+    auto const it = map.try_emplace(map.begin() + 10, 150, 0);
+    EXPECT_EQ(it, map.end() - 1);
+    EXPECT_EQ(map.emplace_hint(map.end(), -5, 0), map.begin());
+}
+
+TEST(std_flat_map, equal_range_bounded)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t map;
+    for (int i = 0; i < 64; i += 2) {
+        map.emplace(i, i);
+    }
+    fmap_t const & cmap = map;
+    for (int k = -1; k < 66; ++k) {
+        auto const eq_range = map.equal_range(k);
+        auto const c_eq_range = cmap.equal_range(k);
+        EXPECT_EQ(eq_range.first, map.lower_bound(k));
+        EXPECT_EQ(eq_range.second, map.upper_bound(k));
+        EXPECT_EQ(c_eq_range.first, cmap.lower_bound(k));
+        EXPECT_EQ(c_eq_range.second, cmap.upper_bound(k));
+    }
+}
+
+TEST(std_flat_map, take)
+{
+    using fmap_t = std::flat_map<int, std::unique_ptr<int>>;
+
+    fmap_t map;
+    for (int i = 0; i < 10; ++i) {
+        map.emplace(i, std::make_unique<int>(i * 10));
+    }
+    std::optional<std::unique_ptr<int>> value = map.take(4);
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(**value, 40);
+    EXPECT_EQ(map.size(), 9u);
+    EXPECT_FALSE(map.contains(4));
+    EXPECT_EQ(*map.at(5), 50);
+    EXPECT_FALSE(map.take(4).has_value());
+    EXPECT_EQ(**map.take(9), 90);
+    EXPECT_EQ(**map.take(0), 0);
+    EXPECT_EQ(map.keys(), (std::vector<int>{1, 2, 3, 5, 6, 7, 8}));
+
+    std::flat_map<std::string, std::string, std::less<>> smap = {
+        {"a", "x"}, {"b", "y"}};
+    EXPECT_EQ(smap.take(std::string_view("b")), std::string("y"));
+    EXPECT_EQ(smap.size(), 1u);
+}
+
+TEST(std_flat_map, rekey)
+{
+    using fmap_t = std::flat_map<int, std::string>;
+
+    fmap_t map;
+    std::map<int, std::string> std_map;
+    for (int i = 0; i < 200; i += 2) {
+        map.emplace(i, std::to_string(i));
+        std_map.emplace(i, std::to_string(i));
+    }
+    std::mt19937 gen(13);
+    for (int i = 0; i < 2000; ++i) {
+        auto const it = map.begin() + gen() % map.size();
+        int const old_key = it->first;
+        int const new_key = int(gen() % 250) - 25;
+        auto const result = map.rekey(it, new_key);
+        bool const taken = new_key != old_key && std_map.count(new_key);
+        EXPECT_EQ(result.second, !taken);
+        EXPECT_EQ(result.first->first, new_key);
+        if (!taken) {
+            auto node = std_map.extract(old_key);
+            node.key() = new_key;
+            std_map.insert(std::move(node));
+        }
+        ASSERT_TRUE(std::equal(
+            map.begin(),
+            map.end(),
+            std_map.begin(),
+            std_map.end(),
+            [](auto lhs, auto rhs) {
+                return lhs.first == rhs.first && lhs.second == rhs.second;
+            }));
+    }
+
+    std::flat_map<std::string, int> smap = {{"a", 1}, {"b", 2}, {"c", 3}};
+    EXPECT_TRUE(smap.rekey(smap.begin(), "d").second);
+    EXPECT_EQ(smap.keys(), (std::vector<std::string>{"b", "c", "d"}));
+    EXPECT_EQ(smap.values(), (std::vector<int>{2, 3, 1}));
+    EXPECT_FALSE(smap.rekey(smap.begin(), "c").second);
+}
+
+TEST(std_flat_map, erase_if)
+{
+    using fmap_t = std::flat_map<std::string, int>;
+    using pair_t = std::pair<std::string, int>;
+
+    auto pair_cmp = [](auto lhs, auto rhs) {
+        return lhs.first == rhs.first && lhs.second == rhs.second;
+    };
+
+    auto const odd = [](auto const & x) { return x.second % 2 == 1; };
+    auto const none = [](auto const &) { return false; };
+
+    fmap_t map = {{"key0", 0}, {"key1", 1}, {"key2", 2}, {"key3", 3}};
+    EXPECT_EQ(std::erase_if(map, odd), 2u);
+    std::vector<pair_t> const expected = {{"key0", 0}, {"key2", 2}};
+    EXPECT_TRUE(std::equal(
+        map.begin(), map.end(), expected.begin(), expected.end(), pair_cmp));
+
+    EXPECT_EQ(erase_if(map, none), 0u);
+    EXPECT_EQ(map.size(), 2u);
+
+    int calls = 0;
+    EXPECT_THROW(
+        std::erase_if(
+            map,
+            [&](auto const &) {
+                if (calls++)
+                    throw 0;
+                return true;
+            }),
+        int);
+    EXPECT_EQ(map.size(), 1u);
+    EXPECT_EQ(map.begin()->first, "key2");
+}
+
+TEST(std_flat_map, transform_values)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t map = {{1, 10}, {2, 20}, {3, 30}};
+    map.for_each_value([](int const & k, int & v) { v += k; });
+    EXPECT_EQ(map.values(), (std::vector<int>{11, 22, 33}));
+
+    map.transform_values([](int const & k, int const & v) { return v * k; });
+    EXPECT_EQ(map.values(), (std::vector<int>{11, 44, 99}));
+    EXPECT_EQ(map.keys(), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(std_flat_map, erase_sorted_keys)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t map;
+    for (int i = 0; i < 20; ++i) {
+        map.emplace(i, i * 10);
+    }
+
+    // Keys not in the map, and repeated keys, are skipped.
+    std::vector<int> const keys = {-1, 0, 3, 3, 4, 10, 15, 19, 25};
+    EXPECT_EQ(map.erase(std::sorted_unique, keys.begin(), keys.end()), 6u);
+    EXPECT_EQ(map.size(), 14u);
+
+    std::vector<int> const expected_keys = {
+        1, 2, 5, 6, 7, 8, 9, 11, 12, 13, 14, 16, 17, 18};
+    EXPECT_EQ(map.keys(), expected_keys);
+    for (auto const & x : map) {
+        EXPECT_EQ(x.second, x.first * 10);
+    }
+
+    std::vector<int> const none;
+    EXPECT_EQ(map.erase(std::sorted_unique, none.begin(), none.end()), 0u);
+    EXPECT_EQ(map.erase(std::sorted_unique, keys.begin(), keys.end()), 0u);
+    EXPECT_EQ(map.size(), 14u);
+
+    EXPECT_EQ(
+        map.erase(
+            std::sorted_unique, expected_keys.begin(), expected_keys.end()),
+        14u);
+    EXPECT_TRUE(map.empty());
+}
+
+TEST(std_flat_map, find_index)
+{
+    std::flat_map<int, std::string> map;
+    EXPECT_EQ(map.find_index(0), map.npos);
+    map.emplace(10, "ten");
+    map.emplace(30, "thirty");
+    map.emplace(20, "twenty");
+    EXPECT_EQ(map.find_index(10), 0u);
+    EXPECT_EQ(map.find_index(30), 2u);
+    EXPECT_EQ(map.values()[map.find_index(20)], "twenty");
+    EXPECT_EQ(map.find_index(15), map.npos);
+    EXPECT_EQ(map.find_index(40), map.npos);
+
+    std::flat_map<std::string, int, std::less<>> strings;
+    strings.emplace("b", 2);
+    strings.emplace("a", 1);
+    EXPECT_EQ(strings.find_index(std::string_view("b")), 1u);
+    EXPECT_EQ(strings.find_index("c"), strings.npos);
+}
+
+TEST(std_flat_map, find_many)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t map;
+    for (int i = 0; i < 1000; i += 3) {
+        map.emplace(i, -i);
+    }
+    fmap_t const & cmap = map;
+
+    std::vector<int> keys;
+    for (int i = 1000; -10 < i; i -= 7) {
+        keys.push_back(i);
+    }
+
+    std::vector<fmap_t::iterator> its;
+    map.find_many(keys.begin(), keys.end(), std::back_inserter(its));
+    std::vector<fmap_t::const_iterator> c_its;
+    cmap.find_many(keys.begin(), keys.end(), std::back_inserter(c_its));
+    std::vector<bool> found;
+    cmap.contains_many(keys.begin(), keys.end(), std::back_inserter(found));
+    ASSERT_EQ(its.size(), keys.size());
+    ASSERT_EQ(c_its.size(), keys.size());
+    ASSERT_EQ(found.size(), keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(its[i], map.find(keys[i]));
+        EXPECT_EQ(c_its[i], cmap.find(keys[i]));
+        EXPECT_EQ(found[i], cmap.contains(keys[i]));
+    }
+
+    std::sort(keys.begin(), keys.end());
+    its.clear();
+    map.find_many(
+        std::sorted_unique, keys.begin(), keys.end(), std::back_inserter(its));
+    found.clear();
+    cmap.contains_many(
+        std::sorted_unique,
+        keys.begin(),
+        keys.end(),
+        std::back_inserter(found));
+    ASSERT_EQ(its.size(), keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(its[i], map.find(keys[i]));
+        EXPECT_EQ(found[i], cmap.contains(keys[i]));
+    }
+
+    fmap_t empty;
+    its.clear();
+    empty.find_many(keys.begin(), keys.end(), std::back_inserter(its));
+    EXPECT_EQ(its.size(), keys.size());
+    EXPECT_EQ(its.front(), empty.end());
+}
+
+TEST(std_flat_map, lower_bound_many)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t map;
+    for (int i = 0; i < 1000; i += 3) {
+        map.emplace(i, -i);
+    }
+    fmap_t const & cmap = map;
+
+    std::vector<int> keys;
+    for (int i = 1010; -10 < i; i -= 7) {
+        keys.push_back(i);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(3));
+
+    std::vector<fmap_t::iterator> its;
+    map.lower_bound_many(keys.begin(), keys.end(), std::back_inserter(its));
+    std::vector<fmap_t::const_iterator> c_its;
+    cmap.lower_bound_many(keys.begin(), keys.end(), std::back_inserter(c_its));
+    ASSERT_EQ(its.size(), keys.size());
+    ASSERT_EQ(c_its.size(), keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(its[i], map.lower_bound(keys[i]));
+        EXPECT_EQ(c_its[i], cmap.lower_bound(keys[i]));
+    }
+
+    fmap_t empty;
+    its.clear();
+    empty.lower_bound_many(keys.begin(), keys.end(), std::back_inserter(its));
+    EXPECT_EQ(its.size(), keys.size());
+    EXPECT_EQ(its.back(), empty.end());
+}
+
+TEST(std_flat_map, finger_search)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t map;
+    for (int i = 0; i < 5000; i += 5) {
+        map.emplace(i, -i);
+    }
+    fmap_t const & cmap = map;
+
+    // A walk of nearby keys, each searched from the previous result.
+    std::mt19937 gen(5);
+    fmap_t::iterator it = map.begin();
+    fmap_t::const_iterator cit = cmap.end();
+    int k = 2500;
+    for (int i = 0; i < 2000; ++i) {
+        k += int(gen() % 41) - 20;
+        it = map.lower_bound(it, k);
+        EXPECT_EQ(it, map.lower_bound(k));
+        cit = cmap.find(cit, k);
+        EXPECT_EQ(cit, cmap.find(k));
+        if (cit == cmap.end())
+            cit = cmap.lower_bound(cit, k);
+    }
+
+    // Hints far from the result, and at either end, are still correct.
+    for (int key : {-10, 0, 4, 5, 2501, 4995, 4996, 10000}) {
+        for (auto hint : {cmap.begin(), cmap.begin() + 600, cmap.end()}) {
+            EXPECT_EQ(cmap.lower_bound(hint, key), cmap.lower_bound(key));
+            EXPECT_EQ(cmap.find(hint, key), cmap.find(key));
+        }
+    }
+
+    std::flat_map<std::string, int, std::less<>> smap = {{"a", 1}, {"c", 2}};
+    std::string_view const sv = "c";
+    EXPECT_EQ(smap.find(smap.begin(), sv)->second, 2);
+    EXPECT_EQ(smap.lower_bound(smap.end(), std::string_view("b"))->second, 2);
+
+    fmap_t empty;
+    EXPECT_EQ(empty.find(empty.end(), 1), empty.end());
+    EXPECT_EQ(empty.lower_bound(empty.begin(), 1), empty.end());
+}
+
+TEST(std_flat_map, probe_cursor)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t map;
+    for (int i = 0; i < 3000; i += 3) {
+        map.emplace(i, -i);
+    }
+    fmap_t const & cmap = map;
+
+    std::vector<int> keys;
+    std::mt19937 gen(9);
+    for (int k = -5; k < 3100; k += int(gen() % 8)) {
+        keys.push_back(k);
+    }
+
+    fmap_t::probe_cursor cursor = map.probe_keys();
+    EXPECT_EQ(cursor.position(), map.begin());
+    for (int k : keys) {
+        auto const it = cursor.seek(k);
+        EXPECT_EQ(it, map.find(k));
+        EXPECT_EQ(cursor.position(), map.lower_bound(k));
+        if (it != map.end())
+            it->second = k;
+    }
+    for (auto const & x : map) {
+        bool const seen =
+            std::binary_search(keys.begin(), keys.end(), x.first);
+        EXPECT_EQ(x.second, seen ? x.first : -x.first);
+    }
+
+    std::vector<fmap_t::const_iterator> found;
+    fmap_t::const_probe_cursor c_cursor = cmap.probe_keys();
+    c_cursor.seek(-100);
+    c_cursor.seek_many(keys.begin(), keys.end(), std::back_inserter(found));
+    ASSERT_EQ(found.size(), keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(found[i], cmap.find(keys[i]));
+    }
+    EXPECT_EQ(c_cursor.position(), cmap.end());
+}
+
+TEST(std_flat_map, find_async)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t map;
+    for (int i = 0; i < 1000; i += 3) {
+        map.emplace(i, -i);
+    }
+    fmap_t const & cmap = map;
+
+    std::vector<fmap_t::find_handle> handles;
+    std::vector<fmap_t::const_find_handle> c_handles;
+    for (int i = -2; i < 1003; ++i) {
+        handles.push_back(map.find_async(i));
+        c_handles.push_back(cmap.find_async(i));
+    }
+    // Interleave the searches one level at a time, and leave some
+    // unfinished for get().
+    for (int level = 0; level < 5; ++level) {
+        for (auto & h : handles) {
+            h.step();
+        }
+    }
+    for (int i = -2; i < 1003; ++i) {
+        std::size_t const q = i + 2;
+        EXPECT_FALSE(handles[q].done());
+        fmap_t::iterator const it = handles[q].get();
+        EXPECT_TRUE(handles[q].done());
+        EXPECT_EQ(it, map.find(i));
+        EXPECT_EQ(c_handles[q].get(), cmap.find(i));
+    }
+    auto h = map.find_async(3);
+    h.get()->second = 42;
+    EXPECT_EQ(map.at(3), 42);
+
+    fmap_t empty;
+    auto e = empty.find_async(1);
+    EXPECT_TRUE(e.done());
+    e.step();
+    EXPECT_EQ(e.get(), empty.end());
+
+    fmap_t one;
+    one.emplace(7, 8);
+    EXPECT_EQ(one.find_async(7).get(), one.begin());
+    EXPECT_EQ(one.find_async(6).get(), one.end());
+    EXPECT_EQ(one.find_async(8).get(), one.end());
+}
+
+TEST(std_flat_map, instrumented_compare)
+{
+    using fmap_t =
+        std::flat_map<int, int, std::instrumented_compare<std::less<>>>;
+
+    fmap_t map;
+    EXPECT_EQ(map.stats().comparisons, 0u);
+    for (int i = 0; i < 1024; ++i) {
+        map.emplace_hint(map.end(), i, i);
+    }
+    EXPECT_EQ(map.stats().elements_moved, 0u);
+    EXPECT_LE(2u, map.stats().reallocations);
+
+    map.reset_stats();
+    EXPECT_TRUE(map.contains(500));
+    EXPECT_TRUE(map.contains(std::int64_t(501)));
+    EXPECT_LE(10u, map.stats().comparisons);
+    EXPECT_LE(map.stats().comparisons, 30u);
+
+    map.reset_stats();
+    map.reserve(map.capacity());
+    EXPECT_EQ(map.stats().reallocations, 0u);
+    map.erase(1000);
+    EXPECT_EQ(map.stats().elements_moved, 23u);
+    map.erase(map.begin());
+    EXPECT_EQ(map.stats().elements_moved, 23u + 1022u);
+    map.emplace(0, 0);
+    EXPECT_EQ(map.stats().elements_moved, 23u + 1022u + 1022u);
+
+    map.reset_stats();
+    std::vector<std::pair<int, int>> const more = {{-3, 0}, {2000, 0}, {-1, 0}};
+    map.insert(more.begin(), more.end());
+    EXPECT_EQ(map.size(), 1026u);
+    EXPECT_EQ(map.begin()->first, -3);
+    EXPECT_LT(0u, map.stats().elements_moved);
+    EXPECT_LT(0, map.stats().sort_time.count());
+    EXPECT_LT(0, map.stats().merge_time.count());
+
+    // The statistics travel with the comparator.
+    fmap_t const copy = map;
+    EXPECT_EQ(copy.stats().elements_moved, map.stats().elements_moved);
+
+    std::flat_map<int, int> plain;
+    plain.emplace(1, 1);
+    EXPECT_EQ(plain.size(), 1u);
+}
+
+TEST(std_flat_map, merge)
+{
+    using fmap_t = std::flat_map<std::string, int>;
+    using pair_t = std::pair<std::string, int>;
+
+    auto pair_cmp = [](auto lhs, auto rhs) {
+        return lhs.first == rhs.first && lhs.second == rhs.second;
+    };
+
+    {
+        fmap_t map = {{"key1", 1}, {"key3", 3}};
+        fmap_t source = {{"key0", 0}, {"key1", 10}, {"key2", 2}, {"key4", 4}};
+        map.merge(source);
+        std::vector<pair_t> const expected = {
+            {"key0", 0}, {"key1", 1}, {"key2", 2}, {"key3", 3}, {"key4", 4}};
+        EXPECT_TRUE(std::equal(
+            map.begin(), map.end(), expected.begin(), expected.end(), pair_cmp));
+        std::vector<pair_t> const expected_source = {{"key1", 10}};
+        EXPECT_TRUE(std::equal(
+            source.begin(),
+            source.end(),
+            expected_source.begin(),
+            expected_source.end(),
+            pair_cmp));
+    }
+
+    {
+        fmap_t map;
+        fmap_t source = {{"key0", 0}, {"key1", 1}};
+        auto const keys_data = source.keys().data();
+        map.merge(std::move(source));
+        EXPECT_EQ(map.size(), 2u);
+        EXPECT_EQ(map.keys().data(), keys_data);
+        EXPECT_TRUE(source.empty());
+    }
+
+    {
+        fmap_t map = {{"key1", 1}, {"key3", 3}};
+        std::flat_map<std::string, int, std::greater<std::string>> source = {
+            {"key2", 2}, {"key1", 10}, {"key0", 0}};
+        map.merge(source);
+        std::vector<pair_t> const expected = {
+            {"key0", 0}, {"key1", 1}, {"key2", 2}, {"key3", 3}};
+        EXPECT_TRUE(std::equal(
+            map.begin(), map.end(), expected.begin(), expected.end(), pair_cmp));
+        EXPECT_EQ(source.size(), 1u);
+        EXPECT_EQ(source.begin()->second, 10);
+    }
+
+    // Keys that the source tells apart but the target does not: the first
+    // of them moves, and the others stay in the source, in its order.
+    {
+        struct ci_less
+        {
+            bool operator()(std::string const & x, std::string const & y) const
+            {
+                return std::lexicographical_compare(
+                    x.begin(), x.end(), y.begin(), y.end(), [](char a, char b) {
+                        return std::tolower(a) < std::tolower(b);
+                    });
+            }
+        };
+        std::flat_map<std::string, int, ci_less> map = {{"z", 0}};
+        fmap_t source = {{"A", 1}, {"B", 2}, {"a", 3}, {"b", 4}, {"c", 5}};
+        map.merge(source);
+        std::vector<pair_t> const expected = {
+            {"A", 1}, {"B", 2}, {"c", 5}, {"z", 0}};
+        EXPECT_TRUE(std::equal(
+            map.begin(), map.end(), expected.begin(), expected.end(), pair_cmp));
+        std::vector<pair_t> const expected_source = {{"a", 3}, {"b", 4}};
+        EXPECT_TRUE(std::equal(
+            source.begin(),
+            source.end(),
+            expected_source.begin(),
+            expected_source.end(),
+            pair_cmp));
+    }
+}
+
+TEST(std_flat_map, reserve_capacity)
+{
+    {
+        std::flat_map<int, int> map;
+        map.reserve(100);
+        EXPECT_GE(map.capacity(), 100u);
+        EXPECT_GE(map.keys().capacity(), 100u);
+        EXPECT_GE(map.values().capacity(), 100u);
+
+        auto const keys_data = map.keys().data();
+        for (int i = 0; i < 100; ++i) {
+            map.emplace(i, i);
+        }
+        EXPECT_EQ(map.keys().data(), keys_data);
+
+        map.erase(map.begin() + 10, map.end());
+        map.shrink_to_fit();
+        EXPECT_EQ(map.size(), 10u);
+        EXPECT_GE(map.capacity(), map.size());
+    }
+
+    {
+        std::flat_map<int, double> map;
+        EXPECT_EQ(map.memory_usage(), 0u);
+        map.reserve(100);
+        map.emplace(1, 1.0);
+        EXPECT_EQ(
+            map.memory_usage(),
+            map.keys().capacity() * sizeof(int) +
+                map.values().capacity() * sizeof(double));
+        EXPECT_GE(map.memory_usage(), 100u * (sizeof(int) + sizeof(double)));
+    }
+
+    {
+        std::flat_map<int, int, std::less<int>, std::deque<int>> map = {
+            {0, 0}, {1, 1}};
+        map.reserve(100);
+        map.shrink_to_fit();
+        EXPECT_EQ(map.capacity(), 2u);
+        EXPECT_GE(map.memory_usage(), 2u * 2u * sizeof(int));
+    }
+}
+
+// Maps of these grow by half again, and shrink below a quarter full.
+namespace std {
+    template<>
+    struct flat_map_capacity_policy<short, unsigned>
+    {
+        using growth_factor = ratio<3, 2>;
+        using shrink_threshold = ratio<1, 4>;
+    };
+}
+
+TEST(std_flat_map, capacity_policy)
+{
+    {
+        std::flat_map<short, unsigned> map;
+        std::size_t prev_capacity = 0;
+        for (short i = 0; i < 1000; ++i) {
+            map.emplace(i, i);
+            if (map.keys().capacity() != prev_capacity && 4 <= prev_capacity) {
+                EXPECT_EQ(map.keys().capacity(), prev_capacity * 3 / 2);
+            }
+            prev_capacity = map.keys().capacity();
+            EXPECT_EQ(map.values().capacity(), prev_capacity);
+        }
+
+        // A quarter full is not yet sparse.
+        std::size_t const capacity = map.keys().capacity();
+        std::size_t const quarter = (capacity + 3) / 4;
+        map.erase(map.begin() + quarter, map.end());
+        EXPECT_EQ(map.keys().capacity(), capacity);
+        map.erase(map.begin());
+        EXPECT_EQ(map.size(), quarter - 1);
+        EXPECT_EQ(map.keys().capacity(), map.size());
+        EXPECT_EQ(map.values().capacity(), map.size());
+        EXPECT_EQ(map.begin()->first, 1);
+
+        auto it = map.erase(map.begin(), map.begin() + 10);
+        EXPECT_EQ(it, map.begin());
+        EXPECT_EQ(it->first, 11);
+
+        // Erasing a quarter of the elements by key or predicate shrinks
+        // the now sparse map again.
+        std::size_t const n = map.size();
+        map.reserve(n * 2);
+        EXPECT_EQ(map.erase(short(11)), 1u);
+        EXPECT_EQ(map.keys().capacity(), n * 2);
+        std::size_t const erased =
+            erase_if(map, [](auto const & x) { return x.first % 4 != 0; });
+        EXPECT_EQ(erased, n - 1 - map.size());
+        EXPECT_EQ(map.size(), (n + 3) / 4);
+        EXPECT_EQ(map.keys().capacity(), map.size());
+        EXPECT_TRUE(std::all_of(map.begin(), map.end(), [](auto const & x) {
+            return x.first % 4 == 0 && unsigned(x.first) == x.second;
+        }));
+    }
+
+    {
+        std::flat_multimap<short, unsigned> map;
+        for (short i = 0; i < 100; ++i) {
+            map.emplace(short(i % 10), i);
+        }
+        std::size_t const capacity = map.keys().capacity();
+        EXPECT_GE(capacity, 100u);
+        for (short k = 0; k < 8; ++k) {
+            EXPECT_EQ(map.erase(k), 10u);
+        }
+        EXPECT_EQ(map.size(), 20u);
+        EXPECT_LT(map.keys().capacity(), capacity);
+        EXPECT_LE(map.keys().capacity(), 4u * map.size());
+        EXPECT_EQ(map.values().capacity(), map.keys().capacity());
+    }
+
+    // Other maps keep their capacity.
+    {
+        std::flat_map<int, int> map;
+        for (int i = 0; i < 1000; ++i) {
+            map.emplace(i, i);
+        }
+        std::size_t const capacity = map.keys().capacity();
+        map.erase(map.begin() + 1, map.end());
+        EXPECT_EQ(map.keys().capacity(), capacity);
+    }
+}
+
+#if USE_EXECUTION_POLICIES
+TEST(std_flat_map, parallel_build)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    std::vector<int> keys;
+    std::vector<int> values;
+    for (int i = 0; i < 10000; ++i) {
+        keys.push_back((i * 7919) % 5000);
+        values.push_back(i);
+    }
+
+    fmap_t const expected(keys, values);
+    std::vector<std::pair<int, int>> pairs;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        pairs.emplace_back(keys[i], values[i]);
+    }
+
+    fmap_t const map(std::execution::par, keys, values);
+    EXPECT_EQ(map.size(), 5000u);
+    EXPECT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+    // The first of each run of equivalent keys is kept.
+    for (auto const & x : map) {
+        EXPECT_EQ(x.first, keys[x.second]);
+        EXPECT_LT(x.second, 5000);
+    }
+    EXPECT_EQ(map, fmap_t(pairs.begin(), pairs.end()));
+
+    fmap_t const map_2(std::execution::par, pairs.begin(), pairs.end());
+    EXPECT_EQ(map_2, map);
+
+    fmap_t map_3 = {{-1, -1}, {0, -2}};
+    map_3.insert(std::execution::par, pairs.begin(), pairs.end());
+    EXPECT_EQ(map_3.size(), 5001u);
+    EXPECT_EQ(map_3[0], -2);
+}
+
+TEST(std_flat_map, parallel_radix_build)
+{
+    using fmap_t = std::flat_map<long long, int, std::greater<>>;
+
+    std::mt19937_64 gen(11);
+    std::vector<long long> keys;
+    std::vector<int> values;
+    std::vector<std::pair<long long, int>> pairs;
+    for (int i = 0; i < 200000; ++i) {
+        keys.push_back(
+            (long long)(gen() % 100000) - 50000 +
+            (i % 5 == 0 ? (long long)(gen() << 20) : 0));
+        values.push_back(i);
+        pairs.emplace_back(keys.back(), i);
+    }
+
+    fmap_t const expected(pairs.begin(), pairs.end());
+    fmap_t const map(std::execution::par, keys, values);
+    EXPECT_EQ(map, expected);
+
+    std::vector<long long> probes(keys.begin(), keys.begin() + 50000);
+    for (auto & k : probes) {
+        k += 1;
+    }
+    std::vector<fmap_t::const_iterator> found(probes.size());
+    auto const found_last = map.lower_bound_many(
+        std::execution::par, probes.begin(), probes.end(), found.begin());
+    EXPECT_EQ(found_last, found.end());
+    for (std::size_t i = 0; i < probes.size(); ++i) {
+        EXPECT_EQ(found[i], map.lower_bound(probes[i]));
+    }
+}
+
+TEST(std_flat_map, parallel_find_many)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t map;
+    for (int i = 0; i < 20000; ++i) {
+        map.emplace(i * 3, i);
+    }
+    std::vector<int> keys;
+    for (int k = -5; k < 70000; k += 2) {
+        keys.push_back(k);
+    }
+
+    std::vector<fmap_t::iterator> expected;
+    map.find_many(
+        std::sorted_unique, keys.begin(), keys.end(), back_inserter(expected));
+
+    std::vector<fmap_t::iterator> found(keys.size());
+    auto const found_last = map.find_many(
+        std::execution::par,
+        std::sorted_unique,
+        keys.begin(),
+        keys.end(),
+        found.begin());
+    EXPECT_EQ(found_last, found.end());
+    EXPECT_EQ(found, expected);
+
+    fmap_t const & const_map = map;
+    std::vector<fmap_t::const_iterator> const_found(keys.size());
+    const_map.find_many(
+        std::execution::par,
+        std::sorted_unique,
+        keys.begin(),
+        keys.end(),
+        const_found.begin());
+    EXPECT_TRUE(std::equal(
+        const_found.begin(),
+        const_found.end(),
+        expected.begin(),
+        expected.end()));
+
+    std::vector<char> contained(keys.size());
+    const_map.contains_many(
+        std::execution::par,
+        std::sorted_unique,
+        keys.begin(),
+        keys.end(),
+        contained.begin());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(bool(contained[i]), map.contains(keys[i]));
+    }
+}
+
+TEST(std_flat_map, parallel_erase_if)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t map;
+    for (int i = 0; i < 20000; ++i) {
+        map.emplace(i, i * 2);
+    }
+    fmap_t expected = map;
+    auto const every_third = [](auto const & x) { return x.first % 3 == 0; };
+    EXPECT_EQ(std::erase_if(expected, every_third), 6667u);
+
+    EXPECT_EQ(std::erase_if(std::execution::par, map, every_third), 6667u);
+    EXPECT_EQ(map, expected);
+
+    auto const none = [](auto const &) { return false; };
+    EXPECT_EQ(std::erase_if(std::execution::par, map, none), 0u);
+    EXPECT_EQ(map, expected);
+
+    auto const all = [](auto const &) { return true; };
+    EXPECT_EQ(std::erase_if(std::execution::par, map, all), 13333u);
+    EXPECT_TRUE(map.empty());
+}
+
+TEST(std_flat_map, parallel_transform_values)
+{
+    using fmap_t = std::flat_map<int, int>;
+
+    fmap_t map;
+    for (int i = 0; i < 10000; ++i) {
+        map.emplace(i, i);
+    }
+    map.for_each_value(
+        std::execution::par, [](int const & k, int & v) { v += k; });
+    map.transform_values(
+        std::execution::par, [](int const &, int const & v) { return v + 1; });
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_EQ(map.values()[i], 2 * i + 1);
+    }
+}
+
+TEST(std_flat_map, parallel_merge)
+{
+    std::mt19937 gen(23);
+    for (int old_size : {0, 100, 30000, 200000}) {
+        for (int new_size : {50, 40000, 150000}) {
+            std::vector<std::pair<int, int>> old;
+            std::vector<std::pair<int, int>> more;
+            for (int i = 0; i < old_size; ++i) {
+                old.emplace_back(int(gen() % 400000), i);
+            }
+            std::flat_map<int, int> const map(old.begin(), old.end());
+            std::map<int, int> const expected(old.begin(), old.end());
+            for (int i = 0; i < new_size; ++i) {
+                more.emplace_back(int(gen() % 400000), -i);
+            }
+
+            // Old elements win over new ones, and the first new one over
+            // those after it.
+            std::flat_map<int, int> inserted = map;
+            std::map<int, int> inserted_expected = expected;
+            inserted.insert(std::execution::par, more.begin(), more.end());
+            inserted_expected.insert(more.begin(), more.end());
+            ASSERT_TRUE(std::equal(
+                inserted.begin(),
+                inserted.end(),
+                inserted_expected.begin(),
+                inserted_expected.end()));
+
+            std::flat_map<int, int> const source_init(more.begin(), more.end());
+            std::flat_map<int, int> sorted = map;
+            sorted.insert(
+                std::execution::par,
+                std::sorted_unique,
+                source_init.begin(),
+                source_init.end());
+            EXPECT_EQ(sorted, inserted);
+
+            // merge() leaves the elements already present in the source.
+            std::flat_map<int, int> merged = map;
+            std::flat_map<int, int> source = source_init;
+            merged.merge(std::execution::par, source);
+            EXPECT_EQ(merged, inserted);
+            for (auto const & x : source_init) {
+                EXPECT_EQ(source.contains(x.first), map.contains(x.first));
+            }
+            EXPECT_EQ(
+                merged.size() + source.size(),
+                map.size() + source_init.size());
+        }
+    }
+
+    // Keys that are all before, or all after, the old ones.
+    std::flat_map<int, int> map;
+    for (int i = 0; i < 50000; ++i) {
+        map.emplace_hint(map.end(), 100000 + i, i);
+    }
+    std::flat_map<int, int> low;
+    for (int i = 0; i < 50000; ++i) {
+        low.emplace_hint(low.end(), i, i);
+    }
+    std::flat_map<int, int> const low_copy = low;
+    map.merge(std::execution::par, std::move(low));
+    EXPECT_EQ(map.size(), 100000u);
+    EXPECT_TRUE(std::equal(
+        low_copy.begin(), low_copy.end(), map.begin(), map.begin() + 50000));
+    EXPECT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+}
+#endif
+
+namespace {
+    struct counted_value
+    {
+        counted_value(int v = 0) : value(v) {}
+        counted_value(counted_value const & other) : value(other.value) {}
+        counted_value(counted_value && other) : value(other.value)
+        {
+            ++moves;
+        }
+        counted_value & operator=(counted_value const & other)
+        {
+            value = other.value;
+            return *this;
+        }
+        counted_value & operator=(counted_value && other)
+        {
+            value = other.value;
+            ++moves;
+            return *this;
+        }
+
+        int value;
+        static int moves;
+    };
+    int counted_value::moves = 0;
+}
+
+TEST(std_flat_map, permutation_sort)
+{
+    using fmap_t = std::flat_map<int, counted_value>;
+
+    std::vector<int> keys;
+    std::vector<counted_value> values;
+    for (int i = 0; i < 1000; ++i) {
+        int const k = (i * 389) % 1000;
+        keys.push_back(k);
+        values.push_back(counted_value(-k));
+    }
+
+    counted_value::moves = 0;
+    fmap_t const map(keys, values);
+    int const moves = counted_value::moves;
+    EXPECT_LE(moves, 2 * 1000 + 2);
+
+    EXPECT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+    for (auto const & x : map) {
+        EXPECT_EQ(x.second.value, -x.first);
+    }
+
+    std::flat_map<int, std::string> strings = {{3, "3"}, {1, "1"}};
+    strings.insert({{2, "2"}, {0, "0"}, {2, "x"}});
+    std::vector<std::string> const expected_values = {"0", "1", "2", "3"};
+    EXPECT_EQ(strings.values(), expected_values);
+}
+
+// Maps of up to 200 of these keys are searched by the linear scan alone.
+namespace std {
+    template<>
+    struct flat_map_linear_search_threshold<unsigned short>
+        : integral_constant<size_t, 200>
+    {};
+}
+
+TEST(std_flat_map, linear_search_threshold)
+{
+    using fmap_t = std::flat_map<unsigned short, int>;
+
+    for (int n : {0, 1, 7, 199, 200, 201, 1000}) {
+        fmap_t map;
+        for (int i = 0; i < n; ++i) {
+            map.emplace(static_cast<unsigned short>(i * 2 + 1), i);
+        }
+        for (int k = 0; k < 2 * n + 3; ++k) {
+            auto const key = static_cast<unsigned short>(k);
+            auto const it = map.lower_bound(key);
+            std::ptrdiff_t const expected = (std::min)(k / 2, n);
+            EXPECT_EQ(it - map.begin(), expected);
+            EXPECT_EQ(map.contains(key), k % 2 == 1 && k < 2 * n);
+        }
+    }
+}
+
+namespace std {
+    template<>
+    struct flat_map_interpolation_search<long long, std::less<long long>>
+        : true_type
+    {};
+    template<>
+    struct flat_map_interpolation_search<double, std::less<>> : true_type
+    {};
+}
+
+// Interpolation only starts at 2 MiB of keys, so the larger sizes matter.
+TEST(std_flat_map, interpolation_search)
+{
+    std::vector<std::vector<long long>> key_sets;
+    for (int n : {0, 1, 2, 3, 40, 1000, 300000}) {
+        std::vector<long long> evenly_spread;
+        std::vector<long long> skewed;
+        for (int i = 0; i < n; ++i) {
+            evenly_spread.push_back(1000000 + 7 * i);
+            skewed.push_back((long long)i * i * i);
+        }
+        key_sets.push_back(evenly_spread);
+        key_sets.push_back(skewed);
+    }
+
+    for (auto const & keys : key_sets) {
+        std::flat_map<long long, int> map;
+        for (auto k : keys) {
+            map.emplace(k, 0);
+        }
+        std::vector<long long> queries = {
+            std::numeric_limits<long long>::min(),
+            std::numeric_limits<long long>::max()};
+        for (std::size_t i = 0; i < keys.size(); i += 1 + i % 61) {
+            queries.push_back(keys[i] - 1);
+            queries.push_back(keys[i]);
+            queries.push_back(keys[i] + 1);
+        }
+        for (auto q : queries) {
+            std::ptrdiff_t const lower =
+                std::lower_bound(keys.begin(), keys.end(), q) - keys.begin();
+            std::ptrdiff_t const upper =
+                std::upper_bound(keys.begin(), keys.end(), q) - keys.begin();
+            EXPECT_EQ(map.lower_bound(q) - map.begin(), lower);
+            EXPECT_EQ(map.upper_bound(q) - map.begin(), upper);
+            EXPECT_EQ(map.contains(q), lower != upper);
+        }
+    }
+
+    {
+        double const inf = std::numeric_limits<double>::infinity();
+        std::flat_multimap<double, int, std::less<>> map;
+        std::vector<double> keys = {-inf, -1.0, 0.5, 0.5, 0.5, 2.0, inf, inf};
+        for (int i = 0; i < 300000; ++i) {
+            keys.push_back(i / 8.0);
+        }
+        std::sort(keys.begin(), keys.end());
+        for (auto k : keys) {
+            map.emplace(k, 0);
+        }
+        for (double q :
+             {-inf, -2.0, -1.0, 0.0, 0.5, 1.7, 2.0, 99.0, 12345.6, 4e4, inf}) {
+            std::ptrdiff_t const lower =
+                std::lower_bound(keys.begin(), keys.end(), q) - keys.begin();
+            std::ptrdiff_t const upper =
+                std::upper_bound(keys.begin(), keys.end(), q) - keys.begin();
+            EXPECT_EQ(map.lower_bound(q) - map.begin(), lower);
+            EXPECT_EQ(map.upper_bound(q) - map.begin(), upper);
+            EXPECT_EQ(map.count(q), std::size_t(upper - lower));
+        }
+    }
+}
+
+// Comparators that order ints as less<int> and greater<int> do, and say so.
+struct by_id
+{
+    bool operator()(int x, int y) const { return x < y; }
+};
+struct by_id_descending
+{
+    bool operator()(int x, int y) const { return y < x; }
+};
+namespace std {
+    template<>
+    struct flat_map_key_traits<int, by_id>
+        : flat_map_default_key_traits<int, less<int>>
+    {};
+    template<>
+    struct flat_map_key_traits<int, by_id_descending>
+        : flat_map_default_key_traits<int, greater<int>>
+    {};
+}
+
+TEST(std_flat_map, key_traits)
+{
+    using traits = std::flat_map_key_traits<int, std::greater<>>;
+    static_assert(traits::descending && !traits::ascending);
+    static_assert(traits::branchless && traits::radix_sortable);
+    static_assert(!traits::interpolation_search);
+    static_assert(!traits::three_way<int>);
+    using string_traits =
+        std::flat_map_key_traits<std::string, std::less<std::string>>;
+    static_assert(string_traits::ascending && !string_traits::branchless);
+    static_assert(!string_traits::radix_sortable);
+    static_assert(!std::flat_map_key_traits<int, by_id_descending>::ascending);
+
+    // The specialized comparators get the kernels of the orders they
+    // claim.
+    static_assert(std::__is_branchless_searchable<
+                  int,
+                  by_id,
+                  std::vector<int>>::value);
+    static_assert(std::__is_radix_sortable<int, by_id_descending>::value);
+
+    std::vector<int> keys;
+    std::vector<int> values;
+    for (int i = 0; i < 20000; ++i) {
+        keys.push_back(i * 7919 % 30000 - 15000);
+        values.push_back(i);
+    }
+    std::flat_map<int, int> const expected(keys, values);
+    std::flat_map<int, int, by_id> const ascending(keys, values);
+    std::flat_map<int, int, by_id_descending> const descending(keys, values);
+    EXPECT_TRUE(std::equal(
+        ascending.begin(), ascending.end(), expected.begin(), expected.end()));
+    EXPECT_TRUE(std::equal(
+        descending.begin(),
+        descending.end(),
+        expected.rbegin(),
+        expected.rend()));
+    for (int k = -15001; k < 15001; k += 3) {
+        auto const it = expected.find(k);
+        ASSERT_EQ(ascending.contains(k), it != expected.end());
+        ASSERT_EQ(descending.contains(k), it != expected.end());
+        if (it != expected.end()) {
+            EXPECT_EQ(ascending.at(k), it->second);
+            EXPECT_EQ(descending.at(k), it->second);
+        }
+        EXPECT_EQ(
+            ascending.lower_bound(k) - ascending.begin(),
+            expected.lower_bound(k) - expected.begin());
+    }
+}
+
+TEST(std_flat_map, radix_sort)
+{
+    std::vector<int> keys;
+    std::vector<int> values;
+    for (int i = 0; i < 5000; ++i) {
+        int const k = (i * 2039) % 5000 - 2500;
+        keys.push_back(k);
+        values.push_back(-k);
+    }
+
+    {
+        std::flat_map<int, int> const map(keys, values);
+        EXPECT_EQ(map.size(), 5000u);
+        EXPECT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+        for (auto const & x : map) {
+            EXPECT_EQ(x.second, -x.first);
+        }
+    }
+
+    {
+        std::flat_map<int, int, std::greater<>> map;
+        map.insert(std::sorted_unique, {{9000, 0}});
+        std::vector<std::pair<int, int>> pairs;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            pairs.emplace_back(keys[i], values[i]);
+            pairs.emplace_back(keys[i], 0);
+        }
+        map.insert(pairs.begin(), pairs.end());
+        EXPECT_EQ(map.size(), 5001u);
+        EXPECT_TRUE(std::is_sorted(
+            map.keys().begin(), map.keys().end(), std::greater<>()));
+        for (auto const & x : map) {
+            EXPECT_EQ(x.second, x.first == 9000 ? 0 : -x.first);
+        }
+    }
+
+    {
+        std::flat_multimap<std::uint64_t, int> map;
+        for (int i = 0; i < 1000; ++i) {
+            map.insert({std::uint64_t(i % 10) << 40, i});
+        }
+        std::vector<std::pair<std::uint64_t, int>> pairs;
+        for (int i = 0; i < 1000; ++i) {
+            pairs.emplace_back(std::uint64_t(i % 10) << 40, 1000 + i);
+        }
+        map.insert(pairs.begin(), pairs.end());
+        EXPECT_EQ(map.size(), 2000u);
+        EXPECT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+        auto const range = map.equal_range(std::uint64_t(3) << 40);
+        EXPECT_EQ(range.second - range.first, 200);
+        EXPECT_TRUE(std::is_sorted(
+            map.values().begin() + (range.first - map.begin()),
+            map.values().begin() + (range.second - map.begin())));
+    }
+}
+
+namespace {
+    // Orders ints like std::less, but is not recognized as a built-in
+    // order, so maps with it do not radix sort.
+    struct opaque_less
+    {
+        bool operator()(int x, int y) const { return x < y; }
+    };
+}
+
+TEST(std_flat_map, zip_sort)
+{
+    // Shuffled, sorted, reversed, and organ-pipe keys.
+    std::vector<std::vector<int>> patterns(4);
+    for (int i = 0; i < 3000; ++i) {
+        patterns[0].push_back((i * 1999) % 3000);
+        patterns[1].push_back(i);
+        patterns[2].push_back(3000 - i);
+        patterns[3].push_back(i < 1500 ? i : 3000 - i + 1500);
+    }
+    for (auto const & keys : patterns) {
+        std::vector<int> values;
+        for (int k : keys) {
+            values.push_back(-k);
+        }
+        std::flat_map<int, int, opaque_less> const map(keys, values);
+        EXPECT_EQ(map.size(), keys.size());
+        EXPECT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+        for (auto const & x : map) {
+            EXPECT_EQ(x.second, -x.first);
+        }
+    }
+
+    {
+        std::vector<std::string> keys;
+        std::vector<int> values;
+        for (int i = 0; i < 2000; ++i) {
+            int const k = (i * 1237) % 2000;
+            keys.push_back("key" + std::to_string(k));
+            values.push_back(k);
+        }
+        std::flat_map<std::string, int> const map(keys, values);
+        EXPECT_EQ(map.size(), 2000u);
+        EXPECT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+        for (auto const & x : map) {
+            EXPECT_EQ(x.first, "key" + std::to_string(x.second));
+        }
+    }
+
+    // Bulk inserts keep the first of each run of equivalent keys, and the
+    // multimap keeps equivalent keys in insertion order.
+    {
+        std::vector<std::pair<int, int>> pairs;
+        for (int i = 0; i < 3000; ++i) {
+            pairs.emplace_back(i % 100, i);
+        }
+        std::flat_map<int, int, opaque_less> map;
+        map.insert(pairs.begin(), pairs.end());
+        EXPECT_EQ(map.size(), 100u);
+        for (auto const & x : map) {
+            EXPECT_EQ(x.second, x.first);
+        }
+
+        std::flat_multimap<std::string, int> multimap;
+        for (auto const & x : pairs) {
+            multimap.emplace(std::to_string(x.first % 7), x.second);
+        }
+        std::vector<std::pair<std::string, int>> more;
+        for (auto const & x : pairs) {
+            more.emplace_back(std::to_string(x.first % 7), 3000 + x.second);
+        }
+        multimap.insert(more.begin(), more.end());
+        EXPECT_EQ(multimap.size(), 6000u);
+        EXPECT_TRUE(
+            std::is_sorted(multimap.keys().begin(), multimap.keys().end()));
+        auto const range = multimap.equal_range("3");
+        EXPECT_TRUE(std::is_sorted(
+            multimap.values().begin() + (range.first - multimap.begin()),
+            multimap.values().begin() + (range.second - multimap.begin())));
+    }
+}
+
+// Keys appended from several sorted feeds, in runs of uneven lengths with
+// keys repeated across runs, as the natural-run merge takes them.
+template<typename Key>
+std::vector<std::pair<Key, int>>
+sorted_feeds(std::vector<int> const & lengths, bool unique)
+{
+    std::mt19937 gen(7);
+    std::vector<std::pair<Key, int>> pairs;
+    int next_unique = 0;
+    for (int length : lengths) {
+        std::vector<int> run(length);
+        for (int & k : run) {
+            k = unique ? next_unique++ * 7919 % 100003 : int(gen() % 4000);
+        }
+        std::sort(run.begin(), run.end());
+        for (int k : run) {
+            Key key{};
+            if constexpr (std::is_same<Key, std::string>::value)
+                key = std::to_string(1000000 + k);
+            else
+                key = k;
+            pairs.emplace_back(key, int(pairs.size()));
+        }
+    }
+    return pairs;
+}
+
+template<typename Map>
+void check_natural_runs()
+{
+    using key_type = typename Map::key_type;
+    std::vector<std::vector<int>> const shapes = {
+        {3000, 2000},
+        {5000, 37, 800, 1, 2600, 64, 64, 900},
+        {100, 100, 100, 100, 100, 100, 100, 100, 100, 100, 100, 100}};
+    for (auto const & lengths : shapes) {
+        // Bulk insert is stable: the first of equivalent keys is kept.
+        auto const pairs = sorted_feeds<key_type>(lengths, false);
+        Map map;
+        map.insert(pairs.begin(), pairs.end());
+        std::map<key_type, int> expected;
+        for (auto const & x : pairs) {
+            expected.emplace(x.first, x.second);
+        }
+        EXPECT_TRUE(std::equal(
+            map.begin(), map.end(), expected.begin(), expected.end(),
+            [](auto const & a, auto const & b) {
+                return a.first == b.first && a.second == b.second;
+            }));
+
+        // The multimap keeps equivalent keys in insertion order.
+        std::flat_multimap<key_type, int, typename Map::key_compare>
+            multimap;
+        multimap.insert(pairs.begin(), pairs.end());
+        EXPECT_EQ(multimap.size(), pairs.size());
+        for (std::size_t i = 1; i < multimap.size(); ++i) {
+            auto const & a = multimap.begin()[i - 1];
+            auto const & b = multimap.begin()[i];
+            EXPECT_TRUE(a.first < b.first ||
+                        (a.first == b.first && a.second < b.second));
+        }
+
+        // The container constructors keep each value with its key.
+        auto const unique_pairs = sorted_feeds<key_type>(lengths, true);
+        std::vector<key_type> keys;
+        std::vector<int> values;
+        for (auto const & x : unique_pairs) {
+            keys.push_back(x.first);
+            values.push_back(x.second);
+        }
+        Map const from_containers(keys, values);
+        EXPECT_EQ(from_containers.size(), keys.size());
+        EXPECT_TRUE(std::is_sorted(
+            from_containers.keys().begin(), from_containers.keys().end()));
+        for (auto const & x : from_containers) {
+            EXPECT_EQ(x.first, keys[x.second]);
+        }
+    }
+}
+
+TEST(std_flat_map, natural_runs)
+{
+    check_natural_runs<std::flat_map<int, int, opaque_less>>();
+    check_natural_runs<std::flat_map<int, int>>();
+    check_natural_runs<std::flat_map<std::string, int>>();
+}
+
+TEST(std_flat_map, combine_duplicates)
+{
+    using fmap_t = std::flat_map<std::string, int>;
+
+    fmap_t const sums(
+        std::combine_duplicates,
+        {"b", "a", "c", "a", "b", "a"},
+        {1, 2, 3, 4, 5, 6},
+        std::plus<>());
+    fmap_t const expected_sums = {{"a", 12}, {"b", 6}, {"c", 3}};
+    EXPECT_EQ(sums, expected_sums);
+
+    // Values are folded in the order given, so keep-last keeps the last.
+    std::vector<int> keys;
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i) {
+        keys.push_back((i * 37) % 100);
+        values.push_back(i);
+    }
+    std::flat_map<int, int, std::greater<int>> const last(
+        std::combine_duplicates,
+        keys,
+        values,
+        [](int, int x) { return x; },
+        std::greater<int>());
+    EXPECT_EQ(last.size(), 100u);
+    int prev = 100;
+    for (auto const & x : last) {
+        EXPECT_LT(x.first, prev);
+        prev = x.first;
+        EXPECT_EQ(x.second, 900 + (x.first * 73) % 100);
+        EXPECT_EQ(keys[x.second], x.first);
+    }
+
+    fmap_t const empty(
+        std::combine_duplicates, {}, {}, [](int x, int y) {
+            return std::max(x, y);
+        });
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST(std_flat_map, add_counts)
+{
+    using fmap_t = std::flat_map<std::uint32_t, std::uint64_t>;
+
+    fmap_t counts;
+    fmap_t expected;
+    std::mt19937 gen(5);
+    // Batches both larger and smaller than the map, so that keys are
+    // looked up first in some and only sorted in others.
+    for (std::size_t batch : {16u, 1000u, 50u, 5000u, 1u, 0u, 300u}) {
+        std::vector<std::uint32_t> keys(batch);
+        for (auto & k : keys) {
+            k = std::uint32_t(gen() % 400);
+            ++expected[k];
+        }
+        counts.add_counts(keys.begin(), keys.end());
+        EXPECT_EQ(counts, expected);
+    }
+
+    std::flat_map<std::string, int> words = {{"b", 10}};
+    std::istringstream is("a b c b a b");
+    words.add_counts(
+        std::istream_iterator<std::string>(is),
+        std::istream_iterator<std::string>());
+    std::flat_map<std::string, int> const expected_words = {
+        {"a", 2}, {"b", 13}, {"c", 1}};
+    EXPECT_EQ(words, expected_words);
+}
+
+TEST(std_flat_map, insert_or_assign_sorted_range)
+{
+    using fmap_t = std::flat_map<int, std::string>;
+
+    fmap_t map;
+    std::map<int, std::string> std_map;
+    std::mt19937 gen(3);
+    for (int batch = 0; batch < 20; ++batch) {
+        std::map<int, std::string> updates;
+        for (int i = 0; i < 100; ++i) {
+            updates[int(gen() % 1000)] = std::to_string(batch * 1000 + i);
+        }
+        std::vector<std::pair<int, std::string>> sorted(
+            updates.begin(), updates.end());
+        map.insert_or_assign(
+            std::sorted_unique,
+            std::make_move_iterator(sorted.begin()),
+            std::make_move_iterator(sorted.end()));
+        for (auto const & x : updates) {
+            std_map[x.first] = x.second;
+        }
+        EXPECT_TRUE(std::equal(
+            map.begin(),
+            map.end(),
+            std_map.begin(),
+            std_map.end(),
+            [](auto lhs, auto rhs) {
+                return lhs.first == rhs.first && lhs.second == rhs.second;
+            }));
+    }
+
+    fmap_t small = {{2, "b"}, {4, "d"}};
+    small.insert_or_assign(
+        std::sorted_unique, {{1, "A"}, {2, "B"}, {3, "C"}, {4, "D"}, {5, "E"}});
+    fmap_t const expected = {
+        {1, "A"}, {2, "B"}, {3, "C"}, {4, "D"}, {5, "E"}};
+    EXPECT_EQ(small, expected);
+}
+
+TEST(std_flat_map, blockwise_comparisons)
+{
+    std::mt19937 gen(13);
+    for (int i = 0; i < 500; ++i) {
+        std::flat_map<int, int> x;
+        std::map<int, int> std_x;
+        for (int j = 0, n = int(gen() % 1000); j < n; ++j) {
+            int const k = int(gen() % 1200);
+            int const v = int(gen() % 3);
+            x.emplace(k, v);
+            std_x.emplace(k, v);
+        }
+        auto y = x;
+        auto std_y = std_x;
+        if (!y.empty() && gen() % 2) {
+            auto const it = y.begin() + gen() % y.size();
+            auto std_it = std::next(std_y.begin(), it - y.begin());
+            if (gen() % 2) {
+                it->second = std_it->second = int(gen() % 3);
+            } else {
+                y.erase(it);
+                std_y.erase(std_it);
+            }
+        }
+        EXPECT_EQ(x == y, std_x == std_y);
+        EXPECT_EQ(x < y, std_x < std_y);
+        EXPECT_EQ(y < x, std_y < std_x);
+#if FLAT_MAP_THREE_WAY
+        EXPECT_TRUE((x <=> y) == (std_x <=> std_y));
+#endif
+    }
+
+    // Values that are not bytewise comparable are ordered by < alone.
+    double const nan = std::numeric_limits<double>::quiet_NaN();
+    std::flat_map<int, double> const a = {{1, nan}, {2, 1.0}};
+    std::flat_map<int, double> const b = {{1, 0.0}, {2, 2.0}};
+    EXPECT_TRUE(a < b);
+    EXPECT_FALSE(b < a);
+    EXPECT_FALSE(a == a);
+#if FLAT_MAP_THREE_WAY
+    EXPECT_TRUE((a <=> b) < 0);
+    EXPECT_TRUE((b <=> a) > 0);
+    EXPECT_TRUE(a <= b);
+    EXPECT_FALSE(a >= b);
+#endif
+    std::flat_multimap<int, double> const c = {{1, -0.0}, {1, 0.0}};
+    std::flat_multimap<int, double> const d = {{1, 0.0}, {1, -0.0}};
+    EXPECT_TRUE(c == d);
+}
+
+TEST(std_flat_map, hash)
+{
+    using fmap_t = std::flat_map<int, long>;
+
+    std::unordered_set<fmap_t> seen;
+    std::mt19937 gen(17);
+    for (int i = 0; i < 1000; ++i) {
+        fmap_t m;
+        for (int j = 0, n = int(gen() % 40); j < n; ++j) {
+            m.emplace(int(gen() % 50), long(gen() % 4));
+        }
+        fmap_t const copy(std::sorted_unique, m.keys(), m.values());
+        EXPECT_EQ(std::hash<fmap_t>()(m), std::hash<fmap_t>()(copy));
+        seen.insert(m);
+    }
+    EXPECT_GT(seen.size(), 900u);
+    std::unordered_set<std::size_t> hashes;
+    for (auto const & m : seen) {
+        hashes.insert(std::hash<fmap_t>()(m));
+    }
+    EXPECT_EQ(hashes.size(), seen.size());
+
+    // Moving a value to another key changes the hash.
+    fmap_t const a = {{1, 2}, {3, 4}};
+    fmap_t const b = {{1, 4}, {3, 2}};
+    EXPECT_NE(hash_value(a), hash_value(b));
+
+    // Elements that are equal but not bytewise hash alike.
+    using fmmap_t = std::flat_multimap<std::string, double>;
+    fmmap_t const c = {{"x", 0.0}, {"x", 1}};
+    fmmap_t const d = {{"x", -0.0}, {"x", 1}};
+    EXPECT_EQ(c, d);
+    EXPECT_EQ(std::hash<fmmap_t>()(c), std::hash<fmmap_t>()(d));
+}
+
+TEST(std_flat_map, split)
+{
+    using fmap_t = std::flat_map<int, std::string>;
+
+    fmap_t map = {{1, "a"}, {3, "c"}, {5, "e"}, {7, "g"}};
+    fmap_t const high = map.split(6);
+    fmap_t const expected_high = {{7, "g"}};
+    EXPECT_EQ(high, expected_high);
+    fmap_t const middle = map.split(3);
+    fmap_t const expected_middle = {{3, "c"}, {5, "e"}};
+    EXPECT_EQ(middle, expected_middle);
+    fmap_t const expected_low = {{1, "a"}};
+    EXPECT_EQ(map, expected_low);
+
+    EXPECT_TRUE(map.split(10).empty());
+    fmap_t const all = map.split(0);
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(all, expected_low);
+}
+
+TEST(std_flat_map, append_ordered)
+{
+    using fmap_t = std::flat_map<int, std::string>;
+
+    fmap_t map;
+    map.append_ordered(fmap_t{{1, "a"}, {3, "c"}});
+    fmap_t high = {{5, "e"}, {7, "g"}};
+    map.append_ordered(std::move(high));
+    EXPECT_TRUE(high.empty());
+    fmap_t const expected = {{1, "a"}, {3, "c"}, {5, "e"}, {7, "g"}};
+    EXPECT_EQ(map, expected);
+
+    // Ranges that overlap are merged, keeping the values already present.
+    map.append_ordered(fmap_t{{0, "z"}, {3, "x"}, {6, "f"}});
+    fmap_t const merged = {
+        {0, "z"}, {1, "a"}, {3, "c"}, {5, "e"}, {6, "f"}, {7, "g"}};
+    EXPECT_EQ(map, merged);
+
+    // split() and append_ordered() are inverses.
+    fmap_t tail = map.split(4);
+    map.append_ordered(std::move(tail));
+    EXPECT_EQ(map, merged);
+}
+
+namespace {
+    struct tracked_key
+    {
+        explicit tracked_key(std::string_view s) : value(s)
+        {
+            ++constructions;
+        }
+
+        std::string value;
+        static int constructions;
+    };
+    int tracked_key::constructions = 0;
+
+    struct tracked_less
+    {
+        using is_transparent = void;
+        bool operator()(tracked_key const & x, tracked_key const & y) const
+        {
+            return x.value < y.value;
+        }
+        bool operator()(tracked_key const & x, std::string_view y) const
+        {
+            return x.value < y;
+        }
+        bool operator()(std::string_view x, tracked_key const & y) const
+        {
+            return x < y.value;
+        }
+    };
+
+    template<class Map, class K, class = void>
+    struct has_at : std::false_type
+    {};
+    template<class Map, class K>
+    struct has_at<
+        Map,
+        K,
+        std::void_t<decltype(std::declval<Map &>().at(std::declval<K>()))>>
+        : std::true_type
+    {};
+}
+
+TEST(std_flat_map, heterogeneous_lookup)
+{
+    static_assert(has_at<std::flat_map<std::string, int, std::less<>>,
+                         std::string_view>::value);
+    static_assert(
+        !has_at<std::flat_map<std::string, int>, std::string_view>::value);
+
+    using namespace std::literals;
+    tracked_key::constructions = 0;
+    std::flat_map<tracked_key, int, tracked_less> map;
+
+    EXPECT_TRUE(map.try_emplace("b"sv, 2).second);
+    EXPECT_FALSE(map.try_emplace("b"sv, 3).second);
+    map["a"sv] = 1;
+    ++map["a"sv];
+    EXPECT_TRUE(map.insert_or_assign("c"sv, 3).second);
+    EXPECT_FALSE(map.insert_or_assign("c"sv, 30).second);
+    map.try_emplace(map.end(), "d"sv, 4);
+    map.try_emplace(map.end(), "d"sv, 40);
+    map.insert_or_assign(map.begin(), "e"sv, 5);
+    EXPECT_EQ(tracked_key::constructions, 5);
+
+    auto const & const_map = map;
+    EXPECT_EQ(map.find("a"sv)->second, 2);
+    static_assert(std::is_same<
+                  decltype(const_map.find("c"sv)),
+                  decltype(const_map.cend())>::value);
+    EXPECT_EQ(const_map.find("c"sv)->second, 30);
+    EXPECT_EQ(const_map.find("cc"sv), const_map.cend());
+    EXPECT_EQ(map.count("b"sv), 1u);
+    EXPECT_FALSE(const_map.contains("z"sv));
+    EXPECT_EQ(map.lower_bound("bb"sv)->second, 30);
+    EXPECT_EQ(const_map.upper_bound("c"sv)->second, 4);
+    auto const range = const_map.equal_range("d"sv);
+    EXPECT_EQ(range.second - range.first, 1);
+    EXPECT_EQ(map.at("e"sv), 5);
+    EXPECT_EQ(const_map.at("b"sv), 2);
+    EXPECT_THROW(map.at("z"sv), std::out_of_range);
+    EXPECT_EQ(map.erase("b"sv), 1u);
+    EXPECT_EQ(map.erase("b"sv), 0u);
+    EXPECT_EQ(map.size(), 4u);
+    EXPECT_EQ(tracked_key::constructions, 5);
+
+    std::flat_multimap<tracked_key, int, tracked_less> multimap;
+    multimap.emplace("x"sv, 1);
+    multimap.emplace("x"sv, 2);
+    multimap.emplace("y"sv, 3);
+    tracked_key::constructions = 0;
+    EXPECT_EQ(multimap.count("x"sv), 2u);
+    EXPECT_EQ(multimap.find("y"sv)->second, 3);
+    EXPECT_EQ(multimap.erase("x"sv), 2u);
+    EXPECT_EQ(multimap.size(), 1u);
+    EXPECT_EQ(tracked_key::constructions, 0);
+}
+
+namespace {
+    struct emplace_counted
+    {
+        emplace_counted(int x, int y) : value(x + y) { ++constructions; }
+        emplace_counted(emplace_counted const & other) : value(other.value)
+        {
+            ++copies;
+        }
+        emplace_counted(emplace_counted && other) noexcept : value(other.value)
+        {
+            ++moves;
+        }
+        emplace_counted & operator=(emplace_counted const &) = default;
+        emplace_counted & operator=(emplace_counted &&) = default;
+
+        static void reset() { constructions = copies = moves = 0; }
+
+        int value;
+        static int constructions;
+        static int copies;
+        static int moves;
+    };
+    int emplace_counted::constructions = 0;
+    int emplace_counted::copies = 0;
+    int emplace_counted::moves = 0;
+}
+
+TEST(std_flat_map, emplace_in_place)
+{
+    std::flat_map<std::string, emplace_counted> map;
+    map.reserve(8);
+    emplace_counted::reset();
+
+    std::string const key = "b";
+    EXPECT_TRUE(map.emplace(
+                       std::piecewise_construct,
+                       std::forward_as_tuple(key),
+                       std::forward_as_tuple(1, 2))
+                    .second);
+    EXPECT_EQ(emplace_counted::constructions, 1);
+    EXPECT_EQ(emplace_counted::moves, 0);
+    EXPECT_FALSE(map.emplace(
+                        std::piecewise_construct,
+                        std::forward_as_tuple("b"),
+                        std::forward_as_tuple(3, 4))
+                     .second);
+    EXPECT_EQ(emplace_counted::constructions, 1);
+
+    emplace_counted const value(5, 6);
+    emplace_counted::reset();
+    EXPECT_FALSE(map.emplace(key, value).second);
+    EXPECT_FALSE(map.emplace(std::make_pair(key, value)).second);
+    EXPECT_EQ(emplace_counted::copies, 1);
+    emplace_counted::reset();
+    EXPECT_EQ(map.emplace_hint(map.end(), "c", value)->second.value, 11);
+    EXPECT_EQ(emplace_counted::copies, 1);
+    EXPECT_EQ(emplace_counted::moves, 0);
+    EXPECT_EQ(map.emplace_hint(map.end(), "c", value)->second.value, 11);
+    EXPECT_EQ(emplace_counted::copies, 1);
+    EXPECT_EQ(map.find("b")->second.value, 3);
+
+    std::flat_multimap<std::string, emplace_counted> multimap;
+    emplace_counted::reset();
+    multimap.emplace(
+        std::piecewise_construct,
+        std::forward_as_tuple("x"),
+        std::forward_as_tuple(1, 2));
+    EXPECT_EQ(emplace_counted::constructions, 1);
+    EXPECT_EQ(emplace_counted::moves, 0);
+    multimap.emplace_hint(multimap.end(), *map.begin());
+    EXPECT_EQ(emplace_counted::copies, 1);
+    EXPECT_EQ(multimap.begin()->first, "b");
+
+    // Containers that must grow still get the value built in place, unless
+    // an argument might refer into the map.
+    std::flat_map<std::string, emplace_counted> full;
+    emplace_counted::reset();
+    full.try_emplace("a", 1, 2);
+    EXPECT_EQ(emplace_counted::moves, 0);
+    full.shrink_to_fit();
+    full.try_emplace("b", full.begin()->second);
+    EXPECT_EQ(emplace_counted::copies, 1);
+    EXPECT_EQ(full.find("b")->second.value, 3);
+}
+
+namespace {
+    struct throwing_key
+    {
+        throwing_key(int v) : value(v) {}
+        throwing_key(throwing_key const & other) : value(other.value)
+        {
+            if (value == throw_on_copy)
+                throw std::runtime_error("copy");
+        }
+        throwing_key(throwing_key &&) noexcept = default;
+        throwing_key & operator=(throwing_key const &) = default;
+        throwing_key & operator=(throwing_key &&) noexcept = default;
+        bool operator<(throwing_key const & other) const
+        {
+            return value < other.value;
+        }
+
+        int value;
+        static int throw_on_copy;
+    };
+    int throwing_key::throw_on_copy = -1;
+}
+
+TEST(std_flat_map, insert_strong_guarantee)
+{
+    std::flat_map<throwing_key, std::string> map;
+    for (int i = 0; i < 8; ++i) {
+        map.emplace(i * 2, std::to_string(i));
+        EXPECT_EQ(map.keys().capacity(), map.values().capacity());
+    }
+
+    throwing_key const five(5);
+    throwing_key::throw_on_copy = 5;
+    EXPECT_THROW(map.try_emplace(five, "five"), std::runtime_error);
+    map.reserve(16);
+    EXPECT_THROW(map.try_emplace(five, "five"), std::runtime_error);
+    EXPECT_THROW(map.insert_or_assign(five, "five"), std::runtime_error);
+    EXPECT_THROW(map.emplace_hint(map.end(), five, "5"), std::runtime_error);
+    EXPECT_EQ(map.size(), 8u);
+    EXPECT_EQ(map.values().size(), 8u);
+    EXPECT_EQ(map.find(5), map.end());
+    EXPECT_EQ(map.find(6)->second, "3");
+
+    throwing_key::throw_on_copy = -1;
+    EXPECT_TRUE(map.try_emplace(five, "five").second);
+    EXPECT_EQ(map.size(), 9u);
+    EXPECT_EQ(map.keys().capacity(), map.values().capacity());
+    EXPECT_EQ((map.begin() + 3)->second, "five");
+
+    std::flat_multimap<throwing_key, std::string> multimap;
+    multimap.emplace(1, "one");
+    multimap.emplace(*multimap.begin());
+    throwing_key::throw_on_copy = 1;
+    EXPECT_THROW(multimap.emplace(*multimap.begin()), std::runtime_error);
+    throwing_key::throw_on_copy = -1;
+    EXPECT_EQ(multimap.size(), 2u);
+    EXPECT_EQ(multimap.values().size(), 2u);
+    EXPECT_EQ((multimap.begin() + 1)->second, "one");
+}
+
+TEST(std_flat_map, insert_range_into_existing)
+{
+    std::vector<std::vector<std::pair<int, int>>> batches = {
+        {{-3, 0}, {-1, 0}},
+        {{1, 1}, {3, 1}, {5, 1}, {99, 1}},
+        {{0, 2}, {2, 2}, {41, 2}, {42, 2}, {43, 2}, {44, 2}},
+        {{7, 3}, {500, 3}, {501, 3}},
+        {{501, 4}, {600, 4}},
+        {{601, 5}, {602, 5}},
+    };
+    std::flat_map<int, int> map;
+    std::flat_multimap<int, int> multimap;
+    for (int i = 0; i < 100; i += 2) {
+        map.emplace(i, -1);
+        multimap.emplace(i, -1);
+    }
+    std::vector<std::pair<int, int>> expected(map.begin(), map.end());
+    std::vector<std::pair<int, int>> expected_multi = expected;
+    auto buffered_map = map;
+    auto buffered_multimap = multimap;
+    std::flat_map<int, int>::merge_buffer buffer;
+    std::flat_multimap<int, int>::merge_buffer multi_buffer;
+    for (auto const & batch : batches) {
+        map.insert(std::sorted_unique, batch.begin(), batch.end());
+        multimap.insert(batch.rbegin(), batch.rend());
+        buffered_map.insert(batch.rbegin(), batch.rend(), buffer);
+        buffered_multimap.insert(
+            std::sorted_equivalent, batch.begin(), batch.end(), multi_buffer);
+        for (auto const & x : batch) {
+            auto const it = std::lower_bound(
+                expected.begin(), expected.end(), std::make_pair(x.first, -2));
+            if (it == expected.end() || it->first != x.first)
+                expected.insert(it, x);
+            expected_multi.insert(
+                std::upper_bound(
+                    expected_multi.begin(),
+                    expected_multi.end(),
+                    x,
+                    [](auto const & a, auto const & b) {
+                        return a.first < b.first;
+                    }),
+                x);
+        }
+        using pairs_t = std::vector<std::pair<int, int>>;
+        EXPECT_EQ(pairs_t(map.begin(), map.end()), expected);
+        EXPECT_EQ(pairs_t(multimap.begin(), multimap.end()), expected_multi);
+        EXPECT_EQ(buffered_map, map);
+        EXPECT_EQ(buffered_multimap, multimap);
+    }
+    EXPECT_EQ(map.size(), 64u);
+    EXPECT_EQ(multimap.size(), 69u);
+
+    // The merge buffer holds the map's own container types.
+    using deque_t = std::deque<int>;
+    std::flat_map<int, int, std::less<int>, deque_t, deque_t> deque_map;
+    decltype(deque_map)::merge_buffer deque_buffer;
+    for (int i = 0; i < 100; i += 2) {
+        deque_map.emplace(i, -1);
+    }
+    for (auto const & batch : batches) {
+        deque_map.insert(batch.rbegin(), batch.rend(), deque_buffer);
+    }
+    EXPECT_TRUE(std::equal(
+        deque_map.begin(),
+        deque_map.end(),
+        expected.begin(),
+        expected.end(),
+        [](auto const & a, auto const & b) {
+            return a.first == b.first && a.second == b.second;
+        }));
+}
+
+TEST(std_flat_map, insert_moved_elements)
+{
+    using fmap_t = std::flat_map<std::string, std::string>;
+    using fmmap_t = std::flat_multimap<std::string, std::string>;
+    std::string const long_a(40, 'a');
+    std::string const long_b(40, 'b');
+    std::string const long_c(40, 'c');
+
+    {
+        std::vector<std::pair<std::string, std::string>> source = {
+            {long_b, long_b}, {long_a, long_a}};
+        fmap_t map = {{long_c, long_c}};
+        map.insert(
+            std::make_move_iterator(source.begin()),
+            std::make_move_iterator(source.end()));
+        EXPECT_EQ(map.size(), 3u);
+        EXPECT_EQ(map.at(long_a), long_a);
+        EXPECT_TRUE(source[0].first.empty());
+        EXPECT_TRUE(source[1].second.empty());
+    }
+
+    {
+        fmap_t map = {{long_b, "old"}};
+        fmap_t::containers c = {
+            {long_c, long_b, long_a, long_c}, {"c0", "b", "a", "c1"}};
+        map.insert(std::move(c));
+        EXPECT_EQ(map.size(), 3u);
+        EXPECT_EQ(map.at(long_b), "old");
+        EXPECT_EQ(map.at(long_c), "c0");
+        EXPECT_TRUE(c.keys[0].empty());
+
+        fmap_t empty_map;
+        std::vector<std::string> keys = {long_b, long_a, long_b};
+        std::vector<std::string> values = {"b0", "a", "b1"};
+        auto const data = keys.data();
+        empty_map.insert(std::move(keys), std::move(values));
+        EXPECT_EQ(empty_map.keys().data(), data);
+        EXPECT_EQ(empty_map.size(), 2u);
+        EXPECT_EQ(empty_map.at(long_b), "b0");
+    }
+
+    {
+        fmmap_t multimap = {{long_b, "old"}};
+        multimap.insert(
+            {long_c, long_b, long_a, long_b}, {"c", "b0", "a", "b1"});
+        std::vector<std::string> const expected = {"a", "old", "b0", "b1", "c"};
+        EXPECT_EQ(multimap.values(), expected);
+    }
+}
+
+#if defined(__cpp_lib_memory_resource)
+TEST(std_flat_map, pmr)
+{
+    using fmap_t = std::pmr::flat_map<int, std::pmr::string>;
+    using fmmap_t = std::pmr::flat_multimap<int, int>;
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::monotonic_buffer_resource other_arena;
+    auto const resource_of = [](auto const & cont) {
+        return cont.get_allocator().resource();
+    };
+
+    fmap_t map(&arena);
+    for (int i = 0; i < 100; ++i) {
+        map.emplace(i, std::string(40, char('a' + i % 26)));
+    }
+    EXPECT_EQ(resource_of(map.keys()), &arena);
+    EXPECT_EQ(resource_of(map.values()), &arena);
+    EXPECT_EQ(resource_of(map.values()[7]), &arena);
+
+    {
+        fmap_t copy(map, &other_arena);
+        EXPECT_EQ(copy, map);
+        EXPECT_EQ(resource_of(copy.keys()), &other_arena);
+
+        auto const data = copy.keys().data();
+        fmap_t same_arena(std::move(copy), &other_arena);
+        EXPECT_EQ(same_arena.keys().data(), data);
+        fmap_t moved_across(std::move(same_arena), &arena);
+        EXPECT_EQ(moved_across, map);
+        EXPECT_EQ(resource_of(moved_across.values()), &arena);
+    }
+
+    {
+        auto containers = std::move(map).extract();
+        EXPECT_TRUE(map.empty());
+        EXPECT_EQ(resource_of(containers.keys), &arena);
+        EXPECT_EQ(containers.keys.size(), 100u);
+
+        std::pmr::vector<int> keys({1, 2, 3}, &other_arena);
+        std::pmr::vector<std::pmr::string> values(
+            {"one", "two", "three"}, &other_arena);
+        map.replace(std::move(keys), std::move(values));
+        EXPECT_EQ(resource_of(map.keys()), &arena);
+        EXPECT_EQ(map.at(2), "two");
+
+        fmap_t other(&arena);
+        other.replace(std::move(containers.keys), std::move(containers.values));
+        other.swap(map);
+        EXPECT_EQ(map.size(), 100u);
+        EXPECT_EQ(other.size(), 3u);
+        EXPECT_EQ(resource_of(other.keys()), &arena);
+    }
+
+    {
+        // Rvalue containers on the same resource are moved in whole.
+        std::pmr::vector<int> keys({3, 1, 2}, &arena);
+        std::pmr::vector<std::pmr::string> values({"c", "a", "b"}, &arena);
+        auto const key_data = keys.data();
+        auto const value_data = values.data();
+        fmap_t const moved(std::move(keys), std::move(values), &arena);
+        EXPECT_EQ(moved.keys().data(), key_data);
+        EXPECT_EQ(moved.values().data(), value_data);
+        EXPECT_EQ(moved.begin()->second, "a");
+
+        std::pmr::vector<int> sorted_keys({1, 2}, &arena);
+        std::pmr::vector<std::pmr::string> sorted_values({"a", "b"}, &arena);
+        auto const sorted_data = sorted_keys.data();
+        fmap_t const sorted(
+            std::sorted_unique,
+            std::move(sorted_keys),
+            std::move(sorted_values),
+            &arena);
+        EXPECT_EQ(sorted.keys().data(), sorted_data);
+
+        // Across resources, the elements are moved into new storage.
+        std::pmr::vector<int> far_keys({1, 2}, &other_arena);
+        std::pmr::vector<std::pmr::string> far_values({"a", "b"}, &other_arena);
+        fmap_t const across(
+            std::sorted_unique,
+            std::move(far_keys),
+            std::move(far_values),
+            &arena);
+        EXPECT_EQ(resource_of(across.keys()), &arena);
+        EXPECT_EQ(resource_of(across.values()[1]), &arena);
+        EXPECT_EQ(across, sorted);
+
+        std::pmr::vector<int> multi_keys({2, 1, 2}, &arena);
+        std::pmr::vector<int> multi_values({1, 2, 3}, &arena);
+        auto const multi_data = multi_keys.data();
+        fmmap_t const multi(
+            std::move(multi_keys), std::move(multi_values), &arena);
+        EXPECT_EQ(multi.keys().data(), multi_data);
+        EXPECT_EQ(multi.count(2), 2u);
+    }
+
+    fmmap_t multimap({{1, 1}, {1, 2}}, &arena);
+    EXPECT_EQ(multimap.count(1), 2u);
+    EXPECT_EQ(resource_of(multimap.values()), &arena);
+}
+#endif
+
+namespace {
+    struct relocatable_value
+    {
+        explicit relocatable_value(int v) : value(std::make_unique<int>(v)) {}
+        std::unique_ptr<int> value;
+    };
+}
+
+namespace std {
+    template<>
+    struct flat_map_trivially_relocatable<relocatable_value> : true_type
+    {};
+}
+
+TEST(std_flat_map, relocating_insert_erase)
+{
+    std::flat_map<int, relocatable_value> map;
+    std::flat_multimap<int, relocatable_value> multimap;
+    std::vector<int> expected;
+    for (int i = 0; i < 200; ++i) {
+        int const k = (i * 37) % 101;
+        if (map.try_emplace(k, k).second) {
+            expected.insert(
+                std::lower_bound(expected.begin(), expected.end(), k), k);
+        }
+        multimap.emplace(k, relocatable_value(k));
+        if (i % 3 == 0) {
+            int const gone = (i * 11) % 101;
+            if (map.erase(gone)) {
+                expected.erase(
+                    std::lower_bound(expected.begin(), expected.end(), gone));
+            }
+        }
+    }
+    ASSERT_EQ(map.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(map.keys()[i], expected[i]);
+        EXPECT_EQ(*map.values()[i].value, expected[i]);
+    }
+
+    auto it = map.erase(map.begin() + 1);
+    EXPECT_EQ(it->first, expected[2]);
+    EXPECT_EQ(*map.begin()->second.value, expected[0]);
+    EXPECT_EQ(*(map.end() - 1)->second.value, expected.back());
+
+    EXPECT_EQ(multimap.size(), 200u);
+    multimap.erase(multimap.begin());
+    EXPECT_EQ(multimap.size(), 199u);
+    for (auto const & x : multimap) {
+        EXPECT_EQ(*x.second.value, x.first);
+    }
+}
+
+namespace {
+    struct copy_counting_less
+    {
+        copy_counting_less() = default;
+        copy_counting_less(copy_counting_less const &) { ++copies; }
+        copy_counting_less & operator=(copy_counting_less const &)
+        {
+            ++copies;
+            return *this;
+        }
+        bool operator()(int x, int y) const { return x < y; }
+
+        std::shared_ptr<int> state;
+        static int copies;
+    };
+    int copy_counting_less::copies = 0;
+}
+
+TEST(std_flat_map, comparator_not_copied)
+{
+    static_assert(
+        sizeof(std::flat_map<int, int>) ==
+        sizeof(std::flat_map<int, int>::containers));
+    static_assert(
+        sizeof(std::flat_multimap<int, int>) ==
+        sizeof(std::flat_multimap<int, int>::containers));
+
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < 1000; ++i) {
+        pairs.emplace_back((i * 7919) % 1000, i);
+    }
+    std::flat_map<int, int, copy_counting_less> map;
+    std::flat_multimap<int, int, copy_counting_less> multimap;
+    copy_counting_less::copies = 0;
+
+    map.insert(pairs.begin(), pairs.begin() + 500);
+    map.insert(pairs.begin() + 500, pairs.end());
+    multimap.insert(pairs.begin(), pairs.end());
+    for (int i = 0; i < 1000; i += 10) {
+        EXPECT_TRUE(map.contains(i));
+        EXPECT_EQ(map.equal_range(i).second - map.equal_range(i).first, 1);
+        EXPECT_EQ(multimap.count(i), 1u);
+        map.emplace_hint(map.begin(), i, 0);
+        multimap.emplace_hint(multimap.end(), i, 0);
+    }
+    map.erase(map.lower_bound(500), map.upper_bound(600));
+    EXPECT_EQ(map.size(), 899u);
+    auto batch = map.batch();
+    batch.insert_or_assign(550, 1);
+    batch.erase(0);
+    batch.insert(2000, 2);
+    batch.commit();
+    EXPECT_EQ(map.size(), 900u);
+    EXPECT_EQ(copy_counting_less::copies, 0);
+}
+
+namespace {
+    struct three_way_less
+    {
+        bool operator()(std::string const & x, std::string const & y) const
+        {
+            ++less_calls;
+            return x < y;
+        }
+        int compare(std::string const & x, std::string const & y) const
+        {
+            ++compare_calls;
+            return x.compare(y);
+        }
+
+        static int less_calls;
+        static int compare_calls;
+    };
+    int three_way_less::less_calls = 0;
+    int three_way_less::compare_calls = 0;
+}
+
+TEST(std_flat_map, three_way_lookup)
+{
+    std::flat_map<std::string, int, three_way_less> map;
+    for (int i = 0; i < 1000; i += 2) {
+        map.emplace(std::to_string(100000 + i), i);
+    }
+    three_way_less::less_calls = 0;
+    three_way_less::compare_calls = 0;
+    for (int i = 0; i < 1000; ++i) {
+        std::string const k = std::to_string(100000 + i);
+        EXPECT_EQ(map.contains(k), i % 2 == 0);
+        if (i % 2 == 0) {
+            EXPECT_EQ(map.find(k)->second, i);
+            EXPECT_FALSE(map.try_emplace(k, -1).second);
+        }
+    }
+    EXPECT_EQ(three_way_less::less_calls, 0);
+    // Each of the 2000 searches probes at most ceil(log2(501)) = 9 keys.
+    EXPECT_LE(three_way_less::compare_calls, 2000 * 9);
+
+    EXPECT_TRUE(map.try_emplace("0", 0).second);
+    EXPECT_TRUE(map.insert_or_assign("100001", 1).second);
+    EXPECT_FALSE(map.insert_or_assign("100001", 11).second);
+    map["100003"] = 3;
+    EXPECT_EQ(map.erase("100000"), 1u);
+    EXPECT_EQ(map.erase("100000"), 0u);
+    EXPECT_EQ(map.size(), 502u);
+    EXPECT_EQ(map.begin()->first, "0");
+    EXPECT_EQ((map.begin() + 1)->second, 11);
+    EXPECT_EQ((map.begin() + 2)->first, "100002");
+    EXPECT_EQ((map.begin() + 3)->second, 3);
+}
+
+#if defined(__cpp_lib_span)
+TEST(std_flat_map, spans)
+{
+    std::flat_map<int, double> map;
+    std::flat_multimap<int, double> multimap;
+    for (int i = 0; i < 100; ++i) {
+        map.emplace(i, i * 0.5);
+        multimap.emplace(i / 2, i * 0.5);
+    }
+
+    for (double & v : map.values_span()) {
+        v *= 2;
+    }
+    double sum = 0;
+    for (double v : std::as_const(map).values_span()) {
+        sum += v;
+    }
+    EXPECT_EQ(sum, 4950.0);
+    EXPECT_EQ(map.at(7), 7.0);
+    EXPECT_EQ(map.keys_span().size(), 100u);
+    EXPECT_EQ(map.keys_span().back(), 99);
+    EXPECT_EQ(map.values_span().data(), map.values().data());
+
+    auto const values = multimap.values_span();
+    std::fill(values.begin(), values.begin() + 10, -1.0);
+    EXPECT_EQ(multimap.find(4)->second, -1.0);
+    EXPECT_EQ(multimap.find(5)->second, 5.0);
+    EXPECT_EQ(multimap.keys_span()[99], 49);
+
+    static_assert(std::is_same<
+                  decltype(map.keys_span()),
+                  std::span<int const>>::value);
+    static_assert(std::is_same<
+                  decltype(std::as_const(map).values_span()),
+                  std::span<double const>>::value);
+}
+#endif
+
+// Maps of these keys check the keys given to their sorted_unique_t and
+// sorted_equivalent_t overloads.
+namespace std {
+    template<>
+    struct flat_map_check_sorted_input<unsigned, less<unsigned>> : true_type
+    {};
+    template<>
+    struct flat_map_check_sorted_input<string, greater<>> : true_type
+    {};
+}
+
+TEST(std_flat_map, checked_sorted_input)
+{
+    using fmap_t = std::flat_map<unsigned, int>;
+    using fmmap_t = std::flat_multimap<unsigned, int>;
+
+    std::vector<unsigned> keys(10000);
+    std::iota(keys.begin(), keys.end(), 0u);
+    std::vector<int> values(keys.size(), 1);
+
+    {
+        fmap_t map(std::sorted_unique, keys, values);
+        EXPECT_EQ(map.size(), 10000u);
+    }
+    {
+        auto bad_keys = keys;
+        bad_keys[7000] = 6999;
+        EXPECT_THROW(
+            fmap_t(std::sorted_unique, bad_keys, values),
+            std::invalid_argument);
+        fmmap_t multimap(std::sorted_equivalent, bad_keys, values);
+        EXPECT_EQ(multimap.count(6999), 2u);
+        bad_keys[7000] = 6998;
+        EXPECT_THROW(
+            fmmap_t(std::sorted_equivalent, bad_keys, values),
+            std::invalid_argument);
+    }
+    {
+        fmap_t map = {{1, 1}, {3, 3}};
+        std::pair<unsigned, int> const in_order[] = {{0, 0}, {2, 2}, {4, 4}};
+        std::pair<unsigned, int> const reversed[] = {{6, 6}, {5, 5}};
+        map.insert(
+            std::sorted_unique, std::begin(in_order), std::end(in_order));
+        EXPECT_EQ(map.size(), 5u);
+        EXPECT_THROW(
+            map.insert(
+                std::sorted_unique, std::begin(reversed), std::end(reversed)),
+            std::invalid_argument);
+        EXPECT_EQ(map.size(), 5u);
+        EXPECT_EQ(map.keys().back(), 4u);
+    }
+    {
+        using sfmap_t = std::flat_map<std::string, int, std::greater<>>;
+        sfmap_t const map(std::sorted_unique, {{"b", 0}, {"a", 1}});
+        EXPECT_EQ(map.size(), 2u);
+        EXPECT_THROW(
+            sfmap_t(std::sorted_unique, {{"a", 0}, {"b", 1}}),
+            std::invalid_argument);
+        EXPECT_THROW(
+            sfmap_t(std::sorted_unique, {{"a", 0}, {"a", 1}}),
+            std::invalid_argument);
+    }
+}
+
+#if defined(__cpp_lib_ranges)
+TEST(std_flat_map, ranges_algorithms)
+{
+    using fmap_t = std::flat_map<std::string, int>;
+    using fmmap_t = std::flat_multimap<std::string, int>;
+    static_assert(std::random_access_iterator<fmap_t::iterator>);
+    static_assert(std::random_access_iterator<fmap_t::const_iterator>);
+    static_assert(std::random_access_iterator<fmmap_t::iterator>);
+    static_assert(std::ranges::random_access_range<fmap_t const>);
+
+    fmap_t map;
+    for (int i = 0; i < 100; ++i) {
+        map.emplace(std::to_string(1000 + i), i);
+    }
+
+    auto const it = std::ranges::lower_bound(
+        map, std::pair<std::string, int>("1042", 0), map.value_comp());
+    EXPECT_EQ(it - map.begin(), 42);
+    auto const seven =
+        std::ranges::find_if(map, [](auto e) { return e.second == 7; });
+    EXPECT_EQ(seven, map.begin() + 7);
+    EXPECT_EQ(std::ranges::distance(map), 100);
+
+    // The reference, its rvalue reference and value_type have a common
+    // reference, and moving out through iter_move() moves the values.
+    static_assert(std::indirectly_readable<fmap_t::iterator>);
+    static_assert(std::is_same_v<
+                  std::iter_common_reference_t<fmap_t::iterator>,
+                  std::__ref_pair<std::string const &, int &>>);
+    std::flat_map<int, std::unique_ptr<int>> owners;
+    owners.emplace(1, std::make_unique<int>(1));
+    std::pair<int, std::unique_ptr<int>> const moved =
+        std::ranges::iter_move(owners.begin());
+    EXPECT_EQ(*moved.second, 1);
+    EXPECT_EQ(owners.begin()->second, nullptr);
+}
+#endif
+
+#if defined(__cpp_lib_ranges)
+TEST(std_flat_map, from_range_insert_range)
+{
+    using fmap_t = std::flat_map<std::string, int>;
+    using fmmap_t = std::flat_multimap<std::string, int>;
+    using pairs_t = std::vector<std::pair<std::string, int>>;
+
+    pairs_t const pairs = {{"c", 2}, {"a", 0}, {"b", 1}, {"a", 3}};
+    fmap_t map(std::from_range, pairs);
+    EXPECT_EQ(map.size(), 3u);
+    EXPECT_EQ(map.at("a"), 0);
+    EXPECT_EQ(map.keys().capacity(), pairs.size());
+
+    fmmap_t multimap(std::from_range, pairs, std::allocator<int>());
+    EXPECT_EQ(multimap.count("a"), 2u);
+
+    auto const doubled = pairs | std::views::transform([](auto const & p) {
+                             return std::pair(p.first + p.first, p.second);
+                         });
+    map.insert_range(doubled);
+    EXPECT_EQ(map.size(), 6u);
+    EXPECT_EQ(map.at("cc"), 2);
+
+    pairs_t long_keys = {
+        {std::string(100, 'x'), 1}, {std::string(100, 'y'), 2}};
+    map.insert_range(std::sorted_unique, std::move(long_keys));
+    EXPECT_EQ(map.size(), 8u);
+    EXPECT_TRUE(long_keys[0].first.empty());
+    EXPECT_TRUE(long_keys[1].first.empty());
+
+    pairs_t kept = {{"z", 9}};
+    map.insert_range(kept);
+    EXPECT_EQ(kept[0].first, "z");
+    EXPECT_EQ(pairs[0].first, "c");
+}
+#endif
+
+TEST(std_flat_map, nearest_key)
+{
+    std::flat_map<int, int> const map = {{10, 0}, {20, 1}, {30, 2}};
+    EXPECT_EQ(map.floor(5), map.end());
+    EXPECT_EQ(map.floor(10)->first, 10);
+    EXPECT_EQ(map.floor(29)->first, 20);
+    EXPECT_EQ(map.floor(100)->first, 30);
+    EXPECT_EQ(map.ceiling(5)->first, 10);
+    EXPECT_EQ(map.ceiling(21)->first, 30);
+    EXPECT_EQ(map.ceiling(31), map.end());
+    EXPECT_EQ(map.nearest(-100)->first, 10);
+    EXPECT_EQ(map.nearest(14)->first, 10);
+    EXPECT_EQ(map.nearest(15)->first, 10);
+    EXPECT_EQ(map.nearest(16)->first, 20);
+    EXPECT_EQ(map.nearest(30)->first, 30);
+    EXPECT_EQ(map.nearest(100)->first, 30);
+    std::flat_map<int, int> empty;
+    EXPECT_EQ(empty.nearest(0), empty.end());
+
+    // The distances do not overflow at the ends of the key type.
+    int const min = std::numeric_limits<int>::min();
+    int const max = std::numeric_limits<int>::max();
+    std::flat_map<int, int> const extremes = {{min, 0}, {max, 1}};
+    EXPECT_EQ(extremes.nearest(-2)->first, min);
+    EXPECT_EQ(extremes.nearest(1)->first, max);
+
+    std::flat_map<double, int, std::greater<>> const descending = {
+        {1.0, 0}, {2.0, 1}, {4.0, 2}};
+    EXPECT_EQ(descending.floor(3.0)->first, 4.0);
+    EXPECT_EQ(descending.ceiling(3.0)->first, 2.0);
+    EXPECT_EQ(descending.nearest(3.5)->first, 4.0);
+    EXPECT_EQ(descending.nearest(2.5)->first, 2.0);
+
+    std::flat_map<int, int> random_map;
+    std::mt19937 gen(7);
+    for (int i = 0; i < 500; ++i) {
+        random_map.emplace(int(gen() % 5000), i);
+    }
+    std::vector<int> queries;
+    for (int i = 0; i < 300; ++i) {
+        queries.push_back(int(gen() % 5200) - 100);
+    }
+    std::sort(queries.begin(), queries.end());
+    using const_iterator = std::flat_map<int, int>::const_iterator;
+    std::vector<const_iterator> floors;
+    std::vector<const_iterator> ceilings;
+    std::vector<const_iterator> nearests;
+    auto const & const_map = random_map;
+    const_map.floor_many(
+        std::sorted_unique,
+        queries.begin(),
+        queries.end(),
+        std::back_inserter(floors));
+    const_map.ceiling_many(
+        std::sorted_unique,
+        queries.begin(),
+        queries.end(),
+        std::back_inserter(ceilings));
+    const_map.nearest_many(
+        std::sorted_unique,
+        queries.begin(),
+        queries.end(),
+        std::back_inserter(nearests));
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        int const q = queries[i];
+        auto const up = const_map.upper_bound(q);
+        auto const expected_floor =
+            up == const_map.begin() ? const_map.end() : std::prev(up);
+        EXPECT_EQ(floors[i], expected_floor);
+        EXPECT_EQ(ceilings[i], const_map.lower_bound(q));
+        EXPECT_EQ(nearests[i], const_map.nearest(q));
+        int best = -1;
+        for (auto const & e : random_map) {
+            if (best < 0 || std::abs(e.first - q) < std::abs(best - q))
+                best = e.first;
+        }
+        EXPECT_EQ(nearests[i]->first, best);
+    }
+}
+
+TEST(std_flat_map, assignment_reuses_capacity)
+{
+    using fmap_t = std::flat_map<int, double>;
+
+    fmap_t big;
+    for (int i = 0; i < 100; ++i) {
+        big.emplace(i, i * 0.5);
+    }
+    fmap_t small = {{3, 1.0}, {1, 2.0}};
+
+    fmap_t map = big;
+    int const * const keys = map.keys().data();
+    double const * const values = map.values().data();
+
+    // Shrinking and regrowing within the capacity keep the storage.
+    map = small;
+    EXPECT_EQ(map, small);
+    EXPECT_EQ(map.keys().data(), keys);
+    EXPECT_EQ(map.values().data(), values);
+    map = big;
+    EXPECT_EQ(map, big);
+    EXPECT_EQ(map.keys().data(), keys);
+    EXPECT_EQ(map.values().data(), values);
+
+    map = {{5, 5.0}, {2, 2.0}, {5, 6.0}, {4, 4.0}};
+    EXPECT_EQ(map, (fmap_t{{2, 2.0}, {4, 4.0}, {5, 5.0}}));
+    EXPECT_EQ(map.keys().data(), keys);
+    EXPECT_EQ(map.values().data(), values);
+
+    map = map;
+    EXPECT_EQ(map.size(), 3u);
+
+    // Non-trivially-copyable elements are copy-assigned.
+    std::flat_map<std::string, std::string> s = {{"a", "x"}, {"b", "y"}};
+    std::flat_map<std::string, std::string> t = {{"c", "z"}};
+    t = s;
+    EXPECT_EQ(t, s);
+
+    std::flat_multimap<int, int> mm = {{1, 1}, {1, 2}, {0, 0}};
+    std::flat_multimap<int, int> mm2;
+    mm2 = mm;
+    EXPECT_EQ(mm2, mm);
+    mm2 = {{2, 2}, {2, 3}};
+    EXPECT_EQ(mm2.count(2), 2u);
+    EXPECT_EQ(mm2.size(), 2u);
+}
+
+TEST(std_flat_map, ordered_sources)
+{
+    static_assert(std::__is_ordered_source<
+                  std::map<int, double>,
+                  int,
+                  std::less<int>,
+                  true>::value);
+    static_assert(!std::__is_ordered_source<
+                  std::multimap<int, double>,
+                  int,
+                  std::less<int>,
+                  true>::value);
+    static_assert(std::__is_ordered_source<
+                  std::multimap<int, double>,
+                  int,
+                  std::less<int>,
+                  false>::value);
+    static_assert(!std::__is_ordered_source<
+                  std::map<int, double>,
+                  long,
+                  std::less<long>,
+                  true>::value);
+    static_assert(!std::__is_ordered_source<
+                  std::vector<std::pair<int, double>>,
+                  int,
+                  std::less<int>,
+                  true>::value);
+
+    std::map<std::string, int, std::greater<>> source;
+    for (int i = 0; i < 1000; ++i) {
+        source.emplace(std::to_string(i), i);
+    }
+    std::flat_map<std::string, int, std::greater<>> const from_map(source);
+    ASSERT_EQ(from_map.size(), source.size());
+    EXPECT_EQ(from_map.keys().capacity(), source.size());
+    EXPECT_TRUE(std::equal(
+        from_map.begin(),
+        from_map.end(),
+        source.begin(),
+        source.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second == y.second;
+        }));
+
+    std::multimap<int, int> const multi_source = {
+        {2, 0}, {1, 1}, {2, 2}, {1, 3}};
+    std::flat_multimap<int, int> const from_multimap(multi_source);
+    EXPECT_TRUE(std::equal(
+        from_multimap.begin(),
+        from_multimap.end(),
+        multi_source.begin(),
+        multi_source.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second == y.second;
+        }));
+
+    // Nearly sorted input, in a few long runs, keeps the first of each
+    // run of equivalent keys, as a full sort does.
+    std::vector<std::pair<int, int>> runs;
+    for (int r = 0; r < 4; ++r) {
+        for (int i = 0; i < 500; ++i) {
+            runs.emplace_back(i * 4 + r % 2, r * 1000 + i);
+        }
+    }
+    std::map<int, int> expected;
+    expected.insert(runs.begin(), runs.end());
+    std::flat_map<int, int> const from_runs(runs.begin(), runs.end());
+    EXPECT_TRUE(std::equal(
+        from_runs.begin(),
+        from_runs.end(),
+        expected.begin(),
+        expected.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second == y.second;
+        }));
+
+    std::flat_multimap<int, int> const multi_runs(runs.begin(), runs.end());
+    ASSERT_EQ(multi_runs.size(), runs.size());
+    EXPECT_TRUE(std::is_sorted(
+        multi_runs.begin(),
+        multi_runs.end(),
+        [](auto const & x, auto const & y) {
+            return x.first < y.first ||
+                   (x.first == y.first && x.second < y.second);
+        }));
+}
+
+namespace {
+    struct directed_less
+    {
+        bool descending = false;
+        bool operator()(int x, int y) const
+        {
+            return descending ? y < x : x < y;
+        }
+    };
+}
+
+TEST(std_flat_map, container_ctors_with_comparator)
+{
+    using fmap_t = std::flat_map<int, int, directed_less>;
+    using fmmap_t = std::flat_multimap<int, int, directed_less>;
+    directed_less const down{true};
+    std::vector<int> const keys = {2, 3, 1};
+    std::vector<int> const values = {20, 30, 10};
+    std::vector<int> const down_keys = {3, 2, 1};
+    std::vector<int> const down_values = {30, 20, 10};
+    std::vector<std::pair<int, int>> const down_pairs = {
+        {3, 30}, {2, 20}, {1, 10}};
+    auto const descending = [](auto const & map) {
+        return map.key_comp().descending;
+    };
+
+    fmap_t const map(keys, values, down);
+    EXPECT_TRUE(descending(map));
+    EXPECT_EQ(map.keys(), down_keys);
+    EXPECT_EQ(map.values(), down_values);
+
+    fmap_t const sorted(std::sorted_unique, down_keys, down_values, down);
+    EXPECT_TRUE(descending(sorted));
+    EXPECT_EQ(sorted, map);
+
+    // The comparator used to be dropped here.
+    fmap_t const sorted_pairs(std::sorted_unique, down_pairs, down);
+    EXPECT_TRUE(descending(sorted_pairs));
+    EXPECT_EQ(sorted_pairs, map);
+
+    std::allocator<int> const alloc;
+    fmap_t const with_alloc(keys, values, down, alloc);
+    EXPECT_TRUE(descending(with_alloc));
+    EXPECT_EQ(with_alloc, map);
+    fmap_t const moved_with_alloc(
+        std::vector<int>(keys), std::vector<int>(values), down, alloc);
+    EXPECT_EQ(moved_with_alloc, map);
+    fmap_t const sorted_with_alloc(
+        std::sorted_unique, down_keys, down_values, down, alloc);
+    EXPECT_TRUE(descending(sorted_with_alloc));
+    EXPECT_EQ(sorted_with_alloc, map);
+    fmap_t const pairs_with_alloc(std::sorted_unique, down_pairs, down, alloc);
+    EXPECT_TRUE(descending(pairs_with_alloc));
+    EXPECT_EQ(pairs_with_alloc, map);
+    fmap_t const source_with_alloc(down_pairs, down, alloc);
+    EXPECT_TRUE(descending(source_with_alloc));
+    EXPECT_EQ(source_with_alloc, map);
+
+    std::vector<int> const multi_keys = {2, 3, 1, 3};
+    std::vector<int> const multi_values = {20, 30, 10, 31};
+    fmmap_t const multimap(multi_keys, multi_values, down);
+    EXPECT_TRUE(descending(multimap));
+    EXPECT_EQ(multimap.keys(), (std::vector<int>{3, 3, 2, 1}));
+    EXPECT_EQ(multimap.values(), (std::vector<int>{30, 31, 20, 10}));
+    fmmap_t const multi_with_alloc(
+        std::vector<int>(multi_keys),
+        std::vector<int>(multi_values),
+        down,
+        alloc);
+    EXPECT_EQ(multi_with_alloc, multimap);
+    fmmap_t const multi_sorted(
+        std::sorted_equivalent,
+        multimap.keys(),
+        multimap.values(),
+        down,
+        alloc);
+    EXPECT_TRUE(descending(multi_sorted));
+    EXPECT_EQ(multi_sorted, multimap);
+    fmmap_t const multi_pairs(std::sorted_equivalent, down_pairs, down, alloc);
+    EXPECT_TRUE(descending(multi_pairs));
+    EXPECT_EQ(multi_pairs.keys(), down_keys);
+}
+
+TEST(std_flat_map, mutation_batch)
+{
+    using map_t = std::flat_map<int, std::string>;
+    map_t map = {{1, "one"}, {3, "three"}, {5, "five"}, {7, "seven"}};
+    auto batch = map.batch();
+    batch.insert(2, "two");
+    batch.insert(3, "not three");
+    batch.insert_or_assign(5, "FIVE");
+    batch.erase(7);
+    batch.insert(7, "SEVEN");
+    batch.erase(1);
+    batch.insert_or_assign(9, "nine");
+    batch.erase(9);
+    batch.insert_or_assign(4, "four");
+    batch.insert(4, "not four");
+    batch.erase(100);
+    EXPECT_EQ(batch.size(), 11u);
+
+    // Nothing changes before commit().
+    EXPECT_EQ(map.size(), 4u);
+    EXPECT_EQ(map.at(1), "one");
+
+    batch.commit();
+    EXPECT_TRUE(batch.empty());
+    map_t const expected = {
+        {2, "two"}, {3, "three"}, {4, "four"}, {5, "FIVE"}, {7, "SEVEN"}};
+    EXPECT_EQ(map, expected);
+
+    // A batch matches the same operations applied one at a time.
+    std::mt19937 gen(42);
+    std::flat_map<int, int> batched;
+    std::flat_map<int, int> one_by_one;
+    for (int round = 0; round < 50; ++round) {
+        auto b = batched.batch();
+        for (int i = 0; i < 60; ++i) {
+            int const key = int(gen() % 200);
+            int const value = int(gen());
+            switch (gen() % 3) {
+            case 0:
+                b.insert(key, value);
+                one_by_one.insert({key, value});
+                break;
+            case 1:
+                b.insert_or_assign(key, value);
+                one_by_one.insert_or_assign(key, value);
+                break;
+            default:
+                b.erase(key);
+                one_by_one.erase(key);
+                break;
+            }
+        }
+        b.commit();
+        ASSERT_EQ(batched, one_by_one);
+    }
+}
+
+TEST(std_flat_multimap, ctors_insert)
+{
+    using fmmap_t = std::flat_multimap<std::string, int>;
+    using pair_t = std::pair<std::string, int>;
+
+    auto pair_cmp = [](auto lhs, auto rhs) {
+        return lhs.first == rhs.first && lhs.second == rhs.second;
+    };
+
+    {
+        fmmap_t map = {{"key1", 0}, {"key0", 1}, {"key1", 2}, {"key0", 3}};
+        std::vector<pair_t> const expected = {
+            {"key0", 1}, {"key0", 3}, {"key1", 0}, {"key1", 2}};
+        EXPECT_EQ(map.size(), 4u);
+        EXPECT_TRUE(std::equal(
+            map.begin(), map.end(), expected.begin(), expected.end(), pair_cmp));
+    }
+
+    {
+        fmmap_t map(
+            std::sorted_equivalent,
+            {"key0", "key0", "key1"},
+            {0, 1, 2});
+        EXPECT_EQ(map.count("key0"), 2u);
+        EXPECT_EQ(map.count("key1"), 1u);
+        EXPECT_EQ(map.count("key2"), 0u);
+    }
+
+    {
+        fmmap_t map = {{"key0", 0}, {"key1", 1}};
+        auto it = map.insert(pair_t("key0", 2));
+        EXPECT_EQ(it - map.begin(), 1);
+        it = map.emplace("key1", 3);
+        EXPECT_EQ(it - map.begin(), 3);
+        it = map.emplace("key", 4);
+        EXPECT_EQ(it - map.begin(), 0);
+        std::vector<pair_t> const expected = {
+            {"key", 4}, {"key0", 0}, {"key0", 2}, {"key1", 1}, {"key1", 3}};
+        EXPECT_TRUE(std::equal(
+            map.begin(), map.end(), expected.begin(), expected.end(), pair_cmp));
+    }
+
+    {
+        fmmap_t map = {{"key0", 0}, {"key1", 1}, {"key2", 2}};
+        std::vector<pair_t> const vec = {{"key2", 3}, {"key1", 4}, {"key1", 5}};
+        map.insert(vec.begin(), vec.end());
+        std::vector<pair_t> const expected = {
+            {"key0", 0},
+            {"key1", 1},
+            {"key1", 4},
+            {"key1", 5},
+            {"key2", 2},
+            {"key2", 3}};
+        EXPECT_TRUE(std::equal(
+            map.begin(), map.end(), expected.begin(), expected.end(), pair_cmp));
+
+        fmmap_t::containers c = std::move(map).extract();
+        EXPECT_EQ(c.keys.size(), 6u);
+        EXPECT_TRUE(map.empty());
+        map.replace(std::move(c.keys), std::move(c.values));
+        EXPECT_EQ(map.size(), 6u);
+    }
+}
+
+TEST(std_flat_multimap, hinted_insert)
+{
+    using fmmap_t = std::flat_multimap<int, int>;
+
+    fmmap_t map = {{1, 0}, {2, 0}, {2, 1}, {3, 0}};
+
+    // A valid hint is used as-is, even in the middle of equivalent keys.
+    auto it = map.emplace_hint(map.begin() + 2, 2, 2);
+    EXPECT_EQ(it - map.begin(), 2);
+
+    // An invalid hint yields the valid position closest to it.
+    it = map.emplace_hint(map.end(), 2, 3);
+    EXPECT_EQ(it - map.begin(), 4);
+    it = map.emplace_hint(map.begin(), 2, 4);
+    EXPECT_EQ(it - map.begin(), 1);
+
+    std::vector<int> const values = {0, 4, 0, 2, 1, 3, 0};
+    EXPECT_EQ(map.values(), values);
+}
+
+TEST(std_flat_multimap, lookup_erase)
+{
+    using fmmap_t = std::flat_multimap<int, int>;
+
+    fmmap_t map;
+    for (int i = 0; i < 100; ++i) {
+        map.emplace(i % 10, i);
+    }
+    fmmap_t const & cmap = map;
+
+    for (int k = -1; k < 11; ++k) {
+        auto const eq_range = map.equal_range(k);
+        auto const c_eq_range = cmap.equal_range(k);
+        EXPECT_EQ(eq_range.first, map.lower_bound(k));
+        EXPECT_EQ(eq_range.second, map.upper_bound(k));
+        EXPECT_EQ(c_eq_range.first, cmap.lower_bound(k));
+        EXPECT_EQ(c_eq_range.second, cmap.upper_bound(k));
+        std::size_t const n = 0 <= k && k < 10 ? 10 : 0;
+        EXPECT_EQ(map.count(k), n);
+        EXPECT_EQ(map.contains(k), n != 0);
+        EXPECT_EQ(map.find(k) == map.end(), n == 0);
+        EXPECT_EQ(cmap.find(k) == cmap.end(), n == 0);
+    }
+
+    // Values of equivalent keys stay in insertion order.
+    auto const threes = map.equal_range(3);
+    int expected = 3;
+    for (auto it = threes.first; it != threes.second; ++it, expected += 10) {
+        EXPECT_EQ(it->second, expected);
+    }
+
+    EXPECT_EQ(map.erase(3), 10u);
+    EXPECT_EQ(map.erase(3), 0u);
+    EXPECT_EQ(map.size(), 90u);
+
+    auto const odd = [](auto const & x) { return x.second % 2 == 1; };
+    EXPECT_EQ(std::erase_if(map, odd), 40u);
+    EXPECT_EQ(map.count(1), 0u);
+    EXPECT_EQ(map.count(2), 10u);
+}
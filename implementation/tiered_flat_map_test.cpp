@@ -0,0 +1,133 @@
+#include "tiered_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <map>
+#include <random>
+
+// Test instantiations.
+template class std::tiered_flat_map<int, double>;
+template class std::tiered_flat_map<long, int, std::greater<long>, 16>;
+
+namespace {
+    bool exists(std::string const & path)
+    {
+        return std::ifstream(path).good();
+    }
+}
+
+TEST(std_tiered_flat_map, cold_lookups)
+{
+    char const * const path = "tiered_flat_map_test.cold.bin";
+    {
+        std::flat_map<int, double> m;
+        for (int i = 0; i < 1000; ++i) {
+            m.emplace(i * 2, i * 0.5);
+        }
+        // 1000 elements in blocks of 48 take 21 blocks; 3 stay in memory.
+        std::tiered_flat_map<int, double, std::less<int>, 64> map(path, 3, m);
+        EXPECT_TRUE(exists(path));
+        EXPECT_EQ(map.size(), 1000u);
+        EXPECT_EQ(map.block_count(), 21u);
+        EXPECT_EQ(map.resident_block_count(), 3u);
+        EXPECT_EQ(map.stats().writebacks, 18u);
+        map.evict_all();
+        EXPECT_EQ(map.stats().writebacks, 21u);
+        EXPECT_EQ(map.resident_block_count(), 0u);
+
+        // Each lookup in a cold block costs one fault, and evicting a
+        // clean block writes nothing.
+        std::tiered_flat_map<int, double, std::less<int>, 64> const & cmap =
+            map;
+        auto const stats = map.stats();
+        EXPECT_TRUE(cmap.contains(10));
+        EXPECT_FALSE(cmap.contains(11));
+        EXPECT_EQ(cmap.at(998), 499 * 0.5);
+        EXPECT_EQ(map.stats().faults, stats.faults + 2);
+        EXPECT_EQ(map.resident_block_count(), 2u);
+        EXPECT_THROW(cmap.at(11), std::out_of_range);
+
+        EXPECT_EQ(cmap.find(500)->second, 125.0);
+        EXPECT_EQ(cmap.find(501), cmap.end());
+        EXPECT_EQ(cmap.lower_bound(501)->first, 502);
+        EXPECT_EQ(cmap.upper_bound(1998), cmap.end());
+        EXPECT_EQ(cmap.upper_bound(95)->first, 96);
+
+        // Iteration faults every block in turn, through any number of
+        // evictions.
+        int expected = 0;
+        for (auto it = cmap.begin(); it != cmap.end(); ++it) {
+            EXPECT_EQ(it->first, expected);
+            expected += 2;
+        }
+        EXPECT_EQ(expected, 2000);
+        EXPECT_EQ(map.stats().writebacks, stats.writebacks);
+
+        // Writes through an iterator are written back.
+        for (auto it = map.begin(); it != map.end(); ++it) {
+            it->second = -it->second;
+        }
+        map.evict_all();
+        EXPECT_EQ(map.resident_block_count(), 0u);
+        EXPECT_EQ(map.at(400), -100.0);
+        EXPECT_EQ(std::move(map).release().size(), 1000u);
+    }
+    EXPECT_FALSE(exists(path));
+}
+
+TEST(std_tiered_flat_map, random_operations)
+{
+    char const * const path = "tiered_flat_map_test.random.bin";
+    std::tiered_flat_map<int, int, std::less<int>, 32> map(path, 4);
+    std::map<int, int> std_map;
+    std::mt19937 gen(5);
+    for (int i = 0; i < 30000; ++i) {
+        int const k = int(gen() % 3000);
+        int const v = int(gen());
+        switch (gen() % 5) {
+        case 0:
+        case 1:
+            EXPECT_EQ(
+                map.try_emplace(k, v).second, std_map.try_emplace(k, v).second);
+            break;
+        case 2:
+            map.insert_or_assign(k, v);
+            std_map[k] = v;
+            break;
+        case 3:
+            EXPECT_EQ(map.erase(k), std_map.erase(k));
+            break;
+        case 4: {
+            auto const it = std_map.find(k);
+            EXPECT_EQ(map.contains(k), it != std_map.end());
+            if (it != std_map.end()) {
+                EXPECT_EQ(map.at(k), it->second);
+            }
+            break;
+        }
+        }
+        ASSERT_LE(map.resident_block_count(), 4u);
+    }
+    EXPECT_EQ(map.size(), std_map.size());
+    EXPECT_LT(4u, map.block_count());
+    EXPECT_TRUE(std::equal(
+        map.cbegin(),
+        map.cend(),
+        std_map.begin(),
+        std_map.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second == y.second;
+        }));
+
+    auto const released = std::move(map).release();
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(std::equal(
+        released.begin(),
+        released.end(),
+        std_map.begin(),
+        std_map.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second == y.second;
+        }));
+}
@@ -0,0 +1,137 @@
+#include "value_indexed_flat_map"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Test instantiations.
+template class std::value_indexed_flat_map<std::flat_map<std::string, int>>;
+
+namespace {
+    // Checks value_order() against a sort of the map's positions.
+    template<class Map>
+    bool index_valid(Map const & map)
+    {
+        std::vector<std::size_t> expected(map.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            expected[i] = i;
+        }
+        auto const & values = map.map().values();
+        std::stable_sort(
+            expected.begin(),
+            expected.end(),
+            [&](std::size_t i, std::size_t j) {
+                return values[i] < values[j];
+            });
+        return map.value_order() == expected;
+    }
+}
+
+TEST(std_value_indexed_flat_map, lookups)
+{
+    using fmap_t = std::flat_map<std::string, int>;
+    using vmap_t = std::value_indexed_flat_map<fmap_t>;
+
+    vmap_t map = {{"d", 4}, {"a", 1}, {"c", 2}, {"b", 2}, {"e", 0}};
+    EXPECT_TRUE(index_valid(map));
+    EXPECT_EQ(map.value_order(), (std::vector<std::size_t>{4, 0, 1, 2, 3}));
+
+    EXPECT_EQ(map.find_by_value(2)->first, "b");
+    EXPECT_EQ(map.count_by_value(2), 2u);
+    EXPECT_EQ(map.find_by_value(3), map.end());
+    EXPECT_FALSE(map.contains_value(3));
+    EXPECT_TRUE(map.contains_value(0));
+    auto const range = map.equal_range_by_value(2);
+    ASSERT_EQ(range.second - range.first, 2);
+    EXPECT_EQ(map.begin()[range.first[0]].first, "b");
+    EXPECT_EQ(map.begin()[range.first[1]].first, "c");
+    EXPECT_EQ(map.lower_bound_by_value(3), map.upper_bound_by_value(3));
+    EXPECT_EQ(map.upper_bound_by_value(10), map.value_order().end());
+
+    // Reassigning a value moves it in the index.
+    EXPECT_FALSE(map.insert_or_assign("b", 7).second);
+    EXPECT_EQ(map.find_by_value(2)->first, "c");
+    EXPECT_EQ(map.find_by_value(7)->first, "b");
+    EXPECT_TRUE(map.insert_or_assign("aa", 2).second);
+    EXPECT_EQ(map.find_by_value(2)->first, "aa");
+    EXPECT_TRUE(index_valid(map));
+
+    EXPECT_EQ(map.erase_by_value(2), 2u);
+    EXPECT_EQ(map.erase_by_value(2), 0u);
+    EXPECT_EQ(map.size(), 4u);
+    EXPECT_TRUE(index_valid(map));
+    auto const small = [](auto const & x) { return x.second < 3; };
+    EXPECT_EQ(erase_if(map, small), 2u);
+    EXPECT_TRUE(index_valid(map));
+    EXPECT_EQ(std::move(map).release(), fmap_t({{"b", 7}, {"d", 4}}));
+}
+
+TEST(std_value_indexed_flat_map, random_operations)
+{
+    using fmap_t = std::flat_map<int, int>;
+    std::value_indexed_flat_map<fmap_t> map;
+    std::map<int, int> std_map;
+    std::mt19937 gen(13);
+    for (int i = 0; i < 5000; ++i) {
+        int const k = int(gen() % 500);
+        int const v = int(gen() % 50);
+        switch (gen() % 6) {
+        case 0:
+        case 1:
+            EXPECT_EQ(
+                map.try_emplace(k, v).second, std_map.try_emplace(k, v).second);
+            break;
+        case 2:
+            map.insert_or_assign(k, v);
+            std_map[k] = v;
+            break;
+        case 3:
+            EXPECT_EQ(map.erase(k), std_map.erase(k));
+            break;
+        case 4: {
+            std::vector<std::pair<int, int>> elements;
+            for (int j = 0; j < 20; ++j) {
+                elements.emplace_back(int(gen() % 500), int(gen() % 50));
+            }
+            map.insert(elements.begin(), elements.end());
+            std_map.insert(elements.begin(), elements.end());
+            break;
+        }
+        case 5: {
+            int first = -1;
+            for (auto const & x : std_map) {
+                if (x.second == v) {
+                    first = x.first;
+                    break;
+                }
+            }
+            auto const it = map.find_by_value(v);
+            EXPECT_EQ(it == map.end() ? -1 : it->first, first);
+            break;
+        }
+        }
+        if (i % 250 == 0) {
+            ASSERT_TRUE(index_valid(map));
+        }
+    }
+    EXPECT_TRUE(index_valid(map));
+    EXPECT_TRUE(std::equal(
+        map.begin(),
+        map.end(),
+        std_map.begin(),
+        std_map.end(),
+        [](auto const & x, auto const & y) {
+            return x.first == y.first && x.second == y.second;
+        }));
+    for (int v = 0; v < 50; ++v) {
+        std::size_t n = 0;
+        for (auto const & x : std_map) {
+            n += x.second == v;
+        }
+        EXPECT_EQ(map.count_by_value(v), n);
+    }
+}
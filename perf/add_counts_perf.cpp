@@ -0,0 +1,75 @@
+// Compares flat_map::add_counts(), which counts a batch of keys by
+// sorting, run-length counting and merging it in one pass, with
+// ++counts[key] for each key of the batch.  The map is a
+// flat_map<uint32_t, uint64_t> that starts empty, and batches of 64K keys
+// are drawn from a key space of the given size, so that early batches
+// mostly insert and later ones mostly hit.
+//
+// Usage: add_counts_perf [key space]...; the default key spaces are 1K,
+// 64K and 256K.
+
+#include <flat_map>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+
+using counts_t = std::flat_map<std::uint32_t, std::uint64_t>;
+
+template <typename Count>
+double time_ns(
+    std::vector<std::uint32_t> const & keys, counts_t & counts, Count count)
+{
+    std::size_t const batch = 1u << 16;
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < keys.size(); i += batch) {
+        count(counts, keys.data() + i, keys.data() + i + batch);
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() /
+           double(keys.size());
+}
+
+int main(int argc, char * argv[])
+{
+    std::vector<std::size_t> spaces;
+    for (int i = 1; i < argc; ++i) {
+        spaces.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (spaces.empty())
+        spaces = {1u << 10, 1u << 16, 1u << 18};
+
+    std::printf(
+        "ns per key  %10s %12s %12s\n",
+        "key space",
+        "++counts[k]",
+        "add_counts");
+    for (std::size_t space : spaces) {
+        std::mt19937 gen(42);
+        std::vector<std::uint32_t> keys(1u << 22);
+        for (auto & k : keys) {
+            k = std::uint32_t(gen() % space);
+        }
+
+        counts_t one_by_one;
+        double const old_ns = time_ns(
+            keys, one_by_one, [](counts_t & m, auto first, auto last) {
+                for (; first != last; ++first) {
+                    ++m[*first];
+                }
+            });
+        counts_t batched;
+        double const new_ns = time_ns(
+            keys, batched, [](counts_t & m, auto first, auto last) {
+                m.add_counts(first, last);
+            });
+        if (one_by_one != batched)
+            std::abort();
+        std::printf(
+            "            %10zu %12.2f %12.2f\n", space, old_ns, new_ns);
+    }
+}
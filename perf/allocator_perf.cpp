@@ -0,0 +1,259 @@
+// Compares how flat_map grows under different allocators and heap states.
+// For each heap scenario, builds a std::pmr::flat_map of <int, int> and of
+// <pmr::string, pmr::string> two ways -- appending in key order, so that
+// only the containers' reallocations are exercised, and inserting an
+// unsorted batch with one range insert -- and prints the build time, the
+// part of the append time spent in inserts that reallocated, the number of
+// reallocations, the bytes the map requested from its memory resource, and
+// the growth of the process's resident set (memory that earlier rows freed
+// and this one reused does not count, so compare RSS down a column only
+// with care).  The scenarios are
+//   clean:       the global heap, as the program starts;
+//   fragmented:  the global heap, after allocating blocks of random sizes
+//                and freeing a random half of them, so that the map's
+//                growing buffers find holes of every size;
+//   monotonic:   a pmr::monotonic_buffer_resource, which never reuses the
+//                buffers that growth abandons;
+//   pool:        a pmr::unsynchronized_pool_resource.
+// The global heap is whatever malloc the program runs with: glibc's, or
+// jemalloc, tcmalloc or mimalloc, linked in (see the allocator_perf_*
+// targets) or preloaded with LD_PRELOAD; the name of the one detected is
+// printed first.  Expect RSS to exceed the requested bytes most under
+// fragmentation and under the monotonic resource, by up to the sum of the
+// abandoned buffers (about the final size again), and the allocators to
+// differ most in the reallocation time of large maps, where some return
+// memory to the kernel and fault it back in.
+//
+// Usage: allocator_perf [size ...]; the default sizes are 1K, 64K and 1M.
+
+#include "malloc_name.hpp"
+
+#include <flat_map>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+
+long current_rss_kb()
+{
+    std::ifstream ifs("/proc/self/status");
+    std::string line;
+    while (std::getline(ifs, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0)
+            return std::atol(line.c_str() + 6);
+    }
+    return -1;
+}
+
+// Counts the bytes requested through it, and passes them upstream.
+struct counting_resource : std::pmr::memory_resource
+{
+    explicit counting_resource(std::pmr::memory_resource * upstream) :
+        upstream(upstream)
+    {}
+
+    std::pmr::memory_resource * upstream;
+    std::size_t allocated = 0;
+
+private:
+    void * do_allocate(std::size_t bytes, std::size_t align) override
+    {
+        allocated += bytes;
+        return upstream->allocate(bytes, align);
+    }
+    void do_deallocate(void * p, std::size_t bytes, std::size_t align) override
+    {
+        upstream->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(memory_resource const & other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+enum heap_kind
+{
+    clean_heap,
+    fragmented_heap,
+    monotonic_heap,
+    pool_heap,
+
+    num_heap_kinds
+};
+
+char const * const heap_names[num_heap_kinds] = {
+    "clean", "fragmented", "monotonic", "pool"};
+
+// Holds the live half of the blocks that fragment the global heap.
+struct fragmenter
+{
+    fragmenter(heap_kind heap, std::size_t map_size)
+    {
+        if (heap != fragmented_heap)
+            return;
+        std::mt19937 gen(3);
+        std::size_t const n = std::max<std::size_t>(map_size, 1 << 14);
+        std::vector<void *> blocks;
+        for (std::size_t i = 0; i < n; ++i) {
+            blocks.push_back(std::malloc(16 + gen() % 4096));
+        }
+        std::shuffle(blocks.begin(), blocks.end(), gen);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i % 2)
+                std::free(blocks[i]);
+            else
+                live.push_back(blocks[i]);
+        }
+    }
+    ~fragmenter()
+    {
+        for (void * p : live) {
+            std::free(p);
+        }
+    }
+
+    std::vector<void *> live;
+};
+
+template <typename Key>
+Key make_key(int x, std::pmr::memory_resource *)
+{ return x; }
+
+// Long enough to defeat the small-string optimization.
+template <>
+std::pmr::string make_key(int x, std::pmr::memory_resource * r)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "a_key_past_sso_%010d", x);
+    return std::pmr::string(buf, r);
+}
+
+struct result_t
+{
+    double ms = 0.0;
+    double growth_ms = 0.0;
+    int reallocations = 0;
+    std::size_t requested = 0;
+    long rss_kb = 0;
+};
+
+using dur = std::chrono::duration<double, std::milli>;
+
+template <typename Key>
+result_t build(heap_kind heap, std::vector<int> const & ints, bool append)
+{
+    fragmenter const f(heap, ints.size());
+    std::pmr::monotonic_buffer_resource monotonic;
+    std::pmr::unsynchronized_pool_resource pool;
+    std::pmr::memory_resource * upstream = std::pmr::new_delete_resource();
+    if (heap == monotonic_heap)
+        upstream = &monotonic;
+    else if (heap == pool_heap)
+        upstream = &pool;
+    counting_resource counter(upstream);
+
+    std::vector<int> order = ints;
+    if (append)
+        std::sort(order.begin(), order.end());
+
+    result_t result;
+    long const rss_before = current_rss_kb();
+    {
+        using map_t = std::pmr::flat_map<Key, Key>;
+        map_t map(&counter);
+        auto const start = std::chrono::steady_clock::now();
+        if (append) {
+            for (int i : order) {
+                std::size_t const capacity = map.keys().capacity();
+                auto const insert_start = std::chrono::steady_clock::now();
+                map.emplace_hint(
+                    map.end(),
+                    make_key<Key>(i, &counter),
+                    make_key<Key>(i, &counter));
+                if (map.keys().capacity() != capacity) {
+                    result.growth_ms +=
+                        dur(std::chrono::steady_clock::now() - insert_start)
+                            .count();
+                    ++result.reallocations;
+                }
+            }
+        } else {
+            std::vector<std::pair<Key, Key>> elements;
+            elements.reserve(order.size());
+            for (int i : order) {
+                elements.emplace_back(
+                    make_key<Key>(i, &counter), make_key<Key>(i, &counter));
+            }
+            auto const insert_start = std::chrono::steady_clock::now();
+            map.insert(elements.begin(), elements.end());
+            result.growth_ms =
+                dur(std::chrono::steady_clock::now() - insert_start).count();
+        }
+        result.ms = dur(std::chrono::steady_clock::now() - start).count();
+        result.requested = counter.allocated;
+        result.rss_kb = current_rss_kb() - rss_before;
+    }
+    return result;
+}
+
+template <typename Key>
+void run(char const * type_name, std::size_t size)
+{
+    std::vector<int> ints(size);
+    std::iota(ints.begin(), ints.end(), 0);
+    std::shuffle(ints.begin(), ints.end(), std::mt19937(42));
+
+    std::printf("<%s>, %zu elements:\n", type_name, size);
+    std::printf(
+        "  %-11s %-6s %10s %10s %8s %12s %10s\n",
+        "heap",
+        "build",
+        "ms",
+        "growth ms",
+        "reallocs",
+        "requested MB",
+        "RSS MB");
+    for (int h = 0; h < num_heap_kinds; ++h) {
+        for (bool append : {true, false}) {
+            result_t const r = build<Key>(heap_kind(h), ints, append);
+            std::printf(
+                "  %-11s %-6s %10.3f %10.3f %8d %12.2f %10.2f\n",
+                heap_names[h],
+                append ? "append" : "bulk",
+                r.ms,
+                r.growth_ms,
+                r.reallocations,
+                r.requested / 1048576.0,
+                r.rss_kb / 1024.0);
+        }
+    }
+    std::printf("\n");
+}
+
+int main(int argc, char * argv[])
+{
+    std::vector<std::size_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (sizes.empty())
+        sizes = {1u << 10, 1u << 16, 1u << 20};
+
+    std::printf("malloc: %s\n", malloc_name());
+    std::printf(
+        "(bulk rows: growth ms is the range insert alone; reallocs are not "
+        "counted)\n\n");
+    for (std::size_t size : sizes) {
+        run<int>("int, int", size);
+        run<std::pmr::string>("pmr::string, pmr::string", size);
+    }
+    return 0;
+}
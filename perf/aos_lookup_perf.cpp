@@ -0,0 +1,101 @@
+// Compares flat_map, which keeps keys and values in separate containers,
+// with aos_flat_map, which keeps each value next to its key.  For int keys
+// and values of 4, 16 and 64 bytes, prints the nanoseconds per random
+// lookup that only tests for the key (contains) and per lookup that goes
+// on to read the value (find).  The array of structs saves find the one
+// miss on the value, but every probe of its search strides over values
+// too, so its searches touch two or more times the memory.  Expect it to
+// win only while the maps fit in L1, and the split layout to win both
+// columns, increasingly with the value size, once they outgrow L2.
+
+#include <aos_flat_map>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+constexpr int repetitions = 4;
+
+template <int Bytes>
+struct value
+{
+    int data[Bytes / sizeof(int)];
+};
+
+template <typename F>
+double ns_per_lookup(std::vector<int> const & queries, F f)
+{
+    std::size_t sum = 0;
+    auto const start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        for (int q : queries) {
+            sum += f(q);
+        }
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    if (sum == std::size_t(-1))
+        std::puts("");
+    return std::chrono::duration<double, std::nano>(stop - start).count() /
+           (double(repetitions) * queries.size());
+}
+
+template <typename Map>
+void measure(Map const & map, std::vector<int> const & queries, double * out)
+{
+    out[0] = ns_per_lookup(
+        queries, [&](int q) { return std::size_t(map.contains(q)); });
+    out[1] = ns_per_lookup(queries, [&](int q) {
+        auto const it = map.find(q);
+        return it == map.end() ? std::size_t(0)
+                               : std::size_t(it->second.data[0]);
+    });
+}
+
+template <int Bytes>
+void run(std::size_t n)
+{
+    std::flat_map<int, value<Bytes>> split;
+    std::aos_flat_map<int, value<Bytes>> aos;
+    split.reserve(n);
+    aos.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        value<Bytes> v{};
+        v.data[0] = int(i);
+        split.try_emplace(int(i * 2), v);
+        aos.try_emplace(int(i * 2), v);
+    }
+
+    std::mt19937 gen(42);
+    std::vector<int> queries(1 << 20);
+    for (int & q : queries) {
+        q = int(gen() % (2 * n));
+    }
+
+    double split_times[2];
+    double aos_times[2];
+    measure(split, queries, split_times);
+    measure(aos, queries, aos_times);
+    std::printf(
+        "%5d %9zu %10.2f %10.2f %10.2f %10.2f\n",
+        Bytes,
+        n,
+        split_times[0],
+        aos_times[0],
+        split_times[1],
+        aos_times[1]);
+}
+
+int main()
+{
+    std::printf(
+        "value      size   contains   contains       find       find\n"
+        "bytes                 split        aos      split        aos\n");
+    for (std::size_t n : {1024u, 65536u, 1u << 20, 1u << 23}) {
+        run<4>(n);
+        run<16>(n);
+        run<64>(n);
+    }
+    return 0;
+}
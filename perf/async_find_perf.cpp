@@ -0,0 +1,113 @@
+// Compares three ways of looking up a stream of random keys in a
+// flat_map<int, int>: one find() after another, find_many() over the
+// whole stream, and find_async() with a window of in-flight handles that
+// are stepped round-robin, one probe each, AMAC style.  Prints the
+// nanoseconds per lookup for each.  Expect the three to tie while the
+// keys fit in cache, and the interleaved searches to pull ahead of find()
+// once they do not, because each handle's probe has been prefetched by
+// the time it comes round again.  find_many() does the same interleaving
+// without the per-handle bookkeeping, so it should stay a little ahead.
+
+#include <flat_map>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+constexpr int repetitions = 4;
+constexpr std::size_t window = 16;
+
+template <typename F>
+double ns_per_lookup(std::vector<int> const & queries, F f)
+{
+    std::size_t sum = 0;
+    auto const start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        sum += f();
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    if (sum == std::size_t(-1))
+        std::puts("");
+    return std::chrono::duration<double, std::nano>(stop - start).count() /
+           (double(repetitions) * queries.size());
+}
+
+void run(std::size_t n)
+{
+    using map_t = std::flat_map<int, int>;
+    map_t map;
+    map.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        map.emplace_hint(map.end(), int(i * 2), int(i));
+    }
+    map_t const & cmap = map;
+
+    std::mt19937 gen(42);
+    std::vector<int> queries(1 << 20);
+    for (int & q : queries) {
+        q = int(gen() % (2 * n));
+    }
+
+    double const find = ns_per_lookup(queries, [&] {
+        std::size_t sum = 0;
+        for (int q : queries) {
+            auto const it = cmap.find(q);
+            sum += it == cmap.end() ? 0 : it->second;
+        }
+        return sum;
+    });
+
+    std::vector<map_t::const_iterator> its;
+    its.reserve(queries.size());
+    double const many = ns_per_lookup(queries, [&] {
+        its.clear();
+        cmap.find_many(queries.begin(), queries.end(), std::back_inserter(its));
+        std::size_t sum = 0;
+        for (auto it : its) {
+            sum += it == cmap.end() ? 0 : it->second;
+        }
+        return sum;
+    });
+
+    double const async = ns_per_lookup(queries, [&] {
+        std::size_t sum = 0;
+        map_t::const_find_handle handles[window];
+        std::size_t next = 0;
+        std::size_t live = 0;
+        for (; live < window && next < queries.size(); ++live) {
+            handles[live] = cmap.find_async(queries[next++]);
+        }
+        while (live) {
+            for (std::size_t h = 0; h < live;) {
+                if (!handles[h].done()) {
+                    handles[h].step();
+                    ++h;
+                    continue;
+                }
+                auto const it = handles[h].get();
+                sum += it == cmap.end() ? 0 : it->second;
+                if (next < queries.size()) {
+                    handles[h] = cmap.find_async(queries[next++]);
+                    ++h;
+                } else {
+                    handles[h] = handles[--live];
+                }
+            }
+        }
+        return sum;
+    });
+
+    std::printf("%9zu %10.2f %10.2f %10.2f\n", n, find, many, async);
+}
+
+int main()
+{
+    std::printf(
+        "     size       find  find_many find_async\n");
+    for (std::size_t n : {1024u, 65536u, 1u << 20, 1u << 23}) {
+        run(n);
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#!/usr/bin/env python
+
+# Measures what flat_map costs to compile: compiles compile_time_bench.cpp
+# with 0 (the #include alone), 1, 8 and 32 flat_map instantiations, and
+# prints for each the time of the frontend alone (-fsyntax-only), of a
+# debug build (-O0) and of an optimized build (-O2), with the size of each
+# build's object file.  Each time is the fastest of a few runs.  The
+# instantiations' cost is the difference between rows; divide by the
+# difference in combos for the cost of one more map type.
+#
+# Usage: compile_time.py [--compiler CXX] [--std c++17] [--combos 0 1 8 32]
+#                        [--repetitions 3] [--include DIR] [-- EXTRA_FLAGS]
+#
+# --std c++20 also measures the C++20 ranges and concepts that
+# USE_CONCEPTS pulls in, where the standard library provides them.
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+here = os.path.dirname(os.path.abspath(__file__))
+
+modes = [
+    ('frontend', ['-fsyntax-only']),
+    ('-O0', ['-O0', '-c']),
+    ('-O2', ['-O2', '-c']),
+]
+
+def compile_once(command):
+    start = time.time()
+    subprocess.check_call(command)
+    return time.time() - start
+
+def measure(args, combos, flags, output):
+    command = [args.compiler, '-std=' + args.std, '-I', args.include,
+               '-DFLAT_MAP_COMBOS={}'.format(combos)] + flags + args.extra
+    command += [os.path.join(here, 'compile_time_bench.cpp')]
+    if '-c' in flags:
+        command += ['-o', output]
+    seconds = min(compile_once(command) for _ in range(args.repetitions))
+    size = os.path.getsize(output) if '-c' in flags else None
+    return seconds, size
+
+def main(argv):
+    parser = argparse.ArgumentParser(description='Times the compilation of flat_map instantiations.')
+    parser.add_argument('--compiler', default=os.environ.get('CXX', 'c++'))
+    parser.add_argument('--std', default='c++17')
+    parser.add_argument('--combos', type=int, nargs='+', default=[0, 1, 8, 32])
+    parser.add_argument('--repetitions', type=int, default=3)
+    parser.add_argument('--include', default=os.path.join(here, '..', 'implementation'))
+    parser.add_argument('extra', nargs='*', help='more compiler flags, after --')
+    args = parser.parse_args(argv[1:])
+
+    directory = tempfile.mkdtemp()
+    try:
+        output = os.path.join(directory, 'compile_time_bench.o')
+        print('{} -std={}'.format(args.compiler, args.std))
+        header = '{:>7}'.format('combos')
+        for name, _ in modes:
+            header += ' {:>10}'.format(name + ' s')
+            if name != 'frontend':
+                header += ' {:>10}'.format(name + ' KB')
+        print(header)
+        for combos in args.combos:
+            line = '{:>7}'.format(combos)
+            for _, flags in modes:
+                seconds, size = measure(args, combos, flags, output)
+                line += ' {:>10.2f}'.format(seconds)
+                if size is not None:
+                    line += ' {:>10.1f}'.format(size / 1024.0)
+            print(line)
+            sys.stdout.flush()
+    finally:
+        shutil.rmtree(directory)
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,88 @@
+// The translation unit compile_time.py compiles to measure what flat_map
+// costs to build.  It instantiates FLAT_MAP_COMBOS distinct flat_maps --
+// each key type with int, double and std::string values in turn, as map
+// types tend to share keys in real code -- and calls each one's lookups
+// in all their forms (mutable and const, by key and heterogeneous), its
+// inserts, erases and iteration, as user code would.  With
+// FLAT_MAP_COMBOS of 0, it measures the cost of including <flat_map>
+// alone.
+
+#include <flat_map>
+
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if !defined(FLAT_MAP_COMBOS)
+#define FLAT_MAP_COMBOS 16
+#endif
+
+
+template <int I>
+struct bench_key
+{
+    int x;
+};
+
+template <int I>
+bool operator<(bench_key<I> lhs, bench_key<I> rhs)
+{ return lhs.x < rhs.x; }
+template <int I>
+bool operator<(bench_key<I> lhs, int rhs)
+{ return lhs.x < rhs; }
+template <int I>
+bool operator<(int lhs, bench_key<I> rhs)
+{ return lhs < rhs.x; }
+
+// The mapped type of the I-th map; its key type is bench_key<I / 3>.
+template <int I>
+using bench_value = std::conditional_t<
+    I % 3 == 0,
+    int,
+    std::conditional_t<I % 3 == 1, double, std::string>>;
+
+template <int I>
+std::size_t use_map()
+{
+    using key = bench_key<I / 3>;
+    std::flat_map<key, bench_value<I>, std::less<>> map;
+    map.try_emplace(key{1});
+    map.emplace(key{2}, bench_value<I>());
+    map.insert({key{3}, bench_value<I>()});
+    map[key{4}] = bench_value<I>();
+    map.insert_or_assign(key{5}, bench_value<I>());
+
+    auto const & const_map = map;
+    std::size_t n = 0;
+    n += map.find(key{1}) != map.end();
+    n += const_map.find(key{1}) != const_map.end();
+    n += map.find(2) != map.end();
+    n += const_map.find(2) != const_map.end();
+    n += map.lower_bound(key{1}) != map.end();
+    n += const_map.lower_bound(key{1}) != const_map.end();
+    n += map.lower_bound(2) != map.end();
+    n += const_map.lower_bound(2) != const_map.end();
+    n += map.upper_bound(key{1}) != map.end();
+    n += const_map.upper_bound(key{1}) != const_map.end();
+    n += map.upper_bound(2) != map.end();
+    n += const_map.upper_bound(2) != const_map.end();
+    n += map.equal_range(key{1}).first != map.end();
+    n += const_map.equal_range(key{1}).first != const_map.end();
+    n += map.equal_range(2).first != map.end();
+    n += const_map.equal_range(2).first != const_map.end();
+    n += map.count(key{3}) + map.count(3);
+    n += map.contains(key{4}) + map.contains(4);
+    for (auto const & element : const_map) {
+        n += std::size_t(element.first.x);
+    }
+    map.erase(key{5});
+    map.erase(map.begin());
+    return n + map.size();
+}
+
+template <std::size_t... Is>
+std::size_t use_maps(std::index_sequence<Is...>)
+{ return (use_map<int(Is)>() + ... + std::size_t(0)); }
+
+int main()
+{ return int(use_maps(std::make_index_sequence<FLAT_MAP_COMBOS>()) & 1); }
@@ -0,0 +1,171 @@
+// Measures how reads and writes scale with thread count for three shared
+// maps: a flat_map behind a std::shared_mutex, concurrent_flat_map, and
+// sharded_flat_map.  For each writer count in 0..max_writers and reader
+// count in 1, 2, 4, ..., max_readers, runs the threads for a fixed time
+// and prints the millions of reads and writes per second.  Readers look up
+// random keys, half of them present; writers assign random keys.
+// concurrent_flat_map's writers publish a new version every 64 writes,
+// since each publish copies the map.  The results are also written to
+// concurrent_scaling.py, which make_tex.py turns into scaling curves.
+// Expect the lock-based map's reads to stop scaling once writers run,
+// concurrent_flat_map's reads to scale regardless, at the cost of slow
+// writes, and the sharded map to sit in between.  The numbers mean little
+// on a machine with fewer cores than threads.
+//
+// Usage: concurrent_scaling_perf [max_readers [max_writers [ms_per_run]]]
+
+#include <concurrent_flat_map>
+#include <sharded_flat_map>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+
+using base_map_t = std::flat_map<int, int>;
+
+constexpr int map_size = 1 << 16;
+
+struct locked_map_t
+{
+    bool contains(int k) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return map.contains(k);
+    }
+    void write(int k)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        map.insert_or_assign(k, k);
+    }
+
+    mutable std::shared_mutex mutex;
+    base_map_t map;
+};
+
+struct concurrent_map_t
+{
+    bool contains(int k) const { return map.contains(k); }
+    void write(int k)
+    {
+        map.insert_or_assign(k, k);
+        if (++writes % 64 == 0)
+            map.publish();
+    }
+
+    std::concurrent_flat_map<base_map_t> map;
+    std::atomic<unsigned> writes{0};
+};
+
+struct sharded_map_t
+{
+    sharded_map_t() : map(std::hash_partitioner<int>(64)) {}
+
+    bool contains(int k) const { return map.contains(k); }
+    void write(int k) { map.insert_or_assign(k, k); }
+
+    std::sharded_flat_map<base_map_t> map;
+};
+
+void preload(locked_map_t & m, int k) { m.map.try_emplace(k, k); }
+void preload(concurrent_map_t & m, int k) { m.map.insert_or_assign(k, k); }
+void preload(sharded_map_t & m, int k) { m.map.try_emplace(k, k); }
+void finish_preload(locked_map_t &) {}
+void finish_preload(concurrent_map_t & m) { m.map.publish(); }
+void finish_preload(sharded_map_t &) {}
+
+struct result_t
+{
+    double reads_per_s;
+    double writes_per_s;
+};
+
+template <typename Map>
+result_t run(int readers, int writers, int ms)
+{
+    Map map;
+    for (int i = 0; i < map_size; ++i) {
+        preload(map, i * 2);
+    }
+    finish_preload(map);
+
+    std::atomic<bool> stop{false};
+    std::atomic<long long> reads{0};
+    std::atomic<long long> writes{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < readers + writers; ++t) {
+        bool const writer = t < writers;
+        threads.emplace_back([&, writer, t] {
+            std::mt19937 gen(t + 1);
+            long long n = 0;
+            std::size_t found = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                int const k = int(gen() % (2 * map_size));
+                if (writer)
+                    map.write(k);
+                else
+                    found += map.contains(k);
+                ++n;
+            }
+            (writer ? writes : reads) += n;
+            if (found == std::size_t(-1))
+                std::puts("");
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    stop = true;
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    double const seconds = ms / 1000.0;
+    return {reads / seconds / 1e6, writes / seconds / 1e6};
+}
+
+int main(int argc, char * argv[])
+{
+    int const max_readers =
+        1 < argc ? std::atoi(argv[1])
+                 : std::max(1, int(std::thread::hardware_concurrency()));
+    int const max_writers = 2 < argc ? std::atoi(argv[2]) : 2;
+    int const ms = 3 < argc ? std::atoi(argv[3]) : 500;
+
+    std::ofstream ofs("concurrent_scaling.py");
+    ofs << "scaling_timings = [\n";
+    std::printf(
+        "writers readers    locked reads/writes  concurrent reads/writes"
+        "     sharded reads/writes (M/s)\n");
+    for (int writers = 0; writers <= max_writers; ++writers) {
+        for (int readers = 1; readers <= max_readers; readers *= 2) {
+            result_t const locked = run<locked_map_t>(readers, writers, ms);
+            result_t const concurrent =
+                run<concurrent_map_t>(readers, writers, ms);
+            result_t const sharded = run<sharded_map_t>(readers, writers, ms);
+            std::printf(
+                "%7d %7d %10.2f %10.3f %12.2f %10.3f %12.2f %10.3f\n",
+                writers,
+                readers,
+                locked.reads_per_s,
+                locked.writes_per_s,
+                concurrent.reads_per_s,
+                concurrent.writes_per_s,
+                sharded.reads_per_s,
+                sharded.writes_per_s);
+            ofs << "    {'writers': " << writers << ", 'readers': " << readers
+                << ", 'locked': " << locked.reads_per_s
+                << ", 'concurrent': " << concurrent.reads_per_s
+                << ", 'sharded': " << sharded.reads_per_s
+                << ", 'locked_writes': " << locked.writes_per_s
+                << ", 'concurrent_writes': " << concurrent.writes_per_s
+                << ", 'sharded_writes': " << sharded.writes_per_s << "},\n";
+        }
+    }
+    ofs << "]\n";
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Checks that const lookups through flat_map cost no more than the search
+// they wrap.  For int keys and for string keys looked up by string_view
+// (through std::less<>), prints the nanoseconds per call of a hand-written
+// std::lower_bound plus one equality test over keys(), and of const find()
+// and contains() on the map.  Neither map column should be slower than the
+// bare search beyond noise; a gap means the map adds conversions or
+// comparisons.  (Int keys use the branchless search, so they beat it.)
+
+#include <flat_map>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+constexpr int repetitions = 20;
+
+template <typename Query, typename F>
+double ns_per_lookup(std::vector<Query> const & queries, F f)
+{
+    std::size_t sum = 0;
+    auto const start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        for (Query const & q : queries) {
+            sum += f(q);
+        }
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    if (sum == std::size_t(-1))
+        std::puts("");
+    return std::chrono::duration<double, std::nano>(stop - start).count() /
+           (double(repetitions) * queries.size());
+}
+
+template <typename Map, typename Query>
+void run(char const * name, Map const & map, std::vector<Query> const & queries)
+{
+    auto const & keys = map.keys();
+    auto const comp = map.key_comp();
+    double const bare = ns_per_lookup(queries, [&](Query const & q) {
+        auto const it = std::lower_bound(keys.begin(), keys.end(), q, comp);
+        return std::size_t(it != keys.end() && !comp(q, *it));
+    });
+    double const find = ns_per_lookup(queries, [&](Query const & q) {
+        return std::size_t(map.find(q) != map.end());
+    });
+    double const contains = ns_per_lookup(
+        queries, [&](Query const & q) { return std::size_t(map.contains(q)); });
+    std::printf(
+        "%-22s %8zu %8.2f %8.2f %8.2f\n",
+        name,
+        map.size(),
+        bare,
+        find,
+        contains);
+}
+
+int main()
+{
+    std::printf("keys                       size     bare     find contains\n");
+    std::mt19937 gen(42);
+    for (std::size_t n : {64u, 4096u, 262144u}) {
+        std::flat_map<int, int> int_map;
+        std::flat_map<std::string, int, std::less<>> string_map;
+        for (std::size_t i = 0; i < n; ++i) {
+            int_map.emplace(int(i * 2), int(i));
+            string_map.emplace("key/" + std::to_string(i * 2), int(i));
+        }
+
+        std::vector<int> int_queries(1 << 16);
+        std::vector<std::string> query_strings(1 << 16);
+        for (std::size_t i = 0; i < int_queries.size(); ++i) {
+            int_queries[i] = int(gen() % (2 * n));
+            query_strings[i] = "key/" + std::to_string(int_queries[i]);
+        }
+        std::vector<std::string_view> string_queries(
+            query_strings.begin(), query_strings.end());
+
+        run("int", int_map, int_queries);
+        run("string by string_view", string_map, string_queries);
+    }
+    return 0;
+}
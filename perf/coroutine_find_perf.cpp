@@ -0,0 +1,79 @@
+// Compares find-then-update over a stream of random keys in a
+// flat_map<int, int>, done one find() after another and done by
+// run_interleaved() with a window of lookup_task coroutines.  Prints the
+// nanoseconds per lookup for each window.  Expect the coroutines to lose
+// while the map fits in cache, where they only add the cost of a
+// coroutine frame and a resumption per probe, and to win by a growing
+// margin once each probe is a miss.  Needs C++20.
+
+#include <flat_map_coroutine>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+constexpr int repetitions = 4;
+
+template <typename F>
+double ns_per_lookup(std::vector<int> const & queries, F f)
+{
+    auto const start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        f();
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() /
+           (double(repetitions) * queries.size());
+}
+
+void run(std::size_t n)
+{
+    std::flat_map<int, int> map;
+    map.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        map.emplace_hint(map.end(), int(i * 2), 0);
+    }
+
+    std::mt19937 gen(42);
+    std::vector<int> queries(1 << 20);
+    for (int & q : queries) {
+        q = int(gen() % (2 * n));
+    }
+
+    double const find = ns_per_lookup(queries, [&] {
+        for (int q : queries) {
+            auto const it = map.find(q);
+            if (it != map.end())
+                ++it->second;
+        }
+    });
+    std::printf("%9zu %10.2f", n, find);
+
+    for (std::size_t window : {4u, 16u, 32u}) {
+        double const interleaved = ns_per_lookup(queries, [&] {
+            std::run_interleaved(
+                queries.begin(),
+                queries.end(),
+                [&](int q) -> std::lookup_task {
+                    auto const it = co_await std::async_find(map, q);
+                    if (it != map.end())
+                        ++it->second;
+                },
+                window);
+        });
+        std::printf(" %10.2f", interleaved);
+    }
+    std::printf("\n");
+}
+
+int main()
+{
+    std::printf(
+        "     size       find   window 4  window 16  window 32\n");
+    for (std::size_t n : {1024u, 65536u, 1u << 20, 1u << 23}) {
+        run(n);
+    }
+    return 0;
+}
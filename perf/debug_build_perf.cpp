@@ -0,0 +1,87 @@
+// Times flat_map's find, iteration and try_emplace in an unoptimized
+// build, where each layer of the proxy iterators and of the forwarding
+// functions beneath the public interface costs a call.  It is built twice
+// at -O0: debug_build_perf, with flat_map's default of marking its trivial
+// forwarding functions always_inline, and debug_build_perf_noinline, with
+// FLAT_MAP_DEBUG_INLINE defined to 0.  Expect the first to be faster by the
+// calls it saves; an -O3 build of either is the release figure to compare
+// against.
+//
+// Usage: debug_build_perf [size]; the default size is 64K.
+
+#include <flat_map>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+
+std::size_t sink = 0;
+
+template <typename F>
+double time_ns(std::size_t ops, F f)
+{
+    double best = 0.0;
+    for (int i = 0; i < 5; ++i) {
+        auto const start = std::chrono::steady_clock::now();
+        f();
+        auto const stop = std::chrono::steady_clock::now();
+        double const ns =
+            std::chrono::duration<double, std::nano>(stop - start).count() /
+            double(ops);
+        if (!i || ns < best)
+            best = ns;
+    }
+    return best;
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t const size =
+        1 < argc ? std::strtoull(argv[1], nullptr, 10) : 1u << 16;
+
+    std::vector<int> keys(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        keys[i] = int(2 * i);
+    }
+    std::vector<int> lookups = keys;
+    std::shuffle(lookups.begin(), lookups.end(), std::mt19937(42));
+
+    std::flat_map<int, int> map;
+    for (int k : keys) {
+        map.try_emplace(k, k);
+    }
+
+    std::printf("%zu elements, ns per operation:\n", size);
+    std::printf("  find         %8.2f\n", time_ns(size, [&] {
+        for (int k : lookups) {
+            sink += map.find(k) != map.end();
+        }
+    }));
+    std::printf("  iterate      %8.2f\n", time_ns(size, [&] {
+        for (auto it = map.begin(), last = map.end(); it != last; ++it) {
+            sink += std::size_t(it->second);
+        }
+    }));
+    std::printf("  range for    %8.2f\n", time_ns(size, [&] {
+        for (auto const & element : map) {
+            sink += std::size_t(element.second);
+        }
+    }));
+    std::printf("  try_emplace  %8.2f\n", time_ns(size, [&] {
+        std::flat_map<int, int> m;
+        for (int k : keys) {
+            m.try_emplace(k, k);
+        }
+        sink += m.size();
+    }));
+    std::printf("  operator[]   %8.2f\n", time_ns(size, [&] {
+        for (int k : lookups) {
+            sink += std::size_t(map[k]);
+        }
+    }));
+    return sink == std::size_t(-1);
+}
@@ -0,0 +1,196 @@
+// Google Benchmark microbenchmarks for each public flat_map operation, on
+// int and std::string keys, over map sizes from 8 to 64K elements.  Each
+// benchmark times a whole batch of operations per iteration and reports
+// items per second, so that operations far under a microsecond are not
+// swamped by the clock, as they are in perf_test's per-call timing.  Run
+// with --benchmark_repetitions=N for mean, median and stddev, and with
+// --benchmark_format=json or --benchmark_out=FILE for machine-readable
+// results.  The keys are drawn from a fixed seed, so runs are comparable.
+
+#include <flat_map>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+
+template <typename Key>
+Key make_key(int x)
+{ return x; }
+
+template <>
+std::string make_key(int x)
+{ return "key_" + std::to_string(x); }
+
+// n distinct keys, in random order.
+template <typename Key>
+std::vector<Key> random_keys(std::size_t n)
+{
+    std::vector<int> ints(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        ints[i] = int(i * 2);
+    }
+    std::mt19937 gen(42);
+    std::shuffle(ints.begin(), ints.end(), gen);
+    std::vector<Key> keys;
+    keys.reserve(n);
+    for (int i : ints) {
+        keys.push_back(make_key<Key>(i));
+    }
+    return keys;
+}
+
+template <typename Key>
+std::flat_map<Key, int> make_map(std::vector<Key> const & keys)
+{
+    std::flat_map<Key, int> map;
+    for (auto const & k : keys) {
+        map.try_emplace(k, 0);
+    }
+    return map;
+}
+
+// Lookups for keys that are present and absent in equal measure.
+template <typename Key>
+std::vector<Key> queries(std::size_t n)
+{
+    std::vector<Key> result;
+    std::mt19937 gen(43);
+    for (std::size_t i = 0; i < 4096; ++i) {
+        result.push_back(make_key<Key>(int(gen() % (2 * n))));
+    }
+    return result;
+}
+
+template <typename Key>
+void insert(benchmark::State & state)
+{
+    auto const keys = random_keys<Key>(state.range(0));
+    for (auto _ : state) {
+        std::flat_map<Key, int> map;
+        for (auto const & k : keys) {
+            map[k] = 1;
+        }
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Key>
+void emplace_hint(benchmark::State & state)
+{
+    auto keys = random_keys<Key>(state.range(0));
+    std::sort(keys.begin(), keys.end());
+    for (auto _ : state) {
+        std::flat_map<Key, int> map;
+        for (auto const & k : keys) {
+            map.emplace_hint(map.end(), k, 1);
+        }
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Key>
+void bulk_insert(benchmark::State & state)
+{
+    auto const keys = random_keys<Key>(state.range(0));
+    std::vector<std::pair<Key, int>> elements;
+    for (auto const & k : keys) {
+        elements.emplace_back(k, 1);
+    }
+    std::size_t const half = elements.size() / 2;
+    for (auto _ : state) {
+        std::flat_map<Key, int> map(
+            elements.begin(), elements.begin() + half);
+        map.insert(elements.begin() + half, elements.end());
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Key, typename F>
+void lookup(benchmark::State & state, F f)
+{
+    auto const map = make_map(random_keys<Key>(state.range(0)));
+    auto const qs = queries<Key>(map.size());
+    for (auto _ : state) {
+        for (auto const & q : qs) {
+            benchmark::DoNotOptimize(f(map, q));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * qs.size());
+}
+
+template <typename Key>
+void find(benchmark::State & state)
+{
+    lookup<Key>(state, [](auto const & map, Key const & q) {
+        return map.find(q) != map.end();
+    });
+}
+
+template <typename Key>
+void lower_bound(benchmark::State & state)
+{
+    lookup<Key>(state, [](auto const & map, Key const & q) {
+        return map.lower_bound(q);
+    });
+}
+
+template <typename Key>
+void equal_range(benchmark::State & state)
+{
+    lookup<Key>(state, [](auto const & map, Key const & q) {
+        return map.equal_range(q);
+    });
+}
+
+template <typename Key>
+void erase(benchmark::State & state)
+{
+    auto const keys = random_keys<Key>(state.range(0));
+    auto const full = make_map(keys);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto map = full;
+        state.ResumeTiming();
+        for (auto const & k : keys) {
+            map.erase(k);
+        }
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Key>
+void iterate(benchmark::State & state)
+{
+    auto const map = make_map(random_keys<Key>(state.range(0)));
+    for (auto _ : state) {
+        int sum = 0;
+        for (auto const & element : map) {
+            sum += element.second;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * map.size());
+}
+
+#define FLAT_MAP_BENCHMARK(op)                                          \
+    BENCHMARK_TEMPLATE(op, int)->RangeMultiplier(8)->Range(8, 8 << 13); \
+    BENCHMARK_TEMPLATE(op, std::string)->RangeMultiplier(8)->Range(8, 8 << 13)
+
+FLAT_MAP_BENCHMARK(insert);
+FLAT_MAP_BENCHMARK(emplace_hint);
+FLAT_MAP_BENCHMARK(bulk_insert);
+FLAT_MAP_BENCHMARK(find);
+FLAT_MAP_BENCHMARK(lower_bound);
+FLAT_MAP_BENCHMARK(equal_range);
+FLAT_MAP_BENCHMARK(erase);
+FLAT_MAP_BENCHMARK(iterate);
+
+BENCHMARK_MAIN();
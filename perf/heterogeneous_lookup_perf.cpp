@@ -0,0 +1,136 @@
+// Measures what heterogeneous lookup saves when the caller holds a key as
+// characters rather than as a std::string -- a token parsed out of a
+// buffer, or a literal.  For flat_map<std::string, int> with short keys
+// (which fit in the small-string buffer) and with long ones (which do
+// not), prints the nanoseconds and heap allocations per find() of a key
+// held as a std::string (the baseline, which allocates nothing), as a
+// string_view converted to a temporary std::string for a map with the
+// default comparator, and as a string_view and as a const char * passed
+// through std::less<> as they are.  The temporary's column should be the
+// slowest for long keys, by about one malloc and free a lookup; the
+// string_view column should match the baseline, and the const char *
+// column should trail it by a strlen() a comparison.  Allocations are
+// counted by replacing the global operator new.
+
+#include "key_generators.hpp"
+
+#include <flat_map>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+std::size_t allocations = 0;
+
+void * operator new(std::size_t n)
+{
+    void * const p = std::malloc(n ? n : 1);
+    if (!p)
+        throw std::bad_alloc();
+    ++allocations;
+    return p;
+}
+
+void operator delete(void * p) noexcept { std::free(p); }
+
+void operator delete(void * p, std::size_t) noexcept { operator delete(p); }
+
+constexpr int repetitions = 20;
+
+struct lookup_cost
+{
+    double ns;
+    double allocations;
+};
+
+template <typename Query, typename F>
+lookup_cost cost_per_lookup(std::vector<Query> const & queries, F f)
+{
+    std::size_t sum = 0;
+    std::size_t const allocations_before = allocations;
+    auto const start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        for (Query const & q : queries) {
+            sum += f(q);
+        }
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    std::size_t const allocated = allocations - allocations_before;
+    if (sum == std::size_t(-1))
+        std::puts("");
+    double const lookups = double(repetitions) * queries.size();
+    return {
+        std::chrono::duration<double, std::nano>(stop - start).count() /
+            lookups,
+        allocated / lookups};
+}
+
+void run(char const * name, std::size_t n, std::string const & prefix)
+{
+    std::flat_map<std::string, int> map;
+    std::flat_map<std::string, int, std::less<>> transparent_map;
+    for (std::size_t i = 0; i < n; ++i) {
+        std::string const key = prefix + std::to_string(i * 2);
+        map.emplace(key, int(i));
+        transparent_map.emplace(key, int(i));
+    }
+
+    // Half the queries miss.  The string_views and const char *s point
+    // into query_strings, as they would into a parsed buffer.
+    std::mt19937 gen(42);
+    std::vector<std::string> query_strings(1 << 16);
+    for (auto & s : query_strings) {
+        s = prefix + std::to_string(gen() % (2 * n));
+    }
+    std::vector<std::string_view> views(
+        query_strings.begin(), query_strings.end());
+    std::vector<char const *> c_strs;
+    for (auto const & s : query_strings) {
+        c_strs.push_back(s.c_str());
+    }
+
+    lookup_cost const string =
+        cost_per_lookup(query_strings, [&](std::string const & q) {
+            auto const it = transparent_map.find(q);
+            return std::size_t(it != transparent_map.end());
+        });
+    lookup_cost const temporary =
+        cost_per_lookup(views, [&](std::string_view q) {
+            return std::size_t(map.find(std::string(q)) != map.end());
+        });
+    lookup_cost const view = cost_per_lookup(views, [&](std::string_view q) {
+        return std::size_t(transparent_map.find(q) != transparent_map.end());
+    });
+    lookup_cost const c_str = cost_per_lookup(c_strs, [&](char const * q) {
+        return std::size_t(transparent_map.find(q) != transparent_map.end());
+    });
+
+    std::printf("%-6s %8zu", name, n);
+    for (lookup_cost c : {string, temporary, view, c_str}) {
+        std::printf(" %8.2f", c.ns);
+    }
+    for (lookup_cost c : {string, temporary, view, c_str}) {
+        std::printf(" %6.2f", c.allocations);
+    }
+    std::printf("\n");
+}
+
+int main()
+{
+    std::printf(
+        "                 --------- ns per find() ---------"
+        " ---- allocations per find() ----\n"
+        "keys       size   string     temp     view    c_str"
+        " string   temp   view  c_str\n");
+    for (std::size_t n : {64u, 4096u, 262144u}) {
+        run("short", n, "key/");
+        run("long", n, long_key_prefix());
+    }
+    return 0;
+}
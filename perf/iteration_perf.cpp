@@ -0,0 +1,158 @@
+// Compares the ways to walk every element of a flat_map with a plain
+// vector of structs, the array-of-structs layout flat_map splits apart.
+// For int and std::string keys and values, prints the nanoseconds per
+// element of a pass that reads keys and values through flat_map's
+// iterators, whose proxy references pair up one element of each
+// container; one that zips keys() and values() by index, the same reads
+// without the proxy; and passes over keys() or values() alone.  The
+// vector_custom_pair columns walk a std::vector of {key, value} structs
+// for the same three passes.  The gap between the first two flat_map
+// columns is the cost of the proxy reference; a pass over one side alone
+// is where the split layout wins, since it reads half the memory.
+
+#include <flat_map>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+constexpr int repetitions = 8;
+
+template <typename K, typename V>
+struct custom_pair
+{
+    K first;
+    V second;
+};
+
+std::size_t weight(int x)
+{ return std::size_t(x); }
+
+std::size_t weight(std::string const & x)
+{ return x.size(); }
+
+template <typename T>
+T make(std::size_t i);
+
+template <>
+int make(std::size_t i)
+{ return int(i * 2); }
+
+template <>
+std::string make(std::size_t i)
+{ return "element " + std::to_string(i * 2); }
+
+template <typename F>
+double ns_per_element(std::size_t n, F f)
+{
+    std::size_t sum = 0;
+    auto const start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        sum += f();
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    if (sum == std::size_t(-1))
+        std::puts("");
+    return std::chrono::duration<double, std::nano>(stop - start).count() /
+           (double(repetitions) * n);
+}
+
+template <typename K, typename V>
+void run(char const * name, std::size_t n)
+{
+    std::vector<K> map_keys;
+    std::vector<V> map_values;
+    for (std::size_t i = 0; i < n; ++i) {
+        map_keys.push_back(make<K>(i));
+        map_values.push_back(make<V>(i));
+    }
+    std::flat_map<K, V> const map(std::move(map_keys), std::move(map_values));
+    std::vector<custom_pair<K, V>> vec;
+    vec.reserve(n);
+    for (auto const & x : map) {
+        vec.push_back({x.first, x.second});
+    }
+    auto const & keys = map.keys();
+    auto const & values = map.values();
+
+    double const proxy_pairs = ns_per_element(n, [&] {
+        std::size_t sum = 0;
+        for (auto const & x : map) {
+            sum += weight(x.first) + weight(x.second);
+        }
+        return sum;
+    });
+    double const zipped_pairs = ns_per_element(n, [&] {
+        std::size_t sum = 0;
+        for (std::size_t i = 0, size = keys.size(); i < size; ++i) {
+            sum += weight(keys[i]) + weight(values[i]);
+        }
+        return sum;
+    });
+    double const split_keys = ns_per_element(n, [&] {
+        std::size_t sum = 0;
+        for (auto const & k : keys) {
+            sum += weight(k);
+        }
+        return sum;
+    });
+    double const split_values = ns_per_element(n, [&] {
+        std::size_t sum = 0;
+        for (auto const & v : values) {
+            sum += weight(v);
+        }
+        return sum;
+    });
+
+    double const aos_pairs = ns_per_element(n, [&] {
+        std::size_t sum = 0;
+        for (auto const & x : vec) {
+            sum += weight(x.first) + weight(x.second);
+        }
+        return sum;
+    });
+    double const aos_keys = ns_per_element(n, [&] {
+        std::size_t sum = 0;
+        for (auto const & x : vec) {
+            sum += weight(x.first);
+        }
+        return sum;
+    });
+    double const aos_values = ns_per_element(n, [&] {
+        std::size_t sum = 0;
+        for (auto const & x : vec) {
+            sum += weight(x.second);
+        }
+        return sum;
+    });
+
+    std::printf(
+        "%-7s %8zu %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f\n",
+        name,
+        n,
+        proxy_pairs,
+        zipped_pairs,
+        split_keys,
+        split_values,
+        aos_pairs,
+        aos_keys,
+        aos_values);
+}
+
+int main()
+{
+    std::printf(
+        "                  ---------- flat_map ---------  "
+        "- vector_custom_pair -\n"
+        "types       size    proxy   zipped     keys   values"
+        "    pairs     keys   values\n");
+    for (std::size_t n : {1024u, 65536u, 1u << 20, 1u << 23}) {
+        run<int, int>("int", n);
+    }
+    for (std::size_t n : {1024u, 65536u, 1u << 20}) {
+        run<std::string, std::string>("string", n);
+    }
+    return 0;
+}
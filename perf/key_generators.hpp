@@ -0,0 +1,150 @@
+// Key streams for the perf tests, shaped like traffic seen in practice
+// rather than only uniformly random.  Every generator is driven by an
+// explicit seed, so that a run can be repeated exactly from the seed it
+// reports.
+
+#ifndef PERF_KEY_GENERATORS_HPP
+#define PERF_KEY_GENERATORS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+
+enum class key_distribution
+{
+    // Uniformly random ints.
+    uniform,
+    // Increasing ints, with small random gaps.
+    sorted,
+    // sorted, with about one key in twenty swapped with one up to 16
+    // places away, like timestamps from a few out-of-order producers.
+    near_sorted,
+    // Draws from n distinct keys with Zipf(0.99) probabilities, so that a
+    // few hot keys recur many times.
+    zipfian,
+    // Runs of 64 consecutive ids, starting at random bases, like ids
+    // allocated in blocks.
+    clustered,
+    // uniform, but string keys share a 48-character prefix, so that every
+    // comparison scans it.
+    long_prefix,
+    // Uniform draws from only n / 16 distinct keys.
+    duplicates,
+
+    num_key_distributions
+};
+
+inline char const * name(key_distribution d)
+{
+    switch (d) {
+    case key_distribution::uniform: return "uniform";
+    case key_distribution::sorted: return "sorted";
+    case key_distribution::near_sorted: return "near_sorted";
+    case key_distribution::zipfian: return "zipfian";
+    case key_distribution::clustered: return "clustered";
+    case key_distribution::long_prefix: return "long_prefix";
+    case key_distribution::duplicates: return "duplicates";
+    default: return "unknown";
+    }
+}
+
+// Returns the distribution called s, or num_key_distributions.
+inline key_distribution parse_key_distribution(char const * s)
+{
+    int i = 0;
+    for (; i < int(key_distribution::num_key_distributions); ++i) {
+        if (!std::strcmp(s, name(key_distribution(i))))
+            break;
+    }
+    return key_distribution(i);
+}
+
+// The prefix that make_key<std::string>() puts before each key of the
+// long_prefix distribution.
+inline std::string const & long_key_prefix()
+{
+    static std::string const prefix(48, 'p');
+    return prefix;
+}
+
+// Spreads the ranks 0, 1, 2, ... of the zipfian distribution over the int
+// range, so that hot keys are not all adjacent.
+inline int scramble(std::uint32_t x)
+{
+    return int((x * 2654435761u) >> 1);
+}
+
+inline std::vector<int>
+make_keys(key_distribution d, std::size_t n, std::uint64_t seed)
+{
+    std::mt19937_64 gen(seed);
+    std::vector<int> keys(n);
+    switch (d) {
+    case key_distribution::sorted:
+    case key_distribution::near_sorted: {
+        int key = 0;
+        for (auto & k : keys) {
+            key += 1 + int(gen() % 4);
+            k = key;
+        }
+        if (d == key_distribution::near_sorted) {
+            for (std::size_t i = 0; i + 1 < n; ++i) {
+                if (gen() % 20 == 0) {
+                    std::size_t const j = std::min(n - 1, i + 1 + gen() % 16);
+                    std::swap(keys[i], keys[j]);
+                }
+            }
+        }
+        break;
+    }
+    case key_distribution::zipfian: {
+        std::vector<double> cdf(n);
+        double sum = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            sum += 1.0 / std::pow(double(i + 1), 0.99);
+            cdf[i] = sum;
+        }
+        std::uniform_real_distribution<double> dist(0.0, sum);
+        for (auto & k : keys) {
+            auto const rank =
+                std::lower_bound(cdf.begin(), cdf.end(), dist(gen)) -
+                cdf.begin();
+            k = scramble(std::uint32_t(rank));
+        }
+        break;
+    }
+    case key_distribution::clustered: {
+        std::uniform_int_distribution<int> base(0, (1 << 30) - 64);
+        for (std::size_t i = 0; i < n; i += 64) {
+            int const b = base(gen);
+            for (std::size_t j = i; j < std::min(n, i + 64); ++j) {
+                keys[j] = b + int(j - i);
+            }
+        }
+        break;
+    }
+    case key_distribution::duplicates: {
+        std::uniform_int_distribution<std::uint32_t> dist(
+            0, std::uint32_t(std::max<std::size_t>(n / 16, 1) - 1));
+        for (auto & k : keys) {
+            k = scramble(dist(gen));
+        }
+        break;
+    }
+    default: {
+        std::uniform_int_distribution<int> dist;
+        for (auto & k : keys) {
+            k = dist(gen);
+        }
+        break;
+    }
+    }
+    return keys;
+}
+
+#endif
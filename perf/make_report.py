@@ -0,0 +1,205 @@
+#!/usr/bin/env python
+
+# Turns perf results into an HTML report for comparing containers: for
+# each compiler (data directory), operation and element type, a chart of
+# time against map size with one line per variant, and a table of each
+# variant's speedup over a baseline variant at each size.  The charts are
+# inline SVG, so the report is one self-contained file; with --png-dir,
+# they are also drawn as PNG files, if matplotlib is installed.
+#
+# Usage: make_report.py [--output report.html] [--baseline VARIANT]
+#                       [--png-dir DIR] [DATA_DIRECTORY_OR_FILE ...]
+#
+# Each argument is a directory of results (see perf_data.py for the
+# formats read), or a single results file, which is taken as a variant
+# named after the file.  With none, every ../*_data directory is read,
+# like make_tex.py.
+
+import argparse
+import math
+import os
+import sys
+
+import perf_data
+
+try:
+    from html import escape
+except ImportError:
+    from cgi import escape
+
+svg_colors = {'black': '#000000', 'blue': '#1f4fd1', 'red': '#d12a1f', 'green': '#2a9d3a', 'orange': '#e08a00', 'violet': '#8a2be2', 'brown': '#8b5a2b', 'cyan': '#00a5b5', 'magenta': '#c2188b', 'gray': '#777777'}
+
+def load(paths):
+    if not paths:
+        root = '..'
+        paths = sorted(os.path.join(root, d) for d in os.listdir(root) if d.endswith('_data'))
+    directories = [p for p in paths if os.path.isdir(p)]
+    data, compilers = perf_data.load_all(directories)
+    files = [p for p in paths if os.path.isfile(p)]
+    if files:
+        loose = {}
+        for f in files:
+            loose[os.path.splitext(os.path.basename(f))[0]] = perf_data.load_file(f)
+        data['files'] = loose
+        compilers.append('files')
+    return data, compilers
+
+def series(data, compiler, variant, element_type, operation):
+    rows = data[compiler].get(variant, {}).get(element_type, [])
+    points = []
+    for row in rows:
+        y = perf_data.value(row, operation)
+        if y is not None and 0 < y:
+            points.append((row['size'], y))
+    return points
+
+def svg_chart(title, lines, width=560, height=340):
+    """lines: [(label, color, [(x, y), ...])], drawn on log-log axes."""
+    all_points = [p for _, _, points in lines for p in points]
+    if not all_points:
+        return ''
+    left, right, top, bottom = 70, 150, 30, 45
+    xs = [math.log10(x) for x, _ in all_points]
+    ys = [math.log10(y) for _, y in all_points]
+    x0, x1 = math.floor(min(xs)), math.ceil(max(xs))
+    y0, y1 = math.floor(min(ys)), math.ceil(max(ys))
+    x1 = max(x1, x0 + 1)
+    y1 = max(y1, y0 + 1)
+
+    def px(x):
+        return left + (math.log10(x) - x0) / (x1 - x0) * (width - left - right)
+
+    def py(y):
+        return height - bottom - (math.log10(y) - y0) / (y1 - y0) * (height - top - bottom)
+
+    out = ['<svg xmlns="http://www.w3.org/2000/svg" width="{}" height="{}" font-family="sans-serif" font-size="11">'.format(width, height)]
+    out.append('<text x="{}" y="18" font-size="13" font-weight="bold">{}</text>'.format(left, escape(title)))
+    for e in range(int(x0), int(x1) + 1):
+        x = px(10 ** e)
+        out.append('<line x1="{0:.1f}" y1="{1}" x2="{0:.1f}" y2="{2}" stroke="#ddd"/>'.format(x, top, height - bottom))
+        out.append('<text x="{:.1f}" y="{}" text-anchor="middle">1e{}</text>'.format(x, height - bottom + 15, e))
+    for e in range(int(y0), int(y1) + 1):
+        y = py(10 ** e)
+        out.append('<line x1="{0}" y1="{1:.1f}" x2="{2}" y2="{1:.1f}" stroke="#ddd"/>'.format(left, y, width - right))
+        out.append('<text x="{}" y="{:.1f}" text-anchor="end">1e{}</text>'.format(left - 5, y + 4, e))
+    out.append('<text x="{}" y="{}" text-anchor="middle">map size</text>'.format((left + width - right) // 2, height - 8))
+    out.append('<text x="15" y="{0}" transform="rotate(-90 15 {0})" text-anchor="middle">ms</text>'.format((top + height - bottom) // 2))
+    for i, (label, color, points) in enumerate(lines):
+        if not points:
+            continue
+        stroke = svg_colors.get(color, color)
+        path = ' '.join('{:.1f},{:.1f}'.format(px(x), py(y)) for x, y in points)
+        out.append('<polyline fill="none" stroke="{}" stroke-width="2" points="{}"/>'.format(stroke, path))
+        ly = top + 15 * i + 10
+        out.append('<line x1="{0}" y1="{1}" x2="{2}" y2="{1}" stroke="{3}" stroke-width="2"/>'.format(width - right + 10, ly, width - right + 30, stroke))
+        out.append('<text x="{}" y="{}">{}</text>'.format(width - right + 35, ly + 4, escape(label)))
+    out.append('</svg>')
+    return '\n'.join(out)
+
+def png_chart(path, title, lines):
+    import matplotlib
+    matplotlib.use('Agg')
+    import matplotlib.pyplot as plt
+    fig, ax = plt.subplots(figsize=(7, 4.25))
+    for label, color, points in lines:
+        if points:
+            ax.plot([x for x, _ in points], [y for _, y in points], label=label, color=color)
+    ax.set_xscale('log')
+    ax.set_yscale('log')
+    ax.set_xlabel('map size')
+    ax.set_ylabel('ms')
+    ax.set_title(title)
+    ax.grid(True, which='major', linestyle='--', alpha=0.5)
+    ax.legend(loc='upper left', fontsize='small')
+    fig.tight_layout()
+    fig.savefig(path, dpi=100)
+    plt.close(fig)
+
+def speedup_table(data, compiler, variants, element_type, operation, baseline):
+    """baseline's time over each variant's, per size: above 1 is faster."""
+    base = dict(series(data, compiler, baseline, element_type, operation))
+    if not base:
+        return ''
+    others = [v for v in variants if v != baseline and series(data, compiler, v, element_type, operation)]
+    if not others:
+        return ''
+    rows = ['<table><tr><th>size</th>' + ''.join('<th>{}</th>'.format(escape(perf_data.pretty_variant_name(v))) for v in others) + '</tr>']
+    for size in sorted(base):
+        cells = []
+        for v in others:
+            times = dict(series(data, compiler, v, element_type, operation))
+            if size not in times:
+                cells.append('<td>-</td>')
+                continue
+            speedup = base[size] / times[size]
+            cls = speedup >= 1.0 and 'faster' or 'slower'
+            cells.append('<td class="{}">{:.2f}x</td>'.format(cls, speedup))
+        rows.append('<tr><td>{}</td>{}</tr>'.format(size, ''.join(cells)))
+    rows.append('</table>')
+    return '\n'.join(rows)
+
+def report(data, compilers, baseline, png_dir):
+    variants = perf_data.variants_of(data)
+    element_types = perf_data.element_types_of(data)
+    operations = perf_data.operations_of(data)
+    out = ['''<!DOCTYPE html>
+<html><head><meta charset="utf-8"><title>flat_map perf report</title>
+<style>
+body { font-family: sans-serif; margin: 2em; }
+table { border-collapse: collapse; margin: 0.5em 0 2em; }
+td, th { border: 1px solid #ccc; padding: 2px 8px; text-align: right; }
+td.faster { background: #e3f5e3; }
+td.slower { background: #f9e3e3; }
+.chart { display: inline-block; vertical-align: top; margin-right: 2em; }
+</style></head><body>
+<h1>flat_map perf report</h1>
+<p>Times are in ms for the whole map size, as perf_test reports them.
+Speedups are the time of BASELINE over each variant's: above 1x is faster.</p>
+'''.replace('BASELINE', escape(perf_data.pretty_variant_name(baseline)))]
+    for compiler in compilers:
+        out.append('<h2>{}</h2>'.format(escape(perf_data.pretty_compiler_name(compiler))))
+        for operation in operations:
+            for element_type in element_types:
+                lines = [
+                    (perf_data.pretty_variant_name(v), perf_data.variant_color(v, variants), series(data, compiler, v, element_type, operation))
+                    for v in variants]
+                title = '{} <{}, {}>'.format(operation, element_type, element_type)
+                chart = svg_chart(title, lines)
+                if not chart:
+                    continue
+                out.append('<h3>{}</h3>'.format(escape(title)))
+                out.append('<div class="chart">{}</div>'.format(chart))
+                out.append('<div class="chart">{}</div>'.format(speedup_table(data, compiler, variants, element_type, operation, baseline)))
+                if png_dir:
+                    name = '{}_{}_{}.png'.format(compiler, operation, element_type)
+                    png_chart(os.path.join(png_dir, name), '{}: {}'.format(compiler, title), lines)
+    out.append('</body></html>\n')
+    return '\n'.join(out)
+
+def main(argv):
+    parser = argparse.ArgumentParser(description='Writes an HTML report of perf results.')
+    parser.add_argument('--output', default='report.html')
+    parser.add_argument('--baseline', default='std_map', help='the variant speedups are relative to')
+    parser.add_argument('--png-dir', help='also write each chart as a PNG here (needs matplotlib)')
+    parser.add_argument('paths', nargs='*')
+    args = parser.parse_args(argv[1:])
+
+    data, compilers = load(args.paths)
+    if not compilers:
+        sys.stderr.write('no results found\n')
+        return 1
+    if args.png_dir:
+        try:
+            import matplotlib
+        except ImportError:
+            sys.stderr.write('--png-dir needs matplotlib\n')
+            return 1
+        if not os.path.isdir(args.png_dir):
+            os.makedirs(args.png_dir)
+    with open(args.output, 'w') as f:
+        f.write(report(data, compilers, args.baseline, args.png_dir))
+    print('wrote {}'.format(args.output))
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -2,32 +2,38 @@
 
 import math
 import os
+import re
 
-compiler_names = ['msvc', 'clang', 'gcc']
-compiler_data_paths = {
-    'msvc': os.path.join('..', 'windows_msvc_data'),
-    'clang': os.path.join('..', 'linux_clang_data'),
-    'gcc': os.path.join('..', 'linux_gcc_data')
-}
-pretty_compiler_names = {'msvc': 'Windows/MSVC 2015', 'clang': 'Mac OSX/Clang 4.0', 'gcc': 'Linux/GCC 6.2'}
-
-#variant_names = ['boost_flat_map', 'std_map', 'unordered_map', 'vector', 'vector_custom_pair']
-variant_names = ['boost_flat_map', 'std_map', 'split_map']
-#variant_colors = {'boost_flat_map': 'blue', 'std_map': 'red', 'unordered_map': 'brown', 'vector': 'green', 'vector_custom_pair': 'black'}
-variant_colors = {'boost_flat_map': 'blue', 'std_map': 'red', 'split_map': 'green'}
-
-#pretty_variant_names = {'boost_flat_map': 'Boost.FlatMap', 'std_map': 'std::map', 'unordered_map': 'std::unordered\\_map', 'vector': 'std::vector', 'vector_custom_pair': 'std::vector (custom pair)'}
-pretty_variant_names = {'boost_flat_map': 'Boost.FlatMap', 'std_map': 'std::map', 'split_map': 'split\\_map\\_t'}
-
-compiler_data = {}
-for c in compiler_names:
-    compiler_data[c] = {}
-    variant_data = compiler_data[c]
-    for v in variant_names:
-        execfile(os.path.join(compiler_data_paths[c], '{}.py'.format(v)))
-        variant_data[v] = {'int': int_timings, 'string': string_timings}
+import perf_data
+
+# The data directories, in the order of the graphs' rows; any directory
+# called <platform>_<compiler>_data next to these is picked up too.
+preferred_data_directories = ['windows_msvc_data', 'linux_clang_data', 'linux_gcc_data']
+
+def data_directories():
+    root = os.path.join('..')
+    found = [d for d in os.listdir(root) if d.endswith('_data') and os.path.isdir(os.path.join(root, d))]
+    ordered = [d for d in preferred_data_directories if d in found] + sorted(set(found) - set(preferred_data_directories))
+    return [os.path.join(root, d) for d in ordered]
+
+# A variant without data for a compiler is left out of its graphs; the
+# data for std_flat_map is newer than the rest.
+compiler_data, compiler_names = perf_data.load_all(data_directories())
+variant_names = perf_data.variants_of(compiler_data)
+
+def latex_escape(s):
+    return s.replace('_', '\\_')
+
+def pretty_compiler_name(c):
+    return latex_escape(perf_data.pretty_compiler_name(c))
+
+def pretty_variant_name(v):
+    return latex_escape(perf_data.pretty_variant_name(v))
+
+def variant_color(v):
+    return perf_data.variant_color(v, variant_names)
 
-element_type_marks = {'int': 'square', 'string': 'triangle'}
+element_type_marks = {'int': 'square', 'string': 'triangle', 'inline_string': 'diamond'}
 operation_colors = {'insert': 'red', 'iterate': 'green', 'erase': 'blue'}
 #operation_marks = {'insert': '+', 'iterate': 'o', 'find': '|', 'erase': '-'}
 operation_marks = {'insert': '|', 'iterate': '|', 'find': '|', 'erase': '|'}
@@ -39,11 +45,13 @@ non_power_of_2_initial = 10
 class plot_t:
     def __init__(
         self,
+        variant_name,
         color,
         mark,
         points,
         dashed
     ):
+        self.variant_name = variant_name
         self.color = color
         self.mark = mark
         self.points = points
@@ -85,30 +93,30 @@ def operation_graphs(operation, *element_types):
             ymax = 0
 
             for variant_name in variant_names:
+                if variant_name not in compiler_data[compiler_name]:
+                    continue
                 data = compiler_data[compiler_name][variant_name]
                 points = ''
-                for element in data[element_type]:
+                for element in data.get(element_type, []):
                     x = element['size']
-                    if len(operation_list) == 2:
-                        y = element[operation_list[0]]
-                        divisor = element[operation_list[1]]
-                        if divisor == 0:
-                            divisor = 0.00001
-                        y /= divisor
-                    else:
-                        y = element[operation]
+                    y = perf_data.value(element, operation)
+                    if y is None:
+                        continue
                     xmax = max(xmax, x)
                     ymax = max(ymax, y)
                     points += '({x},{y})'.format(**locals())
                 plots.append(
                     plot_t(
-                        variant_colors[variant_name],
+                        variant_name,
+                        variant_color(variant_name),
                         operation in operation_marks and operation_marks[operation] or '|',
                         points,
                         False # TODO: Perhaps use this to show multiple platforms on one chart.
                     )
                 )
 
+            if ymax <= 0:
+                ymax = 1
             y_step = math.pow(10, math.trunc(math.log10(ymax)))
             ymax = (math.trunc(ymax / y_step) + 1) * y_step
 
@@ -179,12 +187,12 @@ def operation_graphs(operation, *element_types):
             title = '{{{graph.title}}}'.format(**locals())
 
         xlabel = '\\empty'
-        if i / num_element_types == num_compilers - 1:
+        if i // num_element_types == num_compilers - 1:
             xlabel = '{N}'
 
         local_ylabel = '\\empty'
         if i % num_element_types == 0:
-            local_ylabel = '{{{}}}'.format(pretty_compiler_names[compiler_names[i / num_element_types]])
+            local_ylabel = '{{{}}}'.format(pretty_compiler_name(compiler_names[i // num_element_types]))
 
         retval += '''
     \\nextgroupplot[
@@ -209,16 +217,16 @@ def operation_graphs(operation, *element_types):
             dashed = plot.dashed and 'dashed' or ''
             retval += '''    \\addplot[color={plot.color},mark={plot.mark},no markers,{dashed}]
         coordinates {{{plot.points}}};
-        \\label{{plots:plot{j}}}
+        \\label{{plots:{plot.variant_name}}}
 
 '''.format(**locals())
 
         if i == 0:
-            retval += '''    \coordinate (top) at (rel axis cs:0,1);% coordinate at top of the first plot
+            retval += '''    \\coordinate (top) at (rel axis cs:0,1);% coordinate at top of the first plot
 
 '''
         if i == len(graphs) - 1:
-            retval += '''    \coordinate (bot) at (rel axis cs:1,0);% coordinate at bottom of the last plot
+            retval += '''    \\coordinate (bot) at (rel axis cs:1,0);% coordinate at bottom of the last plot
 
 '''
 
@@ -229,10 +237,10 @@ def operation_graphs(operation, *element_types):
           (myplot c1r{num_compilers}.outer south west);% plot in column 1 row {num_compilers}
 
     % legend
-    \path (myplot c1r{num_compilers}.south west|-current bounding box.south)--
+    \\path (myplot c1r{num_compilers}.south west|-current bounding box.south)--
       coordinate(legendpos)
       (myplot c{num_element_types}r{num_compilers}.south east|-current bounding box.south);
-    \matrix[
+    \\matrix[
         matrix of nodes,
         anchor=south,
         draw,
@@ -241,10 +249,9 @@ def operation_graphs(operation, *element_types):
       ]at([yshift=-5ex]legendpos)
       {{'''.format(**locals())
 
-    legends = map(lambda x: pretty_variant_names[x], variant_names)
-    for i in range(len(legends)):
+    for v in variant_names:
         retval += '''
-        \\ref{{plots:plot{}}}& {}&[5pt]'''.format(i, legends[i])
+        \\ref{{plots:{}}}& {}&[5pt]'''.format(v, pretty_variant_name(v))
 
     retval += '''\\\\
       };
@@ -256,14 +263,59 @@ def operation_graphs(operation, *element_types):
 
     return retval
 
-contents = open('../../paper/motivation_and_scope.in.tex', 'r').read()
-
-contents = contents.replace('%%% insert, int, string %%%', operation_graphs('insert', 'int', 'string'))
-contents = contents.replace('%%% iterate, int, string %%%', operation_graphs('iterate', 'int', 'string'))
-contents = contents.replace('%%% find, int, string %%%', operation_graphs('find', 'int', 'string'))
-#contents = contents.replace('%%% erase, int, string %%%', operation_graphs('erase', 'int', 'string'))
+# Read throughput against reader count, one graph per writer count, from
+# the concurrent_scaling.py that concurrent_scaling_perf writes.
+scaling_variants = ['locked', 'concurrent', 'sharded']
+scaling_colors = {'locked': 'red', 'concurrent': 'blue', 'sharded': 'green'}
+pretty_scaling_names = {'locked': 'flat\\_map + shared\\_mutex', 'concurrent': 'concurrent\\_flat\\_map', 'sharded': 'sharded\\_flat\\_map'}
 
-#contents = contents.replace('%%% insert/iterate, int, string %%%', operation_graphs('insert/iterate', 'int', 'string'))
-#contents = contents.replace('%%% insert/find, int, string %%%', operation_graphs('insert/find', 'int', 'string'))
+def scaling_graphs(timings):
+    writer_counts = sorted(set(t['writers'] for t in timings))
+    retval = '''\\begin{{tikzpicture}}
+    \\begin{{groupplot}}[group style={{group size={} by 1}}, width={}in, xlabel={{Readers}}, ymin=0, ymajorgrids=true, grid style=dashed]
+'''.format(len(writer_counts), 6.5 / len(writer_counts))
+    for i in range(len(writer_counts)):
+        writers = writer_counts[i]
+        rows = sorted([t for t in timings if t['writers'] == writers], key=lambda t: t['readers'])
+        ylabel = i == 0 and '{M reads/s}' or '\\empty'
+        retval += '''
+    \\nextgroupplot[title={{{} writers}}, ylabel={}]
+'''.format(writers, ylabel)
+        for v in scaling_variants:
+            points = ''.join('({},{})'.format(t['readers'], t[v]) for t in rows)
+            retval += '''    \\addplot[color={},mark=*] coordinates {{{}}};
+'''.format(scaling_colors[v], points)
+            if i == 0:
+                retval += '''    \\label{{plots:scaling_{}}}
+'''.format(v)
+    retval += '''    \\end{groupplot}
+\\end{tikzpicture}
+'''
+    for v in scaling_variants:
+        retval += '\\ref{{plots:scaling_{}}} {}\\quad\n'.format(v, pretty_scaling_names[v])
+    return retval
 
-open('../../paper/motivation_and_scope.tex', 'w').write(contents)
+if os.path.exists('concurrent_scaling.py'):
+    scope = {}
+    exec(open('concurrent_scaling.py').read(), scope)
+    open('concurrent_scaling.tex', 'w').write(scaling_graphs(scope['scaling_timings']))
+
+# Fills in each "%%% operation, element_type, ... %%%" placeholder, for any
+# operation (or ratio of two, as in insert/find) there is data for; the
+# placeholders for operations without data are left alone.
+template_path = os.path.join('..', '..', 'paper', 'motivation_and_scope.in.tex')
+if os.path.exists(template_path):
+    operations = perf_data.operations_of(compiler_data)
+
+    def fill_in(match):
+        operation = match.group(1)
+        if any(o not in operations for o in operation.split('/')):
+            return match.group(0)
+        element_types = [t.strip() for t in match.group(2).split(',')]
+        return operation_graphs(operation, *element_types)
+
+    contents = open(template_path, 'r').read()
+    contents = re.sub(r'%%% ([\w/]+), ([\w, ]+) %%%', fill_in, contents)
+    open(os.path.join('..', '..', 'paper', 'motivation_and_scope.tex'), 'w').write(contents)
+else:
+    print('{} not found; only the data was checked'.format(template_path))
@@ -0,0 +1,31 @@
+// Names the malloc implementation the perf tests run with, so that their
+// results can say which one they were measured under.  The allocators
+// other than glibc's are recognized by a function only they export, which
+// they do whether they are linked in or preloaded with LD_PRELOAD.
+
+#ifndef PERF_MALLOC_NAME_HPP
+#define PERF_MALLOC_NAME_HPP
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#endif
+
+
+inline char const * malloc_name()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    if (dlsym(RTLD_DEFAULT, "mallctl"))
+        return "jemalloc";
+    if (dlsym(RTLD_DEFAULT, "tc_malloc"))
+        return "tcmalloc";
+    if (dlsym(RTLD_DEFAULT, "mi_malloc"))
+        return "mimalloc";
+#endif
+#if defined(__GLIBC__)
+    return "glibc";
+#else
+    return "system";
+#endif
+}
+
+#endif
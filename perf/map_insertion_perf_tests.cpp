@@ -1,13 +1,34 @@
+#include "key_generators.hpp"
+#include "malloc_name.hpp"
+#include "perf_counters.hpp"
+
 #include <boost/container/flat_map.hpp>
+#include <boost/version.hpp>
+#if 108100 <= BOOST_VERSION
+#include <boost/unordered/unordered_flat_map.hpp>
+#define PERF_TEST_BOOST_UNORDERED_FLAT_MAP 1
+#else
+#define PERF_TEST_BOOST_UNORDERED_FLAT_MAP 0
+#endif
+#if PERF_TEST_ABSL
+#include <absl/container/btree_map.h>
+#include <absl/container/flat_hash_map.h>
+#endif
+#include <flat_map>
+#include <string_flat_map>
 
 #include <algorithm>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <numeric>
+#include <string>
 #include <vector>
 #include <random>
+#include <unordered_map>
 
 
 enum map_impl_kind
@@ -15,6 +36,14 @@ enum map_impl_kind
     boost_flat_map,
     std_map,
     split_map,
+    std_flat_map,
+    // The alternatives to a sorted map, which are measured where they are
+    // available: absl where perf/CMakeLists.txt finds it, and
+    // boost::unordered_flat_map from Boost 1.81 on.
+    std_unordered_map,
+    absl_flat_hash_map,
+    absl_btree_map,
+    boost_unordered_flat_map,
 
     num_map_impl_kinds
 };
@@ -36,7 +65,7 @@ struct split_map_t
     typename std::vector<U>::iterator find(T const & t)
     {
         auto const it = lower_bound(t);
-        if (it != values.end() && *it == t)
+        if (it != values.end() && keys[it - values.begin()] == t)
             return it;
         return values.end();
     }
@@ -44,7 +73,7 @@ struct split_map_t
     U& operator[](T const & t)
     {
         auto const values_it = lower_bound(t);
-        if (values_it != values.end() && *values_it == t)
+        if (values_it != values.end() && keys[values_it - values.begin()] == t)
             return *values_it;
         auto const keys_it = keys.begin() + (values_it - values.begin());
         keys.insert(keys_it, t);
@@ -61,7 +90,14 @@ struct split_map_t
         }
     }
 
-    std::vector<U> keys;
+    void erase(const_iterator first, const_iterator last)
+    {
+        auto const keys_first = keys.begin() + (first - values.cbegin());
+        keys.erase(keys_first, keys_first + (last - first));
+        values.erase(first, last);
+    }
+
+    std::vector<T> keys;
     std::vector<U> values;
 };
 
@@ -72,6 +108,28 @@ template <typename T, typename U>
 typename split_map_t<T, U>::const_iterator end(split_map_t<T, U> const & c)
 { return c.values.end(); }
 
+template <typename Map, typename Iter>
+void bulk_build(Map & map, Iter first, Iter last)
+{ map.insert(first, last); }
+
+template <typename T, typename U, typename Iter>
+void bulk_build(split_map_t<T, U> & map, Iter first, Iter last)
+{
+    std::vector<std::pair<T, U>> elements(first, last);
+    std::stable_sort(
+        elements.begin(), elements.end(), [](auto const & a, auto const & b) {
+            return a.first < b.first;
+        });
+    auto const unique_end = std::unique(
+        elements.begin(), elements.end(), [](auto const & a, auto const & b) {
+            return a.first == b.first;
+        });
+    for (auto it = elements.begin(); it != unique_end; ++it) {
+        map.keys.push_back(it->first);
+        map.values.push_back(it->second);
+    }
+}
+
 template <typename KeyType, typename ValueType, map_impl_kind MapImpl>
 struct map_impl
 {
@@ -90,16 +148,231 @@ struct map_impl<KeyType, ValueType, split_map>
     using type = split_map_t<KeyType, ValueType>;
 };
 
+template <typename KeyType, typename ValueType>
+struct map_impl<KeyType, ValueType, std_flat_map>
+{
+    using type = std::flat_map<KeyType, ValueType>;
+};
+
+template <typename KeyType, typename ValueType>
+struct map_impl<KeyType, ValueType, std_unordered_map>
+{
+    using type = std::unordered_map<KeyType, ValueType>;
+};
+
+#if PERF_TEST_ABSL
+template <typename KeyType, typename ValueType>
+struct map_impl<KeyType, ValueType, absl_flat_hash_map>
+{
+    using type = absl::flat_hash_map<KeyType, ValueType>;
+};
+
+template <typename KeyType, typename ValueType>
+struct map_impl<KeyType, ValueType, absl_btree_map>
+{
+    using type = absl::btree_map<KeyType, ValueType>;
+};
+#endif
+
+#if PERF_TEST_BOOST_UNORDERED_FLAT_MAP
+template <typename KeyType, typename ValueType>
+struct map_impl<KeyType, ValueType, boost_unordered_flat_map>
+{
+    using type = boost::unordered_flat_map<KeyType, ValueType>;
+};
+#endif
+
 template <typename KeyType, typename ValueType, map_impl_kind MapImpl>
 using map_impl_t = typename map_impl<KeyType, ValueType, MapImpl>::type;
 
+bool is_odd(int k)
+{ return k % 2 != 0; }
+
+bool is_odd(std::string const & k)
+{ return (k.back() - '0') % 2 != 0; }
+
+bool is_odd(std::inline_string<15> const & k)
+{ return (k.view().back() - '0') % 2 != 0; }
+
+// Erases the elements with odd keys, the way each map does it best.
+template <typename Map>
+void erase_odd(Map & map)
+{
+    for (auto it = map.begin(); it != map.end();) {
+        if (is_odd(it->first))
+            it = map.erase(it);
+        else
+            ++it;
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void erase_odd(std::flat_map<KeyType, ValueType> & map)
+{
+    std::erase_if(map, [](auto const & e) { return is_odd(e.first); });
+}
+
+template <typename KeyType, typename ValueType>
+void erase_odd(boost::container::flat_map<KeyType, ValueType> & map)
+{
+    auto seq = map.extract_sequence();
+    seq.erase(
+        std::remove_if(
+            seq.begin(),
+            seq.end(),
+            [](auto const & e) { return is_odd(e.first); }),
+        seq.end());
+    map.adopt_sequence(boost::container::ordered_unique_range, std::move(seq));
+}
+
+#if PERF_TEST_ABSL
+template <typename KeyType, typename ValueType>
+void erase_odd(absl::flat_hash_map<KeyType, ValueType> & map)
+{
+    absl::erase_if(map, [](auto const & e) { return is_odd(e.first); });
+}
+
+template <typename KeyType, typename ValueType>
+void erase_odd(absl::btree_map<KeyType, ValueType> & map)
+{
+    absl::erase_if(map, [](auto const & e) { return is_odd(e.first); });
+}
+#endif
+
+#if PERF_TEST_BOOST_UNORDERED_FLAT_MAP
+template <typename KeyType, typename ValueType>
+void erase_odd(boost::unordered_flat_map<KeyType, ValueType> & map)
+{
+    boost::unordered::erase_if(
+        map, [](auto const & e) { return is_odd(e.first); });
+}
+#endif
+
+template <typename T, typename U>
+void erase_odd(split_map_t<T, U> & map)
+{
+    std::size_t out = 0;
+    for (std::size_t i = 0; i < map.keys.size(); ++i) {
+        if (is_odd(map.keys[i]))
+            continue;
+        if (out != i) {
+            map.keys[out] = std::move(map.keys[i]);
+            map.values[out] = std::move(map.values[i]);
+        }
+        ++out;
+    }
+    map.keys.resize(out);
+    map.values.resize(out);
+}
+
+// The shape of the key stream, and the seed it is drawn from; set from the
+// command line.
+struct workload_t
+{
+    key_distribution distribution = key_distribution::uniform;
+    std::uint64_t seed = 42;
+};
+
+workload_t workload;
+
+// The sizes to run, and how; set from the command line.
+struct options_t
+{
+    std::size_t min_size = 8;
+    std::size_t max_size = 8u << 12;
+    std::size_t factor = 2;
+    // Above this size, each map is built with one range insert, instead of
+    // one insert per element among the fragmenting maps, which would take
+    // quadratic time and 64 times the memory.
+    std::size_t bulk_above = 8u << 12;
+    // Whether to evict the caches before each timed pass.
+    bool cold = false;
+    // Whether one-at-a-time inserts are interleaved with inserts into
+    // other maps, to fragment the heap the measured map grows in.
+    bool fragmented_heap = true;
+};
+
+options_t options;
+
+volatile char flush_sink;
+
+// Evicts the maps from the caches by reading and writing a buffer larger
+// than any last-level cache.
+void flush_caches()
+{
+    static std::vector<char> buffer(std::size_t(128) << 20);
+    char sum = 0;
+    for (std::size_t i = 0; i < buffer.size(); i += 64) {
+        sum += buffer[i]++;
+    }
+    flush_sink = sum;
+}
+
+char const * heap_name()
+{ return options.fragmented_heap ? "fragmented" : "clean"; }
+
+void maybe_flush_caches()
+{
+    if (options.cold)
+        flush_caches();
+}
+
+// The hardware counters, if they were asked for on the command line.
+perf_counters * counters = nullptr;
+
+void start_counters()
+{
+    if (counters)
+        counters->start();
+}
+
+void stop_counters()
+{
+    if (counters)
+        counters->stop();
+}
+
+// Writes the counts per operation since the last reset() next to op's
+// timing, as a dict called op + "_counters", and resets the counters.
+void report_counters(
+    std::string const & kind_name,
+    char const * op,
+    double operations,
+    std::ofstream & ofs)
+{
+    if (!counters)
+        return;
+    perf_counts_t const c = counters->read();
+    counters->reset();
+    ofs << "'" << op << "_counters': {";
+    std::cout << "  " << kind_name;
+    for (int k = 0; k < num_perf_counter_kinds; ++k) {
+        double const per_op =
+            c.counts[k] < 0.0 ? c.counts[k] : c.counts[k] / operations;
+        ofs << "'" << name(perf_counter_kind(k)) << "': " << per_op << ", ";
+        std::cout << name(perf_counter_kind(k)) << '=' << per_op << ' ';
+    }
+    ofs << "},";
+    std::cout << "per " << op << "\n";
+}
+
 template <typename KeyType>
 KeyType make_key(int x)
 { return x; }
 
 template <>
 std::string make_key(int x)
-{ return std::to_string(x); }
+{
+    if (workload.distribution == key_distribution::long_prefix)
+        return long_key_prefix() + std::to_string(x);
+    return std::to_string(x);
+}
+
+// The long_prefix distribution's keys would not fit, so inline_string keys
+// are always the short ones.
+template <>
+std::inline_string<15> make_key(int x)
+{ return std::inline_string<15>(std::to_string(x)); }
 
 template <typename ValueType>
 ValueType make_value()
@@ -113,6 +386,11 @@ template <typename T, typename U>
 auto value_of(std::pair<T, U> const & x)
 { return x.second; }
 
+// std::flat_map's iterators dereference to a proxy pair of references.
+template <typename T, typename U>
+auto value_of(std::__ref_pair<T, U> const & x)
+{ return x.second; }
+
 struct output_files_t
 {
     std::ofstream ofs[num_map_impl_kinds];
@@ -134,18 +412,46 @@ void test_map_type(std::string kind_name, std::vector<int> const & v, output_fil
 
     std::vector<map_t> maps(Iterations);
 
-    int const other_map_factor = 64;
+    bool const bulk = options.bulk_above < v.size();
+    int const other_map_factor = bulk || !options.fragmented_heap ? 0 : 64;
     std::vector<map_t> other_maps_were_not_measuring(other_map_factor * Iterations);
 
     output_files.ofs[MapImpl] << "    {'size': " << v.size() << ", ";
+    if (bulk)
+        output_files.ofs[MapImpl] << "'insert_mode': 'bulk', ";
 
     kind_name += ':';
     kind_name += std::string(40 - kind_name.size(), ' ');
 
-    {
+    if (bulk) {
+        std::vector<std::pair<KeyType, ValueType>> elements;
+        elements.reserve(v.size());
+        for (auto e : v) {
+            elements.emplace_back(make_key<KeyType>(e), make_value<ValueType>());
+        }
+        std::vector<double> times;
+        for (auto & map : maps) {
+            maybe_flush_caches();
+            start_counters();
+            auto start = std::chrono::high_resolution_clock::now();
+            bulk_build(map, elements.begin(), elements.end());
+            auto stop = std::chrono::high_resolution_clock::now();
+            stop_counters();
+            times.push_back(dur(stop - start).count() * 1000);
+        }
+        auto const elapsed = single_elapsed_value(times);
+        output_files.ofs[MapImpl] << "'insert': " << elapsed << ",";
+        std::cout << "  " << kind_name << elapsed << " ms bulk insert\n";
+        report_counters(
+            kind_name,
+            "insert",
+            double(Iterations) * v.size(),
+            output_files.ofs[MapImpl]);
+    } else {
         std::vector<double> times;
         for (int i = 0, size = (int)maps.size(); i < size; ++i) {
             map_t & map = maps[i];
+            maybe_flush_caches();
             double time = 0.0;
             for (auto e : v)
             {
@@ -158,9 +464,11 @@ void test_map_type(std::string kind_name, std::vector<int> const & v, output_fil
                     other_map[key] = make_value<ValueType>();
                 }
                 auto const key = make_key<KeyType>(e);
+                start_counters();
                 auto start = std::chrono::high_resolution_clock::now();
                 map[key] = make_value<ValueType>();
                 auto stop = std::chrono::high_resolution_clock::now();
+                stop_counters();
                 time += dur(stop - start).count() * 1000;
             }
             times.push_back(time);
@@ -168,6 +476,11 @@ void test_map_type(std::string kind_name, std::vector<int> const & v, output_fil
         auto const elapsed = single_elapsed_value(times);
         output_files.ofs[MapImpl] << "'insert': " << elapsed << ",";
         std::cout << "  " << kind_name << elapsed << " ms insert\n";
+        report_counters(
+            kind_name,
+            "insert",
+            double(Iterations) * v.size(),
+            output_files.ofs[MapImpl]);
     }
 
     {
@@ -175,12 +488,15 @@ void test_map_type(std::string kind_name, std::vector<int> const & v, output_fil
         int copy_count = 0; // To ensure the optimizer does not remove the loops below altogether, do some work.
         for (auto const & map : maps) {
             std::vector<ValueType> values(map.size());
+            maybe_flush_caches();
+            start_counters();
             auto start = std::chrono::high_resolution_clock::now();
             std::transform(
                 begin(map), end(map), begin(values),
                 [](auto const & elem){ return value_of(elem); }
             );
             auto stop = std::chrono::high_resolution_clock::now();
+            stop_counters();
             times.push_back(dur(stop - start).count() * 1000);
             for (auto x : values) {
                 ++copy_count;
@@ -189,6 +505,11 @@ void test_map_type(std::string kind_name, std::vector<int> const & v, output_fil
         auto const elapsed = single_elapsed_value(times);
         output_files.ofs[MapImpl] << "'iterate': " << elapsed << ",";
         std::cout << "  " << kind_name << elapsed << " ms iterate\n";
+        report_counters(
+            kind_name,
+            "iterate",
+            double(Iterations) * v.size(),
+            output_files.ofs[MapImpl]);
         if (copy_count == 2)
             std::cout << "  SURPRISE! copy_count=" << copy_count << "\n";
     }
@@ -198,14 +519,17 @@ void test_map_type(std::string kind_name, std::vector<int> const & v, output_fil
         int key_count = 0; // To ensure the optimizer does not remove the loops below altogether, do some work.
         for (auto & map : maps) {
             auto const end_ = end(map);
+            maybe_flush_caches();
             double time = 0.0;
             for (auto e : v) {
                 auto const key = make_key<KeyType>(e);
+                start_counters();
                 auto start = std::chrono::high_resolution_clock::now();
                 auto const it = map.find(key);
                 if (it != end_)
                     ++key_count;
                 auto stop = std::chrono::high_resolution_clock::now();
+                stop_counters();
                 time += dur(stop - start).count() * 1000;
             }
             times.push_back(time);
@@ -213,110 +537,258 @@ void test_map_type(std::string kind_name, std::vector<int> const & v, output_fil
         auto const elapsed = single_elapsed_value(times);
         output_files.ofs[MapImpl] << "'find': " << elapsed << ",";
         std::cout << "  " << kind_name << elapsed << " ms find\n";
+        report_counters(
+            kind_name,
+            "find",
+            double(Iterations) * v.size(),
+            output_files.ofs[MapImpl]);
         if (key_count == 2)
             std::cout << "  SURPRISE! key_count=" << key_count << "\n";
     }
 
+    // Each erase below shifts the elements after it, so erase at most 8K
+    // keys one at a time, to bound the time taken at large sizes.
+    std::size_t const single_erases = std::min<std::size_t>(v.size() / 2, 8192);
+
+    {
+        std::vector<double> times;
+        for (auto & map : maps) {
+            maybe_flush_caches();
+            double time = 0.0;
+            for (std::size_t i = 0; i < single_erases; ++i) {
+                auto const key = make_key<KeyType>(v[i]);
+                start_counters();
+                auto start = std::chrono::high_resolution_clock::now();
+                map.erase(key);
+                auto stop = std::chrono::high_resolution_clock::now();
+                stop_counters();
+                time += dur(stop - start).count() * 1000;
+            }
+            times.push_back(time);
+        }
+        auto const elapsed = single_elapsed_value(times);
+        output_files.ofs[MapImpl] << "'erase': " << elapsed << ",";
+        std::cout << "  " << kind_name << elapsed << " ms erase\n";
+        report_counters(
+            kind_name,
+            "erase",
+            double(Iterations) * single_erases,
+            output_files.ofs[MapImpl]);
+    }
+
+    {
+        // The second quarter of what is left.
+        std::vector<double> times;
+        std::size_t erased = 0;
+        for (auto & map : maps) {
+            auto const first = std::next(begin(map), map.size() / 4);
+            auto const last = std::next(first, map.size() / 4);
+            erased += map.size() / 4;
+            maybe_flush_caches();
+            start_counters();
+            auto start = std::chrono::high_resolution_clock::now();
+            map.erase(first, last);
+            auto stop = std::chrono::high_resolution_clock::now();
+            stop_counters();
+            times.push_back(dur(stop - start).count() * 1000);
+        }
+        auto const elapsed = single_elapsed_value(times);
+        output_files.ofs[MapImpl] << "'erase_range': " << elapsed << ",";
+        std::cout << "  " << kind_name << elapsed << " ms erase_range\n";
+        report_counters(
+            kind_name,
+            "erase_range",
+            double(erased ? erased : 1),
+            output_files.ofs[MapImpl]);
+    }
+
+    {
+        std::vector<double> times;
+        std::size_t visited = 0;
+        for (auto & map : maps) {
+            visited += map.size();
+            maybe_flush_caches();
+            start_counters();
+            auto start = std::chrono::high_resolution_clock::now();
+            erase_odd(map);
+            auto stop = std::chrono::high_resolution_clock::now();
+            stop_counters();
+            times.push_back(dur(stop - start).count() * 1000);
+        }
+        auto const elapsed = single_elapsed_value(times);
+        output_files.ofs[MapImpl] << "'erase_if': " << elapsed << ",";
+        std::cout << "  " << kind_name << elapsed << " ms erase_if\n";
+        report_counters(
+            kind_name,
+            "erase_if",
+            double(visited ? visited : 1),
+            output_files.ofs[MapImpl]);
+    }
+
     output_files.ofs[MapImpl] << "},\n";
 }
 
 template <typename KeyType, typename ValueType>
 void test(std::size_t size, output_files_t & output_files)
 {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> dist;
-
-    auto rand = [&]() {
-        return dist(gen);
-    };
-
-    std::vector<int> v(size);
-    std::generate(v.begin(), v.end(), rand);
+    std::vector<int> const v =
+        make_keys(workload.distribution, size, workload.seed);
 
     int const iterations = 7;
 
     test_map_type<KeyType, ValueType, boost_flat_map, iterations>("boost flat_map", v, output_files);
     test_map_type<KeyType, ValueType, std_map, iterations>("std::map", v, output_files);
     test_map_type<KeyType, ValueType, split_map, iterations>("split_map", v, output_files);
+    test_map_type<KeyType, ValueType, std_flat_map, iterations>("std::flat_map", v, output_files);
+    test_map_type<KeyType, ValueType, std_unordered_map, iterations>("std::unordered_map", v, output_files);
+#if PERF_TEST_ABSL
+    test_map_type<KeyType, ValueType, absl_flat_hash_map, iterations>("absl::flat_hash_map", v, output_files);
+    test_map_type<KeyType, ValueType, absl_btree_map, iterations>("absl::btree_map", v, output_files);
+#endif
+#if PERF_TEST_BOOST_UNORDERED_FLAT_MAP
+    test_map_type<KeyType, ValueType, boost_unordered_flat_map, iterations>("boost::unordered_flat_map", v, output_files);
+#endif
 
     std::cout << std::endl;
 }
 
-#define TEST(key_t, value_t, size)                              \
-    std::cout << "<" << #key_t << ", " << #value_t << ">, "     \
-              << (size) << " elements:\n";                      \
-    test<key_t, value_t>((size), output_files)
+template <typename KeyType, typename ValueType>
+void test_sizes(
+    char const * key_name,
+    char const * value_name,
+    output_files_t & output_files)
+{
+    for (std::size_t size = options.min_size; size <= options.max_size;
+         size *= options.factor) {
+        std::cout << "<" << key_name << ", " << value_name << ">, " << size
+                  << " elements:\n";
+        test<KeyType, ValueType>(size, output_files);
+    }
+}
+
+// Parses --name=value into value; false if arg is not --name=....
+bool parse_size_option(char const * arg, char const * name, std::size_t & value)
+{
+    std::size_t const n = std::strlen(name);
+    if (std::strncmp(arg, name, n) || arg[n] != '=')
+        return false;
+    value = std::strtoull(arg + n + 1, nullptr, 10);
+    return true;
+}
 
-int main()
+// Usage:
+//   perf_test [--counters] [--cold] [--heap=fragmented|clean]
+//             [--min-size=N] [--max-size=N] [--factor=N] [--bulk-above=N]
+//             [distribution [seed]]
+// where distribution is one of the names in key_generators.hpp; the
+// default is uniform keys from seed 42, and sizes 8, 16, ..., 32K.
+//
+// --counters also records the hardware counters in perf_counters.hpp
+// around each timed operation, and writes their means per operation (over
+// all iterations, where the timings drop the fastest and slowest) next to
+// the timings.  The counters cost two system calls an operation, which
+// slows the timings and evicts some of the cache, so take timings from a
+// run without them.
+//
+// --cold evicts the caches before each timed pass over a map, so that
+// small maps are measured out of cache too; large maps are out of cache
+// regardless.  Sizes above --bulk-above (32K by default) are built with
+// one range insert per map, reported as the insert time with
+// 'insert_mode': 'bulk'.  Every size holds 7 maps of each kind at once, so
+// 100M-element runs need a lot of memory.
+//
+// --heap=clean inserts into the measured maps alone, instead of among 64
+// other maps each (--heap=fragmented, the default).  The results record
+// the heap and the malloc they ran with; to measure another malloc, link
+// it in (see the perf_test_* targets) or preload it with LD_PRELOAD.
+int main(int argc, char * argv[])
 {
+    perf_counters hardware_counters;
+    std::vector<char const *> positional;
+    for (int i = 1; i < argc; ++i) {
+        char const * const arg = argv[i];
+        if (!std::strcmp(arg, "--counters")) {
+            if (hardware_counters.available())
+                counters = &hardware_counters;
+            else
+                std::cerr << "no hardware counters available; timing only\n";
+        } else if (!std::strcmp(arg, "--cold")) {
+            options.cold = true;
+        } else if (!std::strcmp(arg, "--heap=fragmented")) {
+            options.fragmented_heap = true;
+        } else if (!std::strcmp(arg, "--heap=clean")) {
+            options.fragmented_heap = false;
+        } else if (
+            !parse_size_option(arg, "--min-size", options.min_size) &&
+            !parse_size_option(arg, "--max-size", options.max_size) &&
+            !parse_size_option(arg, "--factor", options.factor) &&
+            !parse_size_option(arg, "--bulk-above", options.bulk_above)) {
+            positional.push_back(arg);
+        }
+    }
+    if (0 < positional.size())
+        workload.distribution = parse_key_distribution(positional[0]);
+    if (1 < positional.size())
+        workload.seed = std::strtoull(positional[1], nullptr, 10);
+    if (workload.distribution == key_distribution::num_key_distributions ||
+        2 < positional.size() || !options.min_size || options.factor < 2) {
+        std::cerr << "usage: " << argv[0]
+                  << " [--counters] [--cold] [--heap=fragmented|clean]"
+                     " [--min-size=N] [--max-size=N] [--factor=N]"
+                     " [--bulk-above=N] [distribution [seed]]\n"
+                  << "distributions:";
+        for (int i = 0; i < int(key_distribution::num_key_distributions); ++i) {
+            std::cerr << ' ' << name(key_distribution(i));
+        }
+        std::cerr << '\n';
+        return 1;
+    }
+    std::cout << "distribution=" << name(workload.distribution)
+              << " seed=" << workload.seed << (options.cold ? " cold" : "")
+              << " heap=" << heap_name() << " malloc=" << malloc_name()
+              << "\n\n";
+
     output_files_t output_files;
     output_files.ofs[boost_flat_map].open("boost_flat_map.py");
     output_files.ofs[std_map].open("std_map.py");
     output_files.ofs[split_map].open("split_map.py");
+    output_files.ofs[std_flat_map].open("std_flat_map.py");
+    output_files.ofs[std_unordered_map].open("std_unordered_map.py");
+#if PERF_TEST_ABSL
+    output_files.ofs[absl_flat_hash_map].open("absl_flat_hash_map.py");
+    output_files.ofs[absl_btree_map].open("absl_btree_map.py");
+#endif
+#if PERF_TEST_BOOST_UNORDERED_FLAT_MAP
+    output_files.ofs[boost_unordered_flat_map].open(
+        "boost_unordered_flat_map.py");
+#endif
 
     for (auto & of : output_files.ofs) {
-        of << "int_timings = [\n";
+        of << "distribution = '" << name(workload.distribution) << "'\n"
+           << "seed = " << workload.seed << "\n"
+           << "cold_cache = " << (options.cold ? "True" : "False") << "\n"
+           << "heap = '" << heap_name() << "'\n"
+           << "malloc = '" << malloc_name() << "'\n\n"
+           << "int_timings = [\n";
     }
 
-#if 1
-    TEST(int, int, 8u);
-    TEST(int, int, 8u << 1);
-    TEST(int, int, 8u << 2);
-    TEST(int, int, 8u << 3);
-    TEST(int, int, 8u << 4);
-    TEST(int, int, 8u << 5);
-    TEST(int, int, 8u << 6);
-    TEST(int, int, 8u << 7);
-    TEST(int, int, 8u << 8);
-    TEST(int, int, 8u << 9);
-    TEST(int, int, 8u << 10);
-    TEST(int, int, 8u << 11);
-    TEST(int, int, 8u << 12);
-#if 0
-    TEST(int, int, 8u << 13);
-    TEST(int, int, 8u << 14);
-    TEST(int, int, 8u << 15);
-#endif
-#else
-    TEST(int, int, 10u);
-    TEST(int, int, 100u);
-    TEST(int, int, 1000u);
-    TEST(int, int, 10000u);
-    TEST(int, int, 100000u);
-#endif
+    test_sizes<int, int>("int", "int", output_files);
 
     for (auto & of : output_files.ofs) {
         of << "]\n\n"
            << "string_timings = [\n";
     }
 
-#if 1
-    TEST(std::string, std::string, 8u);
-    TEST(std::string, std::string, 8u << 1);
-    TEST(std::string, std::string, 8u << 2);
-    TEST(std::string, std::string, 8u << 3);
-    TEST(std::string, std::string, 8u << 4);
-    TEST(std::string, std::string, 8u << 5);
-    TEST(std::string, std::string, 8u << 6);
-    TEST(std::string, std::string, 8u << 7);
-    TEST(std::string, std::string, 8u << 8);
-    TEST(std::string, std::string, 8u << 9);
-    TEST(std::string, std::string, 8u << 10);
-    TEST(std::string, std::string, 8u << 11);
-    TEST(std::string, std::string, 8u << 12);
-#if 0
-    TEST(std::string, std::string, 8u << 13);
-    TEST(std::string, std::string, 8u << 14);
-    TEST(std::string, std::string, 8u << 15);
-#endif
-#else
-    TEST(std::string, std::string, 10u);
-    TEST(std::string, std::string, 100u);
-    TEST(std::string, std::string, 1000u);
-    TEST(std::string, std::string, 10000u);
-    TEST(std::string, std::string, 100000u);
-#endif
+    test_sizes<std::string, std::string>(
+        "std::string", "std::string", output_files);
+
+    for (auto & of : output_files.ofs) {
+        of << "]\n\n"
+           << "inline_string_timings = [\n";
+    }
+
+    test_sizes<std::inline_string<15>, std::string>(
+        "std::inline_string<15>", "std::string", output_files);
 
     for (auto & of : output_files.ofs) {
         of << "]\n";
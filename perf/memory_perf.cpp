@@ -0,0 +1,177 @@
+// Measures memory rather than time: for std::flat_map, std::map and
+// boost::container::flat_map of <int, int> and <std::string, int>, prints
+// the heap bytes per element once the map is built, and the growth of the
+// peak resident set while it is built from an unsorted vector of
+// elements.  Heap bytes are counted by replacing the global operator new,
+// and include the allocator's rounding (malloc_usable_size) and an
+// estimated 8-byte chunk header per allocation, so they cover capacity
+// slack and per-node overhead.  For std::flat_map, memory_usage() is
+// printed too; it counts only the containers' element storage.  Expect
+// the flat maps to need about the size of their elements, plus up to 2x
+// growth slack when built one insert at a time (in sorted order, to keep
+// the run short), and std::map to need 32
+// or more bytes a node on top; and expect the flat maps' peak during a
+// bulk build to exceed their final size, because of the sorting buffers.
+// The peak RSS column is only filled where /proc/self/clear_refs can reset
+// the high-water mark (Linux).
+
+#include <boost/container/flat_map.hpp>
+#include <flat_map>
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+
+constexpr std::size_t chunk_header_bytes = 8;
+
+std::size_t live_bytes = 0;
+
+void * operator new(std::size_t n)
+{
+    void * const p = std::malloc(n ? n : 1);
+    if (!p)
+        throw std::bad_alloc();
+    live_bytes += malloc_usable_size(p) + chunk_header_bytes;
+    return p;
+}
+
+void operator delete(void * p) noexcept
+{
+    if (!p)
+        return;
+    live_bytes -= malloc_usable_size(p) + chunk_header_bytes;
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept { operator delete(p); }
+
+// Resets the peak resident set to the current one; false if the kernel
+// does not allow it.
+bool reset_peak_rss()
+{
+    std::ofstream ofs("/proc/self/clear_refs");
+    return ofs && (ofs << "5").flush();
+}
+
+// VmHWM, the peak resident set, in kB.
+long peak_rss_kb()
+{
+    std::ifstream ifs("/proc/self/status");
+    std::string line;
+    while (std::getline(ifs, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0)
+            return std::atol(line.c_str() + 6);
+    }
+    return -1;
+}
+
+long current_rss_kb()
+{
+    std::ifstream ifs("/proc/self/status");
+    std::string line;
+    while (std::getline(ifs, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0)
+            return std::atol(line.c_str() + 6);
+    }
+    return -1;
+}
+
+template <typename Key>
+Key make_key(int x)
+{ return x; }
+
+// Long enough to defeat the small-string optimization.
+template <>
+std::string make_key(int x)
+{ return "a_key_longer_than_sso_" + std::to_string(x); }
+
+template <typename Map>
+std::size_t memory_usage(Map const &)
+{ return 0; }
+
+template <typename Key, typename T>
+std::size_t memory_usage(std::flat_map<Key, T> const & map)
+{ return map.memory_usage(); }
+
+template <typename Map, typename Key>
+void measure(
+    char const * name,
+    std::vector<std::pair<Key, int>> const & elements)
+{
+    double const n = double(elements.size());
+
+    // One insert at a time, in order, so that the containers grow as
+    // they would under any insertion order, without the quadratic time.
+    auto sorted = elements;
+    std::sort(sorted.begin(), sorted.end());
+    std::size_t const before_inserts = live_bytes;
+    {
+        Map map;
+        for (auto const & e : sorted) {
+            map.emplace_hint(map.end(), e);
+        }
+        std::size_t const bytes = live_bytes - before_inserts;
+        std::size_t const usage = memory_usage(map);
+        std::printf(
+            "  %-16s %12.1f %12.1f",
+            name,
+            bytes / n,
+            usage ? usage / n : 0.0);
+    }
+
+    // Bulk build from the unsorted range.
+    bool const have_rss = reset_peak_rss();
+    long const rss_before = current_rss_kb();
+    std::size_t const before_bulk = live_bytes;
+    {
+        Map const map(elements.begin(), elements.end());
+        std::size_t const bytes = live_bytes - before_bulk;
+        std::printf(" %12.1f", bytes / n);
+    }
+    if (have_rss)
+        std::printf(" %12.1f\n", (peak_rss_kb() - rss_before) / 1024.0);
+    else
+        std::printf(" %12s\n", "n/a");
+}
+
+template <typename Key>
+void run(char const * type_name, std::size_t size)
+{
+    std::mt19937 gen(42);
+    std::vector<std::pair<Key, int>> elements;
+    elements.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        elements.emplace_back(make_key<Key>(int(gen() >> 1)), int(i));
+    }
+
+    std::printf("<%s, int>, %zu elements:\n", type_name, size);
+    std::printf(
+        "  %-16s %12s %12s %12s %12s\n",
+        "",
+        "B/elem",
+        "usage B/elem",
+        "bulk B/elem",
+        "bulk peak MB");
+    measure<std::flat_map<Key, int>>("std::flat_map", elements);
+    measure<boost::container::flat_map<Key, int>>("boost flat_map", elements);
+    measure<std::map<Key, int>>("std::map", elements);
+    std::printf("\n");
+}
+
+int main()
+{
+    for (std::size_t size : {1000u, 100000u, 1000000u}) {
+        run<int>("int", size);
+        run<std::string>("std::string", size);
+    }
+    return 0;
+}
@@ -0,0 +1,262 @@
+// A YCSB-style mixed workload: after preloading a map, runs a fixed
+// stream of reads, inserts, updates, erases and short scans against
+// std::flat_map, boost::container::flat_map and std::map, and prints each
+// one's throughput and its latency percentiles, per operation and
+// overall.  Every operation is timed on its own, so the latencies include
+// the cost of reading the clock, roughly 20ns; throughput is the whole
+// stream over its wall time, clock reads included.  The operation mix and
+// the (seeded, see key_generators.hpp) key stream are the same for every
+// map.  Expect the flat maps' inserts and erases to dominate their tails
+// once the map is large, since each shifts half the map on average.
+//
+// Usage: mixed_workload_perf [name=value ...], with the names and
+// defaults
+//   read=50 insert=20 update=20 erase=5 scan=5  (percentages)
+//   size=100000 ops=1000000 scan_length=100
+//   distribution=zipfian seed=42
+
+#include "key_generators.hpp"
+
+#include <boost/container/flat_map.hpp>
+#include <flat_map>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+
+enum op_kind
+{
+    read_op,
+    insert_op,
+    update_op,
+    erase_op,
+    scan_op,
+
+    num_op_kinds
+};
+
+char const * const op_names[num_op_kinds] = {
+    "read", "insert", "update", "erase", "scan"};
+
+struct options_t
+{
+    int ratios[num_op_kinds] = {50, 20, 20, 5, 5};
+    std::size_t size = 100000;
+    std::size_t ops = 1000000;
+    std::size_t scan_length = 100;
+    key_distribution distribution = key_distribution::zipfian;
+    std::uint64_t seed = 42;
+};
+
+struct operation_t
+{
+    op_kind kind;
+    int key;
+};
+
+struct workload_t
+{
+    std::vector<int> preload;
+    std::vector<operation_t> ops;
+};
+
+// Draws the keys of the operations from a key space twice the preloaded
+// size, so that about half the reads miss and inserts have room to add.
+workload_t make_workload(options_t const & opts)
+{
+    workload_t w;
+    std::vector<int> const space = make_keys(
+        key_distribution::uniform, 2 * opts.size, opts.seed);
+    w.preload.assign(space.begin(), space.begin() + opts.size);
+
+    std::vector<int> const picks =
+        make_keys(opts.distribution, opts.ops, opts.seed + 1);
+    std::mt19937_64 gen(opts.seed + 2);
+    int total = 0;
+    for (int r : opts.ratios) {
+        total += r;
+    }
+    for (std::size_t i = 0; i < opts.ops; ++i) {
+        int x = int(gen() % std::uint64_t(total));
+        int kind = 0;
+        while (opts.ratios[kind] <= x) {
+            x -= opts.ratios[kind++];
+        }
+        int const key = space[unsigned(picks[i]) % space.size()];
+        w.ops.push_back(operation_t{op_kind(kind), key});
+    }
+    return w;
+}
+
+template <typename Map>
+std::size_t run_op(Map & map, operation_t op, std::size_t scan_length)
+{
+    switch (op.kind) {
+    case read_op: {
+        auto const it = map.find(op.key);
+        return it == map.end() ? 0 : std::size_t(it->second);
+    }
+    case insert_op: return map.try_emplace(op.key, op.key).second;
+    case update_op: {
+        auto const it = map.find(op.key);
+        if (it == map.end())
+            return 0;
+        it->second += 1;
+        return 1;
+    }
+    case erase_op: return map.erase(op.key);
+    default: {
+        std::size_t sum = 0;
+        auto it = map.lower_bound(op.key);
+        for (std::size_t i = 0; i < scan_length && it != map.end();
+             ++i, ++it) {
+            sum += std::size_t(it->second);
+        }
+        return sum;
+    }
+    }
+}
+
+double percentile(std::vector<double> const & sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+    std::size_t const i = std::min(
+        sorted.size() - 1, std::size_t(p / 100.0 * double(sorted.size())));
+    return sorted[i];
+}
+
+void print_latencies(char const * name, std::vector<double> & ns)
+{
+    std::sort(ns.begin(), ns.end());
+    std::printf(
+        "  %-8s %9zu %10.0f %10.0f %10.0f %10.0f\n",
+        name,
+        ns.size(),
+        percentile(ns, 50.0),
+        percentile(ns, 99.0),
+        percentile(ns, 99.9),
+        ns.empty() ? 0.0 : ns.back());
+}
+
+template <typename Map>
+void run(char const * map_name, workload_t const & w, options_t const & opts)
+{
+    Map map;
+    for (int k : w.preload) {
+        map.try_emplace(k, k);
+    }
+
+    std::vector<double> latencies[num_op_kinds];
+    std::vector<double> all;
+    all.reserve(w.ops.size());
+    std::size_t sum = 0;
+    auto const start = std::chrono::steady_clock::now();
+    for (auto const & op : w.ops) {
+        auto const op_start = std::chrono::steady_clock::now();
+        sum += run_op(map, op, opts.scan_length);
+        auto const op_stop = std::chrono::steady_clock::now();
+        double const ns =
+            std::chrono::duration<double, std::nano>(op_stop - op_start)
+                .count();
+        latencies[op.kind].push_back(ns);
+        all.push_back(ns);
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    double const seconds = std::chrono::duration<double>(stop - start).count();
+
+    std::printf(
+        "%s: %.3f Mops/s, final size %zu (checksum %zu)\n",
+        map_name,
+        double(w.ops.size()) / seconds / 1e6,
+        map.size(),
+        sum);
+    std::printf(
+        "  %-8s %9s %10s %10s %10s %10s\n",
+        "op",
+        "count",
+        "p50 ns",
+        "p99 ns",
+        "p99.9 ns",
+        "max ns");
+    for (int k = 0; k < num_op_kinds; ++k) {
+        if (!latencies[k].empty())
+            print_latencies(op_names[k], latencies[k]);
+    }
+    print_latencies("all", all);
+    std::printf("\n");
+}
+
+bool parse_option(options_t & opts, std::string const & arg)
+{
+    auto const eq = arg.find('=');
+    if (eq == std::string::npos)
+        return false;
+    std::string const name = arg.substr(0, eq);
+    char const * const value = arg.c_str() + eq + 1;
+    for (int k = 0; k < num_op_kinds; ++k) {
+        if (name == op_names[k]) {
+            opts.ratios[k] = std::atoi(value);
+            return 0 <= opts.ratios[k];
+        }
+    }
+    if (name == "size")
+        opts.size = std::strtoull(value, nullptr, 10);
+    else if (name == "ops")
+        opts.ops = std::strtoull(value, nullptr, 10);
+    else if (name == "scan_length")
+        opts.scan_length = std::strtoull(value, nullptr, 10);
+    else if (name == "seed")
+        opts.seed = std::strtoull(value, nullptr, 10);
+    else if (name == "distribution")
+        opts.distribution = parse_key_distribution(value);
+    else
+        return false;
+    return opts.distribution != key_distribution::num_key_distributions &&
+           opts.size;
+}
+
+int main(int argc, char * argv[])
+{
+    options_t opts;
+    for (int i = 1; i < argc; ++i) {
+        if (!parse_option(opts, argv[i])) {
+            std::fprintf(stderr, "bad option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    int total = 0;
+    for (int r : opts.ratios) {
+        total += r;
+    }
+    if (!total) {
+        std::fprintf(stderr, "the operation ratios add up to 0\n");
+        return 1;
+    }
+
+    std::printf(
+        "read=%d insert=%d update=%d erase=%d scan=%d size=%zu ops=%zu "
+        "scan_length=%zu distribution=%s seed=%llu\n\n",
+        opts.ratios[read_op],
+        opts.ratios[insert_op],
+        opts.ratios[update_op],
+        opts.ratios[erase_op],
+        opts.ratios[scan_op],
+        opts.size,
+        opts.ops,
+        opts.scan_length,
+        name(opts.distribution),
+        (unsigned long long)opts.seed);
+
+    workload_t const w = make_workload(opts);
+    run<std::flat_map<int, int>>("std::flat_map", w, opts);
+    run<boost::container::flat_map<int, int>>("boost flat_map", w, opts);
+    run<std::map<int, int>>("std::map", w, opts);
+    return 0;
+}
@@ -0,0 +1,126 @@
+// Measures how flat_map sorts bulk input that arrives nearly sorted, as
+// the concatenation of several sorted feeds.  For 1M elements in 1, 4, 16,
+// ... up to 64K ascending runs of equal length, prints the milliseconds
+// to build a map from key and value containers (which sorts without
+// stability) and by insert() of the pairs (which sorts stably), and to
+// build it from the same elements shuffled, which must be sorted from
+// scratch.  Runs are merged by __zip_natural_sort() while they average
+// __natural_run_min elements or more (512 for the int keys, which can be
+// radix sorted, and 128 for strings), so with few runs the first two
+// columns should be far below the shuffled ones, and should approach
+// them as the runs shorten.  Int keys are radix sorted when shuffled, so
+// their margin is smaller than that of string keys.
+
+#include <flat_map>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+
+constexpr std::size_t size = 1 << 20;
+constexpr int repetitions = 5;
+
+template <typename F>
+double fastest_ms(F f)
+{
+    double best = 1e300;
+    for (int r = 0; r < repetitions; ++r) {
+        auto const start = std::chrono::steady_clock::now();
+        std::size_t const n = f();
+        auto const stop = std::chrono::steady_clock::now();
+        if (n != size)
+            std::puts("");
+        best = std::min(
+            best,
+            std::chrono::duration<double, std::milli>(stop - start).count());
+    }
+    return best;
+}
+
+template <typename Key>
+Key make_key(std::uint64_t x)
+{ return Key(x); }
+
+template <>
+std::string make_key(std::uint64_t x)
+{ return "key/" + std::to_string(x); }
+
+// The keys of runs ascending runs, each drawn from the whole key range,
+// so that every run overlaps the others.  The keys are unique.
+template <typename Key>
+std::vector<Key> run_keys(std::size_t runs, std::mt19937_64 & gen)
+{
+    std::vector<std::uint64_t> ids(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        ids[i] = i * 0x9e3779b97f4a7c15ull >> 8;
+    }
+    std::shuffle(ids.begin(), ids.end(), gen);
+    std::vector<Key> keys;
+    keys.reserve(size);
+    for (std::size_t r = 0; r < runs; ++r) {
+        std::size_t const first = size * r / runs;
+        std::size_t const last = size * (r + 1) / runs;
+        std::vector<Key> run;
+        for (std::size_t i = first; i < last; ++i) {
+            run.push_back(make_key<Key>(ids[i]));
+        }
+        std::sort(run.begin(), run.end());
+        keys.insert(keys.end(), run.begin(), run.end());
+    }
+    return keys;
+}
+
+template <typename Key>
+void run(char const * name)
+{
+    using map_t = std::flat_map<Key, int>;
+    std::mt19937_64 gen(42);
+    for (std::size_t runs = 1; runs <= (std::size_t(1) << 16); runs *= 4) {
+        std::vector<Key> const keys = run_keys<Key>(runs, gen);
+        std::vector<int> const values(size, 1);
+        std::vector<std::pair<Key, int>> pairs;
+        for (auto const & k : keys) {
+            pairs.emplace_back(k, 1);
+        }
+        std::vector<Key> shuffled_keys = keys;
+        std::shuffle(shuffled_keys.begin(), shuffled_keys.end(), gen);
+        std::vector<std::pair<Key, int>> shuffled_pairs = pairs;
+        std::shuffle(shuffled_pairs.begin(), shuffled_pairs.end(), gen);
+
+        auto const from_containers = [](std::vector<Key> const & k,
+                                        std::vector<int> const & v) {
+            return [&] { return map_t(k, v).size(); };
+        };
+        auto const by_insert = [](auto const & p) {
+            return [&] {
+                map_t map;
+                map.insert(p.begin(), p.end());
+                return map.size();
+            };
+        };
+        std::printf(
+            "%-8s %6zu %10.2f %10.2f %10.2f %10.2f\n",
+            name,
+            runs,
+            fastest_ms(from_containers(keys, values)),
+            fastest_ms(by_insert(pairs)),
+            fastest_ms(from_containers(shuffled_keys, values)),
+            fastest_ms(by_insert(shuffled_pairs)));
+    }
+}
+
+int main()
+{
+    std::printf(
+        "%zu elements, ms            runs  shuffled\n"
+        "keys       runs containers     insert containers     insert\n",
+        size);
+    run<std::int64_t>("int64");
+    run<std::string>("string");
+    return 0;
+}
@@ -0,0 +1,185 @@
+// The reduced benchmark set behind the perf_check target: times the hot
+// paths of std::flat_map -- lookups, inserts, erases and iteration -- at a
+// cache-resident and a larger size, and prints the results as JSON for
+// perf_check.py to compare against perf_baseline.json.  Each benchmark
+// reports the fastest of several repetitions, in nanoseconds per
+// operation, since the minimum is the figure least disturbed by other load
+// on the machine.  A calibration benchmark that does not touch flat_map is
+// reported too, so that perf_check.py can compare times relative to the
+// machine's speed rather than absolute times.
+//
+// Usage: perf_check_bench [repetitions]
+
+#include "key_generators.hpp"
+
+#include <flat_map>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+std::size_t repetitions = 7;
+
+std::size_t sink = 0;
+
+// The fastest of the repetitions of f(), which performs ops operations, in
+// ns per operation.  setup() runs untimed before each repetition.
+double time_ns(
+    std::size_t ops,
+    std::function<void()> const & setup,
+    std::function<void()> const & f)
+{
+    double best = 0.0;
+    for (std::size_t i = 0; i < repetitions; ++i) {
+        setup();
+        auto const start = std::chrono::steady_clock::now();
+        f();
+        auto const stop = std::chrono::steady_clock::now();
+        double const ns =
+            std::chrono::duration<double, std::nano>(stop - start).count() /
+            double(ops);
+        if (!i || ns < best)
+            best = ns;
+    }
+    return best;
+}
+
+bool first_result = true;
+
+void report(std::string const & name, double ns)
+{
+    std::printf(
+        "%s\n        \"%s\": %.3f",
+        first_result ? "" : ",",
+        name.c_str(),
+        ns);
+    first_result = false;
+}
+
+template <typename Key>
+Key make_key(int x)
+{ return x; }
+
+template <>
+std::string make_key(int x)
+{ return "key_" + std::to_string(x); }
+
+// Sorts and binary-searches plain vectors; its speed follows the machine's
+// rather than flat_map's.
+double calibration()
+{
+    std::vector<int> const keys =
+        make_keys(key_distribution::uniform, 1 << 16, 7);
+    std::vector<int> v;
+    return time_ns(
+        2 * keys.size(),
+        [&] { v = keys; },
+        [&] {
+            std::sort(v.begin(), v.end());
+            for (int k : keys) {
+                sink += std::lower_bound(v.begin(), v.end(), k) - v.begin();
+            }
+        });
+}
+
+template <typename Key>
+void run(char const * type_name, std::size_t size)
+{
+    using map_t = std::flat_map<Key, int>;
+
+    // Even keys are in the map, odd keys are not.
+    std::vector<int> const ints = make_keys(key_distribution::uniform, size, 42);
+    std::vector<Key> hits;
+    std::vector<Key> misses;
+    for (int i : ints) {
+        hits.push_back(make_key<Key>(i & ~1));
+        misses.push_back(make_key<Key>(i | 1));
+    }
+    std::vector<std::pair<Key, int>> elements;
+    for (auto const & k : hits) {
+        elements.emplace_back(k, 0);
+    }
+    map_t const full(elements.begin(), elements.end());
+    auto sorted = elements;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::string const suffix =
+        std::string("/") + type_name + "/" + std::to_string(size);
+    map_t map;
+
+    report("find_hit" + suffix, time_ns(hits.size(), [] {}, [&] {
+        for (auto const & k : hits) {
+            sink += full.find(k) != full.end();
+        }
+    }));
+    report("find_miss" + suffix, time_ns(misses.size(), [] {}, [&] {
+        for (auto const & k : misses) {
+            sink += full.find(k) != full.end();
+        }
+    }));
+    // A single pass takes only microseconds, so time several.
+    report("iterate" + suffix, time_ns(16 * full.size(), [] {}, [&] {
+        for (int pass = 0; pass < 16; ++pass) {
+            for (auto const & element : full) {
+                sink += std::size_t(element.second);
+            }
+        }
+    }));
+    report("emplace_hint_end" + suffix, time_ns(
+        sorted.size(),
+        [&] { map.clear(); },
+        [&] {
+            for (auto const & e : sorted) {
+                map.emplace_hint(map.end(), e.first, e.second);
+            }
+        }));
+    report("bulk_insert" + suffix, time_ns(
+        elements.size(),
+        [&] {
+            map.clear();
+            map.insert(
+                elements.begin(), elements.begin() + elements.size() / 2);
+        },
+        [&] {
+            map.insert(
+                elements.begin() + elements.size() / 2, elements.end());
+        }));
+    // One insert and one erase at a time shift the elements after them,
+    // so keep these to at most 8K elements to bound the run time.
+    std::size_t const shifting = std::min<std::size_t>(size, 1 << 13);
+    report("insert" + suffix, time_ns(
+        shifting,
+        [&] { map.clear(); },
+        [&] {
+            for (std::size_t i = 0; i < shifting; ++i) {
+                map.try_emplace(hits[i], 0);
+            }
+        }));
+    report("erase" + suffix, time_ns(
+        shifting,
+        [&] { map = full; },
+        [&] {
+            for (std::size_t i = 0; i < shifting; ++i) {
+                sink += map.erase(hits[i]);
+            }
+        }));
+}
+
+int main(int argc, char * argv[])
+{
+    if (1 < argc)
+        repetitions = std::max<std::size_t>(1, std::strtoull(argv[1], nullptr, 10));
+
+    std::printf("{\n    \"calibration\": %.3f,\n    \"benchmarks\": {", calibration());
+    run<int>("int", 1 << 10);
+    run<int>("int", 1 << 16);
+    run<std::string>("string", 1 << 10);
+    run<std::string>("string", 1 << 16);
+    std::printf("\n    }\n}\n");
+    return sink == std::size_t(-1);
+}
@@ -0,0 +1,95 @@
+#!/usr/bin/env python
+
+# Runs perf_check_bench and compares its results against a baseline,
+# exiting non-zero if any benchmark regressed by more than its tolerance.
+# Times are compared relative to the calibration benchmark, so that a
+# baseline taken on one machine still means something on another of the
+# same kind; a baseline from a very different machine or compiler should
+# be regenerated with --update rather than trusted.
+#
+# Usage: perf_check.py BENCH_EXECUTABLE BASELINE_JSON [--update]
+#
+# The baseline holds the calibration time, a default tolerance, and for
+# each benchmark its time and, optionally, its own tolerance, e.g.
+#     {"calibration": 3.1, "tolerance": 0.25,
+#      "benchmarks": {"find_hit/int/1024": {"ns": 4.2, "tolerance": 0.4}}}
+# --update rewrites the times from a fresh run and keeps the tolerances.
+
+import json
+import subprocess
+import sys
+
+def run_benchmarks(executable):
+    output = subprocess.check_output([executable])
+    return json.loads(output.decode('utf-8'))
+
+def update(baseline_path, results):
+    try:
+        with open(baseline_path) as f:
+            baseline = json.load(f)
+    except (IOError, ValueError):
+        baseline = {'tolerance': 0.25, 'benchmarks': {}}
+    old = baseline.get('benchmarks', {})
+    benchmarks = {}
+    for name, ns in results['benchmarks'].items():
+        entry = {'ns': ns}
+        if name in old and 'tolerance' in old[name]:
+            entry['tolerance'] = old[name]['tolerance']
+        benchmarks[name] = entry
+    baseline['calibration'] = results['calibration']
+    baseline['benchmarks'] = benchmarks
+    with open(baseline_path, 'w') as f:
+        json.dump(baseline, f, indent=4, sort_keys=True)
+        f.write('\n')
+    print('wrote {} benchmarks to {}'.format(len(benchmarks), baseline_path))
+    return 0
+
+def check(baseline_path, results):
+    with open(baseline_path) as f:
+        baseline = json.load(f)
+    default_tolerance = baseline.get('tolerance', 0.25)
+    speed = results['calibration'] / baseline['calibration']
+    print('calibration: {:.3f} ns, baseline {:.3f} ns (machine speed ratio {:.2f})'.format(
+        results['calibration'], baseline['calibration'], speed))
+    print('{:<32} {:>10} {:>10} {:>8} {:>6}'.format(
+        'benchmark', 'ns', 'expected', 'ratio', 'limit'))
+
+    regressions = []
+    for name in sorted(results['benchmarks']):
+        ns = results['benchmarks'][name]
+        if name not in baseline['benchmarks']:
+            print('{:<32} {:>10.2f} {:>10} {:>8} {:>6}  new'.format(name, ns, '-', '-', '-'))
+            continue
+        entry = baseline['benchmarks'][name]
+        expected = entry['ns'] * speed
+        tolerance = entry.get('tolerance', default_tolerance)
+        ratio = ns / expected if expected else 1.0
+        status = ''
+        if 1.0 + tolerance < ratio:
+            status = '  REGRESSION'
+            regressions.append(name)
+        elif ratio < 1.0 / (1.0 + tolerance):
+            status = '  faster; consider --update'
+        print('{:<32} {:>10.2f} {:>10.2f} {:>8.2f} {:>6.2f}{}'.format(
+            name, ns, expected, ratio, 1.0 + tolerance, status))
+    for name in sorted(baseline['benchmarks']):
+        if name not in results['benchmarks']:
+            print('{:<32} missing from this run'.format(name))
+
+    if regressions:
+        print('{} regression(s): {}'.format(len(regressions), ', '.join(regressions)))
+        return 1
+    print('no regressions')
+    return 0
+
+def main(argv):
+    if len(argv) not in (3, 4) or (len(argv) == 4 and argv[3] != '--update'):
+        sys.stderr.write('usage: {} BENCH_EXECUTABLE BASELINE_JSON [--update]\n'.format(argv[0]))
+        return 2
+    results = run_benchmarks(argv[1])
+    if len(argv) == 4:
+        return update(argv[2], results)
+    return check(argv[2], results)
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,196 @@
+// Hardware performance counters for the perf tests, read through Linux's
+// perf_event_open.  Counts user-space events only, so that it works at the
+// default perf_event_paranoid level of 2.  Elsewhere, or where the kernel
+// or the (virtual) machine does not expose a counter, that counter reads
+// as unavailable and the rest still count.
+
+#ifndef PERF_PERF_COUNTERS_HPP
+#define PERF_PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+enum perf_counter_kind
+{
+    cycles_counter,
+    instructions_counter,
+    branch_misses_counter,
+    l1d_misses_counter,
+    llc_misses_counter,
+    dtlb_misses_counter,
+    l1i_misses_counter,
+
+    num_perf_counter_kinds
+};
+
+inline char const * name(perf_counter_kind k)
+{
+    switch (k) {
+    case cycles_counter: return "cycles";
+    case instructions_counter: return "instructions";
+    case branch_misses_counter: return "branch_misses";
+    case l1d_misses_counter: return "l1d_misses";
+    case llc_misses_counter: return "llc_misses";
+    case dtlb_misses_counter: return "dtlb_misses";
+    case l1i_misses_counter: return "l1i_misses";
+    default: return "unknown";
+    }
+}
+
+// The counts accumulated between calls to start() and stop(), scaled up
+// for any time the kernel multiplexed a counter out; -1 for a counter that
+// could not be opened.
+struct perf_counts_t
+{
+    double counts[num_perf_counter_kinds];
+};
+
+// Opens all the counters as one group, which starts disabled; start() and
+// stop() enable and disable the whole group, and read() returns the counts
+// since construction or the last reset().  Each start() and stop() is a
+// system call, so bracket work much longer than that with them.
+class perf_counters
+{
+public:
+    perf_counters()
+    {
+        for (int & fd : fds_) {
+            fd = -1;
+        }
+#if defined(__linux__)
+        for (int k = 0; k < num_perf_counter_kinds; ++k) {
+            open(perf_counter_kind(k));
+        }
+#endif
+    }
+
+    ~perf_counters()
+    {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd != -1)
+                close(fd);
+        }
+#endif
+    }
+
+    perf_counters(perf_counters const &) = delete;
+    perf_counters & operator=(perf_counters const &) = delete;
+
+    // True if at least one counter is open.
+    bool available() const
+    { return leader_ != -1; }
+
+    void start()
+    {
+#if defined(__linux__)
+        if (leader_ != -1)
+            ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    void stop()
+    {
+#if defined(__linux__)
+        if (leader_ != -1)
+            ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    void reset()
+    {
+#if defined(__linux__)
+        if (leader_ != -1)
+            ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    perf_counts_t read() const
+    {
+        perf_counts_t result;
+        for (int k = 0; k < num_perf_counter_kinds; ++k) {
+            result.counts[k] = -1.0;
+#if defined(__linux__)
+            // value, time enabled, time running.
+            std::uint64_t values[3] = {0, 0, 0};
+            if (fds_[k] == -1 ||
+                ::read(fds_[k], values, sizeof(values)) != sizeof(values)) {
+                continue;
+            }
+            result.counts[k] = values[2]
+                ? double(values[0]) * double(values[1]) / double(values[2])
+                : 0.0;
+#endif
+        }
+        return result;
+    }
+
+private:
+#if defined(__linux__)
+    void open(perf_counter_kind k)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = leader_ == -1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format =
+            PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        auto const cache_miss = [](std::uint64_t cache) {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        };
+        switch (k) {
+        case cycles_counter:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case instructions_counter:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case branch_misses_counter:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case l1d_misses_counter:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache_miss(PERF_COUNT_HW_CACHE_L1D);
+            break;
+        case llc_misses_counter:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache_miss(PERF_COUNT_HW_CACHE_LL);
+            break;
+        case dtlb_misses_counter:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache_miss(PERF_COUNT_HW_CACHE_DTLB);
+            break;
+        default:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache_miss(PERF_COUNT_HW_CACHE_L1I);
+            break;
+        }
+
+        int const fd =
+            int(syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0));
+        fds_[k] = fd;
+        if (fd != -1 && leader_ == -1)
+            leader_ = fd;
+    }
+#endif
+
+    int fds_[num_perf_counter_kinds];
+    int leader_ = -1;
+};
+
+#endif
@@ -0,0 +1,188 @@
+# Loads the perf tests' results for make_tex.py and make_report.py.
+#
+# Results are kept as
+#     data[compiler][variant][element_type] = [{'size': N, op: ms, ...}, ...]
+# with one dict per map size, in the shape perf_test writes.  They can be
+# read from:
+#   - perf_test's <variant>.py files, which assign int_timings,
+#     string_timings and inline_string_timings;
+#   - <variant>.json files holding the same lists under the same names;
+#   - Google Benchmark JSON (flat_map_benchmarks --benchmark_format=json),
+#     whose benchmarks are named op<key_type>/size; their times are
+#     converted to ms for the whole map size, like perf_test's.
+# Every operation found is kept, so new operations and variants need no
+# changes here.
+#
+# Works with Python 2 and 3.
+
+import json
+import os
+import re
+
+# Names and colors for the variants perf_test knows; others get their file
+# name and the next unused color.
+pretty_variant_names = {
+    'boost_flat_map': 'Boost.FlatMap',
+    'std_map': 'std::map',
+    'split_map': 'split_map_t',
+    'std_flat_map': 'std::flat_map',
+    'std_unordered_map': 'std::unordered_map',
+    'absl_flat_hash_map': 'absl::flat_hash_map',
+    'absl_btree_map': 'absl::btree_map',
+    'boost_unordered_flat_map': 'boost::unordered_flat_map',
+}
+variant_colors = {
+    'boost_flat_map': 'blue',
+    'std_map': 'red',
+    'split_map': 'green',
+    'std_flat_map': 'black',
+    'std_unordered_map': 'orange',
+    'absl_flat_hash_map': 'violet',
+    'absl_btree_map': 'brown',
+    'boost_unordered_flat_map': 'cyan',
+}
+spare_colors = ['magenta', 'gray', 'olive', 'teal', 'purple', 'lime']
+
+pretty_compiler_names = {
+    'msvc': 'Windows/MSVC 2015',
+    'clang': 'Mac OSX/Clang 4.0',
+    'gcc': 'Linux/GCC 6.2',
+}
+
+# The keys of a size's dict that are not an operation's time.
+non_operation_keys = set(['size', 'insert_mode'])
+
+def is_operation(key):
+    return key not in non_operation_keys and not key.endswith('_counters')
+
+def pretty_variant_name(variant):
+    return pretty_variant_names.get(variant, variant)
+
+def pretty_compiler_name(compiler):
+    return pretty_compiler_names.get(compiler, compiler)
+
+def variant_color(variant, variants):
+    if variant in variant_colors:
+        return variant_colors[variant]
+    unknown = [v for v in variants if v not in variant_colors]
+    return spare_colors[unknown.index(variant) % len(spare_colors)]
+
+def _element_type(key_type):
+    return key_type == 'std::string' and 'string' or key_type
+
+def _load_google_benchmark(results):
+    timings = {}
+    pattern = re.compile(r'^(\w+)<([\w:]+)>/(\d+)$')
+    for b in results['benchmarks']:
+        if b.get('run_type', 'iteration') != 'iteration':
+            continue
+        m = pattern.match(b['name'])
+        if not m:
+            continue
+        operation, key_type, size = m.group(1), m.group(2), int(m.group(3))
+        if 'items_per_second' in b:
+            ms = size / b['items_per_second'] * 1000.0
+        else:
+            scale = {'ns': 1e-6, 'us': 1e-3, 'ms': 1.0, 's': 1000.0}
+            ms = b['real_time'] * scale[b.get('time_unit', 'ns')]
+        rows = timings.setdefault(_element_type(key_type) + '_timings', {})
+        rows.setdefault(size, {'size': size})[operation] = ms
+    return dict(
+        (name, [rows[size] for size in sorted(rows)])
+        for name, rows in timings.items())
+
+def load_file(path):
+    """Returns {element_type: [row, ...]} from one results file."""
+    if path.endswith('.py'):
+        scope = {}
+        with open(path) as f:
+            exec(compile(f.read(), path, 'exec'), scope)
+    else:
+        with open(path) as f:
+            scope = json.load(f)
+        if 'benchmarks' in scope and isinstance(scope['benchmarks'], list):
+            scope = _load_google_benchmark(scope)
+    return dict(
+        (name[:-len('_timings')], value)
+        for name, value in scope.items()
+        if name.endswith('_timings') and isinstance(value, list))
+
+def load_directory(path):
+    """Returns {variant: {element_type: rows}} for the .py and .json files
+    in path; a .json file wins over a .py file of the same name."""
+    variants = {}
+    names = sorted(os.listdir(path))
+    for name in names:
+        stem, ext = os.path.splitext(name)
+        if ext not in ('.py', '.json'):
+            continue
+        if ext == '.py' and stem + '.json' in names:
+            continue
+        timings = load_file(os.path.join(path, name))
+        if timings:
+            variants[stem] = timings
+    return variants
+
+def compiler_of(directory):
+    """'linux_gcc_data' -> 'gcc', 'windows_msvc_data' -> 'msvc'."""
+    parts = os.path.basename(os.path.normpath(directory)).split('_')
+    if parts[-1] == 'data':
+        parts = parts[:-1]
+    return parts[-1] if len(parts) else directory
+
+def load_all(directories):
+    """Returns {compiler: {variant: {element_type: rows}}}, and the
+    compilers in the order of directories."""
+    data = {}
+    compilers = []
+    for d in directories:
+        if not os.path.isdir(d):
+            continue
+        variants = load_directory(d)
+        if not variants:
+            continue
+        compiler = compiler_of(d)
+        if compiler in data:
+            compiler = os.path.basename(os.path.normpath(d))
+        data[compiler] = variants
+        compilers.append(compiler)
+    return data, compilers
+
+known_variants = ['boost_flat_map', 'std_map', 'split_map', 'std_flat_map']
+
+def variants_of(data):
+    """The variants in data, the known ones first, in a stable order."""
+    found = set()
+    for variants in data.values():
+        found.update(variants)
+    known = [v for v in known_variants if v in found]
+    return known + sorted(found - set(known))
+
+def element_types_of(data):
+    found = set()
+    for variants in data.values():
+        for timings in variants.values():
+            found.update(timings)
+    order = ['int', 'string']
+    return [t for t in order if t in found] + sorted(found - set(order))
+
+def operations_of(data):
+    """The operations timed anywhere in data, in perf_test's order first."""
+    found = set()
+    for variants in data.values():
+        for timings in variants.values():
+            for rows in timings.values():
+                for row in rows:
+                    found.update(k for k in row if is_operation(k))
+    order = ['insert', 'iterate', 'find', 'erase']
+    return [o for o in order if o in found] + sorted(found - set(order))
+
+def value(row, operation):
+    """row's time for operation, or for 'a/b' the ratio of a to b; None if
+    row lacks it."""
+    parts = operation.split('/')
+    if any(p not in row for p in parts):
+        return None
+    if len(parts) == 2:
+        return row[parts[0]] / (row[parts[1]] or 0.00001)
+    return row[operation]
@@ -0,0 +1,111 @@
+// Compares the lookup strategies flat_map can use for integer keys: plain
+// std::lower_bound over the keys, the default branchless search, and the
+// interpolation search enabled by std::flat_map_interpolation_search.  Each
+// row prints nanoseconds per lower_bound for one key distribution and size.
+// Below 2 MiB of keys the interpolating map just halves, so the last two
+// columns should match; above that, interpolation should win clearly on ids
+// and timestamps, and the skewed rows show what a bad guess costs.
+
+#include <flat_map>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+namespace std {
+    template <>
+    struct flat_map_interpolation_search<long long, less<>> : true_type
+    {};
+}
+
+using branchless_map = std::flat_map<long long, int>;
+using interpolating_map = std::flat_map<long long, int, std::less<>>;
+
+constexpr std::size_t queries_per_run = 1 << 20;
+
+template <typename F>
+double ns_per_lookup(std::vector<long long> const & queries, F f)
+{
+    std::size_t sum = 0;
+    auto const start = std::chrono::steady_clock::now();
+    for (long long q : queries) {
+        sum += f(q);
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    if (sum == std::size_t(-1))
+        std::puts("");
+    return std::chrono::duration<double, std::nano>(stop - start).count() /
+           queries.size();
+}
+
+void run(char const * name, std::vector<long long> const & keys)
+{
+    std::mt19937_64 gen(42);
+    std::vector<long long> queries(queries_per_run);
+    for (long long & q : queries) {
+        q = keys[gen() % keys.size()] + (long long)(gen() % 2);
+    }
+
+    branchless_map::containers c;
+    c.keys = keys;
+    c.values.assign(keys.size(), 0);
+    branchless_map const branchless(std::sorted_unique, c.keys, c.values);
+    interpolating_map const interpolating(
+        std::sorted_unique, std::move(c.keys), std::move(c.values));
+
+    double const binary = ns_per_lookup(queries, [&](long long q) {
+        return std::size_t(
+            std::lower_bound(keys.begin(), keys.end(), q) - keys.begin());
+    });
+    double const default_search = ns_per_lookup(queries, [&](long long q) {
+        return std::size_t(branchless.lower_bound(q) - branchless.begin());
+    });
+    double const interpolation = ns_per_lookup(queries, [&](long long q) {
+        return std::size_t(
+            interpolating.lower_bound(q) - interpolating.begin());
+    });
+    std::printf(
+        "%-12s %9zu %8.2f %8.2f %8.2f\n",
+        name,
+        keys.size(),
+        binary,
+        default_search,
+        interpolation);
+}
+
+int main()
+{
+    std::printf(
+        "distribution      size   binary  default   interp\n");
+    std::mt19937_64 gen(1);
+    for (std::size_t n : {1000u, 65536u, 1u << 18, 1u << 20, 1u << 24}) {
+        std::vector<long long> ids(n);
+        long long id = 1000000;
+        for (long long & k : ids) {
+            k = id;
+            id += 1 + (long long)(gen() % 4);
+        }
+        run("ids", ids);
+
+        std::vector<long long> timestamps(n);
+        for (long long & k : timestamps) {
+            k = 1600000000000000ll + (long long)(gen() % (n * 1000000));
+        }
+        std::sort(timestamps.begin(), timestamps.end());
+        timestamps.erase(
+            std::unique(timestamps.begin(), timestamps.end()),
+            timestamps.end());
+        run("timestamps", timestamps);
+
+        std::vector<long long> skewed(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            double const x = double(i) / n;
+            skewed[i] = (long long)(x * x * x * x * 1e15) + (long long)i;
+        }
+        run("skewed", skewed);
+    }
+    return 0;
+}
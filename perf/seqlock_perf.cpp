@@ -0,0 +1,148 @@
+// Compares seqlock_flat_map with a flat_map behind a std::shared_mutex,
+// for a small map with one writer and 1, 2, 4, ..., max_readers readers.
+// Each configuration runs for a fixed time and prints the millions of
+// reads and writes per second.  Readers look up random keys, half of
+// them present, and copy the value; the writer assigns random keys, and
+// erases and re-inserts one key in 16, so that elements shift.  Expect the
+// shared_mutex writer to starve as readers are added, while the seqlock
+// writer never waits for them; with a writer that never pauses, as here,
+// the seqlock readers pay for that in retries.  The numbers mean little
+// on a machine with fewer cores than threads.
+//
+// Usage: seqlock_perf [max_readers [map_size [ms_per_run]]]
+
+#include <seqlock_flat_map>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+
+struct value_t
+{
+    long count;
+    long timestamp;
+};
+
+struct locked_map_t
+{
+    bool find(int k, value_t & v) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto const it = map.find(k);
+        if (it == map.end())
+            return false;
+        v = it->second;
+        return true;
+    }
+    void assign(int k, value_t v)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        map.insert_or_assign(k, v);
+    }
+    void erase(int k)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        map.erase(k);
+    }
+
+    mutable std::shared_mutex mutex;
+    std::flat_map<int, value_t> map;
+};
+
+struct seqlock_map_t
+{
+    bool find(int k, value_t & v) const
+    {
+        auto const found = map.find(k);
+        if (found)
+            v = *found;
+        return bool(found);
+    }
+    void assign(int k, value_t v) { map.insert_or_assign(k, v); }
+    void erase(int k) { map.erase(k); }
+
+    std::seqlock_flat_map<int, value_t> map;
+};
+
+struct result_t
+{
+    double reads_per_s;
+    double writes_per_s;
+};
+
+template <typename Map>
+result_t run(int readers, int map_size, int ms)
+{
+    Map map;
+    for (int i = 0; i < map_size; ++i) {
+        map.assign(i * 2, value_t{i, i});
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<long long> reads{0};
+    long long writes = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < readers; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937 gen(t + 1);
+            long long n = 0;
+            long sum = 0;
+            value_t v;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (map.find(int(gen() % (2 * map_size)), v))
+                    sum += v.count;
+                ++n;
+            }
+            reads += n;
+            if (sum == -1)
+                std::puts("");
+        });
+    }
+    threads.emplace_back([&] {
+        std::mt19937 gen(0);
+        while (!stop.load(std::memory_order_relaxed)) {
+            int const k = int(gen() % map_size) * 2;
+            if (writes % 16 == 0)
+                map.erase(k);
+            map.assign(k, value_t{long(writes), long(writes)});
+            ++writes;
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    stop = true;
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    double const seconds = ms / 1000.0;
+    return {reads / seconds / 1e6, writes / seconds / 1e6};
+}
+
+int main(int argc, char * argv[])
+{
+    int const max_readers =
+        1 < argc ? std::atoi(argv[1])
+                 : std::max(1, int(std::thread::hardware_concurrency()) - 1);
+    int const map_size = 2 < argc ? std::atoi(argv[2]) : 64;
+    int const ms = 3 < argc ? std::atoi(argv[3]) : 500;
+
+    std::printf(
+        "readers  shared_mutex reads/writes    seqlock reads/writes (M/s)\n");
+    for (int readers = 1; readers <= max_readers; readers *= 2) {
+        result_t const locked = run<locked_map_t>(readers, map_size, ms);
+        result_t const seqlock = run<seqlock_map_t>(readers, map_size, ms);
+        std::printf(
+            "%7d  %12.2f %12.2f  %10.2f %10.2f\n",
+            readers,
+            locked.reads_per_s,
+            locked.writes_per_s,
+            seqlock.reads_per_s,
+            seqlock.writes_per_s);
+    }
+}
@@ -0,0 +1,93 @@
+// Compares flat_maps used as sliding windows over a stream of increasing
+// int64 timestamps, with vector, deque and offset_vector as both of their
+// containers.  Each step appends the next timestamp at the back, expires
+// the oldest one from the front with erase(begin()), and looks up a
+// random timestamp in the window, so the map holds the window size
+// throughout.
+//
+// Usage: sliding_window_perf [window size]...; the default sizes are 1K,
+// 16K and 256K.
+
+#include <flat_map>
+#include <offset_vector>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <vector>
+
+
+template <template <class...> class Container>
+using window_t = std::flat_map<
+    std::int64_t,
+    std::int64_t,
+    std::less<std::int64_t>,
+    Container<std::int64_t>,
+    Container<std::int64_t>>;
+
+// Returns the time per step in ns, and the sum of the values looked up in
+// *sum.
+template <typename Map>
+double time_ns(std::size_t window, std::int64_t * sum)
+{
+    Map map;
+    for (std::size_t i = 0; i < window; ++i) {
+        map.emplace(std::int64_t(i), std::int64_t(i));
+    }
+    std::mt19937_64 gen(42);
+    std::size_t const steps = std::size_t(1) << 15;
+    std::int64_t s = 0;
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t i = window; i < window + steps; ++i) {
+        map.emplace(std::int64_t(i), std::int64_t(i));
+        map.erase(map.begin());
+        s += map.find(std::int64_t(i - gen() % window))->second;
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    *sum = s;
+    return std::chrono::duration<double, std::nano>(stop - start).count() /
+           double(steps);
+}
+
+template <typename T>
+using vector_t = std::vector<T>;
+template <typename T>
+using deque_t = std::deque<T>;
+template <typename T>
+using offset_vector_t = std::offset_vector<T>;
+
+int main(int argc, char * argv[])
+{
+    std::vector<std::size_t> windows;
+    for (int i = 1; i < argc; ++i) {
+        windows.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (windows.empty())
+        windows = {1u << 10, 1u << 14, 1u << 18};
+
+    std::printf(
+        "ns per step  %10s %12s %12s %14s\n",
+        "window",
+        "vector",
+        "deque",
+        "offset_vector");
+    for (std::size_t window : windows) {
+        std::int64_t sums[3];
+        double const vector_ns =
+            time_ns<window_t<vector_t>>(window, sums + 0);
+        double const deque_ns = time_ns<window_t<deque_t>>(window, sums + 1);
+        double const offset_ns =
+            time_ns<window_t<offset_vector_t>>(window, sums + 2);
+        if (sums[0] != sums[1] || sums[0] != sums[2])
+            std::abort();
+        std::printf(
+            "             %10zu %12.2f %12.2f %14.2f\n",
+            window,
+            vector_ns,
+            deque_ns,
+            offset_ns);
+    }
+}
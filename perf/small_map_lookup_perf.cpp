@@ -0,0 +1,84 @@
+// Measures lookups into small flat_maps, to tune
+// std::flat_map_linear_search_threshold.  For each key type and map size,
+// prints the nanoseconds per lookup of a counting linear scan, of
+// std::lower_bound, and of flat_map::find, and then the largest size at
+// which the scan alone still beat flat_map::find.  If that is well above
+// the threshold, the threshold is too low for this machine.
+
+#include <flat_map>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+constexpr int repetitions = 500;
+constexpr std::size_t queries_per_repetition = 4096;
+
+template <typename T, typename F>
+double ns_per_lookup(std::vector<T> const & queries, F f)
+{
+    std::size_t sum = 0;
+    auto const start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        for (T q : queries) {
+            sum += f(q);
+        }
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    if (sum == std::size_t(-1))
+        std::puts("");
+    return std::chrono::duration<double, std::nano>(stop - start).count() /
+           (double(repetitions) * queries.size());
+}
+
+template <typename T>
+void run(char const * name)
+{
+    std::printf(
+        "%s (threshold %zu)\n     n     scan   binary     find\n",
+        name,
+        std::flat_map_linear_search_threshold<T>::value);
+    std::size_t crossover = 0;
+    std::mt19937 gen(42);
+    for (std::size_t n = 2; n <= 128; n += n < 16 ? 2 : n < 64 ? 8 : 32) {
+        std::flat_map<T, int> map;
+        for (std::size_t i = 0; i < n; ++i) {
+            map.emplace(T(i * 3), int(i));
+        }
+        std::vector<T> const & keys = map.keys();
+        std::vector<T> queries(queries_per_repetition);
+        for (T & q : queries) {
+            q = T(gen() % (3 * n));
+        }
+
+        double const scan = ns_per_lookup(queries, [&](T q) {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                count += keys[i] < q;
+            }
+            return count;
+        });
+        double const binary = ns_per_lookup(queries, [&](T q) {
+            return std::size_t(
+                std::lower_bound(keys.begin(), keys.end(), q) - keys.begin());
+        });
+        double const find = ns_per_lookup(queries, [&](T q) {
+            return std::size_t(map.find(q) != map.end());
+        });
+        std::printf("%6zu %8.2f %8.2f %8.2f\n", n, scan, binary, find);
+        if (scan < find)
+            crossover = n;
+    }
+    std::printf("scan wins up to n = %zu\n\n", crossover);
+}
+
+int main()
+{
+    run<int>("int");
+    run<long long>("long long");
+    run<double>("double");
+    return 0;
+}
@@ -0,0 +1,134 @@
+// Compares flat_map's zipped sort kernels, which sort the key and value
+// arrays in lockstep, with the std::sort() and std::stable_sort() of the
+// proxy iterators over both arrays that the maps used before.  The
+// unstable sorts are the container constructors' path, the stable ones
+// the bulk inserts'.  Keys are ints under a comparator that is not
+// radix sorted, and 16-character strings; values are ints.
+//
+// Usage: zip_sort_perf [size]...; the default sizes are 1K, 64K and 1M.
+
+#include <flat_map>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+
+// Orders ints like std::less, without being recognized as a built-in
+// order, so that flat_map would not radix sort them.
+struct opaque_less
+{
+    bool operator()(int x, int y) const { return x < y; }
+};
+
+template <typename Key>
+using proxy_iterator = std::__flat_map_iterator<
+    Key &,
+    int &,
+    typename std::vector<Key>::iterator,
+    typename std::vector<int>::iterator>;
+
+template <typename Key, typename Compare, typename Sort>
+double time_ns(
+    std::vector<Key> const & keys,
+    std::vector<int> const & values,
+    Compare comp,
+    Sort sort)
+{
+    double best = 0.0;
+    for (int i = 0; i < 5; ++i) {
+        std::vector<Key> k = keys;
+        std::vector<int> v = values;
+        auto const start = std::chrono::steady_clock::now();
+        sort(k, v, comp);
+        auto const stop = std::chrono::steady_clock::now();
+        if (!std::is_sorted(k.begin(), k.end(), comp))
+            std::abort();
+        double const ns =
+            std::chrono::duration<double, std::nano>(stop - start).count() /
+            double(keys.size());
+        if (!i || ns < best)
+            best = ns;
+    }
+    return best;
+}
+
+template <typename Key, typename Compare>
+void run(
+    char const * name,
+    std::vector<Key> const & keys,
+    std::vector<int> const & values,
+    Compare comp)
+{
+    auto const value_comp = [comp](auto const & x, auto const & y) {
+        return comp(x.first, y.first);
+    };
+    auto const proxy_sort = [&](auto & k, auto & v, Compare) {
+        proxy_iterator<Key> first(k.begin(), v.begin());
+        proxy_iterator<Key> last(k.end(), v.end());
+        std::sort(first, last, value_comp);
+    };
+    auto const proxy_stable_sort = [&](auto & k, auto & v, Compare) {
+        proxy_iterator<Key> first(k.begin(), v.begin());
+        proxy_iterator<Key> last(k.end(), v.end());
+        std::stable_sort(first, last, value_comp);
+    };
+    auto const zip_sort = [](auto & k, auto & v, Compare c) {
+        std::__zip_sort(k.begin(), v.begin(), k.size(), c);
+    };
+    auto const zip_stable_sort = [](auto & k, auto & v, Compare c) {
+        std::__zip_stable_sort(k.begin(), v.begin(), k.size(), c);
+    };
+
+    double const sort_old = time_ns(keys, values, comp, proxy_sort);
+    double const sort_new = time_ns(keys, values, comp, zip_sort);
+    double const stable_old = time_ns(keys, values, comp, proxy_stable_sort);
+    double const stable_new = time_ns(keys, values, comp, zip_stable_sort);
+    std::printf(
+        "%-8s %9zu %10.2f %10.2f %7.2fx %10.2f %10.2f %7.2fx\n",
+        name,
+        keys.size(),
+        sort_old,
+        sort_new,
+        sort_old / sort_new,
+        stable_old,
+        stable_new,
+        stable_old / stable_new);
+}
+
+int main(int argc, char * argv[])
+{
+    std::vector<std::size_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (sizes.empty())
+        sizes = {1u << 10, 1u << 16, 1u << 20};
+
+    std::printf(
+        "ns per element      %10s %10s %8s %10s %10s %8s\n",
+        "sort",
+        "zip_sort",
+        "",
+        "stable",
+        "zip_stable",
+        "");
+    for (std::size_t size : sizes) {
+        std::mt19937 gen(42);
+        std::vector<int> int_keys(size);
+        std::vector<std::string> string_keys(size);
+        std::vector<int> values(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            int_keys[i] = int(gen() % (4 * size));
+            string_keys[i] = std::to_string(gen());
+            string_keys[i].resize(16, 'x');
+            values[i] = int(i);
+        }
+        run("int", int_keys, values, opaque_less());
+        run("string", string_keys, values, std::less<std::string>());
+    }
+}